@@ -12,6 +12,7 @@ extern "C" {
 	CRYPTO_STATUS AES_encrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]);
 	CRYPTO_STATUS AES_decrypt_block(const AES_CTX* ctx, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]);
 	CRYPTO_STATUS AES_CTR_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t nonce_counter[AES_BLOCK_SIZE]);
+	CRYPTO_STATUS AES_CTR_seek(uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t blocks);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,29 @@
+#ifndef AES_CTR_HMAC_H
+#define AES_CTR_HMAC_H
+
+#include "crypto_api.h"
+#include "hmac_sha512.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	// 타일 크기 (L1 캐시에 입력/출력 타일이 함께 들어가는 크기, AES/SHA-512 블록 크기의 배수)
+#define AES_CTR_HMAC_TILE_SIZE (16 * 1024)
+
+	// HMAC 적용 순서
+	typedef enum {
+		AES_CTR_HMAC_MAC_INPUT = 0,   // 입력(CTR 이전)에 HMAC: v4 복호화(암호문), v2/v3 암호화(평문)
+		AES_CTR_HMAC_MAC_OUTPUT       // 출력(CTR 이후)에 HMAC: v4 암호화(암호문), v2/v3 복호화(평문)
+	} AES_CTR_HMAC_ORDER;
+
+	// AES-CTR과 HMAC-SHA512 업데이트를 한 번의 패스로 수행 (타일 단위로 캐시에 올라와 있을 때 둘 다 처리)
+	// 결과는 AES_CTR_crypt + hmac_sha512_update를 따로 호출한 것과 동일 (in == out 허용)
+	CRYPTO_STATUS AES_CTR_HMAC_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+		uint8_t nonce_counter[AES_BLOCK_SIZE], HMAC_SHA512_CTX* hmac_ctx, AES_CTR_HMAC_ORDER order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AES_CTR_HMAC_H
@@ -9,6 +9,7 @@
 #include "aes.h"
 #include "sha512.h"
 #include "hmac_sha512.h"
+#include "aes_ctr_hmac.h"
 #include "kdf.h"
 #include "file_crypto.h"
 #include "platform_utils.h"
@@ -17,6 +18,16 @@
 #include "key_derivation.h"
 #include "random_utils.h"
 #include "file_path_utils.h"
+#include "file_pipeline.h"
+#include "file_segments.h"
+#include "file_archive.h"
+#include "lz_codec.h"
+#include "file_chunks.h"
+#include "key_slots.h"
+#include "file_hash.h"
+#include "file_crypto_internal.h"
+#include "file_inplace.h"
+#include "file_checkpoint.h"
 
 
 #ifdef PLATFORM_WINDOWS
@@ -26,8 +37,17 @@
 #endif
 #endif
 
-// 청크 크기 정의 (1MB - 성능 최적화)
-#define FILE_CHUNK_SIZE (1024 * 1024)
+// 자동 모드에서 파이프라인/메모리 매핑을 사용하는 최소 데이터 크기 (작은 파일은 준비 비용이 더 큼)
+#define IO_ACCEL_MIN_SIZE (4L * FILE_CHUNK_SIZE)
+
+// io_uring 엔진에서 동시에 진행할 청크 버퍼 수 (메모리 상한 = 깊이 × FILE_CHUNK_SIZE)
+#define URING_QUEUE_DEPTH 8
+
+// 파일 I/O 모드 (set_file_io_mode로 변경)
+static FILE_IO_MODE g_file_io_mode = FILE_IO_MODE_AUTO;
+
+// 파일 암호화 형식 (set_encryption_format으로 변경)
+static ENC_FORMAT g_encryption_format = ENC_FORMAT_DEFAULT;
 
 // 로깅 헬퍼 함수들 (다른 함수들보다 먼저 정의)
 
@@ -38,7 +58,7 @@
  * @param ... 가변 인자 (format에 맞는 값들)
  * @note [ERROR] 접두사가 자동으로 추가됩니다.
  */
-static void log_error(int show_error, const char* format, ...) {
+void log_error(int show_error, const char* format, ...) {
     if (!show_error) return;
     
     va_list args;
@@ -54,7 +74,7 @@ static void log_error(int show_error, const char* format, ...) {
  * @param format printf 형식 문자열
  * @param ... 가변 인자 (format에 맞는 값들)
  */
-static void log_info(int show_error, const char* format, ...) {
+void log_info(int show_error, const char* format, ...) {
     if (!show_error) return;
     
     va_list args;
@@ -132,7 +152,7 @@ static void print_operation_success(const char* operation, const char* output_pa
  * @param operation 작업 이름 (예: "Encrypting", "Decrypting")
  * @note 진행률 바와 퍼센트를 실시간으로 업데이트합니다.
  */
-static void print_progress(long processed, long total, const char* operation) {
+static void print_progress(int64_t processed, int64_t total, const char* operation) {
     if (total <= 0) return;
     
     double percent = (double)processed / total * 100.0;
@@ -152,7 +172,7 @@ static void print_progress(long processed, long total, const char* operation) {
             printf(" ");
         }
     }
-    printf("] %.1f%% (%ld / %ld bytes)", percent, processed, total);
+    printf("] %.1f%% (%lld / %lld bytes)", percent, (long long)processed, (long long)total);
     fflush(stdout);
 }
 
@@ -166,14 +186,16 @@ static void print_progress(long processed, long total, const char* operation) {
  * @param update_interval 업데이트 간격 (퍼센트 단위, 0이면 매 퍼센트마다)
  * @note 콜백이 있으면 콜백을 호출하고, 없으면 print_progress를 사용합니다.
  */
-static void update_progress_with_callback(long processed, long total,
-                                          progress_callback_t progress_cb, void* user_data,
-                                          const char* operation, int update_interval) {
+void update_progress_with_callback(int64_t processed, int64_t total,
+                                   progress_callback_t progress_cb, void* user_data,
+                                   const char* operation, int update_interval) {
     if (progress_cb) {
         // 콜백이 있으면 콜백 사용
         progress_cb(processed, total, user_data);
     } else {
         // 콜백이 없으면 print_progress 사용 (간격 제어)
+        if (total <= 0) return;  // 진행률을 보고하지 않는 호출 (예: enc_open의 검증)
+        
         static long last_percent_encrypt = -1;
         static long last_percent_decrypt = -1;
         
@@ -182,7 +204,7 @@ static void update_progress_with_callback(long processed, long total,
                             &last_percent_encrypt : &last_percent_decrypt;
         
         long current_percent = (long)((processed * 100LL) / total);
-        long remaining = total - processed;
+        int64_t remaining = total - processed;
         
         // 업데이트 간격에 따라 출력 조건 결정
         int should_update = 0;
@@ -204,19 +226,198 @@ static void update_progress_with_callback(long processed, long total,
     }
 }
 
+/**
+ * @brief 파일 I/O 모드를 설정합니다.
+ * @param mode FILE_IO_MODE_AUTO, FILE_IO_MODE_SERIAL, FILE_IO_MODE_PIPELINED, FILE_IO_MODE_MMAP,
+ *             FILE_IO_MODE_IO_URING, FILE_IO_MODE_DIRECT
+ */
+void set_file_io_mode(FILE_IO_MODE mode) {
+    g_file_io_mode = mode;
+}
+
+/**
+ * @brief 파일 암호화 형식을 설정합니다.
+ * @param format ENC_FORMAT_DEFAULT, ENC_FORMAT_SEGMENTED, ENC_FORMAT_COMPRESSED, ENC_FORMAT_INCREMENTAL,
+ *               ENC_FORMAT_KEYSLOTS
+ */
+void set_encryption_format(ENC_FORMAT format) {
+    g_encryption_format = format;
+}
+
+/**
+ * @brief 주어진 크기의 데이터를 처리할 I/O 경로를 결정합니다.
+ * @param data_size 처리할 데이터 크기 (바이트)
+ * @return 자동 모드가 아닌 FILE_IO_MODE 값
+ * @note 자동 모드에서는 데이터가 IO_ACCEL_MIN_SIZE 이상일 때 CPU가 2개 이상이면 파이프라인,
+ *       1개면 메모리 매핑을 사용합니다 (I/O와 연산을 겹칠 코어가 없으므로 복사만 줄임).
+ */
+static FILE_IO_MODE select_io_path(int64_t data_size) {
+    if (g_file_io_mode != FILE_IO_MODE_AUTO) return g_file_io_mode;
+    if (data_size < IO_ACCEL_MIN_SIZE) return FILE_IO_MODE_SERIAL;
+    return (platform_cpu_count() >= 2) ? FILE_IO_MODE_PIPELINED : FILE_IO_MODE_MMAP;
+}
+
+// 파이프라인/io_uring 진행률 보고용 컨텍스트
+typedef struct {
+    int64_t base;                    // 처리량에 더할 값 (앞선 단계의 처리량)
+    int64_t total;                   // 진행률 전체 크기
+    progress_callback_t progress_cb; // 진행률 콜백 함수 (NULL 가능)
+    void* user_data;                 // 콜백에 전달할 사용자 데이터
+    const char* operation;           // 작업 이름 (예: "Encrypting")
+    int update_interval;             // 업데이트 간격 (퍼센트 단위)
+} PipelineProgress;
+
+/**
+ * @brief 청크 처리 콜백: 기존 진행률 출력으로 전달합니다.
+ * @param processed 처리한 누적 바이트 수
+ * @param user_data PipelineProgress 포인터
+ */
+static void pipeline_progress(int64_t processed, void* user_data) {
+    PipelineProgress* progress = (PipelineProgress*)user_data;
+    update_progress_with_callback(progress->base + processed, progress->total,
+                                  progress->progress_cb, progress->user_data,
+                                  progress->operation, progress->update_interval);
+}
+
+/**
+ * @brief 헤더 버전에 따른 암호문 시작 오프셋을 반환합니다.
+ * @param header 암호화 파일 헤더
+ * @return v5는 ENC_ALIGNED_PAYLOAD_OFFSET, v6은 헤더 바로 다음 (첫 세그먼트), v7은 압축 정보 다음,
+ *         v9는 키 슬롯 표 다음, 그 외는 헤더 + HMAC 바로 다음
+ */
+int64_t enc_payload_offset(const EncFileHeader* header) {
+    if (header->version == ENC_VERSION_ALIGNED) return ENC_ALIGNED_PAYLOAD_OFFSET;
+    if (header->version == ENC_VERSION_STREAM) return (int64_t)sizeof(EncFileHeader);
+    if (header->version == ENC_VERSION_COMPRESSED) {
+        return (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE + sizeof(EncCompressionInfo));
+    }
+    if (header->version == ENC_VERSION_KEYSLOTS) {
+        return (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE + KEY_SLOT_TABLE_SIZE);
+    }
+    if (header->version == ENC_VERSION_INPLACE) return 0;  // 헤더와 HMAC은 암호문 뒤 트레일러
+    return (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE);
+}
+
+// 64비트 값을 big-endian 8바이트로 저장 / 읽기 (v7 압축 정보)
+void enc_store_be64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (56 - 8 * i));
+    }
+}
+
+uint64_t enc_load_be64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+// 헤더의 키 길이 코드 → AES 키 길이 (알 수 없는 코드면 0)
+int enc_header_key_bits(const EncFileHeader* header) {
+    if (header->key_length_code == KEY_LENGTH_CODE_128) return 128;
+    if (header->key_length_code == KEY_LENGTH_CODE_192) return 192;
+    if (header->key_length_code == KEY_LENGTH_CODE_256) return 256;
+    return 0;
+}
+
+/**
+ * @brief io_uring 엔진으로 데이터 구간을 처리합니다 (Linux 전용).
+ * @param fin 입력 파일 포인터
+ * @param in_offset 입력 시작 오프셋
+ * @param length 처리할 바이트 수
+ * @param fout 출력 파일 포인터 (NULL이면 읽기만)
+ * @param out_offset 출력 시작 오프셋
+ * @param digest_ctx CTR 이전 내용의 SHA-512 컨텍스트 (NULL이면 생략, 암호화 시 평문 해시)
+ * @param aes_ctx AES 컨텍스트 (NULL이면 CTR 생략)
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param hmac_ctx HMAC 컨텍스트 (NULL이면 HMAC 생략)
+ * @param order CTR과 HMAC을 모두 적용할 때 HMAC 적용 순서
+ * @param ctr_error CTR 실패 시 에러 코드
+ * @param progress 진행률 컨텍스트
+ * @param result 처리 결과 (반환값이 1일 때만 유효)
+ * @return 1 io_uring으로 처리함, 0 io_uring 사용 불가 (호출자가 stdio 경로로 처리)
+ * @note 여러 읽기/쓰기를 동시에 걸어 두고 완료된 청크를 순서대로 처리합니다.
+ *       FILE_IO_MODE_DIRECT에서는 오프셋이 4 KiB 정렬일 때 O_DIRECT로 페이지 캐시를 우회합니다.
+ */
+static int process_uring_content(FILE* fin, int64_t in_offset, int64_t length, FILE* fout, int64_t out_offset,
+                                 SHA512_CTX* digest_ctx, const AES_CTX* aes_ctx, uint8_t* nonce_counter,
+                                 HMAC_SHA512_CTX* hmac_ctx, AES_CTR_HMAC_ORDER order,
+                                 FILE_CRYPTO_STATUS ctr_error, PipelineProgress* progress,
+                                 FILE_CRYPTO_STATUS* result) {
+    platform_uring_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.in = fin;
+    config.in_offset = in_offset;
+    config.length = length;
+    config.out = fout;
+    config.out_offset = out_offset;
+    config.chunk_size = FILE_CHUNK_SIZE;
+    config.depth = URING_QUEUE_DEPTH;
+    config.direct = (g_file_io_mode == FILE_IO_MODE_DIRECT);
+    
+    platform_uring_stream_t* stream = platform_uring_stream_open(&config);
+    if (!stream) return 0;
+    
+    *result = FILE_CRYPTO_SUCCESS;
+    int64_t processed = 0;
+    uint8_t* data;
+    size_t chunk;
+    int next;
+    while ((next = platform_uring_stream_next(stream, &data, &chunk)) == 1) {
+        CRYPTO_STATUS crypt_status = CRYPTO_SUCCESS;
+        if (digest_ctx) sha512_update(digest_ctx, data, chunk);
+        if (aes_ctx && hmac_ctx) {
+            crypt_status = AES_CTR_HMAC_crypt(aes_ctx, data, chunk, data, nonce_counter, hmac_ctx, order);
+        } else if (aes_ctx) {
+            crypt_status = AES_CTR_crypt(aes_ctx, data, chunk, data, nonce_counter);
+        } else if (hmac_ctx) {
+            hmac_sha512_update(hmac_ctx, data, chunk);
+        }
+        if (crypt_status != CRYPTO_SUCCESS) {
+            *result = ctr_error;
+            break;
+        }
+        
+        if (!platform_uring_stream_commit(stream)) {
+            *result = fout ? FILE_CRYPTO_ERR_FILE_WRITE : FILE_CRYPTO_ERR_FILE_READ;
+            break;
+        }
+        
+        processed += (int64_t)chunk;
+        pipeline_progress(processed, progress);
+    }
+    if (next < 0 && *result == FILE_CRYPTO_SUCCESS) {
+        *result = FILE_CRYPTO_ERR_FILE_READ;
+    }
+    
+    if (!platform_uring_stream_close(stream) && *result == FILE_CRYPTO_SUCCESS) {
+        *result = fout ? FILE_CRYPTO_ERR_FILE_WRITE : FILE_CRYPTO_ERR_FILE_READ;
+    }
+    
+    // stdio 쓰기 위치를 처리한 구간 끝으로 맞춤
+    if (*result == FILE_CRYPTO_SUCCESS && fout && platform_fseek64(fout, out_offset + length, SEEK_SET) != 0) {
+        *result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    return 1;
+}
+
 /**
  * @brief 암호화 파일 헤더를 생성합니다.
  * @param input_path 입력 파일 경로 (확장자 추출용)
  * @param aes_key_bits AES 키 길이 (128, 192, 256)
  * @param salt PBKDF2 salt (16바이트)
  * @param nonce CTR 모드 nonce (8바이트)
+ * @param key_check 키 확인 값 (ENC_KCV_SIZE 바이트, reserved에 저장)
+ * @param version 기록할 형식 버전 (ENC_VERSION, ENC_VERSION_ALIGNED, ENC_VERSION_STREAM)
  * @param header 출력 헤더 구조체
  * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_INVALID_INPUT 파라미터 오류
  */
-static FILE_CRYPTO_STATUS create_encryption_header(const char* input_path, int aes_key_bits,
-                                                    const uint8_t* salt, const uint8_t* nonce,
-                                                    EncFileHeader* header) {
-    if (!input_path || !salt || !nonce || !header) return FILE_CRYPTO_ERR_INVALID_INPUT;
+FILE_CRYPTO_STATUS create_encryption_header(const char* input_path, int aes_key_bits,
+                                             const uint8_t* salt, const uint8_t* nonce,
+                                             const uint8_t* key_check, uint8_t version,
+                                             EncFileHeader* header) {
+    if (!input_path || !salt || !nonce || !key_check || !header) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
     // 원본 파일 확장자 추출 및 헤더에 저장
     char original_ext[16];
@@ -226,7 +427,7 @@ static FILE_CRYPTO_STATUS create_encryption_header(const char* input_path, int a
     
     // 헤더 작성
     memcpy(header->signature, ENC_SIGNATURE, 4);
-    header->version = ENC_VERSION;
+    header->version = version;
     header->key_length_code = (aes_key_bits == 128) ? KEY_LENGTH_CODE_128 : 
                              (aes_key_bits == 192) ? KEY_LENGTH_CODE_192 : KEY_LENGTH_CODE_256;
     header->mode_code = ENC_MODE_CTR;
@@ -239,10 +440,72 @@ static FILE_CRYPTO_STATUS create_encryption_header(const char* input_path, int a
     }
     memcpy(header->salt, salt, ENC_SALT_SIZE);
     memset(header->reserved, 0, sizeof(header->reserved));
+    memcpy(header->reserved, key_check, ENC_KCV_SIZE);  // v3: 키 확인 값
     
     return FILE_CRYPTO_SUCCESS;
 }
 
+/**
+ * @brief 메모리 매핑으로 파일 내용을 암호화합니다 (stdio 버퍼를 거치지 않음).
+ * @param fin 입력 파일 포인터 (읽기 전용 매핑)
+ * @param fout 출력 파일 포인터 ("w+b", 현재 위치부터 암호문 기록)
+ * @param file_size 파일 크기 (바이트)
+ * @param aes_ctx AES 암호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param hmac_ctx HMAC 컨텍스트 (암호문에 대해 업데이트)
+ * @param digest_ctx 평문 SHA-512 컨텍스트 (NULL 가능)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param result 처리 결과 (반환값이 1일 때만 유효)
+ * @return 1 매핑으로 처리함, 0 매핑할 수 없음 (호출자가 stdio 경로로 처리)
+ * @note 입력 페이지에서 읽어 출력 페이지(미리 할당)로 바로 암호화하므로 커널↔사용자 버퍼 복사가 없습니다.
+ */
+static int encrypt_mapped_content(FILE* fin, FILE* fout, int64_t file_size,
+                                  const AES_CTX* aes_ctx, uint8_t* nonce_counter,
+                                  HMAC_SHA512_CTX* hmac_ctx, SHA512_CTX* digest_ctx,
+                                  progress_callback_t progress_cb, void* user_data,
+                                  FILE_CRYPTO_STATUS* result) {
+    int64_t out_offset = platform_ftell64(fout);
+    if (out_offset < 0 || file_size <= 0) return 0;
+    
+    platform_file_map_t in_map;
+    platform_file_map_t out_map;
+    if (!platform_map_stream(fin, (uint64_t)file_size, 0, &in_map)) return 0;
+    if (!platform_map_stream(fout, (uint64_t)(out_offset + file_size), 1, &out_map)) {
+        platform_unmap_stream(&in_map);
+        return 0;
+    }
+    
+    *result = FILE_CRYPTO_SUCCESS;
+    int64_t processed = 0;
+    while (processed < file_size) {
+        size_t chunk = (file_size - processed < FILE_CHUNK_SIZE) ? (size_t)(file_size - processed) : FILE_CHUNK_SIZE;
+        
+        // 입력 페이지 → 출력 페이지로 암호화 + 암호문 HMAC (v4 Encrypt-then-MAC)
+        // 평문 해시는 같은 청크가 캐시에 있는 동안 계산
+        if (digest_ctx) sha512_update(digest_ctx, in_map.data + processed, chunk);
+        if (AES_CTR_HMAC_crypt(aes_ctx, in_map.data + processed, chunk,
+                               out_map.data + out_offset + processed, nonce_counter,
+                               hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+            *result = FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+            break;
+        }
+        
+        processed += (int64_t)chunk;
+        update_progress_with_callback(processed, file_size, progress_cb, user_data,
+                                     "Encrypting", 2);
+    }
+    
+    platform_unmap_stream(&out_map);
+    platform_unmap_stream(&in_map);
+    
+    // stdio 쓰기 위치를 암호문 끝으로 맞춤 (이후 HMAC 기록과 일관성 유지)
+    if (*result == FILE_CRYPTO_SUCCESS && platform_fseek64(fout, out_offset + file_size, SEEK_SET) != 0) {
+        *result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    return 1;
+}
+
 /**
  * @brief 파일 내용을 암호화하고 출력 파일에 씁니다.
  * @param fin 입력 파일 포인터
@@ -250,36 +513,80 @@ static FILE_CRYPTO_STATUS create_encryption_header(const char* input_path, int a
  * @param file_size 파일 크기 (바이트)
  * @param aes_ctx AES 암호화 컨텍스트
  * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
- * @param hmac_ctx HMAC 컨텍스트 (평문에 대해 업데이트)
+ * @param hmac_ctx HMAC 컨텍스트 (암호문에 대해 업데이트, Encrypt-then-MAC)
+ * @param digest_ctx 평문 SHA-512 컨텍스트 (NULL 가능)
  * @param progress_cb 진행률 콜백 함수 (NULL 가능)
  * @param user_data 콜백에 전달할 사용자 데이터
  * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note digest_ctx를 주면 어느 I/O 경로든 암호화하려고 읽은 평문을 그대로 해시하므로 입력을 한 번만 읽습니다.
  */
-static FILE_CRYPTO_STATUS encrypt_file_content(FILE* fin, FILE* fout, long file_size,
+static FILE_CRYPTO_STATUS encrypt_file_content(FILE* fin, FILE* fout, int64_t file_size,
                                                 const AES_CTX* aes_ctx, uint8_t* nonce_counter,
-                                                HMAC_SHA512_CTX* hmac_ctx,
+                                                HMAC_SHA512_CTX* hmac_ctx, SHA512_CTX* digest_ctx,
                                                 progress_callback_t progress_cb, void* user_data) {
     if (!fin || !fout || !aes_ctx || !nonce_counter || !hmac_ctx) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
+    FILE_IO_MODE io_path = select_io_path(file_size);
+    if (io_path == FILE_IO_MODE_MMAP) {
+        // 매핑할 수 없으면 (빈 파일, 미지원 파일시스템 등) 아래 stdio 경로로 처리
+        FILE_CRYPTO_STATUS mapped_result;
+        if (encrypt_mapped_content(fin, fout, file_size, aes_ctx, nonce_counter, hmac_ctx, digest_ctx,
+                                   progress_cb, user_data, &mapped_result)) {
+            return mapped_result;
+        }
+    } else if (io_path == FILE_IO_MODE_IO_URING || io_path == FILE_IO_MODE_DIRECT) {
+        // io_uring을 쓸 수 없으면 (Linux 외, 구형 커널, 권한 제한) 아래 stdio 경로로 처리
+        int64_t out_offset = platform_ftell64(fout);
+        PipelineProgress progress = { 0, file_size, progress_cb, user_data, "Encrypting", 2 };
+        FILE_CRYPTO_STATUS uring_result;
+        if (out_offset >= 0 && file_size > 0 &&
+            process_uring_content(fin, 0, file_size, fout, out_offset, digest_ctx, aes_ctx, nonce_counter,
+                                  hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT, FILE_CRYPTO_ERR_ENCRYPTION_FAILED,
+                                  &progress, &uring_result)) {
+            return uring_result;
+        }
+    } else if (io_path == FILE_IO_MODE_PIPELINED) {
+        // 파이프라인: 읽기 → 해시(평문) → CTR → HMAC(암호문) → 쓰기를 각각 다른 스레드에서 겹쳐 실행
+        if (platform_fseek64(fin, 0, SEEK_SET) != 0) return FILE_CRYPTO_ERR_FILE_READ;
+        
+        PipelineProgress progress = { 0, file_size, progress_cb, user_data, "Encrypting", 2 };
+        FilePipelineJob job;
+        memset(&job, 0, sizeof(job));
+        job.fin = fin;
+        job.fout = fout;
+        job.length = -1;  // 단일 스레드 처리와 같이 EOF까지
+        job.chunk_size = FILE_CHUNK_SIZE;
+        job.digest_ctx = digest_ctx;
+        job.aes_ctx = aes_ctx;
+        job.nonce_counter = nonce_counter;
+        job.ctr_error = FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+        job.hmac_ctx = hmac_ctx;
+        job.on_chunk = pipeline_progress;
+        job.user_data = &progress;
+        return file_pipeline_run(&job);
+    }
+    
     uint8_t* buffer = (uint8_t*)malloc(FILE_CHUNK_SIZE);
     if (!buffer) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
     
     size_t bytes_read;
-    long total_processed = 0;
+    int64_t total_processed = 0;
     FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
     
     // 파일 위치를 처음으로
-    if (fseek(fin, 0, SEEK_SET) != 0) {
+    if (platform_fseek64(fin, 0, SEEK_SET) != 0) {
         free(buffer);
         return FILE_CRYPTO_ERR_FILE_READ;
     }
     
     while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, fin)) > 0) {
-        // HMAC 업데이트 (평문에 대해 - 암호화 전)
-        hmac_sha512_update(hmac_ctx, buffer, bytes_read);
+        // 평문 해시는 in-place 암호화가 버퍼를 덮어쓰기 전에
+        if (digest_ctx) sha512_update(digest_ctx, buffer, bytes_read);
         
-        // 동시에 암호화 (in-place)
-        if (AES_CTR_crypt(aes_ctx, buffer, bytes_read, buffer, nonce_counter) != CRYPTO_SUCCESS) {
+        // 암호화 (in-place) + HMAC 업데이트 (암호문에 대해 - v4 Encrypt-then-MAC)
+        // 타일 단위로 묶어 청크를 캐시에 한 번만 올림
+        if (AES_CTR_HMAC_crypt(aes_ctx, buffer, bytes_read, buffer, nonce_counter,
+                               hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
             free(buffer);
             return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
         }
@@ -306,6 +613,88 @@ static FILE_CRYPTO_STATUS encrypt_file_content(FILE* fin, FILE* fout, long file_
     return result;
 }
 
+/**
+ * @brief 파일 내용을 압축한 뒤 암호화해 출력 파일에 씁니다 (v7).
+ * @param fin 입력 파일 포인터
+ * @param fout 출력 파일 포인터 (압축 정보 자리 다음부터 암호문 기록)
+ * @param file_size 파일 크기 (바이트, 진행률 기준)
+ * @param aes_ctx AES 암호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param hmac_ctx HMAC 컨텍스트 (암호문에 대해 업데이트한 뒤 마지막에 압축 정보 추가)
+ * @param info 출력 압축 정보 (파일의 압축 정보 자리에 기록할 값)
+ * @param digest_ctx 평문 SHA-512 컨텍스트 (압축 전 원본, NULL 가능)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 입력을 LZ_BLOCK_SIZE 블록마다 프레임으로 만들고 FILE_CHUNK_SIZE만큼 모아 한 번에 CTR + HMAC 처리합니다.
+ *       줄지 않는 블록은 원본 그대로 저장하고, 그런 블록이 이어지면 몇 블록씩 압축 시도 없이 넘기므로
+ *       이미 압축된 입력(JPEG, ZIP 등)에서 드는 CPU는 원본을 복사하는 정도입니다.
+ */
+static FILE_CRYPTO_STATUS encrypt_compressed_content(FILE* fin, FILE* fout, int64_t file_size,
+                                                     const AES_CTX* aes_ctx, uint8_t* nonce_counter,
+                                                     HMAC_SHA512_CTX* hmac_ctx, EncCompressionInfo* info,
+                                                     SHA512_CTX* digest_ctx,
+                                                     progress_callback_t progress_cb, void* user_data) {
+    if (!fin || !fout || !aes_ctx || !nonce_counter || !hmac_ctx || !info) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    if (platform_fseek64(fin, 0, SEEK_SET) != 0) return FILE_CRYPTO_ERR_FILE_READ;
+    
+    // block: 원본 블록, frames: 암호화 전에 모으는 프레임 (청크 크기 + 프레임 하나의 여유)
+    uint8_t* block = (uint8_t*)malloc(LZ_BLOCK_SIZE);
+    uint8_t* frames = (uint8_t*)malloc(FILE_CHUNK_SIZE + LZ_FRAME_BOUND);
+    if (!block || !frames) {
+        free(block);
+        free(frames);
+        return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    }
+    
+    LzFrameEncoder encoder;
+    lz_frame_encoder_init(&encoder);
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    int64_t original_size = 0;
+    int64_t stored_size = 0;
+    size_t pending = 0;
+    int at_end = 0;
+    
+    while (result == FILE_CRYPTO_SUCCESS && !at_end) {
+        size_t bytes_read = fread(block, 1, LZ_BLOCK_SIZE, fin);
+        if (bytes_read > 0) {
+            if (digest_ctx) sha512_update(digest_ctx, block, bytes_read);
+            pending += lz_frame_encode(&encoder, block, bytes_read, frames + pending);
+            original_size += (int64_t)bytes_read;
+        }
+        at_end = (bytes_read < LZ_BLOCK_SIZE);
+        
+        // 모은 프레임을 청크 단위로 암호화 (in-place) + 암호문 HMAC
+        // CTR 카운터가 청크 사이에서 이어지도록 마지막 청크 전에는 항상 FILE_CHUNK_SIZE (블록 배수)만 암호화
+        while (result == FILE_CRYPTO_SUCCESS && (pending >= FILE_CHUNK_SIZE || (at_end && pending > 0))) {
+            size_t length = (pending < FILE_CHUNK_SIZE) ? pending : FILE_CHUNK_SIZE;
+            if (AES_CTR_HMAC_crypt(aes_ctx, frames, length, frames, nonce_counter,
+                                   hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+                result = FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+            } else if (fwrite(frames, 1, length, fout) != length) {
+                result = FILE_CRYPTO_ERR_FILE_WRITE;
+            }
+            stored_size += (int64_t)length;
+            pending -= length;
+            memmove(frames, frames + length, pending);
+            update_progress_with_callback(original_size, file_size, progress_cb, user_data,
+                                         "Encrypting", 2);
+        }
+    }
+    if (result == FILE_CRYPTO_SUCCESS && ferror(fin)) result = FILE_CRYPTO_ERR_FILE_READ;
+    free(block);
+    free(frames);
+    
+    // 압축 정보는 암호문 크기가 정해진 지금 HMAC에 추가 (복호화 시 같은 순서로 검증)
+    memset(info, 0, sizeof(*info));
+    info->codec = ENC_CODEC_LZ;
+    enc_store_be64(info->original_size, (uint64_t)original_size);
+    enc_store_be64(info->stored_size, (uint64_t)stored_size);
+    hmac_sha512_update(hmac_ctx, (const uint8_t*)info, sizeof(*info));
+    return result;
+}
+
 /**
  * @brief HMAC을 파일의 지정된 위치에 씁니다.
  * @param fout 출력 파일 포인터
@@ -314,28 +703,330 @@ static FILE_CRYPTO_STATUS encrypt_file_content(FILE* fin, FILE* fout, long file_
  * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_FILE_WRITE 쓰기 실패
  * @note 파일 포인터를 원래 위치로 복원합니다.
  */
-static FILE_CRYPTO_STATUS write_hmac_to_file(FILE* fout, long hmac_position, 
+static FILE_CRYPTO_STATUS write_hmac_to_file(FILE* fout, int64_t hmac_position, 
                                               const uint8_t* hmac) {
     if (!fout || !hmac) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
-    long current_pos = ftell(fout);
+    int64_t current_pos = platform_ftell64(fout);
     if (current_pos < 0) {
         if (ferror(fout)) {
             return FILE_CRYPTO_ERR_FILE_WRITE;
         }
         return FILE_CRYPTO_ERR_FILE_WRITE;
     }
-    if (fseek(fout, hmac_position, SEEK_SET) != 0) {
+    if (platform_fseek64(fout, hmac_position, SEEK_SET) != 0) {
         return FILE_CRYPTO_ERR_FILE_WRITE;
     }
     size_t written = fwrite(hmac, 1, ENC_HMAC_SIZE, fout);
-    if (fseek(fout, current_pos, SEEK_SET) != 0) {  // 원래 위치로 복귀
+    if (platform_fseek64(fout, current_pos, SEEK_SET) != 0) {  // 원래 위치로 복귀
         return FILE_CRYPTO_ERR_FILE_WRITE;
     }
     
     return (written == ENC_HMAC_SIZE) ? FILE_CRYPTO_SUCCESS : FILE_CRYPTO_ERR_FILE_WRITE;
 }
 
+/**
+ * @brief 파일 내용을 v6 세그먼트로 병렬 암호화합니다.
+ * @param fin 입력 파일 포인터
+ * @param fout 출력 파일 포인터 (헤더까지 기록된 상태, 첫 세그먼트는 헤더 바로 다음)
+ * @param file_size 파일 크기 (바이트)
+ * @param aes_ctx AES 암호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트, 세그먼트 0의 값)
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트
+ * @param digest_ctx 평문 SHA-512 컨텍스트 (NULL 가능, 세그먼트를 읽은 스레드가 번호 순서대로 업데이트)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 세그먼트마다 카운터와 파일 위치가 정해져 있어 순서 없이 여러 코어에서 처리해도
+ *       encrypt_stream의 순차 결과와 같은 파일이 만들어집니다.
+ */
+static FILE_CRYPTO_STATUS encrypt_segmented_content(FILE* fin, FILE* fout, int64_t file_size,
+                                                    const AES_CTX* aes_ctx, const uint8_t* nonce_counter,
+                                                    const HMAC_SHA512_CTX* header_ctx, SHA512_CTX* digest_ctx,
+                                                    progress_callback_t progress_cb, void* user_data) {
+    // 헤더를 먼저 파일에 반영 (세그먼트는 stdio 버퍼를 거치지 않는 위치 지정 쓰기)
+    if (fflush(fout) != 0) return FILE_CRYPTO_ERR_FILE_WRITE;
+    
+    PipelineProgress progress = { 0, file_size, progress_cb, user_data, "Encrypting", 2 };
+    FileSegmentJob job;
+    memset(&job, 0, sizeof(job));
+    job.fin = fin;
+    job.fout = fout;
+    job.op = SEGMENT_OP_ENCRYPT;
+    job.data_size = file_size;
+    job.in_offset = 0;
+    job.out_offset = (int64_t)sizeof(EncFileHeader);
+    job.aes_ctx = aes_ctx;
+    job.nonce_counter = nonce_counter;
+    job.header_ctx = header_ctx;
+    job.digest_ctx = digest_ctx;
+    job.on_progress = (file_size > 0) ? pipeline_progress : NULL;  // 빈 파일은 진행률 없음
+    job.user_data = &progress;
+    return file_segments_run(&job);
+}
+
+// v8 증분 갱신 대상 (기존 출력 파일에서 읽은 상태)
+typedef struct {
+    EncFileHeader header;                // 헤더 (재사용 시 salt, KCV 유지)
+    uint8_t aes_key[32];
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    EncChunkMeta* metas;                 // 기존 청크 메타데이터 (재사용할 수 없으면 NULL)
+    uint64_t count;                      // 기존 청크 수
+    size_t final_length;                 // 기존 마지막 청크 길이
+    int intact;                          // 1이면 루트 태그가 맞아 지문이 같은 청크를 그대로 둘 수 있음
+} IncrementalTarget;
+
+/**
+ * @brief 기존 출력이 같은 비밀번호와 키 길이의 v8 파일이면 키와 청크 메타데이터를 읽습니다.
+ * @param fout 기존 출력 파일 ("r+b")
+ * @param input_path 입력 파일 경로 (헤더의 확장자 비교용)
+ * @param aes_key_bits AES 키 길이
+ * @param password 비밀번호
+ * @param target 출력 갱신 대상
+ * @return 1 재사용 가능 (키 설정, intact는 루트 태그 일치 여부), 0 새로 만들어야 함
+ * @note 루트 태그가 맞지 않으면 (중단된 갱신, 손상) 키만 재사용하고 모든 청크를 다시 암호화합니다.
+ */
+static int open_incremental_target(FILE* fout, const char* input_path, int aes_key_bits, const char* password,
+                                   IncrementalTarget* target) {
+    EncFileHeader* header = &target->header;
+    if (platform_pread(fout, header, sizeof(*header), 0) != (int64_t)sizeof(*header) ||
+        memcmp(header->signature, ENC_SIGNATURE, 4) != 0 || header->version != ENC_VERSION_INCREMENTAL) {
+        return 0;
+    }
+    
+    uint8_t key_check[ENC_KCV_SIZE];
+    EncFileHeader expected;
+    derive_keys(password, aes_key_bits, header->salt, ENC_SALT_SIZE, target->aes_key, target->hmac_key);
+    derive_key_check_value(target->hmac_key, key_check, sizeof(key_check));
+    if (create_encryption_header(input_path, aes_key_bits, header->salt, header->nonce, key_check,
+                                 ENC_VERSION_INCREMENTAL, &expected) != FILE_CRYPTO_SUCCESS ||
+        memcmp(header->reserved, key_check, ENC_KCV_SIZE) != 0 ||
+        header->key_length_code != expected.key_length_code) {
+        return 0;  // 다른 비밀번호나 키 길이: 새로 만듦
+    }
+    
+    // 확장자가 바뀌면 모든 청크 태그(헤더 포함)가 달라지므로 키만 재사용
+    target->intact = (memcmp(header, &expected, sizeof(expected)) == 0);
+    *header = expected;
+    
+    uint8_t stored_root[ENC_HMAC_SIZE];
+    int64_t file_size = (platform_fseek64(fout, 0, SEEK_END) == 0) ? platform_ftell64(fout) : -1;
+    int64_t records_offset = (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE);
+    if (!target->intact || file_size < records_offset ||
+        !file_chunk_layout(file_size - records_offset, &target->count, &target->final_length) ||
+        platform_pread(fout, stored_root, sizeof(stored_root), (int64_t)sizeof(EncFileHeader)) !=
+        (int64_t)sizeof(stored_root)) {
+        target->intact = 0;
+        return 1;
+    }
+    
+    target->metas = (EncChunkMeta*)malloc((size_t)target->count * sizeof(EncChunkMeta));
+    if (!target->metas || file_chunks_read_meta(fout, records_offset, target->count, target->metas) != FILE_CRYPTO_SUCCESS) {
+        target->intact = 0;
+        return 1;
+    }
+    
+    HMAC_SHA512_CTX header_ctx;
+    uint8_t root[ENC_HMAC_SIZE];
+    hmac_sha512_init(&header_ctx, target->hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)header, sizeof(*header));
+    file_chunks_root(&header_ctx, target->metas, target->count, target->final_length, root);
+    target->intact = (memcmp(root, stored_root, ENC_HMAC_SIZE) == 0);
+    return 1;
+}
+
+/**
+ * @brief 입력 청크를 기존 v8 출력과 비교해 바뀐 청크만 암호화해 기록합니다.
+ * @param fin 입력 파일 포인터 (처음 위치)
+ * @param fout 출력 파일 포인터 ("r+b" 또는 "w+b", 위치 지정 쓰기만 사용)
+ * @param file_size 입력 크기
+ * @param target 갱신 대상 (헤더, 키, 기존 메타데이터)
+ * @param reused 1이면 fout이 기존 파일 (첫 기록 전에 루트 태그를 지움)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param stats 출력 통계
+ * @param digest_ctx 평문 SHA-512 컨텍스트 (NULL이면 해시하지 않음)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ * @note 지문이 같은 청크는 출력에서 읽지도 쓰지도 않으므로 출력 I/O는 바뀐 양에 비례합니다.
+ *       입력은 지문 계산을 위해 한 번 전부 읽으며, 평문 해시도 같은 읽기에서 계산합니다.
+ */
+static FILE_CRYPTO_STATUS encrypt_incremental_content(FILE* fin, FILE* fout, int64_t file_size,
+                                                      const IncrementalTarget* target, int reused,
+                                                      progress_callback_t progress_cb, void* user_data,
+                                                      EncIncrementalStats* stats, SHA512_CTX* digest_ctx) {
+    uint64_t count;
+    size_t final_length;
+    file_chunk_count(file_size, &count, &final_length);
+    if (count > 0xFFFFFFFFull) return FILE_CRYPTO_ERR_FILE_SIZE;  // 청크 번호는 nonce에 4바이트
+    stats->chunk_count = count;
+    
+    AES_CTX aes_ctx;
+    if (AES_set_key(&aes_ctx, target->aes_key, (target->header.key_length_code == KEY_LENGTH_CODE_128) ? 128 :
+                    (target->header.key_length_code == KEY_LENGTH_CODE_192) ? 192 : 256) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    HMAC_SHA512_CTX header_ctx;
+    hmac_sha512_init(&header_ctx, target->hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)&target->header, sizeof(target->header));
+    uint8_t fingerprint_key[FILE_CHUNK_FINGERPRINT_KEY_SIZE];
+    file_chunk_fingerprint_key(target->hmac_key, fingerprint_key);
+    
+    // 이번 실행의 nonce (청크 nonce = 실행 nonce || 청크 번호)
+    uint8_t run_nonce[ENC_NONCE_SIZE];
+    generate_nonce(run_nonce, sizeof(run_nonce));
+    
+    EncChunkMeta* metas = (EncChunkMeta*)malloc((size_t)count * sizeof(EncChunkMeta));
+    uint8_t* buffer = (uint8_t*)malloc(ENC_CHUNK_SIZE);
+    if (!metas || !buffer) {
+        free(metas);
+        free(buffer);
+        return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    }
+    
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    int64_t records_offset = (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE);
+    uint8_t root[ENC_HMAC_SIZE] = {0};
+    int root_cleared = !reused;
+    for (uint64_t i = 0; i < count && result == FILE_CRYPTO_SUCCESS; i++) {
+        size_t length = (i + 1 == count) ? final_length : ENC_CHUNK_SIZE;
+        if (fread(buffer, 1, length, fin) != length) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+            break;
+        }
+        if (digest_ctx) sha512_update(digest_ctx, buffer, length);
+        file_chunk_fingerprint(fingerprint_key, i, buffer, length, metas[i].fingerprint);
+        
+        size_t old_length = (i + 1 == target->count) ? target->final_length : ENC_CHUNK_SIZE;
+        if (target->intact && i < target->count && old_length == length &&
+            memcmp(metas[i].fingerprint, target->metas[i].fingerprint, ENC_CHUNK_FINGERPRINT_SIZE) == 0) {
+            metas[i] = target->metas[i];  // 바뀌지 않은 청크: 기존 nonce, 태그, 암호문 유지
+        } else {
+            // 첫 기록 전에 루트 태그를 지워 중단되면 다음 실행이 모든 청크를 다시 암호화하게 함
+            if (!root_cleared) {
+                if (!platform_pwrite(fout, root, sizeof(root), (int64_t)sizeof(EncFileHeader))) {
+                    result = FILE_CRYPTO_ERR_FILE_WRITE;
+                    break;
+                }
+                root_cleared = 1;
+            }
+            int64_t position = records_offset + file_chunk_position(i);
+            file_chunk_make_nonce(run_nonce, i, metas[i].nonce);
+            result = file_chunk_seal(&aes_ctx, &header_ctx, i, &metas[i], buffer, length);
+            if (result == FILE_CRYPTO_SUCCESS &&
+                (!platform_pwrite(fout, &metas[i], sizeof(EncChunkMeta), position) ||
+                 !platform_pwrite(fout, buffer, length, position + ENC_CHUNK_META_SIZE))) {
+                result = FILE_CRYPTO_ERR_FILE_WRITE;
+            }
+            stats->chunks_written++;
+        }
+        update_progress_with_callback((int64_t)i * ENC_CHUNK_SIZE + (int64_t)length, file_size,
+                                      progress_cb, user_data, "Encrypting", 2);
+    }
+    
+    // 줄어든 입력은 남는 레코드를 잘라내고, 헤더와 새 루트 태그를 마지막에 기록
+    if (result == FILE_CRYPTO_SUCCESS) {
+        file_chunks_root(&header_ctx, metas, count, final_length, root);
+        int64_t end = records_offset + file_chunk_position(count - 1) + ENC_CHUNK_META_SIZE + (int64_t)final_length;
+        if (!platform_truncate_stream(fout, end) ||
+            !platform_pwrite(fout, &target->header, sizeof(target->header), 0) ||
+            !platform_pwrite(fout, root, sizeof(root), (int64_t)sizeof(EncFileHeader))) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+    }
+    
+    free(metas);
+    free(buffer);
+    memset(fingerprint_key, 0, sizeof(fingerprint_key));
+    return result;
+}
+
+/**
+ * @brief 증분 암호화 내부 구현 함수 (v8, 진행률 콜백 지원).
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 파일 경로 (같은 비밀번호의 v8 파일이면 제자리 갱신)
+ * @param aes_key_bits AES 키 길이 (128, 192, 256)
+ * @param password 비밀번호
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param stats 출력 통계 (NULL 가능)
+ * @param plaintext_digest 출력 평문 SHA-512 (ENC_PLAINTEXT_DIGEST_SIZE, NULL이면 계산하지 않음)
+ * @return 1 성공, 0 실패
+ */
+static int encrypt_incremental_internal(const char* input_path, const char* output_path,
+                                        int aes_key_bits, const char* password,
+                                        progress_callback_t progress_cb, void* user_data,
+                                        EncIncrementalStats* stats, uint8_t* plaintext_digest) {
+    EncIncrementalStats local_stats;
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+    
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) {
+        log_error(!progress_cb, "Cannot open file: %s\n", input_path);
+        return 0;
+    }
+    setvbuf(fin, NULL, _IOFBF, FILE_BUFFER_SIZE);
+    int64_t file_size = (platform_fseek64(fin, 0, SEEK_END) == 0) ? platform_ftell64(fin) : -1;
+    if (file_size < 0 || platform_fseek64(fin, 0, SEEK_SET) != 0) {
+        fclose(fin);
+        log_error(!progress_cb, "Cannot determine file size.\n");
+        return 0;  // FILE_CRYPTO_ERR_FILE_SIZE
+    }
+    
+    log_info(!progress_cb, "Encrypting...\n");
+    
+    // 기존 출력 재사용 시도, 안 되면 새 salt로 새 파일
+    IncrementalTarget target;
+    memset(&target, 0, sizeof(target));
+    FILE* fout = platform_fopen(output_path, "r+b");
+    int reused = fout && open_incremental_target(fout, input_path, aes_key_bits, password, &target);
+    if (!reused) {
+        if (fout) fclose(fout);
+        fout = platform_fopen(output_path, "w+b");
+        
+        uint8_t salt[ENC_SALT_SIZE];
+        uint8_t nonce[ENC_NONCE_SIZE] = {0};  // 청크마다 nonce가 따로 있으므로 헤더 nonce는 0
+        uint8_t key_check[ENC_KCV_SIZE];
+        generate_salt(salt, sizeof(salt));
+        derive_keys(password, aes_key_bits, salt, sizeof(salt), target.aes_key, target.hmac_key);
+        derive_key_check_value(target.hmac_key, key_check, sizeof(key_check));
+        create_encryption_header(input_path, aes_key_bits, salt, nonce, key_check,
+                                 ENC_VERSION_INCREMENTAL, &target.header);
+    }
+    if (!fout) {
+        fclose(fin);
+        free(target.metas);
+        memset(&target, 0, sizeof(target));
+        log_error(!progress_cb, "Cannot open output file: %s\n", output_path);
+        return 0;  // FILE_CRYPTO_ERR_FILE_OPEN
+    }
+    
+    SHA512_CTX digest_ctx;
+    if (plaintext_digest) sha512_init(&digest_ctx);
+    FILE_CRYPTO_STATUS result = encrypt_incremental_content(fin, fout, file_size, &target, reused,
+                                                            progress_cb, user_data, stats,
+                                                            plaintext_digest ? &digest_ctx : NULL);
+    stats->full_rewrite = !target.intact;
+    fclose(fin);
+    if (fclose(fout) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    free(target.metas);
+    memset(&target, 0, sizeof(target));  // 키 제거
+    
+    if (result != FILE_CRYPTO_SUCCESS) {
+        log_error(!progress_cb, "Incremental encryption failed.\n");
+        return 0;  // result에 상세 에러 정보 포함
+    }
+    if (plaintext_digest) sha512_final(&digest_ctx, plaintext_digest);
+    if (progress_cb) {
+        progress_cb(file_size, file_size, user_data);
+    } else {
+        print_progress(file_size, file_size, "Encrypting");
+        log_info(1, "Encryption completed! (%llu of %llu chunks written)\n",
+                 (unsigned long long)stats->chunks_written, (unsigned long long)stats->chunk_count);
+    }
+    return 1;
+}
+
 /**
  * @brief 파일 암호화 내부 구현 함수 (진행률 콜백 지원).
  * @param input_path 입력 파일 경로
@@ -344,11 +1035,21 @@ static FILE_CRYPTO_STATUS write_hmac_to_file(FILE* fout, long hmac_position,
  * @param password 비밀번호
  * @param progress_cb 진행률 콜백 함수 (NULL 가능)
  * @param user_data 콜백에 전달할 사용자 데이터
+ * @param plaintext_digest 출력 평문 SHA-512 (ENC_PLAINTEXT_DIGEST_SIZE, NULL이면 계산하지 않음)
  * @return 1 성공, 0 실패
+ * @note v4/v5/v7/v8/v9는 암호화하면서 같은 패스에서 평문을 해시합니다. v6 세그먼트는 여러 스레드가
+ *       순서 없이 암호화하므로 성공한 뒤 입력을 한 번 더 읽어 해시합니다.
  */
 static int encrypt_file_internal(const char* input_path, const char* output_path,
                                  int aes_key_bits, const char* password,
-                                 progress_callback_t progress_cb, void* user_data) {
+                                 progress_callback_t progress_cb, void* user_data,
+                                 uint8_t* plaintext_digest) {
+    // v8: 기존 출력과 비교해 바뀐 청크만 암호화
+    if (g_encryption_format == ENC_FORMAT_INCREMENTAL) {
+        return encrypt_incremental_internal(input_path, output_path, aes_key_bits, password,
+                                            progress_cb, user_data, NULL, plaintext_digest);
+    }
+    
     FILE* fin = platform_fopen(input_path, "rb");
     if (!fin) {
         log_error(!progress_cb, "Cannot open file: %s\n", input_path);
@@ -359,12 +1060,12 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     setvbuf(fin, NULL, _IOFBF, FILE_BUFFER_SIZE);
     
     // 파일 크기 확인
-    if (fseek(fin, 0, SEEK_END) != 0) {
+    if (platform_fseek64(fin, 0, SEEK_END) != 0) {
         fclose(fin);
         log_error(!progress_cb, "Cannot seek to end of file.\n");
         return 0;  // FILE_CRYPTO_ERR_FILE_READ
     }
-    long file_size = ftell(fin);
+    int64_t file_size = platform_ftell64(fin);
     if (file_size < 0) {
         fclose(fin);
         if (ferror(fin)) {
@@ -374,7 +1075,7 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
         }
         return 0;  // FILE_CRYPTO_ERR_FILE_SIZE
     }
-    if (fseek(fin, 0, SEEK_SET) != 0) {
+    if (platform_fseek64(fin, 0, SEEK_SET) != 0) {
         fclose(fin);
         log_error(!progress_cb, "Cannot seek to beginning of file.\n");
         return 0;  // FILE_CRYPTO_ERR_FILE_READ
@@ -382,14 +1083,35 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     
     log_info(!progress_cb, "Encrypting...\n");
     
+    // 기록할 형식 버전 (세그먼트 형식은 v6, O_DIRECT 모드는 암호문을 4 KiB 경계에 두는 v5 형식으로 기록)
+    uint8_t version = (g_encryption_format == ENC_FORMAT_SEGMENTED) ? ENC_VERSION_STREAM :
+                      (g_encryption_format == ENC_FORMAT_COMPRESSED) ? ENC_VERSION_COMPRESSED :
+                      (g_encryption_format == ENC_FORMAT_KEYSLOTS) ? ENC_VERSION_KEYSLOTS :
+                      (g_file_io_mode == FILE_IO_MODE_DIRECT) ? ENC_VERSION_ALIGNED : ENC_VERSION;
+    
     // Salt 생성 (PBKDF2용)
     uint8_t salt[ENC_SALT_SIZE];
     generate_salt(salt, sizeof(salt));
     
-    // 키 도출
+    // 키 도출 (v9는 무작위 데이터 키, 비밀번호는 키 슬롯에서 데이터 키를 감싸는 데만 사용)
     uint8_t aes_key[32];
     uint8_t hmac_key[HMAC_KEY_SIZE];
-    derive_keys(password, aes_key_bits, salt, sizeof(salt), aes_key, hmac_key);
+    uint8_t data_key[ENC_DATA_KEY_SIZE];
+    if (version == ENC_VERSION_KEYSLOTS) {
+        if (crypto_random_bytes(data_key, sizeof(data_key)) != CRYPTO_SUCCESS) {
+            fclose(fin);
+            log_error(!progress_cb, "Failed to generate data key.\n");
+            return 0;  // FILE_CRYPTO_ERR_ENCRYPTION_FAILED
+        }
+        memcpy(aes_key, data_key, sizeof(aes_key));
+        memcpy(hmac_key, data_key + sizeof(aes_key), HMAC_KEY_SIZE);
+    } else {
+        derive_keys(password, aes_key_bits, salt, sizeof(salt), aes_key, hmac_key);
+    }
+    
+    // 키 확인 값 (복호화 시 잘못된 비밀번호를 즉시 거부하기 위해 헤더에 저장)
+    uint8_t key_check[ENC_KCV_SIZE];
+    derive_key_check_value(hmac_key, key_check, sizeof(key_check));
     
     // AES 컨텍스트 설정
     AES_CTX aes_ctx;
@@ -407,21 +1129,41 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
     memcpy(nonce_counter, nonce, 8);
     memset(nonce_counter + 8, 0, 8);
     
-    // 헤더 생성
+    // 헤더 생성 (v9 헤더의 salt는 0, salt는 키 슬롯마다 따로 둠)
+    static const uint8_t zero_salt[ENC_SALT_SIZE] = { 0 };
     EncFileHeader header;
-    FILE_CRYPTO_STATUS header_result = create_encryption_header(input_path, aes_key_bits, salt, nonce, &header);
+    FILE_CRYPTO_STATUS header_result = create_encryption_header(input_path, aes_key_bits,
+                                                                (version == ENC_VERSION_KEYSLOTS) ? zero_salt : salt,
+                                                                nonce, key_check, version, &header);
     if (header_result != FILE_CRYPTO_SUCCESS) {
         fclose(fin);
         return 0;  // header_result에 상세 에러 정보 포함
     }
     
-    // HMAC 초기화 (헤더 + 원본 파일로 생성)
+    // v9: 슬롯 0에 비밀번호로 감싼 데이터 키 (슬롯 태그가 헤더를 덮으므로 헤더 다음에 생성)
+    EncKeySlot key_slots[ENC_KEY_SLOT_COUNT];
+    memset(key_slots, 0, sizeof(key_slots));
+    if (version == ENC_VERSION_KEYSLOTS) {
+        FILE_CRYPTO_STATUS slot_result = key_slot_seal(&header, 0, password, data_key, &key_slots[0]);
+        memset(data_key, 0, sizeof(data_key));
+        if (slot_result != FILE_CRYPTO_SUCCESS) {
+            fclose(fin);
+            return 0;  // slot_result에 상세 에러 정보 포함
+        }
+    }
+    
+    // HMAC 초기화 (헤더 + 암호문으로 생성)
     HMAC_SHA512_CTX hmac_ctx;
     hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
     hmac_sha512_update(&hmac_ctx, (uint8_t*)&header, sizeof(header));  // 헤더를 HMAC에 포함
     
-    // 출력 파일 작성
-    FILE* fout = platform_fopen(output_path, "wb");
+    // 평문 해시 (요청한 경우, 암호화 루프가 읽은 평문으로 계산)
+    SHA512_CTX digest_ctx;
+    SHA512_CTX* digest = plaintext_digest ? &digest_ctx : NULL;
+    if (digest) sha512_init(digest);
+    
+    // 출력 파일 작성 (메모리 매핑 쓰기를 위해 읽기/쓰기로 열기)
+    FILE* fout = platform_fopen(output_path, "w+b");
     if (!fout) {
         fclose(fin);
         return 0;  // FILE_CRYPTO_ERR_FILE_OPEN (출력 파일)
@@ -438,8 +1180,29 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
         return 0;  // FILE_CRYPTO_ERR_FILE_WRITE
     }
     
+    // v6: 세그먼트를 여러 스레드에서 암호화 (전체 HMAC 자리 없음, 태그는 세그먼트마다)
+    if (version == ENC_VERSION_STREAM) {
+        FILE_CRYPTO_STATUS segment_result = encrypt_segmented_content(fin, fout, file_size, &aes_ctx,
+                                                                      nonce_counter, &hmac_ctx, digest,
+                                                                      progress_cb, user_data);
+        fclose(fin);
+        if (fclose(fout) != 0 && segment_result == FILE_CRYPTO_SUCCESS) {
+            segment_result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        if (digest && segment_result == FILE_CRYPTO_SUCCESS) sha512_final(digest, plaintext_digest);
+        if (segment_result != FILE_CRYPTO_SUCCESS) {
+            log_error(!progress_cb, "Segment encryption failed.\n");
+            return 0;  // segment_result에 상세 에러 정보 포함
+        }
+        if (!progress_cb) {
+            print_progress(file_size, file_size, "Encrypting");
+            log_info(1, "Encryption completed!\n");
+        }
+        return 1;
+    }
+    
     // HMAC을 위한 임시 공간 (나중에 쓸 예정)
-    long hmac_position = ftell(fout);
+    int64_t hmac_position = platform_ftell64(fout);
     if (hmac_position < 0) {
         fclose(fin);
         fclose(fout);
@@ -454,13 +1217,49 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
         return 0;  // FILE_CRYPTO_ERR_FILE_WRITE
     }
     
-    // 파일 내용 암호화 및 쓰기
-    FILE_CRYPTO_STATUS encrypt_result = encrypt_file_content(fin, fout, file_size, &aes_ctx, nonce_counter, 
-                                                             &hmac_ctx, progress_cb, user_data);
+    // v5: 암호문 시작 위치까지 0으로 채움 (v7은 압축 정보 자리, v9는 키 슬롯 표)
+    int64_t padding = enc_payload_offset(&header) - (hmac_position + ENC_HMAC_SIZE);
+    if (version == ENC_VERSION_KEYSLOTS) {
+        if (fwrite(key_slots, 1, sizeof(key_slots), fout) != sizeof(key_slots)) {
+            fclose(fin);
+            fclose(fout);
+            log_error(!progress_cb, "Failed to write key slots.\n");
+            return 0;  // FILE_CRYPTO_ERR_FILE_WRITE
+        }
+        padding -= (int64_t)sizeof(key_slots);
+    }
+    for (int64_t i = 0; i < padding; i++) {
+        if (fputc(0, fout) == EOF) {
+            fclose(fin);
+            fclose(fout);
+            log_error(!progress_cb, "Failed to write payload padding.\n");
+            return 0;  // FILE_CRYPTO_ERR_FILE_WRITE
+        }
+    }
+    
+    // 파일 내용 암호화 및 쓰기 (v7은 압축 후 암호화하고 압축 정보를 제자리에 기록)
+    FILE_CRYPTO_STATUS encrypt_result;
+    if (version == ENC_VERSION_COMPRESSED) {
+        EncCompressionInfo compression_info;
+        encrypt_result = encrypt_compressed_content(fin, fout, file_size, &aes_ctx, nonce_counter,
+                                                    &hmac_ctx, &compression_info, digest, progress_cb, user_data);
+        int64_t end_position = platform_ftell64(fout);
+        if (encrypt_result == FILE_CRYPTO_SUCCESS &&
+            (end_position < 0 ||
+             platform_fseek64(fout, hmac_position + ENC_HMAC_SIZE, SEEK_SET) != 0 ||
+             fwrite(&compression_info, 1, sizeof(compression_info), fout) != sizeof(compression_info) ||
+             platform_fseek64(fout, end_position, SEEK_SET) != 0)) {
+            encrypt_result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+    } else {
+        encrypt_result = encrypt_file_content(fin, fout, file_size, &aes_ctx, nonce_counter,
+                                              &hmac_ctx, digest, progress_cb, user_data);
+    }
     
     // HMAC 최종 계산
     uint8_t hmac[ENC_HMAC_SIZE];
     hmac_sha512_final(&hmac_ctx, hmac);
+    if (digest && encrypt_result == FILE_CRYPTO_SUCCESS) sha512_final(digest, plaintext_digest);
     
     // HMAC을 올바른 위치에 쓰기
     if (encrypt_result == FILE_CRYPTO_SUCCESS) {
@@ -500,7 +1299,7 @@ static int encrypt_file_internal(const char* input_path, const char* output_path
  */
 int encrypt_file(const char* input_path, const char* output_path,
                  int aes_key_bits, const char* password) {
-    return encrypt_file_internal(input_path, output_path, aes_key_bits, password, NULL, NULL);
+    return encrypt_file_internal(input_path, output_path, aes_key_bits, password, NULL, NULL, NULL);
 }
 
 /**
@@ -516,7 +1315,45 @@ int encrypt_file(const char* input_path, const char* output_path,
 int encrypt_file_with_progress(const char* input_path, const char* output_path,
                                int aes_key_bits, const char* password,
                                progress_callback_t progress_cb, void* user_data) {
-    return encrypt_file_internal(input_path, output_path, aes_key_bits, password, progress_cb, user_data);
+    return encrypt_file_internal(input_path, output_path, aes_key_bits, password, progress_cb, user_data, NULL);
+}
+
+/**
+ * @brief 파일을 암호화하면서 평문의 SHA-512를 계산합니다.
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 파일 경로
+ * @param aes_key_bits AES 키 길이 (128, 192, 256)
+ * @param password 비밀번호
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param plaintext_digest 출력 평문 SHA-512 (ENC_PLAINTEXT_DIGEST_SIZE, 성공 시에만 유효)
+ * @return 1 성공, 0 실패
+ * @note 만드는 파일은 encrypt_file_with_progress와 같고, 해시는 sha512sum의 결과와 같습니다.
+ *       암호화 후 sha512sum을 따로 실행하면 입력을 두 번 읽지만 여기서는 한 번만 읽습니다.
+ */
+int encrypt_file_with_digest(const char* input_path, const char* output_path,
+                             int aes_key_bits, const char* password,
+                             progress_callback_t progress_cb, void* user_data,
+                             uint8_t* plaintext_digest) {
+    if (!plaintext_digest) return 0;
+    return encrypt_file_internal(input_path, output_path, aes_key_bits, password, progress_cb, user_data,
+                                 plaintext_digest);
+}
+
+/**
+ * @brief 파일을 증분 암호화합니다 (v8, 바뀐 청크만 다시 암호화).
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 파일 경로 (같은 비밀번호와 키 길이의 v8 파일이면 제자리 갱신)
+ * @param aes_key_bits AES 키 길이 (128, 192, 256)
+ * @param password 비밀번호
+ * @param stats 출력 통계 (NULL 가능)
+ * @return 1 성공, 0 실패
+ */
+int encrypt_file_incremental(const char* input_path, const char* output_path,
+                             int aes_key_bits, const char* password, EncIncrementalStats* stats) {
+    if (!input_path || !output_path || !password) return 0;
+    if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) return 0;
+    return encrypt_incremental_internal(input_path, output_path, aes_key_bits, password, NULL, NULL, stats, NULL);
 }
 
 /**
@@ -524,12 +1361,12 @@ int encrypt_file_with_progress(const char* input_path, const char* output_path,
  * @param fin 입력 파일 포인터
  * @param header 출력 헤더 구조체
  * @param file_size 출력 파일 크기 (바이트)
- * @param ciphertext_size 출력 암호문 크기 (바이트, 헤더와 HMAC 제외)
+ * @param ciphertext_size 출력 암호문 크기 (바이트, 헤더와 HMAC 제외, v6은 세그먼트 태그 포함)
  * @param show_error 에러 메시지 출력 여부
  * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
  */
-static FILE_CRYPTO_STATUS read_and_validate_header(FILE* fin, EncFileHeader* header, long* file_size, 
-                                                    long* ciphertext_size, int show_error) {
+FILE_CRYPTO_STATUS read_and_validate_header(FILE* fin, EncFileHeader* header, int64_t* file_size, 
+                                             int64_t* ciphertext_size, int show_error) {
     if (!fin || !header || !file_size || !ciphertext_size) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
     // 헤더 읽기
@@ -538,18 +1375,12 @@ static FILE_CRYPTO_STATUS read_and_validate_header(FILE* fin, EncFileHeader* hea
         return FILE_CRYPTO_ERR_INVALID_HEADER;
     }
     
-    // 시그니처 검증
-    if (memcmp(header->signature, ENC_SIGNATURE, 4) != 0) {
-        log_error(show_error, "Invalid file format.\n");
-        return FILE_CRYPTO_ERR_INVALID_SIGNATURE;
-    }
-    
     // 파일 크기 확인
-    if (fseek(fin, 0, SEEK_END) != 0) {
+    if (platform_fseek64(fin, 0, SEEK_END) != 0) {
         log_error(show_error, "Cannot seek to end of file.\n");
         return FILE_CRYPTO_ERR_FILE_READ;
     }
-    *file_size = ftell(fin);
+    *file_size = platform_ftell64(fin);
     if (*file_size < 0) {
         if (ferror(fin)) {
             log_error(show_error, "Error occurred while determining file size.\n");
@@ -559,9 +1390,16 @@ static FILE_CRYPTO_STATUS read_and_validate_header(FILE* fin, EncFileHeader* hea
         return FILE_CRYPTO_ERR_FILE_SIZE;
     }
     
+    // 시그니처 검증 (파일 앞에 없으면 v10 트레일러)
+    if (memcmp(header->signature, ENC_SIGNATURE, 4) != 0 && !in_place_read_trailer(fin, *file_size, header)) {
+        log_error(show_error, "Invalid file format.\n");
+        return FILE_CRYPTO_ERR_INVALID_SIGNATURE;
+    }
+    
     // 헤더 다음에 HMAC이 있음
-    long hmac_position = sizeof(EncFileHeader);
-    *ciphertext_size = *file_size - sizeof(EncFileHeader) - ENC_HMAC_SIZE; // 헤더와 HMAC 제외
+    int64_t hmac_position = sizeof(EncFileHeader);
+    *ciphertext_size = *file_size - enc_payload_offset(header); // 헤더와 HMAC (v5는 정렬 패딩까지) 제외
+    if (header->version == ENC_VERSION_INPLACE) *ciphertext_size -= ENC_INPLACE_TRAILER_SIZE;
     
     if (*ciphertext_size <= 0) {
         log_error(show_error, "Invalid file size.\n");
@@ -582,21 +1420,32 @@ static FILE_CRYPTO_STATUS read_and_validate_header(FILE* fin, EncFileHeader* hea
  * @param show_error 에러 메시지 출력 여부
  * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
  */
-static FILE_CRYPTO_STATUS read_encryption_metadata(FILE* fin, const EncFileHeader* header,
-                                                    uint8_t* stored_hmac, int* aes_key_bits,
-                                                    const uint8_t** pbkdf2_salt, size_t* pbkdf2_salt_len,
-                                                    int show_error) {
+FILE_CRYPTO_STATUS read_encryption_metadata(FILE* fin, const EncFileHeader* header,
+                                             uint8_t* stored_hmac, int* aes_key_bits,
+                                             const uint8_t** pbkdf2_salt, size_t* pbkdf2_salt_len,
+                                             int show_error) {
     if (!fin || !header || !stored_hmac || !aes_key_bits) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
-    // HMAC 읽기 (헤더 다음 위치)
-    long hmac_position = sizeof(EncFileHeader);
-    if (fseek(fin, hmac_position, SEEK_SET) != 0) {
-        log_error(show_error, "Cannot seek to HMAC position.\n");
-        return FILE_CRYPTO_ERR_FILE_READ;
+    // 버전 확인 (이 프로그램보다 새로운 형식은 해석할 수 없음)
+    if (header->version > ENC_VERSION_MAX) {
+        log_error(show_error, "Unsupported file version: 0x%02X\n", header->version);
+        return FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
     }
-    if (fread(stored_hmac, 1, ENC_HMAC_SIZE, fin) != ENC_HMAC_SIZE) {
-        log_error(show_error, "Cannot read HMAC.\n");
-        return FILE_CRYPTO_ERR_FILE_READ;
+    
+    // HMAC 읽기 (헤더 다음 위치, v10은 파일 끝, v6은 세그먼트마다 태그가 있으므로 전체 HMAC 없음)
+    if (header->version == ENC_VERSION_STREAM) {
+        memset(stored_hmac, 0, ENC_HMAC_SIZE);
+    } else {
+        int in_place = (header->version == ENC_VERSION_INPLACE);
+        int64_t hmac_position = in_place ? -(int64_t)ENC_HMAC_SIZE : (int64_t)sizeof(EncFileHeader);
+        if (platform_fseek64(fin, hmac_position, in_place ? SEEK_END : SEEK_SET) != 0) {
+            log_error(show_error, "Cannot seek to HMAC position.\n");
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        if (fread(stored_hmac, 1, ENC_HMAC_SIZE, fin) != ENC_HMAC_SIZE) {
+            log_error(show_error, "Cannot read HMAC.\n");
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
     }
     
     // AES 키 길이 결정
@@ -622,35 +1471,243 @@ static FILE_CRYPTO_STATUS read_encryption_metadata(FILE* fin, const EncFileHeade
 }
 
 /**
- * @brief 파일 내용을 복호화하고 임시 파일에 저장합니다.
+ * @brief 헤더의 키 확인 값(KCV)으로 비밀번호를 검증합니다 (v3 이상).
+ * @param header 암호화 파일 헤더
+ * @param hmac_key 도출한 HMAC 키 (24바이트)
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 일치 또는 KCV가 없는 v2 파일, FILE_CRYPTO_ERR_KEY_CHECK_FAILED 불일치
+ * @note 키 도출 직후 호출하여 전체 복호화/HMAC 검증 전에 잘못된 비밀번호를 거부합니다.
+ */
+FILE_CRYPTO_STATUS verify_key_check_value(const EncFileHeader* header, const uint8_t* hmac_key,
+                                          int show_error) {
+    if (!header || !hmac_key) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    // v2 파일은 KCV가 없으므로 HMAC 검증에 맡김
+    if (header->version < ENC_VERSION_KCV) return FILE_CRYPTO_SUCCESS;
+    
+    uint8_t expected[ENC_KCV_SIZE];
+    derive_key_check_value(hmac_key, expected, sizeof(expected));
+    
+    if (memcmp(header->reserved, expected, ENC_KCV_SIZE) != 0) {
+        log_error(show_error, "Incorrect password.\n");
+        return FILE_CRYPTO_ERR_KEY_CHECK_FAILED;
+    }
+    
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 복호화에 쓸 AES 키와 HMAC 키를 구합니다.
+ * @param fin 입력 파일 포인터 (v9 키 슬롯 표를 읽음)
+ * @param header 암호화 파일 헤더
+ * @param password 비밀번호
+ * @param aes_key_bits AES 키 길이
+ * @param pbkdf2_salt PBKDF2 salt (read_encryption_metadata 결과)
+ * @param pbkdf2_salt_len PBKDF2 salt 길이
+ * @param aes_key 출력 AES 키 (32바이트)
+ * @param hmac_key 출력 HMAC 키 (24바이트)
+ * @note v9는 비밀번호로 열리는 키 슬롯에서 데이터 키를 꺼내고, 그 외는 비밀번호에서 바로 도출합니다.
+ *       v9에서 열리는 슬롯이 없으면 키를 0으로 채우므로 이어지는 KCV 검증에서 잘못된 비밀번호로 거부됩니다.
+ */
+void derive_file_keys(FILE* fin, const EncFileHeader* header, const char* password, int aes_key_bits,
+                      const uint8_t* pbkdf2_salt, size_t pbkdf2_salt_len,
+                      uint8_t* aes_key, uint8_t* hmac_key) {
+    if (header->version != ENC_VERSION_KEYSLOTS) {
+        derive_keys(password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, hmac_key);
+        return;
+    }
+    
+    EncKeySlot slots[ENC_KEY_SLOT_COUNT];
+    uint8_t data_key[ENC_DATA_KEY_SIZE];
+    memset(data_key, 0, sizeof(data_key));
+    if (key_slots_read(fin, slots) == FILE_CRYPTO_SUCCESS) {
+        key_slots_unlock(header, slots, password, data_key);
+    }
+    memcpy(aes_key, data_key, 32);
+    memcpy(hmac_key, data_key + 32, HMAC_KEY_SIZE);
+    memset(data_key, 0, sizeof(data_key));
+}
+
+/**
+ * @brief 메모리 매핑으로 암호문을 복호화합니다 (stdio 버퍼를 거치지 않음).
+ * @param fin 입력 파일 포인터 (읽기 전용 매핑)
+ * @param fout 출력 파일 포인터 ("w+b", 오프셋 0부터 평문 기록)
+ * @param payload_offset 암호문 시작 오프셋
+ * @param ciphertext_size 암호문 크기 (바이트)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param hmac_ctx 복호화된 평문으로 업데이트할 HMAC 컨텍스트 (v2/v3, 필요 없으면 NULL)
+ * @param progress_base 진행률 보고 시 처리량에 더할 값
+ * @param progress_total 진행률 보고 시 전체 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param result 처리 결과 (반환값이 1일 때만 유효)
+ * @return 1 매핑으로 처리함, 0 매핑할 수 없음 (호출자가 stdio 경로로 처리)
+ */
+static int decrypt_mapped_content(FILE* fin, FILE* fout, int64_t payload_offset, int64_t ciphertext_size,
+                                  const AES_CTX* aes_ctx, uint8_t* nonce_counter,
+                                  HMAC_SHA512_CTX* hmac_ctx, int64_t progress_base, int64_t progress_total,
+                                  progress_callback_t progress_cb, void* user_data,
+                                  FILE_CRYPTO_STATUS* result) {
+    const int64_t in_offset = payload_offset;
+    if (ciphertext_size <= 0) return 0;
+    
+    platform_file_map_t in_map;
+    platform_file_map_t out_map;
+    if (!platform_map_stream(fin, (uint64_t)(in_offset + ciphertext_size), 0, &in_map)) return 0;
+    if (!platform_map_stream(fout, (uint64_t)ciphertext_size, 1, &out_map)) {
+        platform_unmap_stream(&in_map);
+        return 0;
+    }
+    
+    *result = FILE_CRYPTO_SUCCESS;
+    int64_t processed = 0;
+    while (processed < ciphertext_size) {
+        size_t chunk = (ciphertext_size - processed < FILE_CHUNK_SIZE) ?
+                       (size_t)(ciphertext_size - processed) : FILE_CHUNK_SIZE;
+        const uint8_t* in = in_map.data + in_offset + processed;
+        uint8_t* out = out_map.data + processed;
+        
+        CRYPTO_STATUS crypt_status = hmac_ctx ?
+            AES_CTR_HMAC_crypt(aes_ctx, in, chunk, out, nonce_counter, hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) :
+            AES_CTR_crypt(aes_ctx, in, chunk, out, nonce_counter);
+        if (crypt_status != CRYPTO_SUCCESS) {
+            *result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+            break;
+        }
+        
+        processed += (int64_t)chunk;
+        update_progress_with_callback(progress_base + processed, progress_total, progress_cb, user_data,
+                                     "Decrypting", 0);
+    }
+    
+    platform_unmap_stream(&out_map);
+    platform_unmap_stream(&in_map);
+    return 1;
+}
+
+/**
+ * @brief 메모리 매핑으로 암호문 HMAC을 계산합니다.
+ * @param fin 입력 파일 포인터 (읽기 전용 매핑)
+ * @param payload_offset 암호문 시작 오프셋
+ * @param ciphertext_size 암호문 크기 (바이트)
+ * @param hmac_ctx 헤더까지 업데이트된 HMAC 컨텍스트
+ * @param progress_total 진행률 보고 시 전체 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return 1 매핑으로 처리함, 0 매핑할 수 없음 (호출자가 stdio 경로로 처리)
+ */
+static int hmac_mapped_ciphertext(FILE* fin, int64_t payload_offset, int64_t ciphertext_size, HMAC_SHA512_CTX* hmac_ctx,
+                                  int64_t progress_total, progress_callback_t progress_cb, void* user_data) {
+    const int64_t in_offset = payload_offset;
+    if (ciphertext_size <= 0) return 0;
+    
+    platform_file_map_t in_map;
+    if (!platform_map_stream(fin, (uint64_t)(in_offset + ciphertext_size), 0, &in_map)) return 0;
+    
+    int64_t processed = 0;
+    while (processed < ciphertext_size) {
+        size_t chunk = (ciphertext_size - processed < FILE_CHUNK_SIZE) ?
+                       (size_t)(ciphertext_size - processed) : FILE_CHUNK_SIZE;
+        hmac_sha512_update(hmac_ctx, in_map.data + in_offset + processed, chunk);
+        processed += (int64_t)chunk;
+        update_progress_with_callback(processed, progress_total, progress_cb, user_data,
+                                     "Verifying", 0);
+    }
+    
+    platform_unmap_stream(&in_map);
+    return 1;
+}
+
+/**
+ * @brief 파일 내용을 복호화하고 출력(또는 임시) 파일에 저장합니다.
  * @param fin 입력 파일 포인터 (암호문)
- * @param ftemp 임시 파일 포인터 (복호화된 평문)
+ * @param ftemp 출력 파일 포인터 (복호화된 평문)
+ * @param payload_offset 암호문 시작 오프셋
  * @param ciphertext_size 암호문 크기 (바이트)
  * @param aes_ctx AES 복호화 컨텍스트
  * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param hmac_ctx 복호화된 평문으로 업데이트할 HMAC 컨텍스트 (v2/v3, 필요 없으면 NULL)
  * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기)
+ * @param progress_base 진행률 보고 시 처리량에 더할 값 (앞선 검증 단계의 처리량)
+ * @param progress_total 진행률 보고 시 전체 크기
  * @param progress_cb 진행률 콜백 함수 (NULL 가능)
  * @param user_data 콜백에 전달할 사용자 데이터
  * @param show_error 에러 메시지 출력 여부
  * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
  */
-static FILE_CRYPTO_STATUS decrypt_file_content(FILE* fin, FILE* ftemp, long ciphertext_size,
+static FILE_CRYPTO_STATUS decrypt_file_content(FILE* fin, FILE* ftemp, int64_t payload_offset, int64_t ciphertext_size,
                                                 const AES_CTX* aes_ctx, uint8_t* nonce_counter,
-                                                uint8_t* buffer,
+                                                HMAC_SHA512_CTX* hmac_ctx, uint8_t* buffer,
+                                                int64_t progress_base, int64_t progress_total,
                                                 progress_callback_t progress_cb, void* user_data,
                                                 int show_error) {
     if (!fin || !ftemp || !aes_ctx || !nonce_counter || !buffer) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
-    // 암호문 위치로 이동 (헤더 + HMAC 다음)
-    if (fseek(fin, sizeof(EncFileHeader) + ENC_HMAC_SIZE, SEEK_SET) != 0) {
+    // 암호문 위치로 이동 (헤더 + HMAC 다음, v5는 정렬 패딩 다음)
+    if (platform_fseek64(fin, payload_offset, SEEK_SET) != 0) {
         log_error(show_error, "Cannot seek to ciphertext position.\n");
         return FILE_CRYPTO_ERR_FILE_READ;
     }
     
     size_t bytes_read;
-    long total_read = 0;
+    int64_t total_read = 0;
     FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
     
+    FILE_IO_MODE io_path = select_io_path(ciphertext_size);
+    if (io_path == FILE_IO_MODE_MMAP) {
+        // 매핑할 수 없으면 아래 stdio 경로로 처리
+        if (decrypt_mapped_content(fin, ftemp, payload_offset, ciphertext_size, aes_ctx, nonce_counter, hmac_ctx,
+                                   progress_base, progress_total, progress_cb, user_data, &result)) {
+            if (result != FILE_CRYPTO_SUCCESS) {
+                log_error(show_error, "Decryption failed.\n");
+                return result;
+            }
+            total_read = ciphertext_size;
+        }
+    } else if (io_path == FILE_IO_MODE_IO_URING || io_path == FILE_IO_MODE_DIRECT) {
+        // io_uring을 쓸 수 없으면 아래 stdio 경로로 처리
+        PipelineProgress progress = { progress_base, progress_total, progress_cb, user_data, "Decrypting", 0 };
+        if (process_uring_content(fin, payload_offset, ciphertext_size, ftemp, 0, NULL, aes_ctx, nonce_counter,
+                                  hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT, FILE_CRYPTO_ERR_DECRYPTION_FAILED,
+                                  &progress, &result)) {
+            if (result != FILE_CRYPTO_SUCCESS) {
+                log_error(show_error, "Decryption failed.\n");
+                return result;
+            }
+            total_read = ciphertext_size;
+        }
+    } else if (io_path == FILE_IO_MODE_PIPELINED) {
+        // 파이프라인: 읽기 → CTR → 쓰기를 각각 다른 스레드에서 겹쳐 실행
+        PipelineProgress progress = { progress_base, progress_total, progress_cb, user_data, "Decrypting", 0 };
+        FilePipelineJob job;
+        memset(&job, 0, sizeof(job));
+        job.fin = fin;
+        job.fout = ftemp;
+        job.length = ciphertext_size;
+        job.chunk_size = FILE_CHUNK_SIZE;
+        job.aes_ctx = aes_ctx;
+        job.nonce_counter = nonce_counter;
+        job.ctr_error = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+        job.hmac_ctx = hmac_ctx;  // CTR 이후 버퍼(평문)에 HMAC
+        job.on_chunk = pipeline_progress;
+        job.user_data = &progress;
+        
+        result = file_pipeline_run(&job);
+        if (result == FILE_CRYPTO_ERR_FILE_READ) {
+            log_error(show_error, "Unexpected end of file. Expected %lld bytes, read %lld bytes.\n",
+                     (long long)ciphertext_size, (long long)job.processed);
+            return result;
+        } else if (result == FILE_CRYPTO_ERR_FILE_WRITE) {
+            log_error(show_error, "Failed to write decrypted data.\n");
+            return result;
+        } else if (result != FILE_CRYPTO_SUCCESS) {
+            log_error(show_error, "Decryption failed.\n");
+            return result;
+        }
+        total_read = job.processed;
+    }
+    
     while (total_read < ciphertext_size) {
         size_t to_read = (ciphertext_size - total_read < FILE_CHUNK_SIZE) ? 
                          (ciphertext_size - total_read) : FILE_CHUNK_SIZE;
@@ -664,36 +1721,40 @@ static FILE_CRYPTO_STATUS decrypt_file_content(FILE* fin, FILE* ftemp, long ciph
             }
             // EOF에 도달했는데 아직 읽어야 할 데이터가 남아있으면 에러
             if (total_read < ciphertext_size) {
-                log_error(show_error, "Unexpected end of file. Expected %ld bytes, read %ld bytes.\n", 
-                         ciphertext_size, total_read);
+                log_error(show_error, "Unexpected end of file. Expected %lld bytes, read %lld bytes.\n", 
+                         (long long)ciphertext_size, (long long)total_read);
                 return FILE_CRYPTO_ERR_FILE_READ;
             }
             break;  // 정상 종료
         }
         
-        // 청크 복호화 (in-place)
-        if (AES_CTR_crypt(aes_ctx, buffer, bytes_read, buffer, nonce_counter) != CRYPTO_SUCCESS) {
+        // 청크 복호화 (in-place), v2/v3는 복호화된 평문 타일에 HMAC도 함께 적용
+        CRYPTO_STATUS crypt_status = hmac_ctx ?
+            AES_CTR_HMAC_crypt(aes_ctx, buffer, bytes_read, buffer, nonce_counter,
+                               hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) :
+            AES_CTR_crypt(aes_ctx, buffer, bytes_read, buffer, nonce_counter);
+        if (crypt_status != CRYPTO_SUCCESS) {
             log_error(show_error, "Decryption failed.\n");
             return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
         }
         
-        // 복호화된 평문을 임시 파일에 저장
+        // 복호화된 평문을 출력 파일에 저장
         if (fwrite(buffer, 1, bytes_read, ftemp) != bytes_read) {
-            log_error(show_error, "Failed to write to temporary file.\n");
+            log_error(show_error, "Failed to write decrypted data.\n");
             return FILE_CRYPTO_ERR_FILE_WRITE;
         }
         
         total_read += bytes_read;
         
         // 진행률 업데이트 - 콜백이 있으면 콜백, 없으면 print_progress
-        update_progress_with_callback(total_read, ciphertext_size, progress_cb, user_data,
+        update_progress_with_callback(progress_base + total_read, progress_total, progress_cb, user_data,
                                      "Decrypting", 0);  // 0 = 퍼센트 변경 시마다 출력 (더 자주 업데이트)
     }
     
     // 루프 종료 후 검증: 모든 데이터를 읽었는지 확인
     if (total_read != ciphertext_size) {
-        log_error(show_error, "Incomplete decryption. Expected %ld bytes, read %ld bytes.\n", 
-                 ciphertext_size, total_read);
+        log_error(show_error, "Incomplete decryption. Expected %lld bytes, read %lld bytes.\n", 
+                 (long long)ciphertext_size, (long long)total_read);
         return FILE_CRYPTO_ERR_FILE_READ;
     }
     
@@ -706,40 +1767,136 @@ static FILE_CRYPTO_STATUS decrypt_file_content(FILE* fin, FILE* ftemp, long ciph
 }
 
 /**
- * @brief HMAC을 검증합니다 (헤더 + 복호화된 평문).
- * @param ftemp 임시 파일 포인터 (복호화된 평문)
+ * @brief 암호문에 대한 HMAC을 검증합니다 (v4 Encrypt-then-MAC, 헤더 + 암호문).
+ * @param fin 입력 파일 포인터 (암호문)
  * @param header 암호화 파일 헤더
  * @param hmac_key HMAC 키 (24바이트)
  * @param stored_hmac 저장된 HMAC (64바이트)
+ * @param ciphertext_size 암호문 크기 (바이트)
  * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기)
+ * @param progress_total 진행률 보고 시 전체 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
  * @param show_error 에러 메시지 출력 여부
  * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 검증 실패
+ * @note 복호화 전에 호출되므로 검증되지 않은 평문이 디스크에 기록되지 않습니다.
  */
-static FILE_CRYPTO_STATUS verify_file_hmac(FILE* ftemp, const EncFileHeader* header,
-                                           const uint8_t* hmac_key, const uint8_t* stored_hmac,
-                                           uint8_t* buffer, int show_error) {
-    if (!ftemp || !header || !hmac_key || !stored_hmac || !buffer) return FILE_CRYPTO_ERR_INVALID_INPUT;
+static FILE_CRYPTO_STATUS verify_ciphertext_hmac(FILE* fin, const EncFileHeader* header,
+                                                 const uint8_t* hmac_key, const uint8_t* stored_hmac,
+                                                 int64_t ciphertext_size, uint8_t* buffer, int64_t progress_total,
+                                                 progress_callback_t progress_cb, void* user_data,
+                                                 int show_error) {
+    if (!fin || !header || !hmac_key || !stored_hmac || !buffer) return FILE_CRYPTO_ERR_INVALID_INPUT;
     
-    // HMAC 검증: 헤더 + 복호화한 평문으로 HMAC 생성
     HMAC_SHA512_CTX hmac_ctx;
     hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
-    hmac_sha512_update(&hmac_ctx, (uint8_t*)header, sizeof(EncFileHeader));  // 헤더를 HMAC에 포함
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)header, sizeof(EncFileHeader));  // 헤더를 HMAC에 포함
     
-    // 임시 파일에서 복호화된 평문을 읽으면서 HMAC 업데이트
-    if (fseek(ftemp, 0, SEEK_SET) != 0) {
-        log_error(show_error, "Cannot seek to beginning of temporary file.\n");
+    // 암호문 위치로 이동 (헤더 + HMAC 다음, v5는 정렬 패딩 다음)
+    int64_t payload_offset = enc_payload_offset(header);
+    if (platform_fseek64(fin, payload_offset, SEEK_SET) != 0) {
+        log_error(show_error, "Cannot seek to ciphertext position.\n");
         return FILE_CRYPTO_ERR_FILE_READ;
     }
-    size_t bytes_read;
     
-    while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, ftemp)) > 0) {
+    int64_t total_read = 0;
+    
+    FILE_IO_MODE io_path = select_io_path(ciphertext_size);
+    if (io_path == FILE_IO_MODE_MMAP) {
+        // 매핑할 수 없으면 아래 stdio 경로로 처리
+        if (hmac_mapped_ciphertext(fin, payload_offset, ciphertext_size, &hmac_ctx,
+                                   progress_total, progress_cb, user_data)) {
+            total_read = ciphertext_size;
+        }
+    } else if (io_path == FILE_IO_MODE_IO_URING || io_path == FILE_IO_MODE_DIRECT) {
+        // io_uring을 쓸 수 없으면 아래 stdio 경로로 처리
+        PipelineProgress progress = { 0, progress_total, progress_cb, user_data, "Verifying", 0 };
+        FILE_CRYPTO_STATUS uring_result;
+        if (process_uring_content(fin, payload_offset, ciphertext_size, NULL, 0, NULL, NULL, NULL, &hmac_ctx,
+                                  AES_CTR_HMAC_MAC_INPUT, FILE_CRYPTO_ERR_DECRYPTION_FAILED,
+                                  &progress, &uring_result)) {
+            if (uring_result != FILE_CRYPTO_SUCCESS) {
+                log_error(show_error, "\nFile read error.\n");
+                return uring_result;
+            }
+            total_read = ciphertext_size;
+        }
+    } else if (io_path == FILE_IO_MODE_PIPELINED) {
+        // 파이프라인: 다음 청크를 읽는 동안 현재 청크의 HMAC 계산
+        PipelineProgress progress = { 0, progress_total, progress_cb, user_data, "Verifying", 0 };
+        FilePipelineJob job;
+        memset(&job, 0, sizeof(job));
+        job.fin = fin;
+        job.length = ciphertext_size;
+        job.chunk_size = FILE_CHUNK_SIZE;
+        job.hmac_ctx = &hmac_ctx;
+        job.on_chunk = pipeline_progress;
+        job.user_data = &progress;
+        
+        if (file_pipeline_run(&job) != FILE_CRYPTO_SUCCESS) {
+            log_error(show_error, "Unexpected end of file. Expected %lld bytes, read %lld bytes.\n",
+                     (long long)ciphertext_size, (long long)job.processed);
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        total_read = job.processed;
+    }
+    
+    while (total_read < ciphertext_size) {
+        size_t to_read = (ciphertext_size - total_read < FILE_CHUNK_SIZE) ?
+                         (size_t)(ciphertext_size - total_read) : FILE_CHUNK_SIZE;
+        size_t bytes_read = fread(buffer, 1, to_read, fin);
+        if (bytes_read == 0) {
+            log_error(show_error, "Unexpected end of file. Expected %lld bytes, read %lld bytes.\n",
+                     (long long)ciphertext_size, (long long)total_read);
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        
         hmac_sha512_update(&hmac_ctx, buffer, bytes_read);
+        total_read += bytes_read;
+        
+        update_progress_with_callback(total_read, progress_total, progress_cb, user_data,
+                                     "Verifying", 0);
+    }
+    
+    // v7: 압축 정보는 암호문 다음에 HMAC에 들어감
+    if (header->version == ENC_VERSION_COMPRESSED) {
+        uint8_t info[sizeof(EncCompressionInfo)];
+        if (platform_pread(fin, info, sizeof(info), (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE)) !=
+            (int64_t)sizeof(info)) {
+            log_error(show_error, "Cannot read compression info.\n");
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        hmac_sha512_update(&hmac_ctx, info, sizeof(info));
     }
     
-    // HMAC 최종 계산
     uint8_t computed_hmac[ENC_HMAC_SIZE];
     hmac_sha512_final(&hmac_ctx, computed_hmac);
     
+    if (memcmp(stored_hmac, computed_hmac, ENC_HMAC_SIZE) != 0) {
+        log_error(show_error, "\nHMAC integrity verification failed. File may be corrupted or password is incorrect.\n");
+        return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+    }
+    
+    log_info(show_error, "\nHMAC verification succeeded! Integrity confirmed.\n");
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief HMAC을 검증합니다 (v2/v3, 헤더 + 복호화된 평문).
+ * @param hmac_ctx 헤더와 복호화된 평문으로 업데이트된 HMAC 컨텍스트
+ * @param stored_hmac 저장된 HMAC (64바이트)
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 검증 실패
+ * @note 평문 HMAC은 복호화 중에 계산되므로 복호화된 파일을 다시 읽지 않습니다.
+ */
+static FILE_CRYPTO_STATUS verify_file_hmac(HMAC_SHA512_CTX* hmac_ctx, const uint8_t* stored_hmac,
+                                           int show_error) {
+    if (!hmac_ctx || !stored_hmac) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    // HMAC 최종 계산
+    uint8_t computed_hmac[ENC_HMAC_SIZE];
+    hmac_sha512_final(hmac_ctx, computed_hmac);
+    
     // HMAC 검증
     if (memcmp(stored_hmac, computed_hmac, ENC_HMAC_SIZE) != 0) {
         log_error(show_error, "HMAC integrity verification failed. File may be corrupted or password is incorrect.\n");
@@ -751,23 +1908,123 @@ static FILE_CRYPTO_STATUS verify_file_hmac(FILE* ftemp, const EncFileHeader* hea
 }
 
 /**
- * @brief 복호화된 파일을 최종 경로에 씁니다 (원본 확장자 복원).
- * @param ftemp 임시 파일 포인터 (복호화된 평문)
+ * @brief 입력 스트림을 v6 세그먼트로 암호화해 출력 스트림에 씁니다.
+ * @param fin 입력 스트림 (끝까지 순차 읽기)
+ * @param fout 출력 스트림 (헤더 다음부터 순차 쓰기)
+ * @param aes_ctx AES 암호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트
+ * @param buffer 작업용 버퍼 (ENC_SEGMENT_SIZE + ENC_HMAC_SIZE 크기)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 세그먼트를 다 채우지 못한 읽기가 마지막 세그먼트이므로 입력 크기를 미리 알 필요가 없고,
+ *       태그가 각 세그먼트 뒤에 붙으므로 되돌아가 쓸 필요도 없습니다.
+ */
+static FILE_CRYPTO_STATUS encrypt_segments(FILE* fin, FILE* fout, const AES_CTX* aes_ctx,
+                                           uint8_t* nonce_counter, const HMAC_SHA512_CTX* header_ctx,
+                                           uint8_t* buffer) {
+    for (uint64_t index = 0; ; index++) {
+        size_t length = fread(buffer, 1, ENC_SEGMENT_SIZE, fin);
+        if (ferror(fin)) return FILE_CRYPTO_ERR_FILE_READ;
+        int is_final = (length < ENC_SEGMENT_SIZE);
+        
+        // 암호화 + 암호문 태그 (Encrypt-then-MAC)
+        HMAC_SHA512_CTX segment_ctx;
+        file_segment_begin_tag(header_ctx, index, is_final, &segment_ctx);
+        if (AES_CTR_HMAC_crypt(aes_ctx, buffer, length, buffer, nonce_counter,
+                               &segment_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+            return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+        }
+        hmac_sha512_final(&segment_ctx, buffer + length);  // 태그는 암호문 바로 뒤
+        
+        if (fwrite(buffer, 1, length + ENC_HMAC_SIZE, fout) != length + ENC_HMAC_SIZE) {
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        if (is_final) return FILE_CRYPTO_SUCCESS;
+    }
+}
+
+/**
+ * @brief v6 세그먼트를 하나씩 검증하고 복호화해 출력 스트림에 씁니다.
+ * @param fin 입력 스트림 (첫 세그먼트 위치부터 순차 읽기)
+ * @param fout 출력 스트림 (순차 쓰기)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트
+ * @param buffer 작업용 버퍼 (ENC_SEGMENT_SIZE + ENC_HMAC_SIZE 크기)
+ * @param progress_total 진행률 전체 크기 (0이면 진행률을 보고하지 않음)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 태그 불일치/잘림, 그 외 에러 코드
+ * @note 세그먼트 평문은 태그가 맞을 때만 출력합니다. 마지막 표시가 있는 세그먼트 없이 끝나거나
+ *       그 뒤에 데이터가 더 있으면 실패로 처리합니다.
+ */
+static FILE_CRYPTO_STATUS decrypt_segments(FILE* fin, FILE* fout, const AES_CTX* aes_ctx,
+                                           uint8_t* nonce_counter, const HMAC_SHA512_CTX* header_ctx,
+                                           uint8_t* buffer, int64_t progress_total,
+                                           progress_callback_t progress_cb, void* user_data,
+                                           int show_error) {
+    int64_t processed = 0;
+    for (uint64_t index = 0; ; index++) {
+        size_t length = fread(buffer, 1, ENC_SEGMENT_SIZE + ENC_HMAC_SIZE, fin);
+        if (ferror(fin)) {
+            log_error(show_error, "File read error.\n");
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        if (length < ENC_HMAC_SIZE) {
+            log_error(show_error, "Encrypted stream is truncated (final segment missing).\n");
+            return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        }
+        length -= ENC_HMAC_SIZE;
+        int is_final = (length < ENC_SEGMENT_SIZE);
+        
+        // 암호문 태그 계산과 복호화를 한 패스로 (평문은 검증 전까지 버퍼에만 있음)
+        HMAC_SHA512_CTX segment_ctx;
+        uint8_t computed_tag[ENC_HMAC_SIZE];
+        file_segment_begin_tag(header_ctx, index, is_final, &segment_ctx);
+        if (AES_CTR_HMAC_crypt(aes_ctx, buffer, length, buffer, nonce_counter,
+                               &segment_ctx, AES_CTR_HMAC_MAC_INPUT) != CRYPTO_SUCCESS) {
+            log_error(show_error, "Decryption failed.\n");
+            return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+        }
+        hmac_sha512_final(&segment_ctx, computed_tag);
+        
+        if (memcmp(computed_tag, buffer + length, ENC_HMAC_SIZE) != 0) {
+            log_error(show_error, "Segment %llu failed integrity verification. File may be corrupted or password is incorrect.\n",
+                      (unsigned long long)index);
+            return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        }
+        if (is_final && fgetc(fin) != EOF) {
+            log_error(show_error, "Unexpected data after final segment.\n");
+            return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        }
+        
+        if (fwrite(buffer, 1, length, fout) != length) {
+            log_error(show_error, "File write error.\n");
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        
+        processed += (int64_t)(length + ENC_HMAC_SIZE);
+        if (progress_total > 0) {
+            update_progress_with_callback(processed, progress_total, progress_cb, user_data,
+                                         "Decrypting", 0);
+        }
+        if (is_final) return FILE_CRYPTO_SUCCESS;
+    }
+}
+
+/**
+ * @brief 헤더에 저장된 원본 확장자를 붙여 실제 출력 경로를 만듭니다.
  * @param output_path 출력 파일 경로 (기본 경로)
  * @param header 암호화 파일 헤더 (확장자 정보 포함)
- * @param final_output_path 출력 최종 파일 경로 (확장자 포함)
+ * @param actual_output_path 출력 실제 파일 경로
+ * @param actual_path_size actual_output_path 버퍼 크기
+ * @param final_output_path 호출자에게 돌려줄 최종 파일 경로 (NULL 가능)
  * @param final_path_size final_output_path 버퍼 크기
- * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기)
- * @param show_error 에러 메시지 출력 여부
- * @param progress_cb 진행률 콜백 함수 (GUI 모드 확인용, NULL 가능)
- * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
  */
-static FILE_CRYPTO_STATUS write_decrypted_file(FILE* ftemp, const char* output_path,
-                                                const EncFileHeader* header, char* final_output_path,
-                                                size_t final_path_size, uint8_t* buffer, int show_error,
-                                                progress_callback_t progress_cb) {
-    if (!ftemp || !output_path || !header || !buffer) return FILE_CRYPTO_ERR_INVALID_INPUT;
-    
+void resolve_decrypted_output_path(const char* output_path, const EncFileHeader* header,
+                                   char* actual_output_path, size_t actual_path_size,
+                                   char* final_output_path, size_t final_path_size) {
     // 헤더에서 원본 확장자 읽기
     char format_ext[16] = {0};
     strncpy(format_ext, (const char*)header->format, 8);
@@ -775,9 +2032,8 @@ static FILE_CRYPTO_STATUS write_decrypted_file(FILE* ftemp, const char* output_p
     size_t ext_len = strlen(format_ext);
     
     // 출력 파일 경로에 확장자 추가
-    char actual_output_path[512];
-    strncpy(actual_output_path, output_path, sizeof(actual_output_path) - 1);
-    actual_output_path[sizeof(actual_output_path) - 1] = '\0';
+    strncpy(actual_output_path, output_path, actual_path_size - 1);
+    actual_output_path[actual_path_size - 1] = '\0';
     
     if (ext_len > 0) {
         // 출력 경로에 확장자가 없으면 추가
@@ -786,8 +2042,8 @@ static FILE_CRYPTO_STATUS write_decrypted_file(FILE* ftemp, const char* output_p
         if (!last_dot || (last_slash && last_dot < last_slash)) {
             // 확장자가 없으면 추가
             size_t path_len = strlen(actual_output_path);
-            if (path_len + ext_len < sizeof(actual_output_path)) {
-                strncpy(actual_output_path + path_len, format_ext, ext_len);
+            if (path_len + ext_len < actual_path_size) {
+                memcpy(actual_output_path + path_len, format_ext, ext_len);
                 actual_output_path[path_len + ext_len] = '\0';
             }
         }
@@ -798,231 +2054,685 @@ static FILE_CRYPTO_STATUS write_decrypted_file(FILE* ftemp, const char* output_p
         strncpy(final_output_path, actual_output_path, final_path_size - 1);
         final_output_path[final_path_size - 1] = '\0';
     }
+}
+
+/**
+ * @brief 복호화 출력을 스테이징할 임시 파일을 엽니다.
+ * @param actual_output_path 최종 출력 파일 경로
+ * @param staged_path 출력 스테이징 파일 경로
+ * @param staged_path_size staged_path 버퍼 크기
+ * @return 스테이징 파일 포인터, 실패 시 NULL
+ * @note 최종 경로와 같은 디렉토리에 만들어 검증 후 rename 한 번으로 게시합니다.
+ *       같은 디렉토리에 만들 수 없으면 시스템 임시 디렉토리를 사용합니다 (게시 시 복사 필요).
+ */
+static FILE* open_staged_output(const char* actual_output_path, char* staged_path, size_t staged_path_size) {
+    FILE* fstaged = platform_create_temp_file_near(actual_output_path, staged_path, staged_path_size);
+    if (!fstaged) {
+        fstaged = platform_create_temp_file(staged_path, staged_path_size);
+    }
+    if (fstaged) {
+        // 스테이징 파일 버퍼링 최적화 (모든 플랫폼)
+        setvbuf(fstaged, NULL, _IOFBF, FILE_BUFFER_SIZE);
+    }
+    return fstaged;
+}
+
+/**
+ * @brief 검증이 끝난 스테이징 파일을 최종 경로로 게시합니다.
+ * @param fstaged 스테이징 파일 포인터 (이 함수에서 닫힘)
+ * @param staged_path 스테이징 파일 경로 (게시 후 삭제됨)
+ * @param actual_output_path 최종 출력 파일 경로
+ * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기, 복사가 필요한 경우에만 사용)
+ * @param final_output_path 출력 최종 파일 경로 (GUI 모드에서는 에러 메시지)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @param show_error 에러 메시지 출력 여부
+ * @param progress_cb 진행률 콜백 함수 (GUI 모드 확인용, NULL 가능)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 원자적 rename으로 출력이 한 번에 나타나며, rename이 불가능할 때만 복사합니다.
+ */
+static FILE_CRYPTO_STATUS publish_staged_output(FILE* fstaged, const char* staged_path,
+                                                const char* actual_output_path, uint8_t* buffer,
+                                                char* final_output_path, size_t final_path_size,
+                                                int show_error, progress_callback_t progress_cb) {
+    if (!fstaged || !staged_path || !actual_output_path || !buffer) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    if (fclose(fstaged) != 0) {
+        platform_delete_file(staged_path);
+        if (progress_cb != NULL) {
+            format_error_message(final_output_path, final_path_size, "Failed while writing decrypted file", 1);
+        }
+        log_error(show_error, "Failed to write decrypted data.\n");
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    
+    // 같은 파일시스템이면 rename 한 번으로 게시 (데이터 복사 없음)
+    if (platform_rename_file(staged_path, actual_output_path)) {
+        return FILE_CRYPTO_SUCCESS;
+    }
+    
+    // rename 불가 (다른 파일시스템의 임시 디렉토리 등): 최종 경로로 복사
+    FILE* fsrc = platform_fopen(staged_path, "rb");
+    if (!fsrc) {
+        platform_delete_file(staged_path);
+        log_error(show_error, "Cannot reopen staged output file.\n");
+        return FILE_CRYPTO_ERR_FILE_READ;
+    }
     
-    // 출력 파일 작성
     FILE* fout = platform_fopen(actual_output_path, "wb");
     if (!fout) {
+        fclose(fsrc);
+        platform_delete_file(staged_path);
         if (progress_cb != NULL) {
             format_error_message(final_output_path, final_path_size, "Cannot create output file", 1);
         }
+        log_error(show_error, "Cannot create output file: %s\n", actual_output_path);
         return FILE_CRYPTO_ERR_FILE_OPEN;
     }
     
     // 출력 파일 버퍼링 최적화 (모든 플랫폼)
     setvbuf(fout, NULL, _IOFBF, FILE_BUFFER_SIZE);
     
-    // 임시 파일에서 복호화된 평문을 최종 출력 파일로 복사
-    if (fseek(ftemp, 0, SEEK_SET) != 0) {
-        fclose(fout);
-        log_error(show_error, "Cannot seek to beginning of temporary file.\n");
-        return FILE_CRYPTO_ERR_FILE_READ;
-    }
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
     size_t bytes_read;
-    long total_read = 0;
-    
-    while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, ftemp)) > 0) {
+    while ((bytes_read = fread(buffer, 1, FILE_CHUNK_SIZE, fsrc)) > 0) {
         if (fwrite(buffer, 1, bytes_read, fout) != bytes_read) {
-            fclose(fout);
-            remove(actual_output_path);
-            if (progress_cb != NULL) {
-                format_error_message(final_output_path, final_path_size, "Failed while writing decrypted file", 1);
-            }
-            return FILE_CRYPTO_ERR_FILE_WRITE;
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+            break;
         }
-        total_read += bytes_read;
+    }
+    if (result == FILE_CRYPTO_SUCCESS && ferror(fsrc)) {
+        result = FILE_CRYPTO_ERR_FILE_READ;
     }
     
-    fclose(fout);
-    return FILE_CRYPTO_SUCCESS;
+    fclose(fsrc);
+    if (fclose(fout) != 0 && result == FILE_CRYPTO_SUCCESS) {
+        result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    platform_delete_file(staged_path);
+    
+    if (result != FILE_CRYPTO_SUCCESS) {
+        platform_delete_file(actual_output_path);
+        if (progress_cb != NULL) {
+            format_error_message(final_output_path, final_path_size, "Failed while writing decrypted file", 1);
+        }
+        log_error(show_error, "Failed to write decrypted file.\n");
+    }
+    return result;
 }
 
+// v7 압축 스트림 복원 상태 (암호문을 청크 단위로 복호화해 프레임을 하나씩 꺼냄)
+typedef struct {
+    FILE* fin;                          // 암호화 파일 (위치 지정 읽기)
+    const AES_CTX* aes_ctx;             // AES 컨텍스트
+    uint8_t start_counter[16];          // 암호문 시작의 CTR 카운터
+    uint8_t nonce_counter[16];          // 다음 청크의 CTR 카운터
+    int64_t payload_offset;             // 암호문 시작 위치
+    int64_t stored_size;                // 암호문 크기
+    int64_t original_size;              // 원본 크기 (압축 정보)
+    int64_t read_offset;                // 다음에 읽을 암호문 위치 (암호문 시작 기준)
+    uint8_t* chunk;                     // 복호화한 암호문 청크 (FILE_CHUNK_SIZE)
+    size_t chunk_position;              // chunk에서 다음에 꺼낼 위치
+    size_t chunk_length;                // chunk에 든 바이트 수
+    uint8_t* frame;                     // 프레임 페이로드 (LZ_BLOCK_SIZE)
+    uint8_t* block;                     // 복원한 블록 (LZ_BLOCK_SIZE)
+} CompressedStream;
+
 /**
- * @brief 암호화 파일 헤더에서 AES 키 길이를 읽습니다 (복호화 전 확인용).
- * @param input_path 입력 파일 경로
- * @return AES 키 길이 (128, 192, 256), 실패 시 0
+ * @brief v7 압축 정보를 읽고 압축 스트림 복원을 준비합니다.
+ * @param stream 출력 스트림 상태
+ * @param fin 암호화 파일 포인터
+ * @param header 암호화 파일 헤더
+ * @param ciphertext_size 암호문 크기 (바이트)
+ * @param aes_ctx AES 복호화 컨텍스트 (스트림보다 오래 유지)
+ * @param nonce_counter 암호문 시작의 CTR 카운터 (16바이트)
+ * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_INVALID_HEADER 압축 정보 불일치 등
+ * @note 압축 정보는 HMAC으로 인증되지만 여기서는 형식만 확인하므로 HMAC 검증 후에 사용합니다.
  */
-int read_aes_key_length(const char* input_path) {
-    FILE* fin = platform_fopen(input_path, "rb");
-    if (!fin) {
-        return 0;
-    }
+static FILE_CRYPTO_STATUS compressed_stream_open(CompressedStream* stream, FILE* fin, const EncFileHeader* header,
+                                                 int64_t ciphertext_size, const AES_CTX* aes_ctx,
+                                                 const uint8_t* nonce_counter) {
+    memset(stream, 0, sizeof(*stream));
     
-    EncFileHeader header;
-    if (fread(&header, 1, sizeof(header), fin) != sizeof(header)) {
-        fclose(fin);
-        return 0;
+    EncCompressionInfo info;
+    if (platform_pread(fin, &info, sizeof(info), (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE)) !=
+        (int64_t)sizeof(info)) {
+        return FILE_CRYPTO_ERR_FILE_READ;
     }
-    
-    fclose(fin);
-    
-    // 시그니처 검증
-    if (memcmp(header.signature, ENC_SIGNATURE, 4) != 0) {
-        return 0;
+    uint64_t original_size = enc_load_be64(info.original_size);
+    if (info.codec != ENC_CODEC_LZ || enc_load_be64(info.stored_size) != (uint64_t)ciphertext_size ||
+        original_size > (uint64_t)INT64_MAX) {
+        return FILE_CRYPTO_ERR_INVALID_HEADER;
     }
     
-    // 키 길이 코드에서 실제 키 길이 반환
-    if (header.key_length_code == KEY_LENGTH_CODE_128) return 128;
-    else if (header.key_length_code == KEY_LENGTH_CODE_192) return 192;
-    else if (header.key_length_code == KEY_LENGTH_CODE_256) return 256;
-    else return 0;
+    stream->fin = fin;
+    stream->aes_ctx = aes_ctx;
+    memcpy(stream->start_counter, nonce_counter, 16);
+    memcpy(stream->nonce_counter, nonce_counter, 16);
+    stream->payload_offset = enc_payload_offset(header);
+    stream->stored_size = ciphertext_size;
+    stream->original_size = (int64_t)original_size;
+    stream->chunk = (uint8_t*)malloc(FILE_CHUNK_SIZE);
+    stream->frame = (uint8_t*)malloc(LZ_BLOCK_SIZE);
+    stream->block = (uint8_t*)malloc(LZ_BLOCK_SIZE);
+    if (!stream->chunk || !stream->frame || !stream->block) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+// 압축 스트림을 처음으로 되돌림
+static void compressed_stream_rewind(CompressedStream* stream) {
+    memcpy(stream->nonce_counter, stream->start_counter, 16);
+    stream->read_offset = 0;
+    stream->chunk_position = 0;
+    stream->chunk_length = 0;
+}
+
+// 압축 스트림 버퍼 해제 (실패한 compressed_stream_open 뒤에도 호출 가능)
+static void compressed_stream_close(CompressedStream* stream) {
+    free(stream->chunk);
+    free(stream->frame);
+    free(stream->block);
+    memset(stream, 0, sizeof(*stream));
 }
 
 /**
- * @brief 파일 복호화 내부 구현 함수 (진행률 콜백 지원).
- * @param input_path 입력 파일 경로
- * @param output_path 출력 파일 경로 (기본 경로)
- * @param password 비밀번호
- * @param final_output_path 출력 최종 파일 경로 (확장자 포함)
- * @param final_path_size final_output_path 버퍼 크기
- * @param progress_cb 진행률 콜백 함수 (NULL 가능)
- * @param user_data 콜백에 전달할 사용자 데이터
- * @return 1 성공, 0 실패
+ * @brief 복호화한 압축 스트림에서 정확히 length 바이트를 꺼냅니다.
+ * @param stream 스트림 상태
+ * @param dst 출력 버퍼
+ * @param length 꺼낼 바이트 수
+ * @return 1 성공, 0 암호문 끝이나 읽기 실패
  */
-static int decrypt_file_internal(const char* input_path, const char* output_path,
-                                  const char* password, char* final_output_path, size_t final_path_size,
-                                  progress_callback_t progress_cb, void* user_data) {
-    FILE* fin = platform_fopen(input_path, "rb");
-    if (!fin) {
-        log_error(!progress_cb, "Cannot open file: %s\n", input_path);
-        return 0;
+static int compressed_stream_read(CompressedStream* stream, uint8_t* dst, size_t length) {
+    while (length > 0) {
+        if (stream->chunk_position == stream->chunk_length) {
+            int64_t remaining = stream->stored_size - stream->read_offset;
+            size_t count = (remaining < FILE_CHUNK_SIZE) ? (size_t)remaining : FILE_CHUNK_SIZE;
+            if (count == 0 ||
+                platform_pread(stream->fin, stream->chunk, count, stream->payload_offset + stream->read_offset) !=
+                (int64_t)count ||
+                AES_CTR_crypt(stream->aes_ctx, stream->chunk, count, stream->chunk,
+                              stream->nonce_counter) != CRYPTO_SUCCESS) {
+                return 0;
+            }
+            stream->read_offset += (int64_t)count;
+            stream->chunk_position = 0;
+            stream->chunk_length = count;
+        }
+        size_t available = stream->chunk_length - stream->chunk_position;
+        size_t count = (length < available) ? length : available;
+        memcpy(dst, stream->chunk + stream->chunk_position, count);
+        stream->chunk_position += count;
+        dst += count;
+        length -= count;
+    }
+    return 1;
+}
+
+/**
+ * @brief 다음 프레임을 복원합니다.
+ * @param stream 스트림 상태
+ * @param data 출력: 복원한 블록 (스트림 버퍼 안, 다음 호출까지 유효)
+ * @param length 출력: 블록 길이 (스트림 끝이면 0)
+ * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_DECRYPTION_FAILED 잘린 프레임이나 잘못된 압축 데이터
+ */
+static FILE_CRYPTO_STATUS compressed_stream_next(CompressedStream* stream, const uint8_t** data, size_t* length) {
+    *data = NULL;
+    *length = 0;
+    if (stream->read_offset == stream->stored_size && stream->chunk_position == stream->chunk_length) {
+        return FILE_CRYPTO_SUCCESS;  // 끝
     }
     
-    // 파일 버퍼링 최적화 (모든 플랫폼)
-    setvbuf(fin, NULL, _IOFBF, FILE_BUFFER_SIZE);
-    
-    // 헤더 읽기 및 검증
-    EncFileHeader header;
-    long file_size, ciphertext_size;
-    int show_error = (progress_cb == NULL);
+    uint8_t frame_header[LZ_FRAME_HEADER_SIZE];
+    int raw;
+    size_t payload_length;
+    if (!compressed_stream_read(stream, frame_header, sizeof(frame_header)) ||
+        !lz_frame_parse_header(frame_header, &raw, &payload_length) || payload_length == 0 ||
+        !compressed_stream_read(stream, stream->frame, payload_length)) {
+        return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    }
+    if (raw) {
+        *data = stream->frame;
+        *length = payload_length;
+        return FILE_CRYPTO_SUCCESS;
+    }
     
-    FILE_CRYPTO_STATUS header_result = read_and_validate_header(fin, &header, &file_size, &ciphertext_size, show_error);
-    if (header_result != FILE_CRYPTO_SUCCESS) {
-        fclose(fin);
-        return 0;  // header_result에 상세 에러 정보 포함
+    int64_t block_length = lz_decompress(stream->frame, payload_length, stream->block, LZ_BLOCK_SIZE);
+    if (block_length <= 0) return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    *data = stream->block;
+    *length = (size_t)block_length;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief v7 암호문을 복호화하고 압축을 풀어 출력 파일에 씁니다.
+ * @param fin 입력 파일 포인터 (암호문)
+ * @param fout 출력 파일 포인터
+ * @param header 암호화 파일 헤더
+ * @param ciphertext_size 암호문 크기 (바이트)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param progress_base 진행률 보고 시 처리량에 더할 값
+ * @param progress_total 진행률 보고 시 전체 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 프레임 하나씩 복원해 바로 쓰므로 메모리 사용은 원본 크기와 무관합니다.
+ */
+static FILE_CRYPTO_STATUS decrypt_compressed_content(FILE* fin, FILE* fout, const EncFileHeader* header,
+                                                     int64_t ciphertext_size, const AES_CTX* aes_ctx,
+                                                     const uint8_t* nonce_counter,
+                                                     int64_t progress_base, int64_t progress_total,
+                                                     progress_callback_t progress_cb, void* user_data,
+                                                     int show_error) {
+    CompressedStream stream;
+    FILE_CRYPTO_STATUS result = compressed_stream_open(&stream, fin, header, ciphertext_size, aes_ctx, nonce_counter);
+    if (result != FILE_CRYPTO_SUCCESS) {
+        compressed_stream_close(&stream);
+        log_error(show_error, "Invalid compression info.\n");
+        return result;
     }
     
-    // 암호화 메타데이터 읽기 (HMAC, 키 길이, salt)
-    uint8_t stored_hmac[ENC_HMAC_SIZE];
-    int aes_key_bits;
-    const uint8_t* pbkdf2_salt = NULL;
-    size_t pbkdf2_salt_len = 0;
+    int64_t written = 0;
+    int64_t reported = 0;
+    for (;;) {
+        const uint8_t* data;
+        size_t length;
+        result = compressed_stream_next(&stream, &data, &length);
+        if (result != FILE_CRYPTO_SUCCESS || length == 0) break;
+        if ((uint64_t)length > (uint64_t)(stream.original_size - written)) {
+            result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+            break;
+        }
+        if (fwrite(data, 1, length, fout) != length) {
+            log_error(show_error, "Failed to write decrypted data.\n");
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+            break;
+        }
+        written += (int64_t)length;
+        if (stream.read_offset != reported) {
+            // 진행률은 암호문 청크를 새로 읽을 때만 보고 (다른 경로와 같은 청크 단위)
+            reported = stream.read_offset;
+            update_progress_with_callback(progress_base + reported, progress_total, progress_cb, user_data,
+                                         "Decrypting", 0);
+        }
+    }
+    if (result == FILE_CRYPTO_SUCCESS && written != stream.original_size) result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    if (result == FILE_CRYPTO_ERR_DECRYPTION_FAILED) log_error(show_error, "Corrupted compressed data.\n");
+    compressed_stream_close(&stream);
+    return result;
+}
+
+/**
+ * @brief v4 파일을 복호화합니다 (암호문 HMAC 검증 후 출력 파일에 직접 복호화).
+ * @param fin 입력 파일 포인터 (암호문)
+ * @param header 암호화 파일 헤더
+ * @param hmac_key HMAC 키 (24바이트)
+ * @param stored_hmac 저장된 HMAC (64바이트)
+ * @param ciphertext_size 암호문 크기 (바이트)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기)
+ * @param output_path 출력 파일 경로 (기본 경로)
+ * @param final_output_path 출력 최종 파일 경로 (확장자 포함, GUI 모드에서는 에러 메시지)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 검증 1회 + 복호화 1회로 입력을 두 번 읽고 출력은 한 번만 씁니다.
+ *       검증에 실패하면 출력 파일을 만들지 않고, 성공하면 스테이징 파일을 rename으로 게시합니다.
+ */
+static FILE_CRYPTO_STATUS decrypt_etm_content(FILE* fin, const EncFileHeader* header,
+                                              const uint8_t* hmac_key, const uint8_t* stored_hmac,
+                                              int64_t ciphertext_size, const AES_CTX* aes_ctx,
+                                              uint8_t* nonce_counter, uint8_t* buffer,
+                                              const char* output_path,
+                                              char* final_output_path, size_t final_path_size,
+                                              progress_callback_t progress_cb, void* user_data,
+                                              int show_error) {
+    // GUI 콜백에는 검증 + 복호화 두 단계를 하나의 진행률로 보고
+    int64_t progress_total = progress_cb ? ciphertext_size * 2 : ciphertext_size;
+    int64_t progress_base = progress_cb ? ciphertext_size : 0;
     
-    FILE_CRYPTO_STATUS metadata_result = read_encryption_metadata(fin, &header, stored_hmac, &aes_key_bits, 
-                                                                 &pbkdf2_salt, &pbkdf2_salt_len, show_error);
-    if (metadata_result != FILE_CRYPTO_SUCCESS) {
-        fclose(fin);
-        return 0;  // metadata_result에 상세 에러 정보 포함
+    // 1단계: 암호문 HMAC 검증 (평문을 만들기 전에 무결성 확인)
+    FILE_CRYPTO_STATUS hmac_result = verify_ciphertext_hmac(fin, header, hmac_key, stored_hmac,
+                                                            ciphertext_size, buffer, progress_total,
+                                                            progress_cb, user_data, show_error);
+    if (hmac_result != FILE_CRYPTO_SUCCESS) {
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "HMAC integrity verification failed", 0);
+        return hmac_result;
     }
     
-    // 키 도출
-    uint8_t aes_key[32];
-    uint8_t hmac_key[HMAC_KEY_SIZE];
-    derive_keys(password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, hmac_key);
+    // 2단계: 검증된 암호문을 출력 디렉토리의 스테이징 파일에 복호화
+    char actual_output_path[512];
+    resolve_decrypted_output_path(output_path, header, actual_output_path, sizeof(actual_output_path),
+                                  final_output_path, final_path_size);
     
-    // AES 컨텍스트 설정
-    AES_CTX aes_ctx;
-    if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
-        fclose(fin);
-        return 0;  // FILE_CRYPTO_ERR_DECRYPTION_FAILED (AES 키 설정 실패)
+    char staged_path[512];
+    FILE* fstaged = open_staged_output(actual_output_path, staged_path, sizeof(staged_path));
+    if (!fstaged) {
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Cannot create temporary file", 1);
+        log_error(show_error, "Cannot create temporary file.\n");
+        return FILE_CRYPTO_ERR_TEMP_FILE_CREATE;
     }
     
-    // CTR 모드용 nonce_counter
-    uint8_t nonce_counter[16];
-    memcpy(nonce_counter, header.nonce, 8);
-    memset(nonce_counter + 8, 0, 8);
+    FILE_CRYPTO_STATUS decrypt_result = (header->version == ENC_VERSION_COMPRESSED) ?
+        decrypt_compressed_content(fin, fstaged, header, ciphertext_size, aes_ctx, nonce_counter,
+                                   progress_base, progress_total, progress_cb, user_data, show_error) :
+        decrypt_file_content(fin, fstaged, enc_payload_offset(header), ciphertext_size, aes_ctx, nonce_counter,
+                             NULL, buffer, progress_base, progress_total,
+                             progress_cb, user_data, show_error);
+    if (decrypt_result != FILE_CRYPTO_SUCCESS) {
+        fclose(fstaged);
+        platform_delete_file(staged_path);
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Failed while writing decrypted file", 1);
+        log_error(show_error, "Decryption failed!\n");
+        return decrypt_result;
+    }
     
-    log_info(!progress_cb, "Decrypting...\n");
+    // 3단계: rename으로 최종 경로에 게시 (출력이 한 번에 나타남)
+    return publish_staged_output(fstaged, staged_path, actual_output_path, buffer,
+                                 final_output_path, final_path_size, show_error, progress_cb);
+}
+
+/**
+ * @brief v8 파일의 청크 메타데이터를 읽고 루트 태그를 검증합니다.
+ * @param fin 입력 파일 포인터
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트
+ * @param stored_root 파일에 저장된 루트 태그
+ * @param ciphertext_size 루트 태그 뒤 레코드 영역 크기
+ * @param metas 출력 청크 메타데이터 배열 (호출자가 free)
+ * @param count 출력 청크 수
+ * @param final_length 출력 마지막 청크 길이
+ * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 잘림/변조/중단된 갱신 등
+ * @note 청크 하나에 메타데이터 112바이트만 읽으므로 암호문 전체를 읽기 전에 구조를 확인합니다.
+ */
+static FILE_CRYPTO_STATUS load_incremental_metas(FILE* fin, const HMAC_SHA512_CTX* header_ctx,
+                                                 const uint8_t* stored_root, int64_t ciphertext_size,
+                                                 EncChunkMeta** metas, uint64_t* count, size_t* final_length) {
+    *metas = NULL;
+    if (!file_chunk_layout(ciphertext_size, count, final_length)) return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
     
-    // 임시 파일에 복호화된 평문 저장 (HMAC 검증을 위해)
-    char temp_file_path[512];
-    FILE* ftemp = platform_create_temp_file(temp_file_path, sizeof(temp_file_path));
-    if (!ftemp) {
-        fclose(fin);
+    *metas = (EncChunkMeta*)malloc((size_t)*count * sizeof(EncChunkMeta));
+    if (!*metas) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    FILE_CRYPTO_STATUS result = file_chunks_read_meta(fin, (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE),
+                                                      *count, *metas);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    
+    uint8_t root[ENC_HMAC_SIZE];
+    file_chunks_root(header_ctx, *metas, *count, *final_length, root);
+    if (memcmp(root, stored_root, ENC_HMAC_SIZE) != 0) return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief v8 파일을 복호화합니다 (루트 태그 검증 후 청크마다 태그 검증, 스테이징 파일에 복호화).
+ * @param fin 입력 파일 포인터 (암호문)
+ * @param header 암호화 파일 헤더
+ * @param hmac_key HMAC 키 (24바이트)
+ * @param stored_hmac 저장된 루트 태그 (64바이트)
+ * @param ciphertext_size 레코드 영역 크기 (바이트)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기)
+ * @param output_path 출력 파일 경로 (기본 경로)
+ * @param final_output_path 출력 최종 파일 경로 (확장자 포함, GUI 모드에서는 에러 메시지)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 뒤쪽 청크의 태그가 맞지 않으면 스테이징 파일을 지우므로 출력 경로에는 검증된 결과만 나타납니다.
+ */
+static FILE_CRYPTO_STATUS decrypt_incremental_content(FILE* fin, const EncFileHeader* header,
+                                                      const uint8_t* hmac_key, const uint8_t* stored_hmac,
+                                                      int64_t ciphertext_size, const AES_CTX* aes_ctx,
+                                                      uint8_t* buffer, const char* output_path,
+                                                      char* final_output_path, size_t final_path_size,
+                                                      progress_callback_t progress_cb, void* user_data,
+                                                      int show_error) {
+    HMAC_SHA512_CTX header_ctx;
+    hmac_sha512_init(&header_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)header, sizeof(EncFileHeader));
+    
+    EncChunkMeta* metas;
+    uint64_t count;
+    size_t final_length;
+    FILE_CRYPTO_STATUS result = load_incremental_metas(fin, &header_ctx, stored_hmac, ciphertext_size,
+                                                       &metas, &count, &final_length);
+    if (result != FILE_CRYPTO_SUCCESS) {
+        free(metas);
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "HMAC integrity verification failed", 0);
+        log_error(show_error, "HMAC integrity verification failed. File may be corrupted or password is incorrect.\n");
+        return result;
+    }
+    
+    char actual_output_path[512];
+    resolve_decrypted_output_path(output_path, header, actual_output_path, sizeof(actual_output_path),
+                                  final_output_path, final_path_size);
+    
+    char staged_path[512];
+    FILE* fstaged = open_staged_output(actual_output_path, staged_path, sizeof(staged_path));
+    if (!fstaged) {
+        free(metas);
         if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Cannot create temporary file", 1);
         log_error(show_error, "Cannot create temporary file.\n");
-        return 0;  // FILE_CRYPTO_ERR_TEMP_FILE_CREATE
+        return FILE_CRYPTO_ERR_TEMP_FILE_CREATE;
     }
     
-    // 임시 파일 버퍼링 최적화 (모든 플랫폼)
-    setvbuf(ftemp, NULL, _IOFBF, FILE_BUFFER_SIZE);
+    int64_t records_offset = (int64_t)(sizeof(EncFileHeader) + ENC_HMAC_SIZE);
+    for (uint64_t i = 0; i < count && result == FILE_CRYPTO_SUCCESS; i++) {
+        size_t length = (i + 1 == count) ? final_length : ENC_CHUNK_SIZE;
+        int64_t position = records_offset + file_chunk_position(i) + ENC_CHUNK_META_SIZE;
+        if (platform_pread(fin, buffer, length, position) != (int64_t)length) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+        } else {
+            result = file_chunk_open(aes_ctx, &header_ctx, i, &metas[i], buffer, length);
+        }
+        if (result == FILE_CRYPTO_SUCCESS && fwrite(buffer, 1, length, fstaged) != length) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        update_progress_with_callback(position + (int64_t)length - records_offset, ciphertext_size,
+                                      progress_cb, user_data, "Decrypting", 0);
+    }
+    free(metas);
     
-    // 암호문 읽기 및 복호화를 위한 버퍼 할당
-    uint8_t* buffer = (uint8_t*)malloc(FILE_CHUNK_SIZE);
-    if (!buffer) {
-        fclose(fin);
-        fclose(ftemp);
-        platform_delete_file(temp_file_path);
-        return 0;  // FILE_CRYPTO_ERR_MEMORY_ALLOCATION
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fclose(fstaged);
+        platform_delete_file(staged_path);
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Failed while writing decrypted file", 1);
+        log_error(show_error, (result == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) ?
+                  "Chunk integrity verification failed.\n" : "Decryption failed!\n");
+        return result;
     }
     
-    // 파일 내용 복호화
-    FILE_CRYPTO_STATUS decrypt_result = decrypt_file_content(fin, ftemp, ciphertext_size, &aes_ctx, nonce_counter,
-                                                              buffer, progress_cb, user_data, show_error);
+    return publish_staged_output(fstaged, staged_path, actual_output_path, buffer,
+                                 final_output_path, final_path_size, show_error, progress_cb);
+}
+
+/**
+ * @brief v2/v3 파일을 복호화합니다 (스테이징 파일에 복호화 후 평문 HMAC 검증).
+ * @param fin 입력 파일 포인터 (암호문)
+ * @param header 암호화 파일 헤더
+ * @param hmac_key HMAC 키 (24바이트)
+ * @param stored_hmac 저장된 HMAC (64바이트)
+ * @param ciphertext_size 암호문 크기 (바이트)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트)
+ * @param buffer 작업용 버퍼 (최소 FILE_CHUNK_SIZE 크기)
+ * @param output_path 출력 파일 경로 (기본 경로)
+ * @param final_output_path 출력 최종 파일 경로 (확장자 포함, GUI 모드에서는 에러 메시지)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ */
+static FILE_CRYPTO_STATUS decrypt_legacy_content(FILE* fin, const EncFileHeader* header,
+                                                 const uint8_t* hmac_key, const uint8_t* stored_hmac,
+                                                 int64_t ciphertext_size, const AES_CTX* aes_ctx,
+                                                 uint8_t* nonce_counter, uint8_t* buffer,
+                                                 const char* output_path,
+                                                 char* final_output_path, size_t final_path_size,
+                                                 progress_callback_t progress_cb, void* user_data,
+                                                 int show_error) {
+    char actual_output_path[512];
+    resolve_decrypted_output_path(output_path, header, actual_output_path, sizeof(actual_output_path),
+                                  final_output_path, final_path_size);
+    
+    // 출력 디렉토리의 스테이징 파일에 복호화된 평문 저장 (HMAC 검증을 위해)
+    char temp_file_path[512];
+    FILE* ftemp = open_staged_output(actual_output_path, temp_file_path, sizeof(temp_file_path));
+    if (!ftemp) {
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Cannot create temporary file", 1);
+        log_error(show_error, "Cannot create temporary file.\n");
+        return FILE_CRYPTO_ERR_TEMP_FILE_CREATE;
+    }
     
-    fclose(fin);
+    // 파일 내용 복호화 (HMAC: 헤더 + 복호화된 평문, 복호화와 같은 패스에서 계산)
+    HMAC_SHA512_CTX hmac_ctx;
+    hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)header, sizeof(EncFileHeader));  // 헤더를 HMAC에 포함
     
+    FILE_CRYPTO_STATUS decrypt_result = decrypt_file_content(fin, ftemp, enc_payload_offset(header), ciphertext_size, aes_ctx, nonce_counter,
+                                                              &hmac_ctx, buffer, 0, ciphertext_size,
+                                                              progress_cb, user_data, show_error);
     if (decrypt_result != FILE_CRYPTO_SUCCESS) {
-        free(buffer);
         fclose(ftemp);
         platform_delete_file(temp_file_path);
         if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Decryption failed before HMAC verification", 0);
         log_error(show_error, "Decryption failed!\n");
-        return 0;  // decrypt_result에 상세 에러 정보 포함
+        return decrypt_result;
     }
     
     log_info(show_error, "Decryption completed! Verifying HMAC...\n");
     
     // HMAC 검증
-    FILE_CRYPTO_STATUS hmac_result = verify_file_hmac(ftemp, &header, hmac_key, stored_hmac, buffer, show_error);
+    FILE_CRYPTO_STATUS hmac_result = verify_file_hmac(&hmac_ctx, stored_hmac, show_error);
     if (hmac_result != FILE_CRYPTO_SUCCESS) {
-        free(buffer);
         fclose(ftemp);
         platform_delete_file(temp_file_path);
         if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "HMAC integrity verification failed", 0);
-        return 0;  // hmac_result에 상세 에러 정보 포함
+        return hmac_result;
     }
     
-    // 복호화된 파일 쓰기
-    FILE_CRYPTO_STATUS write_result = write_decrypted_file(ftemp, output_path, &header, final_output_path, 
-                                                          final_path_size, buffer, show_error, progress_cb);
-    if (write_result != FILE_CRYPTO_SUCCESS) {
-        free(buffer);
-        fclose(ftemp);
-        platform_delete_file(temp_file_path);
-        return 0;  // write_result에 상세 에러 정보 포함
+    // 검증된 스테이징 파일을 최종 경로에 게시
+    return publish_staged_output(ftemp, temp_file_path, actual_output_path, buffer,
+                                 final_output_path, final_path_size, show_error, progress_cb);
+}
+
+/**
+ * @brief v6 세그먼트 파일을 복호화합니다 (세그먼트마다 검증 후 스테이징 파일에 기록, 여러 스레드 병렬).
+ * @param fin 입력 파일 포인터 (암호문)
+ * @param header 암호화 파일 헤더
+ * @param hmac_key HMAC 키 (24바이트)
+ * @param ciphertext_size 세그먼트 영역 크기 (바이트, 태그 포함)
+ * @param aes_ctx AES 복호화 컨텍스트
+ * @param nonce_counter CTR 모드 nonce 카운터 (16바이트, 세그먼트 0의 값)
+ * @param buffer 작업용 버퍼 (스테이징 파일을 복사해 게시할 때 사용, FILE_CHUNK_SIZE 이상)
+ * @param output_path 출력 파일 경로 (기본 경로)
+ * @param final_output_path 출력 최종 파일 경로 (확장자 포함, GUI 모드에서는 에러 메시지)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param show_error 에러 메시지 출력 여부
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ * @note 뒤쪽 세그먼트가 실패하면 스테이징 파일을 지우므로 최종 경로에는 검증된 파일만 나타납니다.
+ */
+static FILE_CRYPTO_STATUS decrypt_segmented_content(FILE* fin, const EncFileHeader* header,
+                                                    const uint8_t* hmac_key, int64_t ciphertext_size,
+                                                    const AES_CTX* aes_ctx, uint8_t* nonce_counter,
+                                                    uint8_t* buffer, const char* output_path,
+                                                    char* final_output_path, size_t final_path_size,
+                                                    progress_callback_t progress_cb, void* user_data,
+                                                    int show_error) {
+    char actual_output_path[512];
+    resolve_decrypted_output_path(output_path, header, actual_output_path, sizeof(actual_output_path),
+                                  final_output_path, final_path_size);
+    
+    char staged_path[512];
+    FILE* fstaged = open_staged_output(actual_output_path, staged_path, sizeof(staged_path));
+    if (!fstaged) {
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Cannot create temporary file", 1);
+        log_error(show_error, "Cannot create temporary file.\n");
+        return FILE_CRYPTO_ERR_TEMP_FILE_CREATE;
     }
     
-    free(buffer);
-    fclose(ftemp);
-    platform_delete_file(temp_file_path);
+    HMAC_SHA512_CTX header_ctx;
+    hmac_sha512_init(&header_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)header, sizeof(EncFileHeader));
     
-    // 진행률 완료 표시
-    if (progress_cb) {
-        progress_cb(ciphertext_size, ciphertext_size, user_data);
-    } else {
-        print_progress(ciphertext_size, ciphertext_size, "Decrypting");
-        log_info(!progress_cb, "Decryption completed!\n");
+    // 세그먼트 경계는 파일 크기로 정해지므로 여러 스레드가 검증/복호화를 나눠 처리
+    PipelineProgress progress = { 0, ciphertext_size, progress_cb, user_data, "Decrypting", 0 };
+    FileSegmentJob job;
+    memset(&job, 0, sizeof(job));
+    job.fin = fin;
+    job.fout = fstaged;
+    job.op = SEGMENT_OP_DECRYPT;
+    job.data_size = ciphertext_size;
+    job.in_offset = enc_payload_offset(header);
+    job.out_offset = 0;
+    job.aes_ctx = aes_ctx;
+    job.nonce_counter = nonce_counter;
+    job.header_ctx = &header_ctx;
+    job.on_progress = (ciphertext_size > 0) ? pipeline_progress : NULL;
+    job.user_data = &progress;
+    FILE_CRYPTO_STATUS result = file_segments_run(&job);
+    if (result == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+        log_error(show_error, "Segment %lld failed integrity verification. File may be corrupted, truncated or password is incorrect.\n",
+                  (long long)job.failed_segment);
+    } else if (result != FILE_CRYPTO_SUCCESS) {
+        log_error(show_error, "Segment decryption failed.\n");
+    }
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fclose(fstaged);
+        platform_delete_file(staged_path);
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Segment integrity verification failed", 0);
+        return result;
     }
     
-    return 1;
+    log_info(show_error, "\nAll segments verified. Integrity confirmed.\n");
+    
+    // 검증된 스테이징 파일을 최종 경로에 게시
+    return publish_staged_output(fstaged, staged_path, actual_output_path, buffer,
+                                 final_output_path, final_path_size, show_error, progress_cb);
 }
 
 /**
- * @brief 파일을 복호화합니다 (CLI용).
+ * @brief 암호화 파일 헤더에서 AES 키 길이를 읽습니다 (복호화 전 확인용).
  * @param input_path 입력 파일 경로
- * @param output_path 출력 파일 경로 (기본 경로)
- * @param password 비밀번호
- * @param final_output_path 출력 최종 파일 경로 (확장자 포함)
- * @param final_path_size final_output_path 버퍼 크기
- * @return 1 성공, 0 실패
+ * @return AES 키 길이 (128, 192, 256), 실패 시 0
  */
-int decrypt_file(const char* input_path, const char* output_path,
-                 const char* password, char* final_output_path, size_t final_path_size) {
-    return decrypt_file_internal(input_path, output_path, password, final_output_path, final_path_size, NULL, NULL);
+int read_aes_key_length(const char* input_path) {
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) {
+        return 0;
+    }
+    
+    EncFileHeader header;
+    if (fread(&header, 1, sizeof(header), fin) != sizeof(header)) {
+        fclose(fin);
+        return 0;
+    }
+    
+    // 시그니처 검증 (파일 앞에 없으면 v10 트레일러)
+    int valid = (memcmp(header.signature, ENC_SIGNATURE, 4) == 0);
+    if (!valid && platform_fseek64(fin, 0, SEEK_END) == 0) {
+        valid = in_place_read_trailer(fin, platform_ftell64(fin), &header);
+    }
+    fclose(fin);
+    if (!valid) {
+        return 0;
+    }
+    
+    // 키 길이 코드에서 실제 키 길이 반환
+    if (header.key_length_code == KEY_LENGTH_CODE_128) return 128;
+    else if (header.key_length_code == KEY_LENGTH_CODE_192) return 192;
+    else if (header.key_length_code == KEY_LENGTH_CODE_256) return 256;
+    else return 0;
 }
 
 /**
- * @brief 파일을 복호화합니다 (GUI용, 진행률 콜백 지원).
+ * @brief 파일 복호화 내부 구현 함수 (진행률 콜백 지원).
  * @param input_path 입력 파일 경로
  * @param output_path 출력 파일 경로 (기본 경로)
  * @param password 비밀번호
@@ -1032,27 +2742,3083 @@ int decrypt_file(const char* input_path, const char* output_path,
  * @param user_data 콜백에 전달할 사용자 데이터
  * @return 1 성공, 0 실패
  */
-int decrypt_file_with_progress(const char* input_path, const char* output_path,
-                               const char* password, char* final_output_path, size_t final_path_size,
-                               progress_callback_t progress_cb, void* user_data) {
-    return decrypt_file_internal(input_path, output_path, password, final_output_path, final_path_size, progress_cb, user_data);
-}
-
-/***** 깃허브 주소 https://github.com/SWTEAM4/final_swproject *****/
-int main(void) {
-    // OpenSSL 활성화 여부 확인 (런타임 체크)
-    // crypto_random_bytes가 호출되면 자동으로 OpenSSL을 로드 시도함
-#ifndef NDEBUG
-    uint8_t test_buf[1];
-    if (crypto_random_bytes(test_buf, 1) == CRYPTO_SUCCESS) {
-        printf("OpenSSL enabled (loaded at runtime)\n");
-    } else {
-        printf("OpenSSL not available (will use fallback rand())\n");
+static int decrypt_file_internal(const char* input_path, const char* output_path,
+                                  const char* password, char* final_output_path, size_t final_path_size,
+                                  progress_callback_t progress_cb, void* user_data) {
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) {
+        log_error(!progress_cb, "Cannot open file: %s\n", input_path);
+        return 0;
     }
-#endif
     
-    // 시드 초기화 (프로그램 시작 시 한 번만)
-    srand((unsigned int)time(NULL));
+    // 파일 버퍼링 최적화 (모든 플랫폼)
+    setvbuf(fin, NULL, _IOFBF, FILE_BUFFER_SIZE);
+    
+    // 헤더 읽기 및 검증
+    EncFileHeader header;
+    int64_t file_size, ciphertext_size;
+    int show_error = (progress_cb == NULL);
+    
+    FILE_CRYPTO_STATUS header_result = read_and_validate_header(fin, &header, &file_size, &ciphertext_size, show_error);
+    if (header_result != FILE_CRYPTO_SUCCESS) {
+        fclose(fin);
+        return 0;  // header_result에 상세 에러 정보 포함
+    }
+    
+    // 암호화 메타데이터 읽기 (HMAC, 키 길이, salt)
+    uint8_t stored_hmac[ENC_HMAC_SIZE];
+    int aes_key_bits;
+    const uint8_t* pbkdf2_salt = NULL;
+    size_t pbkdf2_salt_len = 0;
+    
+    FILE_CRYPTO_STATUS metadata_result = read_encryption_metadata(fin, &header, stored_hmac, &aes_key_bits, 
+                                                                 &pbkdf2_salt, &pbkdf2_salt_len, show_error);
+    if (metadata_result != FILE_CRYPTO_SUCCESS) {
+        fclose(fin);
+        return 0;  // metadata_result에 상세 에러 정보 포함
+    }
+    
+    // 키 도출 (v9는 키 슬롯에서 데이터 키를 꺼냄)
+    uint8_t aes_key[32];
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    derive_file_keys(fin, &header, password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, hmac_key);
+    
+    // 키 확인 값 검증 (v3 이상): 잘못된 비밀번호는 데이터를 읽기 전에 거부
+    FILE_CRYPTO_STATUS kcv_result = verify_key_check_value(&header, hmac_key, show_error);
+    if (kcv_result != FILE_CRYPTO_SUCCESS) {
+        fclose(fin);
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Incorrect password", 0);
+        return 0;  // FILE_CRYPTO_ERR_KEY_CHECK_FAILED
+    }
+    
+    // AES 컨텍스트 설정
+    AES_CTX aes_ctx;
+    if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+        fclose(fin);
+        return 0;  // FILE_CRYPTO_ERR_DECRYPTION_FAILED (AES 키 설정 실패)
+    }
+    
+    // CTR 모드용 nonce_counter
+    uint8_t nonce_counter[16];
+    memcpy(nonce_counter, header.nonce, 8);
+    memset(nonce_counter + 8, 0, 8);
+    
+    log_info(!progress_cb, "Decrypting...\n");
+    
+    // 암호문 읽기 및 복호화를 위한 버퍼 할당 (v6 세그먼트 버퍼는 작업 스레드마다 따로 할당)
+    uint8_t* buffer = (uint8_t*)malloc(FILE_CHUNK_SIZE);
+    if (!buffer) {
+        fclose(fin);
+        return 0;  // FILE_CRYPTO_ERR_MEMORY_ALLOCATION
+    }
+    
+    FILE_CRYPTO_STATUS result;
+    if (header.version == ENC_VERSION_STREAM) {
+        // v6: 세그먼트마다 태그 검증 후 복호화 (세그먼트 단위 병렬)
+        result = decrypt_segmented_content(fin, &header, hmac_key, ciphertext_size,
+                                           &aes_ctx, nonce_counter, buffer, output_path,
+                                           final_output_path, final_path_size,
+                                           progress_cb, user_data, show_error);
+    } else if (header.version == ENC_VERSION_INCREMENTAL) {
+        // v8: 루트 태그 검증 후 청크마다 태그 검증, 스테이징 파일에 복호화
+        result = decrypt_incremental_content(fin, &header, hmac_key, stored_hmac, ciphertext_size,
+                                             &aes_ctx, buffer, output_path, final_output_path, final_path_size,
+                                             progress_cb, user_data, show_error);
+    } else if (header.version >= ENC_VERSION_ETM) {
+        // v4: 암호문 HMAC 검증 후 출력 파일에 바로 복호화
+        result = decrypt_etm_content(fin, &header, hmac_key, stored_hmac, ciphertext_size,
+                                     &aes_ctx, nonce_counter, buffer, output_path,
+                                     final_output_path, final_path_size,
+                                     progress_cb, user_data, show_error);
+    } else {
+        // v2/v3: 임시 파일에 복호화 후 평문 HMAC 검증
+        result = decrypt_legacy_content(fin, &header, hmac_key, stored_hmac, ciphertext_size,
+                                        &aes_ctx, nonce_counter, buffer, output_path,
+                                        final_output_path, final_path_size,
+                                        progress_cb, user_data, show_error);
+    }
+    
+    free(buffer);
+    fclose(fin);
+    
+    if (result != FILE_CRYPTO_SUCCESS) {
+        return 0;  // result에 상세 에러 정보 포함
+    }
+    
+    // 진행률 완료 표시
+    if (progress_cb) {
+        progress_cb(ciphertext_size, ciphertext_size, user_data);
+    } else {
+        print_progress(ciphertext_size, ciphertext_size, "Decrypting");
+        log_info(!progress_cb, "Decryption completed!\n");
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief 파일을 복호화합니다 (CLI용).
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 파일 경로 (기본 경로)
+ * @param password 비밀번호
+ * @param final_output_path 출력 최종 파일 경로 (확장자 포함)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @return 1 성공, 0 실패
+ */
+int decrypt_file(const char* input_path, const char* output_path,
+                 const char* password, char* final_output_path, size_t final_path_size) {
+    return decrypt_file_internal(input_path, output_path, password, final_output_path, final_path_size, NULL, NULL);
+}
+
+/**
+ * @brief 파일을 복호화합니다 (GUI용, 진행률 콜백 지원).
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 파일 경로 (기본 경로)
+ * @param password 비밀번호
+ * @param final_output_path 출력 최종 파일 경로 (확장자 포함)
+ * @param final_path_size final_output_path 버퍼 크기
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return 1 성공, 0 실패
+ */
+int decrypt_file_with_progress(const char* input_path, const char* output_path,
+                               const char* password, char* final_output_path, size_t final_path_size,
+                               progress_callback_t progress_cb, void* user_data) {
+    return decrypt_file_internal(input_path, output_path, password, final_output_path, final_path_size, progress_cb, user_data);
+}
+
+/**
+ * @brief 스트림을 v6 세그먼트 형식으로 암호화합니다 (탐색 없음, 파이프/소켓 지원).
+ * @param in 입력 스트림 (평문, 끝까지 읽음)
+ * @param out 출력 스트림 (암호문)
+ * @param aes_key_bits AES 키 길이 (128, 192, 256)
+ * @param password 비밀번호
+ * @return 1 성공, 0 실패
+ * @note 메모리 사용은 세그먼트 버퍼 하나로 고정됩니다. 출력 스트림을 오염시키지 않도록
+ *       메시지를 출력하지 않으며, 원본 확장자는 기록하지 않습니다.
+ */
+int encrypt_stream(FILE* in, FILE* out, int aes_key_bits, const char* password) {
+    if (!in || !out || !password) return 0;
+    if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) return 0;
+    
+    // Salt 생성 및 키 도출
+    uint8_t salt[ENC_SALT_SIZE];
+    generate_salt(salt, sizeof(salt));
+    
+    uint8_t aes_key[32];
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    derive_keys(password, aes_key_bits, salt, sizeof(salt), aes_key, hmac_key);
+    
+    uint8_t key_check[ENC_KCV_SIZE];
+    derive_key_check_value(hmac_key, key_check, sizeof(key_check));
+    
+    AES_CTX aes_ctx;
+    if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) return 0;
+    
+    uint8_t nonce[8];
+    generate_nonce(nonce, 8);
+    uint8_t nonce_counter[16];
+    memcpy(nonce_counter, nonce, 8);
+    memset(nonce_counter + 8, 0, 8);
+    
+    // 헤더 (입력 경로가 없으므로 확장자 비움)
+    EncFileHeader header;
+    if (create_encryption_header("", aes_key_bits, salt, nonce, key_check,
+                                 ENC_VERSION_STREAM, &header) != FILE_CRYPTO_SUCCESS) {
+        return 0;
+    }
+    if (fwrite(&header, 1, sizeof(header), out) != sizeof(header)) return 0;
+    
+    HMAC_SHA512_CTX header_ctx;
+    hmac_sha512_init(&header_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)&header, sizeof(header));
+    
+    uint8_t* buffer = (uint8_t*)malloc(ENC_SEGMENT_SIZE + ENC_HMAC_SIZE);
+    if (!buffer) return 0;  // FILE_CRYPTO_ERR_MEMORY_ALLOCATION
+    
+    FILE_CRYPTO_STATUS result = encrypt_segments(in, out, &aes_ctx, nonce_counter, &header_ctx, buffer);
+    free(buffer);
+    
+    if (result != FILE_CRYPTO_SUCCESS) return 0;
+    return (fflush(out) == 0) ? 1 : 0;
+}
+
+/**
+ * @brief v6 세그먼트 형식 스트림을 복호화합니다 (탐색 없음, 파이프/소켓 지원).
+ * @param in 입력 스트림 (암호문)
+ * @param out 출력 스트림 (평문)
+ * @param password 비밀번호
+ * @return 1 성공, 0 실패 (잘못된 비밀번호, 지원하지 않는 형식, 태그 불일치, 잘림)
+ * @note 세그먼트 평문은 태그 검증 후에만 출력되지만, 뒤쪽 세그먼트에서 실패하면 그 앞까지의
+ *       평문은 이미 출력된 상태이므로 호출자는 반환값으로 결과 전체를 판단해야 합니다.
+ */
+int decrypt_stream(FILE* in, FILE* out, const char* password) {
+    if (!in || !out || !password) return 0;
+    
+    EncFileHeader header;
+    if (fread(&header, 1, sizeof(header), in) != sizeof(header)) return 0;  // FILE_CRYPTO_ERR_INVALID_HEADER
+    if (memcmp(header.signature, ENC_SIGNATURE, 4) != 0) return 0;        // FILE_CRYPTO_ERR_INVALID_SIGNATURE
+    
+    // 탐색 없이 처리할 수 있는 형식은 v6뿐 (v2~v5는 전체 HMAC이 암호문 앞에 있음)
+    if (header.version != ENC_VERSION_STREAM) return 0;  // FILE_CRYPTO_ERR_UNSUPPORTED_VERSION
+    
+    uint8_t stored_hmac[ENC_HMAC_SIZE];
+    int aes_key_bits;
+    const uint8_t* pbkdf2_salt = NULL;
+    size_t pbkdf2_salt_len = 0;
+    if (read_encryption_metadata(in, &header, stored_hmac, &aes_key_bits,
+                                 &pbkdf2_salt, &pbkdf2_salt_len, 0) != FILE_CRYPTO_SUCCESS) {
+        return 0;
+    }
+    
+    uint8_t aes_key[32];
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    derive_keys(password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, hmac_key);
+    if (verify_key_check_value(&header, hmac_key, 0) != FILE_CRYPTO_SUCCESS) return 0;
+    
+    AES_CTX aes_ctx;
+    if (AES_set_key(&aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) return 0;
+    
+    uint8_t nonce_counter[16];
+    memcpy(nonce_counter, header.nonce, 8);
+    memset(nonce_counter + 8, 0, 8);
+    
+    HMAC_SHA512_CTX header_ctx;
+    hmac_sha512_init(&header_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)&header, sizeof(header));
+    
+    uint8_t* buffer = (uint8_t*)malloc(ENC_SEGMENT_SIZE + ENC_HMAC_SIZE);
+    if (!buffer) return 0;  // FILE_CRYPTO_ERR_MEMORY_ALLOCATION
+    
+    FILE_CRYPTO_STATUS result = decrypt_segments(in, out, &aes_ctx, nonce_counter, &header_ctx, buffer,
+                                                 0, NULL, NULL, 0);
+    free(buffer);
+    
+    if (result != FILE_CRYPTO_SUCCESS) return 0;
+    return (fflush(out) == 0) ? 1 : 0;
+}
+
+// encrypt_append가 이어 붙일 데이터 (메모리 또는 스트림)
+typedef struct {
+    const uint8_t* data;                // 메모리 데이터 (in이 NULL일 때)
+    size_t remaining;                   // 메모리 데이터의 남은 길이
+    FILE* in;                           // 스트림 (NULL이면 메모리 데이터 사용)
+} AppendSource;
+
+/**
+ * @brief 이어 붙일 데이터를 최대 capacity바이트 읽습니다.
+ * @param source 데이터 출처
+ * @param dst 출력 버퍼
+ * @param capacity 읽을 최대 길이
+ * @param length 출력 읽은 길이 (capacity보다 작으면 데이터 끝)
+ * @return FILE_CRYPTO_SUCCESS 성공, FILE_CRYPTO_ERR_FILE_READ 스트림 읽기 오류
+ */
+static FILE_CRYPTO_STATUS append_source_read(AppendSource* source, uint8_t* dst, size_t capacity, size_t* length) {
+    if (source->in) {
+        *length = fread(dst, 1, capacity, source->in);
+        return ferror(source->in) ? FILE_CRYPTO_ERR_FILE_READ : FILE_CRYPTO_SUCCESS;
+    }
+    
+    *length = (source->remaining < capacity) ? source->remaining : capacity;
+    if (*length > 0) {
+        memcpy(dst, source->data, *length);
+        source->data += *length;
+        source->remaining -= *length;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+// 추가 저널 태그: HMAC(HMAC 키, 레코드 앞부분 || 꼬리)의 앞 32바이트
+static void append_journal_tag(const uint8_t* hmac_key, const EncAppendJournal* record,
+                               const uint8_t* tail, size_t tail_length, uint8_t* tag) {
+    uint8_t full[ENC_HMAC_SIZE];
+    HMAC_SHA512_CTX ctx;
+    hmac_sha512_init(&ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&ctx, (const uint8_t*)record, offsetof(EncAppendJournal, tag));
+    hmac_sha512_update(&ctx, tail, tail_length);
+    hmac_sha512_final(&ctx, full);
+    memcpy(tag, full, sizeof(record->tag));
+}
+
+/**
+ * @brief 마지막 세그먼트를 다시 쓰기 전에 그 암호문과 태그를 저널에 기록하고 디스크에 반영합니다.
+ * @param journal_path 저널 경로
+ * @param hmac_key HMAC 키
+ * @param tail_offset 마지막 세그먼트 위치
+ * @param tail 마지막 세그먼트의 암호문과 태그 (파일 끝까지)
+ * @param tail_length tail 길이
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_OPEN / FILE_CRYPTO_ERR_FILE_WRITE
+ */
+static FILE_CRYPTO_STATUS append_journal_write(const char* journal_path, const uint8_t* hmac_key,
+                                               int64_t tail_offset, const uint8_t* tail, size_t tail_length) {
+    EncAppendJournal record;
+    memset(&record, 0, sizeof(record));
+    memcpy(record.signature, ENC_APPEND_JOURNAL_SIGNATURE, 4);
+    enc_store_be64(record.file_size, (uint64_t)tail_offset + tail_length);
+    enc_store_be64(record.tail_offset, (uint64_t)tail_offset);
+    append_journal_tag(hmac_key, &record, tail, tail_length, record.tag);
+    
+    FILE* journal = platform_fopen(journal_path, "wb");
+    if (!journal) return FILE_CRYPTO_ERR_FILE_OPEN;
+    int ok = (fwrite(&record, 1, sizeof(record), journal) == sizeof(record) &&
+              fwrite(tail, 1, tail_length, journal) == tail_length &&
+              platform_sync_stream(journal));
+    if (fclose(journal) != 0) ok = 0;
+    return ok ? FILE_CRYPTO_SUCCESS : FILE_CRYPTO_ERR_FILE_WRITE;
+}
+
+/**
+ * @brief 추가 저널이 있으면 마지막 세그먼트와 파일 크기를 추가 전으로 되돌리고 저널을 삭제합니다.
+ * @param file 대상 파일 ("r+b")
+ * @param journal_path 저널 경로
+ * @param hmac_key HMAC 키 (저널 태그 확인)
+ * @param buffer 작업 버퍼 (FILE_SEGMENT_BUFFER_SIZE)
+ * @return FILE_CRYPTO_SUCCESS (저널 없음 또는 정리 완료) 또는 FILE_CRYPTO_ERR_FILE_WRITE
+ * @note 저널은 대상 파일을 바꾸기 전에 디스크에 반영하므로, 태그가 맞지 않는 (기록 도중 끊긴) 저널이면
+ *       파일은 아직 그대로이고 저널만 지웁니다.
+ */
+static FILE_CRYPTO_STATUS append_journal_recover(FILE* file, const char* journal_path, const uint8_t* hmac_key,
+                                                 uint8_t* buffer) {
+    if (!platform_file_exists(journal_path)) return FILE_CRYPTO_SUCCESS;
+    
+    EncAppendJournal record;
+    uint64_t file_size = 0;
+    uint64_t tail_offset = 0;
+    size_t tail_length = 0;
+    int valid = 0;
+    FILE* journal = platform_fopen(journal_path, "rb");
+    if (!journal) return FILE_CRYPTO_ERR_FILE_OPEN;
+    if (fread(&record, 1, sizeof(record), journal) == sizeof(record) &&
+        memcmp(record.signature, ENC_APPEND_JOURNAL_SIGNATURE, 4) == 0) {
+        file_size = enc_load_be64(record.file_size);
+        tail_offset = enc_load_be64(record.tail_offset);
+        if (tail_offset >= sizeof(EncFileHeader) && tail_offset <= file_size &&
+            file_size - tail_offset <= FILE_SEGMENT_BUFFER_SIZE) {
+            tail_length = (size_t)(file_size - tail_offset);
+            uint8_t tag[sizeof(record.tag)];
+            if (fread(buffer, 1, tail_length, journal) == tail_length) {
+                append_journal_tag(hmac_key, &record, buffer, tail_length, tag);
+                valid = (memcmp(tag, record.tag, sizeof(tag)) == 0);
+            }
+        }
+    }
+    fclose(journal);
+    
+    if (valid && (!platform_pwrite(file, buffer, tail_length, (int64_t)tail_offset) ||
+                  !platform_truncate_stream(file, (int64_t)file_size) ||
+                  !platform_sync_stream(file))) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;  // 저널은 남겨 두고 다음 추가에서 다시 되돌림
+    }
+    return platform_delete_file(journal_path) ? FILE_CRYPTO_SUCCESS : FILE_CRYPTO_ERR_FILE_WRITE;
+}
+
+/**
+ * @brief 이어 붙일 v6 파일을 열고 키와 마지막 세그먼트 위치를 구합니다 (파일이 없으면 헤더를 새로 기록).
+ * @param file 대상 파일 ("r+b" 또는 새로 만든 "w+b")
+ * @param create 1이면 새 파일 (aes_key_bits로 헤더 생성)
+ * @param aes_key_bits 새 파일의 AES 키 길이
+ * @param password 비밀번호
+ * @param journal_path 추가 저널 경로 (기존 파일에 남은 저널은 먼저 되돌림)
+ * @param buffer 작업 버퍼 (FILE_SEGMENT_BUFFER_SIZE)
+ * @param header 출력 헤더
+ * @param aes_ctx 출력 AES 컨텍스트
+ * @param hmac_key 출력 HMAC 키
+ * @param last_index 출력 마지막 세그먼트 번호 (새 파일이면 0)
+ * @param last_length 출력 마지막 세그먼트 길이 (새 파일이면 0)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS open_append_target(FILE* file, int create, int aes_key_bits, const char* password,
+                                             const char* journal_path, uint8_t* buffer,
+                                             EncFileHeader* header, AES_CTX* aes_ctx, uint8_t* hmac_key,
+                                             uint64_t* last_index, size_t* last_length) {
+    uint8_t aes_key[32];
+    *last_index = 0;
+    *last_length = 0;
+    
+    if (create) {
+        uint8_t salt[ENC_SALT_SIZE];
+        uint8_t nonce[8];
+        uint8_t key_check[ENC_KCV_SIZE];
+        generate_salt(salt, sizeof(salt));
+        generate_nonce(nonce, sizeof(nonce));
+        derive_keys(password, aes_key_bits, salt, sizeof(salt), aes_key, hmac_key);
+        derive_key_check_value(hmac_key, key_check, sizeof(key_check));
+        
+        // 입력 경로가 없으므로 확장자 비움 (encrypt_stream과 같은 헤더)
+        FILE_CRYPTO_STATUS result = create_encryption_header("", aes_key_bits, salt, nonce, key_check,
+                                                             ENC_VERSION_STREAM, header);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        if (!platform_pwrite(file, header, sizeof(*header), 0)) return FILE_CRYPTO_ERR_FILE_WRITE;
+    } else {
+        int64_t file_size = (platform_fseek64(file, 0, SEEK_END) == 0) ? platform_ftell64(file) : -1;
+        if (file_size < (int64_t)sizeof(*header) ||
+            platform_pread(file, header, sizeof(*header), 0) != (int64_t)sizeof(*header)) {
+            return FILE_CRYPTO_ERR_INVALID_HEADER;
+        }
+        if (memcmp(header->signature, ENC_SIGNATURE, 4) != 0) return FILE_CRYPTO_ERR_INVALID_SIGNATURE;
+        
+        // 세그먼트마다 태그가 있는 v6만 앞부분을 건드리지 않고 이어 붙일 수 있음
+        if (header->version != ENC_VERSION_STREAM) return FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
+        
+        uint8_t stored_hmac[ENC_HMAC_SIZE];
+        const uint8_t* pbkdf2_salt = NULL;
+        size_t pbkdf2_salt_len = 0;
+        FILE_CRYPTO_STATUS result = read_encryption_metadata(file, header, stored_hmac, &aes_key_bits,
+                                                             &pbkdf2_salt, &pbkdf2_salt_len, 0);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        
+        derive_keys(password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, hmac_key);
+        result = verify_key_check_value(header, hmac_key, 0);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        
+        // 중단된 추가가 있으면 마지막 세그먼트와 크기를 되돌린 뒤 다시 크기를 구함
+        result = append_journal_recover(file, journal_path, hmac_key, buffer);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        file_size = (platform_fseek64(file, 0, SEEK_END) == 0) ? platform_ftell64(file) : -1;
+        
+        uint64_t count;
+        if (!file_segment_layout(file_size - (int64_t)sizeof(*header), &count, last_length)) {
+            return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;  // 마지막 태그 자리가 없는 잘린 파일
+        }
+        *last_index = count - 1;
+    }
+    
+    CRYPTO_STATUS status = AES_set_key(aes_ctx, aes_key, aes_key_bits);
+    memset(aes_key, 0, sizeof(aes_key));
+    return (status == CRYPTO_SUCCESS) ? FILE_CRYPTO_SUCCESS : FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+}
+
+/**
+ * @brief v6 파일 끝에 데이터를 이어 붙입니다.
+ * @param path 대상 v6 파일 경로 (없으면 새로 만듦)
+ * @param source 이어 붙일 데이터
+ * @param aes_key_bits 새 파일의 AES 키 길이 (기존 파일은 헤더의 키 길이 사용)
+ * @param password 비밀번호
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ * @note 마지막 세그먼트(ENC_SEGMENT_SIZE 미만)의 태그를 검증해 평문을 얻고, 새 데이터로 채운 뒤
+ *       세그먼트 시작 카운터부터 다시 암호화합니다. CTR은 같은 위치의 같은 평문을 같은 암호문으로
+ *       만들므로 기존 바이트는 그대로이고, 그 뒤의 새 암호문과 태그만 기록합니다.
+ *       새 바이트는 저장된 길이 다음 카운터부터 암호화되어 키스트림이 재사용되지 않습니다.
+ *       앞쪽 세그먼트는 읽지도 쓰지도 않으므로 비용은 추가한 양과 세그먼트 하나에 비례합니다.
+ *       덮어쓰는 태그는 기존 꼬리를 저널에 기록한 뒤에만 바꾸고, 실패하면 바로 되돌립니다.
+ */
+static FILE_CRYPTO_STATUS encrypt_append_internal(const char* path, AppendSource* source,
+                                                  int aes_key_bits, const char* password) {
+    if (!path || !password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    int create = !platform_file_exists(path);
+    if (create && aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) {
+        return FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    }
+    
+    char journal_path[MAX_PATH_LENGTH];
+    int written = snprintf(journal_path, sizeof(journal_path), "%s%s", path, ENC_APPEND_JOURNAL_SUFFIX);
+    if (written < 0 || (size_t)written >= sizeof(journal_path)) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (create) platform_delete_file(journal_path);  // 지워진 파일의 저널은 새 파일과 무관
+    
+    uint8_t* buffer = (uint8_t*)malloc(FILE_SEGMENT_BUFFER_SIZE);
+    if (!buffer) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    FILE* file = platform_fopen(path, create ? "w+b" : "r+b");
+    if (!file) {
+        free(buffer);
+        return FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+    
+    EncFileHeader header;
+    AES_CTX aes_ctx;
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    uint64_t index;
+    size_t fill;
+    FILE_CRYPTO_STATUS result = open_append_target(file, create, aes_key_bits, password, journal_path, buffer,
+                                                   &header, &aes_ctx, hmac_key, &index, &fill);
+    if (result != FILE_CRYPTO_SUCCESS) {
+        memset(hmac_key, 0, sizeof(hmac_key));
+        free(buffer);
+        fclose(file);
+        return result;
+    }
+    
+    uint8_t nonce_counter[16];
+    memcpy(nonce_counter, header.nonce, 8);
+    memset(nonce_counter + 8, 0, 8);
+    
+    HMAC_SHA512_CTX header_ctx;
+    hmac_sha512_init(&header_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&header_ctx, (const uint8_t*)&header, sizeof(header));
+    
+    uint8_t counter[16];
+    HMAC_SHA512_CTX segment_ctx;
+    int64_t position = (int64_t)sizeof(header) + (int64_t)index * (ENC_SEGMENT_SIZE + ENC_HMAC_SIZE);
+    int journaled = 0;   // 기존 꼬리를 저널에 기록함
+    int rewriting = 0;   // 기존 꼬리를 덮어쓰기 시작함 (실패하면 저널로 되돌림)
+    
+    // 기존 마지막 세그먼트를 저널에 보관한 뒤 검증 및 복호화 (손상된 꼬리에는 이어 붙이지 않음)
+    if (!create) {
+        uint8_t computed_tag[ENC_HMAC_SIZE];
+        file_segment_counter(nonce_counter, index, counter);
+        file_segment_begin_tag(&header_ctx, index, 1, &segment_ctx);
+        if (platform_pread(file, buffer, fill + ENC_HMAC_SIZE, position) != (int64_t)(fill + ENC_HMAC_SIZE)) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+        } else {
+            result = append_journal_write(journal_path, hmac_key, position, buffer, fill + ENC_HMAC_SIZE);
+            journaled = (result == FILE_CRYPTO_SUCCESS);
+        }
+        if (result == FILE_CRYPTO_SUCCESS &&
+            AES_CTR_HMAC_crypt(&aes_ctx, buffer, fill, buffer, counter,
+                               &segment_ctx, AES_CTR_HMAC_MAC_INPUT) != CRYPTO_SUCCESS) {
+            result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+        } else if (result == FILE_CRYPTO_SUCCESS) {
+            hmac_sha512_final(&segment_ctx, computed_tag);
+            if (memcmp(computed_tag, buffer + fill, ENC_HMAC_SIZE) != 0) {
+                result = FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+            }
+        }
+    }
+    
+    // 마지막 세그먼트를 채우고 이어서 새 세그먼트 기록 (가득 찬 세그먼트 뒤에는 항상 마지막 세그먼트가 따름)
+    while (result == FILE_CRYPTO_SUCCESS) {
+        size_t added;
+        result = append_source_read(source, buffer + fill, ENC_SEGMENT_SIZE - fill, &added);
+        if (result != FILE_CRYPTO_SUCCESS) break;
+        
+        size_t length = fill + added;
+        int is_final = (length < ENC_SEGMENT_SIZE);
+        file_segment_counter(nonce_counter, index, counter);
+        file_segment_begin_tag(&header_ctx, index, is_final, &segment_ctx);
+        if (AES_CTR_HMAC_crypt(&aes_ctx, buffer, length, buffer, counter,
+                               &segment_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+            result = FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+            break;
+        }
+        hmac_sha512_final(&segment_ctx, buffer + length);
+        
+        // 앞의 fill바이트는 기존 암호문과 같으므로 새 암호문과 태그만 기록
+        rewriting = 1;
+        if (!platform_pwrite(file, buffer + fill, added + ENC_HMAC_SIZE, position + (int64_t)fill)) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+            break;
+        }
+        if (is_final) break;
+        
+        index++;
+        fill = 0;
+        position += ENC_SEGMENT_SIZE + ENC_HMAC_SIZE;
+    }
+    
+    // 새 꼬리가 디스크에 반영된 뒤에만 저널 삭제 (실패하면 기존 꼬리로 되돌리고, 되돌리지 못하면 저널을 남김)
+    if (result == FILE_CRYPTO_SUCCESS && !platform_sync_stream(file)) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    if (journaled) {
+        if (result != FILE_CRYPTO_SUCCESS && rewriting) {
+            append_journal_recover(file, journal_path, hmac_key, buffer);
+        } else {
+            platform_delete_file(journal_path);
+        }
+    }
+    
+    memset(&aes_ctx, 0, sizeof(aes_ctx));
+    memset(hmac_key, 0, sizeof(hmac_key));
+    memset(buffer, 0, FILE_SEGMENT_BUFFER_SIZE);
+    free(buffer);
+    if (fclose(file) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    return result;
+}
+
+FILE_CRYPTO_STATUS encrypt_append(const char* path, const void* data, size_t length,
+                                  int aes_key_bits, const char* password) {
+    if (!data && length > 0) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    AppendSource source = { (const uint8_t*)data, length, NULL };
+    return encrypt_append_internal(path, &source, aes_key_bits, password);
+}
+
+FILE_CRYPTO_STATUS encrypt_append_stream(const char* path, FILE* in, int aes_key_bits, const char* password) {
+    if (!in) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    AppendSource source = { NULL, 0, in };
+    return encrypt_append_internal(path, &source, aes_key_bits, password);
+}
+
+// 임의 위치 읽기 핸들
+struct EncReader {
+    FILE* fin;                          // 암호화 파일 (위치 지정 읽기)
+    EncFileHeader header;               // 파일 헤더
+    AES_CTX aes_ctx;                    // 키 도출은 열 때 한 번
+    uint8_t nonce_counter[16];          // 평문 오프셋 0의 CTR 카운터
+    HMAC_SHA512_CTX header_ctx;         // v6/v8: 헤더까지 업데이트된 세그먼트(청크) 태그 시작 상태
+    int64_t payload_offset;             // 암호문 시작 위치
+    int64_t plaintext_size;             // 평문 전체 크기
+    int64_t file_size;                  // 암호화 파일 전체 크기 (검증 진행률 기준)
+    uint64_t segment_count;             // v6/v8: 세그먼트(청크) 수
+    size_t final_length;                // v6/v8: 마지막 세그먼트(청크) 길이
+    uint8_t* segment;                   // v6/v8: 마지막으로 검증한 세그먼트(청크)의 평문 (+ 태그 자리)
+    int64_t cached_segment;             // segment에 든 세그먼트(청크) 번호 (-1이면 없음)
+    EncChunkMeta* chunk_metas;          // v8: 루트 태그로 검증한 청크 메타데이터
+    CompressedStream* stream;           // v7: 순차 복원 상태 (앞으로 읽으면 이어서, 뒤로 읽으면 처음부터 복원)
+    int64_t block_offset;               // v7: 현재 블록의 평문 시작 위치
+    const uint8_t* block;               // v7: 현재 블록 평문 (stream 버퍼 안)
+    size_t block_length;                // v7: 현재 블록 길이
+};
+
+/**
+ * @brief v2/v3 파일의 평문 HMAC을 검증합니다 (출력 없이 복호화만 해서 계산).
+ * @param reader 읽기 핸들 (키와 헤더 설정 완료)
+ * @param hmac_key HMAC 키
+ * @param stored_hmac 파일에 저장된 HMAC
+ * @param buffer 작업용 버퍼 (FILE_CHUNK_SIZE 크기)
+ * @param progress_total 진행률 보고 시 전체 크기 (0이면 보고하지 않음)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS verify_legacy_plaintext_hmac(EncReader* reader, const uint8_t* hmac_key,
+                                                       const uint8_t* stored_hmac, uint8_t* buffer,
+                                                       int64_t progress_total, progress_callback_t progress_cb,
+                                                       void* user_data) {
+    HMAC_SHA512_CTX hmac_ctx;
+    hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)&reader->header, sizeof(EncFileHeader));
+    
+    uint8_t counter[16];
+    memcpy(counter, reader->nonce_counter, 16);
+    for (int64_t done = 0; done < reader->plaintext_size; ) {
+        size_t length = (reader->plaintext_size - done < FILE_CHUNK_SIZE) ?
+                        (size_t)(reader->plaintext_size - done) : FILE_CHUNK_SIZE;
+        if (platform_pread(reader->fin, buffer, length, reader->payload_offset + done) != (int64_t)length) {
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        // 평문에 HMAC (v2/v3 방식)
+        if (AES_CTR_HMAC_crypt(&reader->aes_ctx, buffer, length, buffer, counter,
+                               &hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+            return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+        }
+        done += (int64_t)length;
+        update_progress_with_callback(reader->payload_offset + done, progress_total, progress_cb, user_data,
+                                      "Verifying", 0);
+    }
+    
+    return verify_file_hmac(&hmac_ctx, stored_hmac, 0);
+}
+
+/**
+ * @brief 암호화 파일을 열어 비밀번호와 전체 HMAC(v2~v5, v7, v9, v10)을 확인합니다 (enc_open, 검증 공통).
+ * @param path 암호화 파일 경로
+ * @param password 비밀번호
+ * @param progress_cb 진행률 콜백 함수 (NULL이면 보고하지 않음, 전체 크기는 암호화 파일 크기)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param out_reader 출력 읽기 핸들 (실패 시 NULL)
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED (잘못된 비밀번호),
+ *         FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED (손상/변조) 등
+ * @note v6은 세그먼트 구조만 확인하고 태그는 읽을 때 검증합니다. v8은 청크 메타데이터만 읽어
+ *       루트 태그를 검증하고 청크 태그는 읽을 때 검증합니다. 전체 HMAC 하나뿐인
+ *       v2~v5, v7은 여기서 파일 전체를 한 번 검증하므로 큰 파일은 열기가 오래 걸립니다.
+ */
+static FILE_CRYPTO_STATUS enc_open_verified(const char* path, const char* password,
+                                            progress_callback_t progress_cb, void* user_data,
+                                            EncReader** out_reader) {
+    *out_reader = NULL;
+    if (!path || !password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    EncReader* reader = (EncReader*)calloc(1, sizeof(EncReader));
+    if (!reader) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    reader->cached_segment = -1;
+    
+    reader->fin = platform_fopen(path, "rb");
+    if (!reader->fin) {
+        free(reader);
+        return FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+    
+    int64_t ciphertext_size;
+    uint8_t stored_hmac[ENC_HMAC_SIZE];
+    int aes_key_bits;
+    const uint8_t* pbkdf2_salt = NULL;
+    size_t pbkdf2_salt_len = 0;
+    FILE_CRYPTO_STATUS result = read_and_validate_header(reader->fin, &reader->header, &reader->file_size,
+                                                         &ciphertext_size, 0);
+    if (result == FILE_CRYPTO_SUCCESS) {
+        result = read_encryption_metadata(reader->fin, &reader->header, stored_hmac, &aes_key_bits,
+                                          &pbkdf2_salt, &pbkdf2_salt_len, 0);
+    }
+    if (result != FILE_CRYPTO_SUCCESS) {
+        enc_close(reader);
+        return result;
+    }
+    
+    uint8_t aes_key[32];
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    derive_file_keys(reader->fin, &reader->header, password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len,
+                     aes_key, hmac_key);
+    result = verify_key_check_value(&reader->header, hmac_key, 0);
+    if (result == FILE_CRYPTO_SUCCESS && AES_set_key(&reader->aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+        result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    }
+    if (result != FILE_CRYPTO_SUCCESS) {
+        enc_close(reader);
+        return result;
+    }
+    memcpy(reader->nonce_counter, reader->header.nonce, 8);
+    memset(reader->nonce_counter + 8, 0, 8);
+    reader->payload_offset = enc_payload_offset(&reader->header);
+    
+    // 콜백이 없으면 전체 크기 0으로 넘겨 콘솔 진행률도 출력하지 않음
+    int64_t progress_total = progress_cb ? reader->file_size : 0;
+    
+    if (reader->header.version == ENC_VERSION_STREAM) {
+        // v6: 크기로 세그먼트 경계를 구하고 읽을 때 세그먼트마다 검증
+        if (!file_segment_layout(ciphertext_size, &reader->segment_count, &reader->final_length)) {
+            result = FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;  // 잘린 파일
+        } else {
+            reader->plaintext_size = (int64_t)(reader->segment_count - 1) * ENC_SEGMENT_SIZE +
+                                     (int64_t)reader->final_length;
+            hmac_sha512_init(&reader->header_ctx, hmac_key, HMAC_KEY_SIZE);
+            hmac_sha512_update(&reader->header_ctx, (const uint8_t*)&reader->header, sizeof(EncFileHeader));
+            reader->segment = (uint8_t*)malloc(ENC_SEGMENT_SIZE + ENC_HMAC_SIZE);
+            if (!reader->segment) result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+        }
+    } else if (reader->header.version == ENC_VERSION_INCREMENTAL) {
+        // v8: 루트 태그로 청크 목록을 검증하고 읽을 때 청크마다 태그 검증
+        hmac_sha512_init(&reader->header_ctx, hmac_key, HMAC_KEY_SIZE);
+        hmac_sha512_update(&reader->header_ctx, (const uint8_t*)&reader->header, sizeof(EncFileHeader));
+        result = load_incremental_metas(reader->fin, &reader->header_ctx, stored_hmac, ciphertext_size,
+                                        &reader->chunk_metas, &reader->segment_count, &reader->final_length);
+        if (result == FILE_CRYPTO_SUCCESS) {
+            reader->plaintext_size = (int64_t)(reader->segment_count - 1) * ENC_CHUNK_SIZE +
+                                     (int64_t)reader->final_length;
+            reader->segment = (uint8_t*)malloc(ENC_CHUNK_SIZE);
+            if (!reader->segment) result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+        }
+    } else {
+        // v2~v5: 전체 HMAC 하나뿐이므로 지금 한 번 검증
+        reader->plaintext_size = ciphertext_size;
+        uint8_t* buffer = (uint8_t*)malloc(FILE_CHUNK_SIZE);
+        if (!buffer) {
+            result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+        } else if (reader->header.version >= ENC_VERSION_ETM) {
+            result = verify_ciphertext_hmac(reader->fin, &reader->header, hmac_key, stored_hmac,
+                                            ciphertext_size, buffer, progress_total, progress_cb, user_data, 0);
+        } else {
+            result = verify_legacy_plaintext_hmac(reader, hmac_key, stored_hmac, buffer,
+                                                  progress_total, progress_cb, user_data);
+        }
+        free(buffer);
+        
+        if (result == FILE_CRYPTO_SUCCESS && reader->header.version == ENC_VERSION_COMPRESSED) {
+            // v7: 인증된 압축 정보로 원본 크기를 알고 읽을 때 순차 복원
+            reader->stream = (CompressedStream*)malloc(sizeof(CompressedStream));
+            if (!reader->stream) {
+                result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+            } else {
+                result = compressed_stream_open(reader->stream, reader->fin, &reader->header, ciphertext_size,
+                                                &reader->aes_ctx, reader->nonce_counter);
+                reader->plaintext_size = reader->stream->original_size;
+            }
+        }
+    }
+    
+    if (result != FILE_CRYPTO_SUCCESS) {
+        enc_close(reader);
+        return result;
+    }
+    *out_reader = reader;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 암호화 파일을 임의 위치 읽기용으로 엽니다.
+ * @param path 암호화 파일 경로
+ * @param password 비밀번호
+ * @return 읽기 핸들, 실패 시 NULL
+ * @note 검증 범위는 enc_open_verified와 같습니다 (진행률 보고 없음).
+ */
+EncReader* enc_open(const char* path, const char* password) {
+    EncReader* reader;
+    enc_open_verified(path, password, NULL, NULL, &reader);
+    return reader;
+}
+
+/**
+ * @brief v6 세그먼트를 읽어 태그를 검증하고 평문을 핸들 캐시에 둡니다.
+ * @param reader 읽기 핸들
+ * @param index 세그먼트 번호
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ * @note 순차적인 작은 읽기가 같은 세그먼트를 다시 검증하지 않도록 마지막 세그먼트를 보관합니다.
+ */
+static FILE_CRYPTO_STATUS load_reader_segment(EncReader* reader, uint64_t index) {
+    if (reader->cached_segment == (int64_t)index) return FILE_CRYPTO_SUCCESS;
+    reader->cached_segment = -1;
+    
+    int is_final = (index + 1 == reader->segment_count);
+    size_t length = is_final ? reader->final_length : ENC_SEGMENT_SIZE;
+    int64_t position = reader->payload_offset + (int64_t)index * (ENC_SEGMENT_SIZE + ENC_HMAC_SIZE);
+    if (platform_pread(reader->fin, reader->segment, length + ENC_HMAC_SIZE, position) !=
+        (int64_t)(length + ENC_HMAC_SIZE)) {
+        return FILE_CRYPTO_ERR_FILE_READ;
+    }
+    
+    uint8_t counter[16];
+    uint8_t computed_tag[ENC_HMAC_SIZE];
+    HMAC_SHA512_CTX segment_ctx;
+    file_segment_counter(reader->nonce_counter, index, counter);
+    file_segment_begin_tag(&reader->header_ctx, index, is_final, &segment_ctx);
+    if (AES_CTR_HMAC_crypt(&reader->aes_ctx, reader->segment, length, reader->segment, counter,
+                           &segment_ctx, AES_CTR_HMAC_MAC_INPUT) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    }
+    hmac_sha512_final(&segment_ctx, computed_tag);
+    if (memcmp(computed_tag, reader->segment + length, ENC_HMAC_SIZE) != 0) {
+        return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+    }
+    
+    reader->cached_segment = (int64_t)index;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief v8 청크를 읽어 태그를 검증하고 평문을 핸들 캐시에 둡니다.
+ * @param reader 읽기 핸들
+ * @param index 청크 번호
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS load_reader_chunk(EncReader* reader, uint64_t index) {
+    if (reader->cached_segment == (int64_t)index) return FILE_CRYPTO_SUCCESS;
+    reader->cached_segment = -1;
+    
+    size_t length = (index + 1 == reader->segment_count) ? reader->final_length : ENC_CHUNK_SIZE;
+    int64_t position = reader->payload_offset + file_chunk_position(index) + ENC_CHUNK_META_SIZE;
+    if (platform_pread(reader->fin, reader->segment, length, position) != (int64_t)length) {
+        return FILE_CRYPTO_ERR_FILE_READ;
+    }
+    FILE_CRYPTO_STATUS result = file_chunk_open(&reader->aes_ctx, &reader->header_ctx, index,
+                                                &reader->chunk_metas[index], reader->segment, length);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    
+    reader->cached_segment = (int64_t)index;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 평문의 임의 위치를 복호화해 읽습니다.
+ * @param reader 읽기 핸들
+ * @param buf 출력 버퍼
+ * @param len 읽을 최대 바이트 수
+ * @param offset 평문 오프셋
+ * @return 읽은 바이트 수 (끝 이후면 0), 실패 시 -1
+ * @note v6은 범위에 걸친 세그먼트만, v8은 범위에 걸친 청크만, v2~v5는 범위의 암호문만 읽고 CTR 카운터를
+ *       offset / 16 블록으로 바로 옮겨 복호화합니다. v7은 압축 블록을 순차 복원하므로
+ *       앞으로 읽을 때만 빠르고, 뒤로 돌아가면 처음부터 다시 복원합니다.
+ */
+int64_t enc_pread(EncReader* reader, void* buf, size_t len, int64_t offset) {
+    if (!reader || (!buf && len > 0) || offset < 0) return -1;
+    if (offset >= reader->plaintext_size) return 0;
+    if ((uint64_t)len > (uint64_t)(reader->plaintext_size - offset)) {
+        len = (size_t)(reader->plaintext_size - offset);
+    }
+    uint8_t* out = (uint8_t*)buf;
+    
+    if (reader->header.version == ENC_VERSION_STREAM || reader->header.version == ENC_VERSION_INCREMENTAL) {
+        int chunked = (reader->header.version == ENC_VERSION_INCREMENTAL);
+        size_t unit = chunked ? ENC_CHUNK_SIZE : ENC_SEGMENT_SIZE;
+        size_t copied = 0;
+        while (copied < len) {
+            int64_t position = offset + (int64_t)copied;
+            uint64_t index = (uint64_t)(position / (int64_t)unit);
+            size_t within = (size_t)(position % (int64_t)unit);
+            FILE_CRYPTO_STATUS loaded = chunked ? load_reader_chunk(reader, index) : load_reader_segment(reader, index);
+            if (loaded != FILE_CRYPTO_SUCCESS) return -1;
+            
+            size_t available = ((index + 1 == reader->segment_count) ? reader->final_length : unit) - within;
+            size_t count = (len - copied < available) ? len - copied : available;
+            memcpy(out + copied, reader->segment + within, count);
+            copied += count;
+        }
+        return (int64_t)copied;
+    }
+    
+    if (reader->header.version == ENC_VERSION_COMPRESSED) {
+        // v7: 압축 블록은 위치로 찾을 수 없으므로 현재 블록부터 이어서 복원 (뒤로 가면 처음부터)
+        if (offset < reader->block_offset) {
+            compressed_stream_rewind(reader->stream);
+            reader->block_offset = 0;
+            reader->block = NULL;
+            reader->block_length = 0;
+        }
+        size_t copied = 0;
+        while (copied < len) {
+            int64_t position = offset + (int64_t)copied;
+            while (position >= reader->block_offset + (int64_t)reader->block_length) {
+                reader->block_offset += (int64_t)reader->block_length;
+                if (compressed_stream_next(reader->stream, &reader->block, &reader->block_length) !=
+                    FILE_CRYPTO_SUCCESS || reader->block_length == 0) {
+                    // 다음 읽기가 처음부터 다시 시작하도록 상태 초기화
+                    compressed_stream_rewind(reader->stream);
+                    reader->block_offset = 0;
+                    reader->block = NULL;
+                    reader->block_length = 0;
+                    return -1;
+                }
+            }
+            size_t within = (size_t)(position - reader->block_offset);
+            size_t available = reader->block_length - within;
+            size_t count = (len - copied < available) ? len - copied : available;
+            memcpy(out + copied, reader->block + within, count);
+            copied += count;
+        }
+        return (int64_t)copied;
+    }
+    
+    // v2~v5: 암호문 바이트 i는 블록 i / 16 키스트림의 i % 16번째 바이트로 복호화
+    uint8_t counter[16];
+    memcpy(counter, reader->nonce_counter, 16);
+    AES_CTR_seek(counter, (uint64_t)(offset / AES_BLOCK_SIZE));
+    
+    size_t head = (size_t)(offset % AES_BLOCK_SIZE);
+    size_t done = 0;
+    if (head != 0) {
+        // 블록 중간에서 시작: 블록 앞부분까지 읽어 복호화한 뒤 필요한 부분만 복사
+        uint8_t block[AES_BLOCK_SIZE];
+        size_t count = (len < AES_BLOCK_SIZE - head) ? len : AES_BLOCK_SIZE - head;
+        if (platform_pread(reader->fin, block, head + count, reader->payload_offset + offset - (int64_t)head) !=
+            (int64_t)(head + count) ||
+            AES_CTR_crypt(&reader->aes_ctx, block, head + count, block, counter) != CRYPTO_SUCCESS) {
+            return -1;
+        }
+        memcpy(out, block + head, count);
+        done = count;
+    }
+    if (done < len) {
+        // 이후는 블록 경계에서 시작하므로 출력 버퍼에 바로 읽어 제자리 복호화
+        size_t rest = len - done;
+        if (platform_pread(reader->fin, out + done, rest, reader->payload_offset + offset + (int64_t)done) !=
+            (int64_t)rest ||
+            AES_CTR_crypt(&reader->aes_ctx, out + done, rest, out + done, counter) != CRYPTO_SUCCESS) {
+            return -1;
+        }
+    }
+    return (int64_t)len;
+}
+
+/**
+ * @brief 읽기 핸들의 평문 전체 크기를 반환합니다.
+ * @param reader 읽기 핸들
+ * @return 평문 크기 (바이트), reader가 NULL이면 -1
+ */
+int64_t enc_size(const EncReader* reader) {
+    return reader ? reader->plaintext_size : -1;
+}
+
+/**
+ * @brief 읽기 핸들을 닫고 키 자료를 지웁니다.
+ * @param reader 읽기 핸들 (NULL 가능)
+ */
+void enc_close(EncReader* reader) {
+    if (!reader) return;
+    if (reader->fin) fclose(reader->fin);
+    free(reader->segment);
+    free(reader->chunk_metas);
+    if (reader->stream) {
+        compressed_stream_close(reader->stream);
+        free(reader->stream);
+    }
+    memset(reader, 0, sizeof(*reader));  // 라운드 키와 HMAC 상태 제거
+    free(reader);
+}
+
+/**
+ * @brief 복호화 결과를 쓰지 않고 암호화 파일의 무결성을 검증합니다 (결과 코드와 진행률 보고).
+ * @param input_path 암호화 파일 경로
+ * @param password 비밀번호
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능, 전체 크기는 암호화 파일 크기)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED (잘못된 비밀번호),
+ *         FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED (손상/변조), 파일/형식 오류 코드
+ * @note v2~v5, v7, v9, v10은 enc_open_verified가 전체 HMAC을 검증하고, v6은 모든 세그먼트 태그를
+ *       file_segments_run으로 병렬 검증하며, v8은 모든 청크 태그를 순서대로 검증합니다.
+ *       복호화한 평문은 작업 버퍼에서 버리므로 디스크에는 아무것도 쓰지 않습니다 (읽기 전용).
+ */
+FILE_CRYPTO_STATUS verify_file_with_progress(const char* input_path, const char* password,
+                                             progress_callback_t progress_cb, void* user_data) {
+    EncReader* reader;
+    FILE_CRYPTO_STATUS result = enc_open_verified(input_path, password, progress_cb, user_data, &reader);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    
+    if (reader->header.version == ENC_VERSION_STREAM) {
+        PipelineProgress progress = { reader->payload_offset, reader->file_size, progress_cb, user_data,
+                                      "Verifying", 0 };
+        FileSegmentJob job;
+        memset(&job, 0, sizeof(job));
+        job.fin = reader->fin;
+        job.fout = NULL;  // 검증만
+        job.op = SEGMENT_OP_DECRYPT;
+        job.data_size = (int64_t)(reader->segment_count - 1) * (ENC_SEGMENT_SIZE + ENC_HMAC_SIZE) +
+                        (int64_t)reader->final_length + ENC_HMAC_SIZE;
+        job.in_offset = reader->payload_offset;
+        job.aes_ctx = &reader->aes_ctx;
+        job.nonce_counter = reader->nonce_counter;
+        job.header_ctx = &reader->header_ctx;
+        job.on_progress = progress_cb ? pipeline_progress : NULL;
+        job.user_data = &progress;
+        result = file_segments_run(&job);
+    } else if (reader->header.version == ENC_VERSION_INCREMENTAL) {
+        // v8: enc_open_verified가 검증한 루트 태그 아래 모든 청크 태그 검증
+        for (uint64_t i = 0; i < reader->segment_count && result == FILE_CRYPTO_SUCCESS; i++) {
+            result = load_reader_chunk(reader, i);
+            if (progress_cb) {
+                // 청크 평문 위치로 근사 (마지막 청크에서 파일 크기에 도달)
+                int64_t done = (i + 1 == reader->segment_count) ? reader->file_size : (int64_t)(i + 1) * ENC_CHUNK_SIZE;
+                progress_cb((done < reader->file_size) ? done : reader->file_size, reader->file_size, user_data);
+            }
+        }
+    }
+    
+    // 헤더, 메타데이터처럼 진행률에 들어가지 않은 부분까지 포함해 완료 보고
+    if (result == FILE_CRYPTO_SUCCESS && progress_cb) progress_cb(reader->file_size, reader->file_size, user_data);
+    enc_close(reader);
+    return result;
+}
+
+/**
+ * @brief 복호화 결과를 쓰지 않고 암호화 파일의 무결성을 검증합니다.
+ * @param input_path 암호화 파일 경로
+ * @param password 비밀번호
+ * @return 1 검증 성공, 0 실패 (파일/형식 오류, 잘못된 비밀번호, 무결성 실패)
+ * @note 실패 원인이 필요하면 verify_file_with_progress를 사용합니다.
+ */
+int verify_file(const char* input_path, const char* password) {
+    return (verify_file_with_progress(input_path, password, NULL, NULL) == FILE_CRYPTO_SUCCESS) ? 1 : 0;
+}
+
+// 배치에서 v6 파일을 나누는 세그먼트 범위 크기 (이보다 큰 범위는 반으로 나눠 한쪽을 덱에 넣음)
+#define BATCH_CHUNK_SEGMENTS 8
+
+typedef struct BatchSegmentedFile BatchSegmentedFile;
+typedef struct FileBatchRun FileBatchRun;
+
+// 작업 배치 순서 정렬용 (크기, 항목 번호)
+typedef struct {
+    int64_t size;
+    size_t index;
+} BatchOrder;
+
+// 배치 작업 종류
+typedef enum {
+    BATCH_TASK_FILE = 0,         // 파일 하나 (v6이면 열어서 세그먼트 범위 작업으로 나눔)
+    BATCH_TASK_SEGMENTS          // 열린 v6 파일의 세그먼트 [first, last)
+} BATCH_TASK_KIND;
+
+// 배치 작업 하나 (스레드 풀 작업 인자, 실행 후 해제)
+typedef struct {
+    FileBatchRun* run;
+    BATCH_TASK_KIND kind;
+    size_t item;                         // 배치 항목 번호
+    BatchSegmentedFile* file;            // BATCH_TASK_SEGMENTS: 열린 파일
+    uint64_t first;                      // BATCH_TASK_SEGMENTS: 첫 세그먼트
+    uint64_t last;                       // BATCH_TASK_SEGMENTS: 끝 세그먼트 (포함하지 않음)
+} BatchTask;
+
+// 세그먼트 범위 작업으로 나눠 처리 중인 v6 파일
+struct BatchSegmentedFile {
+    size_t item;                         // 배치 항목 번호
+    FILE* fin;                           // 입력 파일 (위치 지정 읽기)
+    FILE* fout;                          // 출력 파일 (암호화: 결과 파일, 복호화: 스테이징 파일, 검증: NULL)
+    EncFileHeader header;                // 파일 헤더
+    AES_CTX aes_ctx;                     // 작업 스레드 간 읽기 전용 공유
+    uint8_t nonce_counter[16];           // 세그먼트 0의 CTR 카운터
+    HMAC_SHA512_CTX header_ctx;          // 헤더까지 업데이트된 HMAC 컨텍스트
+    SHA512_CTX digest_ctx;               // 암호화: 평문 SHA-512 (plaintext_digest 요청 시)
+    FileSegmentJob job;                  // 세그먼트 작업 설명 (범위만 바꿔 여러 스레드가 공유)
+    int64_t input_size;                  // 입력 파일 크기 (진행률 기준)
+    int64_t in_stride;                   // 세그먼트 하나의 입력 바이트 수
+    volatile long remaining;             // 끝나지 않은 세그먼트 수 (0으로 만든 스레드가 파일을 닫음)
+    volatile long status;                // 처음 발생한 에러 (FILE_CRYPTO_SUCCESS면 정상)
+    char actual_output_path[MAX_PATH_LENGTH];  // 복호화: 확장자 포함 최종 경로
+    char staged_path[MAX_PATH_LENGTH];         // 복호화: 스테이징 파일 경로
+};
+
+// 배치 실행 상태
+struct FileBatchRun {
+    FileBatchJob* job;
+    platform_thread_pool_t* pool;        // 작업 스레드 풀 (만들지 못하면 NULL, 호출 스레드에서 순차 처리)
+    int workers;                         // 풀 작업 스레드 수
+    uint8_t** buffers;                   // 작업 스레드별 세그먼트 버퍼 (마지막 칸은 풀 밖의 호출 스레드용)
+    BatchOrder* order;                   // 큰 파일부터 정렬한 항목 순서
+    volatile long succeeded;             // 성공한 항목 수
+    volatile long lock;                  // 진행률/완료 콜백 직렬화
+    int64_t processed;                   // 처리한 입력 바이트 (lock 보호)
+    int64_t total;                       // 전체 입력 바이트
+    int64_t* item_sizes;                 // 항목별 입력 크기 (열 수 없으면 0)
+};
+
+// 파일 하나를 통째로 처리할 때의 진행률 전달 상태
+typedef struct {
+    FileBatchRun* run;
+    int64_t reported;                    // 지금까지 배치 진행률에 더한 바이트
+    int64_t limit;                       // 이 파일이 더할 수 있는 최대 바이트 (입력 크기)
+} BatchFileProgress;
+
+/**
+ * @brief 스핀락을 잡습니다 (잠깐 쥐는 진행률/콜백 보호용).
+ * @param lock 잠금 변수
+ */
+static void batch_lock(volatile long* lock) {
+    while (!platform_atomic_compare_exchange(lock, 0, 1)) {
+        platform_thread_yield();
+    }
+}
+
+/**
+ * @brief 스핀락을 놓습니다.
+ * @param lock 잠금 변수
+ */
+static void batch_unlock(volatile long* lock) {
+    platform_atomic_store(lock, 0);
+}
+
+static void batch_task_main(void* arg);
+
+/**
+ * @brief 작업을 스레드 풀에 넣습니다 (작업 스레드에서 부르면 자기 덱에 들어가 다른 스레드가 훔칠 수 있음).
+ * @param run 배치 실행 상태
+ * @param task 작업 (복사해서 넣음)
+ * @return 1 성공, 0 풀 없음/메모리 부족 (호출자가 직접 실행)
+ */
+static int batch_spawn(FileBatchRun* run, const BatchTask* task) {
+    if (!run->pool) return 0;
+    
+    BatchTask* copy = (BatchTask*)malloc(sizeof(BatchTask));
+    if (!copy) return 0;
+    *copy = *task;
+    if (!platform_thread_pool_submit(run->pool, batch_task_main, copy)) {
+        free(copy);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 현재 스레드의 세그먼트 버퍼를 구합니다 (처음 필요할 때 할당).
+ * @param run 배치 실행 상태
+ * @return 버퍼, 메모리 부족이면 NULL
+ */
+static uint8_t* batch_buffer(FileBatchRun* run) {
+    int index = platform_thread_pool_worker_index(run->pool);
+    if (index < 0) index = run->workers;
+    if (!run->buffers[index]) run->buffers[index] = (uint8_t*)malloc(FILE_SEGMENT_BUFFER_SIZE);
+    return run->buffers[index];
+}
+
+/**
+ * @brief 배치 진행률에 처리한 바이트를 더하고 콜백을 호출합니다.
+ * @param run 배치 실행 상태
+ * @param bytes 더할 바이트 수
+ */
+static void batch_add_progress(FileBatchRun* run, int64_t bytes) {
+    if (bytes <= 0 || !run->job->on_progress) return;
+    
+    batch_lock(&run->lock);
+    run->processed += bytes;
+    if (run->processed > run->total) run->processed = run->total;
+    run->job->on_progress(run->processed, run->total, run->job->user_data);
+    batch_unlock(&run->lock);
+}
+
+/**
+ * @brief 항목 결과를 기록하고 완료 콜백을 호출합니다.
+ * @param run 배치 실행 상태
+ * @param index 항목 번호
+ * @param success 1 성공, 0 실패
+ */
+static void batch_finish_item(FileBatchRun* run, size_t index, int success) {
+    FileBatchItem* item = &run->job->items[index];
+    item->result = success ? 1 : 0;
+    if (success) platform_atomic_fetch_add(&run->succeeded, 1);
+    
+    if (run->job->on_item_done) {
+        batch_lock(&run->lock);
+        run->job->on_item_done(index, item, run->job->user_data);
+        batch_unlock(&run->lock);
+    }
+}
+
+/**
+ * @brief 파일 하나를 통째로 처리하는 라이브러리 함수의 진행률을 배치 진행률로 옮깁니다.
+ * @param processed 이 파일에서 처리한 누적 바이트
+ * @param total 이 파일의 전체 바이트
+ * @param user_data BatchFileProgress 포인터
+ * @note 콜백을 넘기면 라이브러리 메시지 출력도 꺼지므로 진행률이 필요 없어도 항상 넘깁니다.
+ */
+static void batch_file_progress(int64_t processed, int64_t total, void* user_data) {
+    BatchFileProgress* progress = (BatchFileProgress*)user_data;
+    (void)total;
+    if (processed > progress->limit) processed = progress->limit;
+    if (processed > progress->reported) {
+        batch_add_progress(progress->run, processed - progress->reported);
+        progress->reported = processed;
+    }
+}
+
+/**
+ * @brief 검증 실패 원인을 항목의 final_path에 한 줄 메시지로 기록합니다 (파일별 보고용).
+ * @param item 배치 항목
+ * @param status 검증 결과 코드
+ */
+static void batch_verify_message(FileBatchItem* item, FILE_CRYPTO_STATUS status) {
+    switch (status) {
+        case FILE_CRYPTO_SUCCESS:
+            item->final_path[0] = '\0';
+            break;
+        case FILE_CRYPTO_ERR_KEY_CHECK_FAILED:
+            format_error_message(item->final_path, sizeof(item->final_path), "Incorrect password", 0);
+            break;
+        case FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED:
+            format_error_message(item->final_path, sizeof(item->final_path),
+                                 "Integrity verification failed (corrupted or tampered)", 0);
+            break;
+        case FILE_CRYPTO_ERR_INVALID_HEADER:
+        case FILE_CRYPTO_ERR_INVALID_SIGNATURE:
+        case FILE_CRYPTO_ERR_UNSUPPORTED_VERSION:
+        case FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH:
+            format_error_message(item->final_path, sizeof(item->final_path), "Not a supported encrypted file", 0);
+            break;
+        case FILE_CRYPTO_ERR_FILE_OPEN:
+            format_error_message(item->final_path, sizeof(item->final_path), "Cannot open file", 1);
+            break;
+        case FILE_CRYPTO_ERR_FILE_READ:
+        case FILE_CRYPTO_ERR_FILE_SIZE:
+            format_error_message(item->final_path, sizeof(item->final_path), "Read error (file may be truncated)", 0);
+            break;
+        default:
+            format_error_message(item->final_path, sizeof(item->final_path), "Verification failed", 0);
+            break;
+    }
+}
+
+/**
+ * @brief 입력 파일 크기를 구합니다 (작업 배치 순서와 진행률 기준).
+ * @param path 파일 경로
+ * @return 파일 크기, 열 수 없으면 0 (실제 실패는 작업 실행 시 보고)
+ */
+static int64_t batch_input_size(const char* path) {
+    FILE* file = path ? platform_fopen(path, "rb") : NULL;
+    if (!file) return 0;
+    int64_t size = (platform_fseek64(file, 0, SEEK_END) == 0) ? platform_ftell64(file) : -1;
+    fclose(file);
+    return (size > 0) ? size : 0;
+}
+
+/**
+ * @brief v6 파일을 열고 세그먼트 작업을 준비합니다 (키 도출, 헤더 기록 또는 검증, 출력 준비).
+ * @param run 배치 실행 상태
+ * @param index 항목 번호
+ * @param fin 입력 파일 (이 함수가 소유, 실패 시 닫음)
+ * @param file 출력 준비된 파일 상태 (실패 시 NULL)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ * @note 암호화는 encrypt_file의 v6 경로, 복호화는 decrypt_segmented_content와 같은 파일을 만듭니다.
+ */
+static FILE_CRYPTO_STATUS batch_open_segmented(FileBatchRun* run, size_t index, FILE* fin,
+                                               BatchSegmentedFile** file) {
+    FileBatchJob* job = run->job;
+    FileBatchItem* item = &job->items[index];
+    *file = NULL;
+    
+    BatchSegmentedFile* segmented = (BatchSegmentedFile*)calloc(1, sizeof(BatchSegmentedFile));
+    if (!segmented) {
+        fclose(fin);
+        return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    }
+    segmented->item = index;
+    segmented->fin = fin;
+    segmented->status = FILE_CRYPTO_SUCCESS;
+    
+    uint8_t aes_key[32];
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    int aes_key_bits = job->aes_key_bits;
+    int64_t data_size = 0;
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    
+    if (job->op == FILE_BATCH_ENCRYPT) {
+        if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) {
+            result = FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+        } else if (platform_fseek64(fin, 0, SEEK_END) != 0 || (data_size = platform_ftell64(fin)) < 0) {
+            result = FILE_CRYPTO_ERR_FILE_SIZE;
+        }
+        if (result == FILE_CRYPTO_SUCCESS) {
+            uint8_t salt[ENC_SALT_SIZE];
+            generate_salt(salt, sizeof(salt));
+            derive_keys(job->password, aes_key_bits, salt, sizeof(salt), aes_key, hmac_key);
+            
+            uint8_t key_check[ENC_KCV_SIZE];
+            derive_key_check_value(hmac_key, key_check, sizeof(key_check));
+            
+            uint8_t nonce[8];
+            generate_nonce(nonce, 8);
+            memcpy(segmented->nonce_counter, nonce, 8);
+            memset(segmented->nonce_counter + 8, 0, 8);
+            
+            result = create_encryption_header(item->input_path, aes_key_bits, salt, nonce, key_check,
+                                              ENC_VERSION_STREAM, &segmented->header);
+        }
+        if (result == FILE_CRYPTO_SUCCESS) {
+            segmented->fout = platform_fopen(item->output_path, "wb");
+            if (!segmented->fout) {
+                result = FILE_CRYPTO_ERR_FILE_OPEN;
+            } else if (fwrite(&segmented->header, 1, sizeof(EncFileHeader), segmented->fout) != sizeof(EncFileHeader) ||
+                       fflush(segmented->fout) != 0) {
+                result = FILE_CRYPTO_ERR_FILE_WRITE;
+            }
+        }
+        segmented->job.op = SEGMENT_OP_ENCRYPT;
+        if (job->plaintext_digest) {
+            sha512_init(&segmented->digest_ctx);
+            segmented->job.digest_ctx = &segmented->digest_ctx;
+        }
+        segmented->job.in_offset = 0;
+        segmented->job.out_offset = (int64_t)sizeof(EncFileHeader);
+        segmented->in_stride = ENC_SEGMENT_SIZE;
+    } else {
+        int64_t file_size;
+        uint8_t stored_hmac[ENC_HMAC_SIZE];
+        const uint8_t* pbkdf2_salt = NULL;
+        size_t pbkdf2_salt_len = 0;
+        result = read_and_validate_header(fin, &segmented->header, &file_size, &data_size, 0);
+        if (result == FILE_CRYPTO_SUCCESS) {
+            result = read_encryption_metadata(fin, &segmented->header, stored_hmac, &aes_key_bits,
+                                              &pbkdf2_salt, &pbkdf2_salt_len, 0);
+        }
+        if (result == FILE_CRYPTO_SUCCESS) {
+            derive_keys(job->password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, hmac_key);
+            result = verify_key_check_value(&segmented->header, hmac_key, 0);
+            if (result == FILE_CRYPTO_ERR_KEY_CHECK_FAILED) {
+                format_error_message(item->final_path, sizeof(item->final_path), "Incorrect password", 0);
+            }
+        }
+        if (result == FILE_CRYPTO_SUCCESS && job->op == FILE_BATCH_DECRYPT) {
+            resolve_decrypted_output_path(item->output_path, &segmented->header,
+                                          segmented->actual_output_path, sizeof(segmented->actual_output_path),
+                                          item->final_path, sizeof(item->final_path));
+            segmented->fout = open_staged_output(segmented->actual_output_path, segmented->staged_path,
+                                                 sizeof(segmented->staged_path));
+            if (!segmented->fout) {
+                format_error_message(item->final_path, sizeof(item->final_path), "Cannot create temporary file", 1);
+                result = FILE_CRYPTO_ERR_TEMP_FILE_CREATE;
+            }
+        }
+        memcpy(segmented->nonce_counter, segmented->header.nonce, 8);
+        memset(segmented->nonce_counter + 8, 0, 8);
+        segmented->job.op = SEGMENT_OP_DECRYPT;
+        segmented->job.in_offset = enc_payload_offset(&segmented->header);
+        segmented->job.out_offset = 0;
+        segmented->in_stride = ENC_SEGMENT_SIZE + ENC_HMAC_SIZE;
+    }
+    
+    if (result == FILE_CRYPTO_SUCCESS && AES_set_key(&segmented->aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+        result = (job->op == FILE_BATCH_ENCRYPT) ? FILE_CRYPTO_ERR_ENCRYPTION_FAILED : FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    }
+    
+    uint64_t segment_count = 0;
+    if (result == FILE_CRYPTO_SUCCESS) {
+        hmac_sha512_init(&segmented->header_ctx, hmac_key, HMAC_KEY_SIZE);
+        hmac_sha512_update(&segmented->header_ctx, (const uint8_t*)&segmented->header, sizeof(EncFileHeader));
+        
+        segmented->job.fin = fin;
+        segmented->job.fout = segmented->fout;
+        segmented->job.data_size = data_size;
+        segmented->job.aes_ctx = &segmented->aes_ctx;
+        segmented->job.nonce_counter = segmented->nonce_counter;
+        segmented->job.header_ctx = &segmented->header_ctx;
+        segmented->input_size = run->item_sizes[index];
+        result = file_segments_count(&segmented->job, &segment_count);  // 잘린 파일은 여기서 거부
+    }
+    
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fclose(fin);
+        if (segmented->fout) {
+            fclose(segmented->fout);
+            if (segmented->staged_path[0] != '\0') platform_delete_file(segmented->staged_path);
+        }
+        free(segmented);
+        return result;
+    }
+    
+    segmented->remaining = (long)segment_count;
+    *file = segmented;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 모든 세그먼트를 마친 v6 파일을 닫고 결과를 게시합니다 (마지막 범위를 끝낸 스레드에서 호출).
+ * @param run 배치 실행 상태
+ * @param file 파일 상태 (이 함수에서 해제)
+ * @param buffer 현재 스레드의 세그먼트 버퍼
+ */
+static void batch_close_segmented(FileBatchRun* run, BatchSegmentedFile* file, uint8_t* buffer) {
+    FileBatchItem* item = &run->job->items[file->item];
+    FILE_CRYPTO_STATUS result = (FILE_CRYPTO_STATUS)platform_atomic_load(&file->status);
+    
+    fclose(file->fin);
+    if (run->job->op == FILE_BATCH_ENCRYPT) {
+        if (fclose(file->fout) != 0 && result == FILE_CRYPTO_SUCCESS) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        if (result == FILE_CRYPTO_SUCCESS && file->job.digest_ctx) {
+            sha512_final(file->job.digest_ctx, item->plaintext_digest);
+        }
+    } else if (run->job->op == FILE_BATCH_DECRYPT) {
+        if (result == FILE_CRYPTO_SUCCESS && !buffer) result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+        if (result == FILE_CRYPTO_SUCCESS) {
+            // 검증된 스테이징 파일을 최종 경로에 게시 (세그먼트 버퍼는 FILE_CHUNK_SIZE보다 큼)
+            result = publish_staged_output(file->fout, file->staged_path, file->actual_output_path, buffer,
+                                           item->final_path, sizeof(item->final_path), 0, batch_file_progress);
+        } else {
+            fclose(file->fout);
+            platform_delete_file(file->staged_path);
+            format_error_message(item->final_path, sizeof(item->final_path),
+                                 (result == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) ?
+                                 "Segment integrity verification failed" : "Segment decryption failed", 0);
+        }
+    } else {
+        batch_verify_message(item, result);
+    }
+    
+    // 헤더처럼 세그먼트 밖에 있는 입력 바이트
+    batch_add_progress(run, file->input_size - file->job.data_size);
+    batch_finish_item(run, file->item, result == FILE_CRYPTO_SUCCESS);
+    free(file);
+}
+
+/**
+ * @brief v6 파일의 세그먼트 범위를 처리합니다 (큰 범위는 반씩 나눠 덱에 넣어 다른 스레드가 훔치게 함).
+ * @param run 배치 실행 상태
+ * @param file 파일 상태
+ * @param first 첫 세그먼트
+ * @param last 끝 세그먼트 (포함하지 않음)
+ */
+static void batch_run_segments(FileBatchRun* run, BatchSegmentedFile* file, uint64_t first, uint64_t last) {
+    // 뒤쪽 절반을 덱에 넣고 앞쪽 절반을 계속 나눔 (덱에 넣지 못하면 직접 처리)
+    // 평문 해시는 세그먼트 순서대로만 쌓이므로 해시하는 파일은 나누지 않고 이 스레드가 처음부터 끝까지 처리
+    while (!file->job.digest_ctx && last - first > BATCH_CHUNK_SEGMENTS) {
+        uint64_t middle = first + (last - first) / 2;
+        BatchTask task = { run, BATCH_TASK_SEGMENTS, file->item, file, middle, last };
+        if (!batch_spawn(run, &task)) break;
+        last = middle;
+    }
+    
+    uint8_t* buffer = batch_buffer(run);
+    if (platform_atomic_load(&file->status) == FILE_CRYPTO_SUCCESS) {
+        FILE_CRYPTO_STATUS result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+        if (buffer) {
+            result = file_segments_run_range(&file->job, first, last, buffer, NULL);
+        }
+        if (result != FILE_CRYPTO_SUCCESS) {
+            platform_atomic_compare_exchange(&file->status, FILE_CRYPTO_SUCCESS, (long)result);
+        }
+    }
+    
+    // 실패 후 건너뛴 범위도 진행률에 반영 (항목이 끝나면 항상 입력 크기만큼 더해짐)
+    int64_t begin = (int64_t)first * file->in_stride;
+    int64_t end = (int64_t)last * file->in_stride;
+    if (end > file->job.data_size) end = file->job.data_size;
+    batch_add_progress(run, end - begin);
+    
+    long count = (long)(last - first);
+    if (platform_atomic_fetch_add(&file->remaining, -count) == count) {
+        batch_close_segmented(run, file, buffer);
+    }
+}
+
+/**
+ * @brief 파일 작업 하나를 실행합니다 (v6은 세그먼트 범위로 나누고, 그 외는 파일 단위 라이브러리 함수 호출).
+ * @param run 배치 실행 상태
+ * @param index 항목 번호
+ */
+static void batch_run_file(FileBatchRun* run, size_t index) {
+    FileBatchJob* job = run->job;
+    FileBatchItem* item = &job->items[index];
+    item->final_path[0] = '\0';
+    
+    if (!item->input_path || (job->op != FILE_BATCH_VERIFY && !item->output_path)) {
+        batch_finish_item(run, index, 0);
+        return;
+    }
+    
+    // 체크포인트 처리: 파일 하나를 한 작업으로 (남은 체크포인트가 있으면 이어서 함)
+    if (job->resumable && job->op != FILE_BATCH_VERIFY) {
+        BatchFileProgress progress = { run, 0, run->item_sizes[index] };
+        FILE_CRYPTO_STATUS result = (job->op == FILE_BATCH_ENCRYPT) ?
+            checkpoint_encrypt_file(item->input_path, item->output_path, job->aes_key_bits, job->password,
+                                    batch_file_progress, &progress,
+                                    job->plaintext_digest ? item->plaintext_digest : NULL) :
+            decrypt_file_resumable(item->input_path, item->output_path, job->password,
+                                   item->final_path, sizeof(item->final_path), batch_file_progress, &progress);
+        batch_add_progress(run, progress.limit - progress.reported);
+        batch_finish_item(run, index, result == FILE_CRYPTO_SUCCESS);
+        return;
+    }
+    
+    // 형식 판별: 암호화는 설정, 복호화/검증은 헤더 버전
+    int segmented = (job->op == FILE_BATCH_ENCRYPT) && (g_encryption_format == ENC_FORMAT_SEGMENTED);
+    if (job->op != FILE_BATCH_ENCRYPT) {
+        FILE* fin = platform_fopen(item->input_path, "rb");
+        EncFileHeader header;
+        if (fin && fread(&header, 1, sizeof(header), fin) == sizeof(header) &&
+            memcmp(header.signature, ENC_SIGNATURE, 4) == 0) {
+            segmented = (header.version == ENC_VERSION_STREAM);
+        }
+        if (fin) fclose(fin);
+    }
+    
+    if (segmented) {
+        FILE* fin = platform_fopen(item->input_path, "rb");
+        BatchSegmentedFile* file = NULL;
+        FILE_CRYPTO_STATUS result = fin ? batch_open_segmented(run, index, fin, &file) : FILE_CRYPTO_ERR_FILE_OPEN;
+        if (result != FILE_CRYPTO_SUCCESS) {
+            if (job->op == FILE_BATCH_VERIFY) batch_verify_message(item, result);
+            batch_add_progress(run, run->item_sizes[index]);
+            batch_finish_item(run, index, 0);
+            return;
+        }
+        batch_run_segments(run, file, 0, (uint64_t)file->remaining);
+        return;
+    }
+    
+    BatchFileProgress progress = { run, 0, run->item_sizes[index] };
+    int success;
+    if (job->op == FILE_BATCH_ENCRYPT && job->plaintext_digest) {
+        success = encrypt_file_with_digest(item->input_path, item->output_path, job->aes_key_bits,
+                                           job->password, batch_file_progress, &progress,
+                                           item->plaintext_digest);
+    } else if (job->op == FILE_BATCH_ENCRYPT) {
+        success = encrypt_file_with_progress(item->input_path, item->output_path, job->aes_key_bits,
+                                             job->password, batch_file_progress, &progress);
+    } else if (job->op == FILE_BATCH_DECRYPT) {
+        success = decrypt_file_with_progress(item->input_path, item->output_path, job->password,
+                                             item->final_path, sizeof(item->final_path),
+                                             batch_file_progress, &progress);
+    } else {
+        // 검증: 평문은 메모리에서 버리고 실패 원인은 final_path에 기록
+        FILE_CRYPTO_STATUS result = verify_file_with_progress(item->input_path, job->password,
+                                                              batch_file_progress, &progress);
+        batch_verify_message(item, result);
+        success = (result == FILE_CRYPTO_SUCCESS);
+    }
+    batch_add_progress(run, progress.limit - progress.reported);
+    batch_finish_item(run, index, success);
+}
+
+/**
+ * @brief 스레드 풀 작업 본체: 배치 작업 하나를 실행하고 해제합니다.
+ * @param arg BatchTask 포인터 (batch_spawn에서 할당)
+ */
+static void batch_task_main(void* arg) {
+    BatchTask* task = (BatchTask*)arg;
+    if (task->kind == BATCH_TASK_FILE) {
+        batch_run_file(task->run, task->item);
+    } else {
+        batch_run_segments(task->run, task->file, task->first, task->last);
+    }
+    free(task);
+}
+
+/**
+ * @brief 시작 작업: 파일 작업을 큰 것부터 한 작업 스레드의 덱에 넣습니다.
+ * @param arg FileBatchRun 포인터
+ * @note 소유 스레드는 덱 뒤쪽(작은 파일)부터 처리해 평균 완료 시간을 줄이고,
+ *       놀고 있는 스레드는 앞쪽의 큰 파일을 훔쳐 가서 다시 세그먼트 범위로 나눕니다.
+ */
+static void batch_root_main(void* arg) {
+    FileBatchRun* run = (FileBatchRun*)arg;
+    for (size_t i = 0; i < run->job->count; i++) {
+        BatchTask task = { run, BATCH_TASK_FILE, run->order[i].index, NULL, 0, 0 };
+        if (!batch_spawn(run, &task)) batch_run_file(run, task.item);
+    }
+}
+
+/**
+ * @brief 큰 파일이 앞에 오도록 비교합니다 (qsort용, 크기가 같으면 항목 순서).
+ * @param a BatchOrder 포인터
+ * @param b BatchOrder 포인터
+ * @return 음수 a가 앞, 양수 b가 앞
+ */
+static int batch_compare_larger_first(const void* a, const void* b) {
+    const BatchOrder* left = (const BatchOrder*)a;
+    const BatchOrder* right = (const BatchOrder*)b;
+    if (left->size != right->size) return (left->size < right->size) ? 1 : -1;
+    return (left->index < right->index) ? -1 : (left->index > right->index);
+}
+
+/**
+ * @brief 여러 파일을 작업 훔치기 스케줄러로 암호화/복호화/검증합니다.
+ * @param job 배치 작업 설명 (항목별 result, final_path가 채워짐)
+ * @return 성공한 항목 수
+ * @note platform_thread_pool 위에서 실행되며 호출 스레드는 끝날 때까지 기다립니다 (콜백은 작업 스레드에서 호출).
+ *       파일은 큰 것부터 한 덱에 들어가 소유 스레드는 작은 파일부터 처리하고
+ *       (평균 완료 시간 단축), 놀고 있는 스레드는 덱 앞쪽의 큰 파일이나 큰 세그먼트 범위를 훔칩니다.
+ *       v6 파일은 세그먼트 범위 작업으로 나뉘어 여러 스레드가 함께 처리하며, 그 외 형식은
+ *       전체 HMAC이 순차 계산이라 파일 하나가 작업 하나입니다.
+ */
+size_t process_file_batch(FileBatchJob* job) {
+    if (!job || !job->password || !job->items || job->count == 0) return 0;
+    if (job->count > (size_t)0x7FFFFFFF) return 0;  // long 카운터 범위
+    
+    FileBatchRun run;
+    memset(&run, 0, sizeof(run));
+    run.job = job;
+    run.item_sizes = (int64_t*)calloc(job->count, sizeof(int64_t));
+    run.order = (BatchOrder*)calloc(job->count, sizeof(BatchOrder));
+    if (!run.item_sizes || !run.order) {
+        free(run.item_sizes);
+        free(run.order);
+        return 0;  // FILE_CRYPTO_ERR_MEMORY_ALLOCATION
+    }
+    
+    for (size_t i = 0; i < job->count; i++) {
+        job->items[i].result = 0;
+        job->items[i].final_path[0] = '\0';
+        run.item_sizes[i] = batch_input_size(job->items[i].input_path);
+        run.total += run.item_sizes[i];
+        run.order[i].size = run.item_sizes[i];
+        run.order[i].index = i;
+    }
+    qsort(run.order, job->count, sizeof(BatchOrder), batch_compare_larger_first);
+    
+    // 난수 생성기와 AES 테이블을 작업 스레드보다 먼저 준비 (지연 초기화가 스레드 사이에서 겹치지 않도록)
+    uint8_t warmup[AES_BLOCK_SIZE] = { 0 };
+    uint8_t counter[AES_BLOCK_SIZE] = { 0 };
+    AES_CTX aes_ctx;
+    crypto_random_bytes(warmup, 1);
+    AES_set_key(&aes_ctx, warmup, 128);
+    AES_CTR_crypt(&aes_ctx, warmup, sizeof(warmup), warmup, counter);
+    
+    // 풀을 만들지 못하면 호출 스레드에서 순차 처리 (batch_spawn이 실패해 작업을 직접 실행)
+    run.pool = platform_thread_pool_create(job->thread_count, 0);
+    run.workers = platform_thread_pool_size(run.pool);
+    run.buffers = (uint8_t**)calloc((size_t)run.workers + 1, sizeof(uint8_t*));
+    if (!run.buffers) {
+        platform_thread_pool_destroy(run.pool);
+        free(run.item_sizes);
+        free(run.order);
+        return 0;  // FILE_CRYPTO_ERR_MEMORY_ALLOCATION
+    }
+    if (!run.pool || !platform_thread_pool_submit(run.pool, batch_root_main, &run)) {
+        batch_root_main(&run);
+    }
+    platform_thread_pool_wait(run.pool);
+    platform_thread_pool_destroy(run.pool);
+    
+    for (int i = 0; i <= run.workers; i++) {
+        free(run.buffers[i]);
+    }
+    free(run.buffers);
+    free(run.item_sizes);
+    free(run.order);
+    return (size_t)platform_atomic_load(&run.succeeded);
+}
+
+/***** 깃허브 주소 https://github.com/SWTEAM4/final_swproject *****/
+// CLI 비밀번호 기본 환경 변수 (스트림 모드나 스크립트처럼 프롬프트로 받을 수 없을 때)
+#define CLI_PASSWORD_ENV "AES_CLI_PASSWORD"
+
+// rekey 명령의 새 비밀번호 기본 환경 변수
+#define CLI_NEW_PASSWORD_ENV "AES_CLI_NEW_PASSWORD"
+
+// 매니페스트 한 줄 최대 길이 (입력 경로 + 탭 + 출력 경로 + 줄바꿈)
+#define MANIFEST_LINE_LENGTH (2 * MAX_PATH_LENGTH + 4)
+
+// 명령 모드 작업 종류
+typedef enum {
+    CLI_COMMAND_ENCRYPT = 0,
+    CLI_COMMAND_DECRYPT,
+    CLI_COMMAND_VERIFY
+} CLI_COMMAND;
+
+// 파일 하나의 작업
+typedef struct {
+    char input[MAX_PATH_LENGTH];     // 입력 파일 경로
+    char output[MAX_PATH_LENGTH];    // 출력 경로 (비어 있으면 --out-dir 또는 입력 디렉토리에서 결정)
+} CliTask;
+
+// 명령 모드 배치 (실행은 process_file_batch가 작업 스레드에 나눔)
+typedef struct {
+    CLI_COMMAND command;             // 작업 종류
+    int aes_key_bits;                // 암호화 키 길이
+    const char* out_dir;             // 출력 디렉토리 (NULL이면 입력 파일과 같은 디렉토리)
+    CliTask* tasks;                  // 작업 목록
+    long count;                      // 작업 수
+    long capacity;                   // tasks 할당 크기
+} CliBatch;
+
+/**
+ * @brief 명령 모드 사용법을 stderr에 출력합니다.
+ * @param program 실행 파일 이름
+ */
+static void print_command_usage(const char* program) {
+    fprintf(stderr, "Usage: %s encrypt [options] FILE...\n", program);
+    fprintf(stderr, "       %s decrypt [options] FILE.enc...\n", program);
+    fprintf(stderr, "       %s verify  [options] FILE.enc|DIR...\n", program);
+    fprintf(stderr, "       %s archive create|add ARCHIVE [options] FILE...\n", program);
+    fprintf(stderr, "       %s archive list ARCHIVE [options]\n", program);
+    fprintf(stderr, "       %s archive extract ARCHIVE [options] [NAME...]\n", program);
+    fprintf(stderr, "       %s rekey [--add | --remove SLOT | --list] [options] FILE.enc...\n", program);
+    fprintf(stderr, "       %s append FILE.enc [128|192|256] < input\n", program);
+    fprintf(stderr, "       %s hash [--jobs N] [--no-mmap] [--files-from LIST] FILE|DIR...\n", program);
+    fprintf(stderr, "       %s hash --check [--quiet] [--jobs N] [--no-mmap] [MANIFEST...]\n", program);
+    fprintf(stderr, "       %s --encrypt-stream [128|192|256] < input > output.enc\n", program);
+    fprintf(stderr, "       %s --decrypt-stream < input.enc > output\n", program);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --key-bits 128|192|256  AES key length for encrypt (default 256)\n");
+    fprintf(stderr, "  --segmented             Write the segmented format (per-segment tags, parallel decrypt/verify)\n");
+    fprintf(stderr, "  --compress              Compress before encrypting (already-compressed data is stored as is)\n");
+    fprintf(stderr, "  --incremental           Update an existing output in place, re-encrypting only changed chunks\n");
+    fprintf(stderr, "  --keyslots              Wrap a random data key in password key slots (passwords can be changed with rekey)\n");
+    fprintf(stderr, "  --in-place              Convert each file where it is, needing almost no free space (resumable after a crash)\n");
+    fprintf(stderr, "  --rollback              With --in-place: undo an interrupted in-place operation\n");
+    fprintf(stderr, "  --resumable             Write periodic checkpoints; rerunning the same command resumes an interrupted file\n");
+    fprintf(stderr, "                          (an interrupted decrypt leaves unverified plaintext in OUTPUT.part until it is resumed)\n");
+    fprintf(stderr, "  --out-dir DIR           Output directory (default: next to each input file; archive extract: current directory)\n");
+    fprintf(stderr, "  --manifest FILE         Read tasks from FILE, one \"input<TAB>output\" per line\n");
+    fprintf(stderr, "                          (output optional, blank lines and lines starting with # ignored)\n");
+    fprintf(stderr, "  --digest-manifest FILE  Encrypt: also write the SHA-512 of each input to FILE in sha512sum format,\n");
+    fprintf(stderr, "                          computed in the same read as the encryption\n");
+    fprintf(stderr, "                          (resumed --resumable runs re-read the part finished earlier)\n");
+    fprintf(stderr, "  --jobs N                Number of worker threads; large segmented files are split across them (default: CPU count)\n");
+    fprintf(stderr, "  --password-env NAME     Read password from environment variable NAME (default %s)\n", CLI_PASSWORD_ENV);
+    fprintf(stderr, "  --password-fd N         Read password from the first line of file descriptor N\n");
+    fprintf(stderr, "  --password-file PATH    Read password from the first line of PATH\n");
+    fprintf(stderr, "Rekey (key-slot files only, rewrites one key slot in place):\n");
+    fprintf(stderr, "  (default)               Replace the current password with the new password\n");
+    fprintf(stderr, "  --add                   Add the new password to a free key slot\n");
+    fprintf(stderr, "  --remove SLOT           Remove key slot SLOT (0-%d), authorized by any current password\n",
+            ENC_KEY_SLOT_COUNT - 1);
+    fprintf(stderr, "  --list                  Show which key slots are in use (no password needed)\n");
+    fprintf(stderr, "  --new-password-env NAME  New password from environment variable NAME (default %s)\n",
+            CLI_NEW_PASSWORD_ENV);
+    fprintf(stderr, "  --new-password-fd N     New password from the first line of file descriptor N\n");
+    fprintf(stderr, "  --new-password-file PATH  New password from the first line of PATH\n");
+    fprintf(stderr, "Verify (read-only, writes nothing):\n");
+    fprintf(stderr, "  DIR                     Verify every .enc file under DIR (recursive, symbolic links not followed)\n");
+    fprintf(stderr, "Hash (SHA-512, sha512sum-compatible output, no password needed):\n");
+    fprintf(stderr, "  DIR                     Hash every regular file under DIR (recursive, symbolic links not followed)\n");
+    fprintf(stderr, "  --files-from LIST       Also hash the paths listed in LIST, one per line (- reads standard input)\n");
+    fprintf(stderr, "  --check, -c             Verify the \"digest  path\" lines of each MANIFEST (default: standard input)\n");
+    fprintf(stderr, "  --quiet                 With --check: print only files that failed\n");
+    fprintf(stderr, "  --no-mmap               Read large files with buffered I/O instead of memory-mapping them\n");
+}
+
+/**
+ * @brief 스트림의 첫 줄을 비밀번호로 읽습니다 (줄바꿈 제거).
+ * @param source 비밀번호를 읽을 스트림
+ * @param password 출력 버퍼
+ * @param password_size 버퍼 크기
+ * @return 1 성공, 0 실패 (읽을 수 없거나 빈 줄)
+ */
+static int read_password_line(FILE* source, char* password, size_t password_size) {
+    if (!fgets(password, (int)password_size, source)) return 0;
+    password[strcspn(password, "\r\n")] = '\0';
+    return password[0] != '\0';
+}
+
+/**
+ * @brief 옵션에 따라 비밀번호를 가져옵니다 (우선순위: --password-fd, --password-file, 환경 변수).
+ * @param env_name 환경 변수 이름
+ * @param fd_text --password-fd 값 (NULL 가능)
+ * @param file_path --password-file 값 (NULL 가능)
+ * @param password 출력 버퍼
+ * @param password_size 버퍼 크기
+ * @return 1 성공, 0 실패 (메시지는 stderr에 출력)
+ * @note 명령줄 인자는 다른 사용자에게 보일 수 있으므로 비밀번호 자체는 인자로 받지 않습니다.
+ */
+static int load_cli_password(const char* env_name, const char* fd_text, const char* file_path,
+                             char* password, size_t password_size) {
+    if (fd_text) {
+        char* end = NULL;
+        long fd = strtol(fd_text, &end, 10);
+        FILE* source = (end != fd_text && *end == '\0' && fd >= 0) ? platform_fdopen((int)fd, "r") : NULL;
+        int ok = source && read_password_line(source, password, password_size);
+        if (source) fclose(source);
+        if (!ok) fprintf(stderr, "[ERROR] Cannot read password from file descriptor %s.\n", fd_text);
+        return ok;
+    }
+    if (file_path) {
+        FILE* source = platform_fopen(file_path, "r");
+        int ok = source && read_password_line(source, password, password_size);
+        if (source) fclose(source);
+        if (!ok) fprintf(stderr, "[ERROR] Cannot read password from file: %s\n", file_path);
+        return ok;
+    }
+    
+    const char* value = getenv(env_name);
+    if (!value || value[0] == '\0') {
+        fprintf(stderr, "[ERROR] %s is not set.\n", env_name);
+        return 0;
+    }
+    if (strlen(value) >= password_size) {
+        fprintf(stderr, "[ERROR] Password in %s is too long.\n", env_name);
+        return 0;
+    }
+    strcpy(password, value);
+    return 1;
+}
+
+/**
+ * @brief 배치에 작업을 추가합니다.
+ * @param batch 배치
+ * @param input 입력 파일 경로
+ * @param output 출력 경로 (NULL 또는 빈 문자열이면 자동 결정)
+ * @return 1 성공, 0 실패 (경로가 너무 길거나 메모리 부족)
+ */
+static int add_cli_task(CliBatch* batch, const char* input, const char* output) {
+    if (!output) output = "";
+    if (input[0] == '\0' || strlen(input) >= MAX_PATH_LENGTH || strlen(output) >= MAX_PATH_LENGTH) return 0;
+    
+    if (batch->count == batch->capacity) {
+        long capacity = batch->capacity ? batch->capacity * 2 : 64;
+        CliTask* tasks = (CliTask*)realloc(batch->tasks, (size_t)capacity * sizeof(CliTask));
+        if (!tasks) return 0;
+        batch->tasks = tasks;
+        batch->capacity = capacity;
+    }
+    strcpy(batch->tasks[batch->count].input, input);
+    strcpy(batch->tasks[batch->count].output, output);
+    batch->count++;
+    return 1;
+}
+
+/**
+ * @brief 매니페스트 파일의 작업을 배치에 추가합니다.
+ * @param batch 배치
+ * @param manifest_path 매니페스트 경로 (한 줄에 "입력<TAB>출력", 출력 생략 가능)
+ * @return 1 성공, 0 실패 (메시지는 stderr에 출력)
+ * @note 경로에 공백이 있을 수 있으므로 구분자는 탭입니다. 빈 줄과 #으로 시작하는 줄은 무시합니다.
+ */
+static int load_cli_manifest(CliBatch* batch, const char* manifest_path) {
+    FILE* manifest = platform_fopen(manifest_path, "r");
+    if (!manifest) {
+        fprintf(stderr, "[ERROR] Cannot open manifest: %s\n", manifest_path);
+        return 0;
+    }
+    
+    char line[MANIFEST_LINE_LENGTH];
+    long line_number = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), manifest)) {
+        line_number++;
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n' && !feof(manifest)) {
+            fprintf(stderr, "[ERROR] %s:%ld: line too long.\n", manifest_path, line_number);
+            ok = 0;
+            break;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+        
+        char* output = strchr(line, '\t');
+        if (output) *output++ = '\0';
+        if (!add_cli_task(batch, line, output)) {
+            fprintf(stderr, "[ERROR] %s:%ld: invalid entry.\n", manifest_path, line_number);
+            ok = 0;
+        }
+    }
+    if (ok && ferror(manifest)) {
+        fprintf(stderr, "[ERROR] Cannot read manifest: %s\n", manifest_path);
+        ok = 0;
+    }
+    fclose(manifest);
+    return ok;
+}
+
+/**
+ * @brief 암호화에 성공한 파일의 평문 SHA-512를 sha512sum 형식으로 기록합니다.
+ * @param manifest_path 출력 경로
+ * @param items 배치 항목 (plaintext_digest가 채워진 상태)
+ * @param count 항목 수
+ * @return 1 성공, 0 실패 (메시지는 stderr에 출력)
+ * @note 한 줄에 "해시  입력 경로"이므로 원본은 sha512sum -c 또는 hash --check로 검사할 수 있습니다.
+ */
+static int write_digest_manifest(const char* manifest_path, const FileBatchItem* items, size_t count) {
+    FILE* manifest = platform_fopen(manifest_path, "w");
+    if (!manifest) {
+        fprintf(stderr, "[ERROR] Cannot create digest manifest: %s\n", manifest_path);
+        return 0;
+    }
+    
+    char line[FILE_HASH_LINE_LENGTH];
+    int ok = 1;
+    for (size_t i = 0; i < count && ok; i++) {
+        if (!items[i].result) continue;
+        if (!file_hash_format_line(items[i].plaintext_digest, items[i].input_path, line, sizeof(line)) ||
+            fputs(line, manifest) == EOF) {
+            ok = 0;
+        }
+    }
+    if (fclose(manifest) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "[ERROR] Cannot write digest manifest: %s\n", manifest_path);
+    return ok;
+}
+
+// 디렉토리 검증에서 파일을 모으는 상태
+typedef struct {
+    CliBatch* batch;                 // 작업을 추가할 배치
+    long failed;                     // 추가하지 못한 파일 수
+} CliDirectoryScan;
+
+/**
+ * @brief 디렉토리 탐색 콜백: .enc 파일이면 검증 작업으로 추가합니다.
+ * @param file_path 파일 경로
+ * @param user_data CliDirectoryScan 포인터
+ * @return 항상 1 (탐색 계속)
+ */
+static int add_cli_directory_file(const char* file_path, void* user_data) {
+    CliDirectoryScan* scan = (CliDirectoryScan*)user_data;
+    size_t length = strlen(file_path);
+    if (length < 4 || file_path[length - 4] != '.') return 1;
+    
+    // 확장자는 대소문자 구분 없이 비교 (Windows 탐색기가 만든 ".ENC" 포함)
+    const char* extension = file_path + length - 3;
+    for (int i = 0; i < 3; i++) {
+        char c = extension[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != "enc"[i]) return 1;
+    }
+    if (!add_cli_task(scan->batch, file_path, NULL)) {
+        fprintf(stderr, "[FAIL] %s: path too long or out of memory\n", file_path);
+        scan->failed++;
+    }
+    return 1;
+}
+
+/**
+ * @brief 디렉토리 아래(하위 디렉토리 포함)의 모든 .enc 파일을 검증 작업으로 추가합니다.
+ * @param batch 배치
+ * @param dir_path 디렉토리 경로
+ * @return 추가하지 못한 항목 수 (읽을 수 없는 디렉토리는 1로 셈, 메시지는 stderr에 출력)
+ * @note 심볼릭 링크는 따라가지 않습니다.
+ */
+static long add_cli_directory(CliBatch* batch, const char* dir_path) {
+    CliDirectoryScan scan = { batch, 0 };
+    if (!platform_walk_directory(dir_path, add_cli_directory_file, &scan)) {
+        fprintf(stderr, "[FAIL] %s: directory could not be read completely\n", dir_path);
+        scan.failed++;
+    }
+    return scan.failed;
+}
+
+/**
+ * @brief 작업의 출력 경로를 정하고 입력 파일을 확인합니다.
+ * @param batch 배치
+ * @param task 작업 (output이 비어 있으면 여기서 채움)
+ * @return 1 실행 가능, 0 실패 (결과 한 줄을 stderr에 출력)
+ * @note 출력 경로를 주지 않으면 암호화는 "파일명.enc", 복호화는 "파일명" + 헤더에 저장된 확장자입니다.
+ */
+static int prepare_cli_task(const CliBatch* batch, CliTask* task) {
+    if (!platform_file_exists(task->input)) {
+        fprintf(stderr, "[FAIL] %s: file does not exist\n", task->input);
+        return 0;
+    }
+    if (batch->command == CLI_COMMAND_VERIFY || task->output[0] != '\0') return 1;
+    
+    char dir[MAX_PATH_LENGTH];
+    char stem[MAX_FILENAME_LENGTH];
+    split_file_path(task->input, dir, sizeof(dir), stem, sizeof(stem));
+    build_output_path(task->output, sizeof(task->output), batch->out_dir ? batch->out_dir : dir, stem,
+                      (batch->command == CLI_COMMAND_ENCRYPT) ? ".enc" : NULL);
+    if (stem[0] == '\0' || task->output[0] == '\0') {
+        fprintf(stderr, "[FAIL] %s: cannot build output path\n", task->input);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 배치 항목 완료 콜백: 파일별 결과를 한 줄로 출력합니다.
+ * @param index 항목 번호
+ * @param item 완료된 항목
+ * @param user_data CliBatch 포인터
+ * @note 라이브러리가 콜백 호출을 직렬화하므로 여러 작업 스레드의 출력이 섞이지 않습니다.
+ */
+static void print_cli_result(size_t index, const FileBatchItem* item, void* user_data) {
+    const CliBatch* batch = (const CliBatch*)user_data;
+    (void)index;
+    
+    if (item->result) {
+        if (batch->command == CLI_COMMAND_VERIFY) {
+            printf("[OK] %s\n", item->input_path);
+        } else {
+            printf("[OK] %s -> %s\n", item->input_path,
+                   (batch->command == CLI_COMMAND_DECRYPT) ? item->final_path : item->output_path);
+        }
+        fflush(stdout);
+    } else if (batch->command == CLI_COMMAND_VERIFY) {
+        // 실패 시 final_path에 원인 메시지가 담김
+        fprintf(stderr, "[FAIL] %s: %s\n", item->input_path, item->final_path[0] ? item->final_path : "verification failed");
+    } else if (batch->command == CLI_COMMAND_ENCRYPT) {
+        fprintf(stderr, "[FAIL] %s: encryption failed\n", item->input_path);
+    } else {
+        // 실패 시 final_path에 원인 메시지가 담김
+        fprintf(stderr, "[FAIL] %s: %s\n", item->input_path, item->final_path[0] ? item->final_path : "decryption failed");
+    }
+}
+
+/**
+ * @brief 제자리 함수의 에러 코드를 한 줄 메시지로 바꿉니다.
+ * @param status 에러 코드
+ * @return 메시지 (정적 문자열)
+ */
+static const char* in_place_status_message(FILE_CRYPTO_STATUS status) {
+    switch (status) {
+        case FILE_CRYPTO_ERR_KEY_CHECK_FAILED: return "incorrect password";
+        case FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED: return "integrity check failed (corrupted or tampered)";
+        case FILE_CRYPTO_ERR_UNSUPPORTED_VERSION: return "not an in-place file; decrypt it without --in-place";
+        case FILE_CRYPTO_ERR_INVALID_SIGNATURE: return "not an encrypted file";
+        case FILE_CRYPTO_ERR_INVALID_HEADER: return "journal is corrupted";
+        case FILE_CRYPTO_ERR_INVALID_INPUT: return "interrupted by another operation; finish it or use --rollback";
+        case FILE_CRYPTO_ERR_FILE_SIZE: return "file is shorter than its journal";
+        case FILE_CRYPTO_ERR_FILE_OPEN: return "cannot open file";
+        case FILE_CRYPTO_ERR_FILE_READ: return "read error";
+        case FILE_CRYPTO_ERR_FILE_WRITE: return "write error";
+        default: return "operation failed";
+    }
+}
+
+/**
+ * @brief 제자리 모드로 작업을 차례로 실행합니다 (--in-place).
+ * @param batch 배치 (command: 암호화/복호화)
+ * @param password 비밀번호
+ * @param rollback 1이면 중단된 작업을 되돌림 (--rollback)
+ * @return 실패한 작업 수
+ * @note 같은 파일을 변환한 뒤 이름만 바꾸므로 여유 공간이 거의 필요 없습니다.
+ *       중단되면 같은 명령을 다시 실행해 이어서 하거나 --rollback으로 원래 상태로 돌립니다.
+ */
+static long run_in_place_tasks(CliBatch* batch, const char* password, int rollback) {
+    long failed = 0;
+    for (long i = 0; i < batch->count; i++) {
+        CliTask* task = &batch->tasks[i];
+        if (!prepare_cli_task(batch, task)) {
+            failed++;
+            continue;
+        }
+        
+        FILE_CRYPTO_STATUS result;
+        if (rollback) {
+            result = enc_in_place_rollback(task->input, password);
+            if (result == FILE_CRYPTO_SUCCESS) {
+                printf("[OK] %s: rolled back\n", task->input);
+                fflush(stdout);
+            } else {
+                fprintf(stderr, "[FAIL] %s: %s\n", task->input,
+                        (result == FILE_CRYPTO_ERR_FILE_OPEN) ? "no interrupted in-place operation" :
+                                                                in_place_status_message(result));
+                failed++;
+            }
+            continue;
+        }
+        
+        if (batch->command == CLI_COMMAND_ENCRYPT) {
+            if (platform_file_exists(task->output)) {
+                fprintf(stderr, "[FAIL] %s: output already exists: %s\n", task->input, task->output);
+                failed++;
+                continue;
+            }
+            result = encrypt_file_in_place(task->input, batch->aes_key_bits, password, NULL, NULL);
+            if (result == FILE_CRYPTO_ERR_UNSUPPORTED_VERSION) {
+                // 이전 실행이 변환을 마치고 이름을 바꾸기 전에 중단됨: 남은 이름 변경만 함
+                if (!enc_in_place_encrypted(task->input)) {
+                    fprintf(stderr, "[FAIL] %s: already encrypted\n", task->input);
+                    failed++;
+                    continue;
+                }
+                result = FILE_CRYPTO_SUCCESS;
+            }
+            if (result == FILE_CRYPTO_SUCCESS && !platform_rename_file(task->input, task->output)) {
+                fprintf(stderr, "[FAIL] %s: encrypted in place, but cannot rename to %s\n", task->input, task->output);
+                failed++;
+                continue;
+            }
+            if (result == FILE_CRYPTO_SUCCESS) printf("[OK] %s -> %s\n", task->input, task->output);
+        } else {
+            char extension[8];
+            char final_path[MAX_PATH_LENGTH];
+            result = decrypt_file_in_place(task->input, password, extension, sizeof(extension), NULL, NULL);
+            if (result == FILE_CRYPTO_SUCCESS) {
+                int written = snprintf(final_path, sizeof(final_path), "%s%s", task->output, extension);
+                if (written < 0 || (size_t)written >= sizeof(final_path) || platform_file_exists(final_path) ||
+                    !platform_rename_file(task->input, final_path)) {
+                    fprintf(stderr, "[FAIL] %s: decrypted in place, but cannot rename to %s%s\n",
+                            task->input, task->output, extension);
+                    failed++;
+                    continue;
+                }
+                printf("[OK] %s -> %s\n", task->input, final_path);
+            }
+        }
+        if (result != FILE_CRYPTO_SUCCESS) {
+            fprintf(stderr, "[FAIL] %s: %s\n", task->input, in_place_status_message(result));
+            failed++;
+        }
+        fflush(stdout);
+    }
+    return failed;
+}
+
+/**
+ * @brief 명령 모드를 실행합니다 (encrypt/decrypt/verify, 파일 목록 또는 매니페스트).
+ * @param argc 인자 개수
+ * @param argv 인자 배열
+ * @return 프로세스 종료 코드 (0 모두 성공, 1 하나 이상 실패, 2 사용법 오류)
+ * @note 작업은 process_file_batch가 --jobs개 스레드에 나눠 처리하며 각 파일 결과는 한 줄로 출력합니다 (cron 등 비대화형 실행용).
+ *       --in-place는 파일을 하나씩 제자리에서 변환합니다. verify는 디렉토리를 받으면 그 아래 .enc 파일을 모두 검증합니다.
+ */
+static int run_command_mode(int argc, char* argv[]) {
+    CliBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.aes_key_bits = 256;
+    
+    if (strcmp(argv[1], "encrypt") == 0) batch.command = CLI_COMMAND_ENCRYPT;
+    else if (strcmp(argv[1], "decrypt") == 0) batch.command = CLI_COMMAND_DECRYPT;
+    else if (strcmp(argv[1], "verify") == 0) batch.command = CLI_COMMAND_VERIFY;
+    else {
+        print_command_usage(argv[0]);
+        return 2;
+    }
+    
+    const char* password_env = CLI_PASSWORD_ENV;
+    const char* password_fd = NULL;
+    const char* password_file = NULL;
+    const char* manifest_path = NULL;
+    const char* digest_manifest = NULL;
+    int jobs = platform_cpu_count();
+    int segmented = 0;
+    int compress = 0;
+    int incremental = 0;
+    int keyslots = 0;
+    int in_place = 0;
+    int rollback = 0;
+    int resumable = 0;
+    int usage_error = 0;
+    int options_done = 0;
+    int directories = 0;
+    long directory_failed = 0;
+    
+    for (int i = 2; i < argc && !usage_error; i++) {
+        const char* arg = argv[i];
+        int has_value = (i + 1 < argc);
+        if (options_done || arg[0] != '-' || arg[1] == '\0') {
+            if (batch.command == CLI_COMMAND_VERIFY && platform_directory_exists(arg)) {
+                directory_failed += add_cli_directory(&batch, arg);
+                directories++;
+            } else if (!add_cli_task(&batch, arg, NULL)) {
+                fprintf(stderr, "[ERROR] Invalid input path: %s\n", arg);
+                usage_error = 1;
+            }
+        } else if (strcmp(arg, "--") == 0) {
+            options_done = 1;
+        } else if (strcmp(arg, "--segmented") == 0) {
+            segmented = 1;
+        } else if (strcmp(arg, "--compress") == 0) {
+            compress = 1;
+        } else if (strcmp(arg, "--incremental") == 0) {
+            incremental = 1;
+        } else if (strcmp(arg, "--keyslots") == 0) {
+            keyslots = 1;
+        } else if (strcmp(arg, "--in-place") == 0) {
+            in_place = 1;
+        } else if (strcmp(arg, "--rollback") == 0) {
+            rollback = 1;
+        } else if (strcmp(arg, "--resumable") == 0) {
+            resumable = 1;
+        } else if (!has_value) {
+            fprintf(stderr, "[ERROR] Missing value for %s\n", arg);
+            usage_error = 1;
+        } else if (strcmp(arg, "--key-bits") == 0) {
+            batch.aes_key_bits = atoi(argv[++i]);
+            if (batch.aes_key_bits != 128 && batch.aes_key_bits != 192 && batch.aes_key_bits != 256) {
+                fprintf(stderr, "[ERROR] --key-bits must be 128, 192 or 256.\n");
+                usage_error = 1;
+            }
+        } else if (strcmp(arg, "--out-dir") == 0) {
+            batch.out_dir = argv[++i];
+        } else if (strcmp(arg, "--manifest") == 0) {
+            manifest_path = argv[++i];
+        } else if (strcmp(arg, "--digest-manifest") == 0) {
+            digest_manifest = argv[++i];
+        } else if (strcmp(arg, "--jobs") == 0) {
+            jobs = atoi(argv[++i]);
+            if (jobs < 1) {
+                fprintf(stderr, "[ERROR] --jobs must be at least 1.\n");
+                usage_error = 1;
+            }
+        } else if (strcmp(arg, "--password-env") == 0) {
+            password_env = argv[++i];
+        } else if (strcmp(arg, "--password-fd") == 0) {
+            password_fd = argv[++i];
+        } else if (strcmp(arg, "--password-file") == 0) {
+            password_file = argv[++i];
+        } else {
+            fprintf(stderr, "[ERROR] Unknown option: %s\n", arg);
+            usage_error = 1;
+        }
+    }
+    
+    if (!usage_error && segmented + compress + incremental + keyslots > 1) {
+        fprintf(stderr, "[ERROR] Only one of --segmented, --compress, --incremental and --keyslots can be used.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && rollback && !in_place) {
+        fprintf(stderr, "[ERROR] --rollback requires --in-place.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && in_place && (batch.command == CLI_COMMAND_VERIFY || batch.out_dir || manifest_path ||
+                                     segmented + compress + incremental + keyslots > 0)) {
+        fprintf(stderr, "[ERROR] --in-place cannot be used with verify, --out-dir, --manifest or a format option.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && resumable && (batch.command == CLI_COMMAND_VERIFY || in_place ||
+                                      segmented + compress + incremental + keyslots > 0)) {
+        fprintf(stderr, "[ERROR] --resumable cannot be used with verify, --in-place or a format option.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && digest_manifest && (batch.command != CLI_COMMAND_ENCRYPT || in_place)) {
+        fprintf(stderr, "[ERROR] --digest-manifest can only be used with encrypt (not --in-place).\n");
+        usage_error = 1;
+    }
+    if (!usage_error && manifest_path && !load_cli_manifest(&batch, manifest_path)) usage_error = 1;
+    if (!usage_error && batch.count == 0 && directories > 0) {
+        // 빈 디렉토리 검증은 사용법 오류가 아니라 실패 (스크립트가 잘못된 경로를 알아채도록)
+        fprintf(stderr, "[ERROR] No .enc files found.\n");
+        free(batch.tasks);
+        return 1;
+    }
+    if (!usage_error && batch.count == 0) {
+        fprintf(stderr, "[ERROR] No input files.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && batch.out_dir && !platform_directory_exists(batch.out_dir)) {
+        fprintf(stderr, "[ERROR] Directory does not exist: %s\n", batch.out_dir);
+        usage_error = 1;
+    }
+    
+    char password[MAX_PASSWORD_LENGTH];
+    if (!usage_error && !load_cli_password(password_env, password_fd, password_file, password, sizeof(password))) {
+        usage_error = 1;
+    }
+    if (!usage_error && batch.command == CLI_COMMAND_ENCRYPT && !rollback && !validate_password(password)) {
+        fprintf(stderr, "[ERROR] Password must be alphanumeric (case-sensitive) with maximum 10 characters.\n");
+        usage_error = 1;
+    }
+    if (usage_error) {
+        if (batch.count == 0 && !manifest_path) print_command_usage(argv[0]);
+        free(batch.tasks);
+        return 2;
+    }
+    if (segmented) set_encryption_format(ENC_FORMAT_SEGMENTED);
+    if (compress) set_encryption_format(ENC_FORMAT_COMPRESSED);
+    if (incremental) set_encryption_format(ENC_FORMAT_INCREMENTAL);
+    if (keyslots) set_encryption_format(ENC_FORMAT_KEYSLOTS);
+    
+    if (in_place) {
+        long in_place_failed = run_in_place_tasks(&batch, password, rollback);
+        fprintf(stderr, "%ld file(s) processed: %ld succeeded, %ld failed.\n",
+                batch.count, batch.count - in_place_failed, in_place_failed);
+        memset(password, 0, sizeof(password));
+        free(batch.tasks);
+        return (in_place_failed == 0) ? 0 : 1;
+    }
+    
+    // 실행할 수 없는 작업은 먼저 실패로 처리하고 나머지를 라이브러리 배치 스케줄러에 넘김
+    FileBatchItem* items = (FileBatchItem*)calloc((size_t)batch.count, sizeof(FileBatchItem));
+    if (!items) {
+        fprintf(stderr, "[ERROR] Memory allocation failed.\n");
+        memset(password, 0, sizeof(password));
+        free(batch.tasks);
+        return 1;
+    }
+    size_t item_count = 0;
+    for (long i = 0; i < batch.count; i++) {
+        if (!prepare_cli_task(&batch, &batch.tasks[i])) continue;
+        items[item_count].input_path = batch.tasks[i].input;
+        items[item_count].output_path = batch.tasks[i].output;
+        item_count++;
+    }
+    
+    FileBatchJob job;
+    memset(&job, 0, sizeof(job));
+    job.op = (batch.command == CLI_COMMAND_ENCRYPT) ? FILE_BATCH_ENCRYPT :
+             (batch.command == CLI_COMMAND_DECRYPT) ? FILE_BATCH_DECRYPT : FILE_BATCH_VERIFY;
+    job.aes_key_bits = batch.aes_key_bits;
+    job.password = password;
+    job.items = items;
+    job.count = item_count;
+    job.thread_count = jobs;
+    job.on_item_done = print_cli_result;
+    job.user_data = &batch;
+    job.resumable = resumable;
+    job.plaintext_digest = (digest_manifest != NULL);
+    long failed = batch.count - (long)process_file_batch(&job);
+    int manifest_failed = digest_manifest && !write_digest_manifest(digest_manifest, items, item_count);
+    free(items);
+    
+    fprintf(stderr, "%ld file(s) processed: %ld succeeded, %ld failed.\n",
+            batch.count, batch.count - failed, failed);
+    if (manifest_failed) failed++;
+    if (directory_failed > 0) {
+        fprintf(stderr, "%ld entr%s under the given directories could not be verified.\n",
+                directory_failed, (directory_failed == 1) ? "y" : "ies");
+        failed += directory_failed;
+    }
+    memset(password, 0, sizeof(password));
+    free(batch.tasks);
+    return (failed == 0) ? 0 : 1;
+}
+
+/**
+ * @brief 아카이브 함수의 에러 코드를 한 줄 메시지로 바꿉니다.
+ * @param status 에러 코드
+ * @return 메시지 (정적 문자열)
+ */
+static const char* archive_status_message(FILE_CRYPTO_STATUS status) {
+    switch (status) {
+        case FILE_CRYPTO_ERR_KEY_CHECK_FAILED: return "incorrect password";
+        case FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED: return "integrity check failed (corrupted or tampered)";
+        case FILE_CRYPTO_ERR_INVALID_SIGNATURE:
+        case FILE_CRYPTO_ERR_INVALID_HEADER:
+        case FILE_CRYPTO_ERR_UNSUPPORTED_VERSION: return "not a valid archive";
+        case FILE_CRYPTO_ERR_INVALID_INPUT: return "invalid entry name";
+        case FILE_CRYPTO_ERR_FILE_OPEN: return "cannot open file";
+        case FILE_CRYPTO_ERR_FILE_READ: return "read error";
+        case FILE_CRYPTO_ERR_FILE_WRITE: return "write error";
+        case FILE_CRYPTO_ERR_TEMP_FILE_CREATE: return "cannot create temporary file";
+        default: return "operation failed";
+    }
+}
+
+/**
+ * @brief 아카이브 모드를 실행합니다 (create/add/list/extract).
+ * @param argc 인자 개수
+ * @param argv 인자 배열 (argv[2] 동작, argv[3] 아카이브 경로)
+ * @return 프로세스 종료 코드 (0 모두 성공, 1 하나 이상 실패, 2 사용법 오류)
+ * @note 파일마다 .enc를 만드는 대신 한 컨테이너에 담으므로 PBKDF2는 아카이브당 한 번만 실행됩니다.
+ */
+static int run_archive_mode(int argc, char* argv[]) {
+    const char* action = (argc > 2) ? argv[2] : "";
+    int create = (strcmp(action, "create") == 0);
+    int add = (strcmp(action, "add") == 0);
+    int list = (strcmp(action, "list") == 0);
+    int extract = (strcmp(action, "extract") == 0);
+    if ((!create && !add && !list && !extract) || argc < 4) {
+        print_command_usage(argv[0]);
+        return 2;
+    }
+    const char* archive_path = argv[3];
+    
+    const char** operands = (const char**)calloc((size_t)argc, sizeof(const char*));
+    if (!operands) {
+        fprintf(stderr, "[ERROR] Memory allocation failed.\n");
+        return 1;
+    }
+    const char* password_env = CLI_PASSWORD_ENV;
+    const char* password_fd = NULL;
+    const char* password_file = NULL;
+    const char* out_dir = ".";
+    int aes_key_bits = 256;
+    int operand_count = 0;
+    int usage_error = 0;
+    int options_done = 0;
+    
+    for (int i = 4; i < argc && !usage_error; i++) {
+        const char* arg = argv[i];
+        if (options_done || arg[0] != '-' || arg[1] == '\0') {
+            operands[operand_count++] = arg;
+        } else if (strcmp(arg, "--") == 0) {
+            options_done = 1;
+        } else if (i + 1 >= argc) {
+            fprintf(stderr, "[ERROR] Missing value for %s\n", arg);
+            usage_error = 1;
+        } else if (strcmp(arg, "--key-bits") == 0 && create) {
+            aes_key_bits = atoi(argv[++i]);
+            if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) {
+                fprintf(stderr, "[ERROR] --key-bits must be 128, 192 or 256.\n");
+                usage_error = 1;
+            }
+        } else if (strcmp(arg, "--out-dir") == 0 && extract) {
+            out_dir = argv[++i];
+        } else if (strcmp(arg, "--password-env") == 0) {
+            password_env = argv[++i];
+        } else if (strcmp(arg, "--password-fd") == 0) {
+            password_fd = argv[++i];
+        } else if (strcmp(arg, "--password-file") == 0) {
+            password_file = argv[++i];
+        } else {
+            fprintf(stderr, "[ERROR] Unknown option: %s\n", arg);
+            usage_error = 1;
+        }
+    }
+    
+    if (!usage_error && (create || add) && operand_count == 0) {
+        fprintf(stderr, "[ERROR] No input files.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && list && operand_count > 0) {
+        fprintf(stderr, "[ERROR] list takes no file arguments.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && extract && !platform_directory_exists(out_dir)) {
+        fprintf(stderr, "[ERROR] Directory does not exist: %s\n", out_dir);
+        usage_error = 1;
+    }
+    
+    char password[MAX_PASSWORD_LENGTH];
+    if (!usage_error && !load_cli_password(password_env, password_fd, password_file, password, sizeof(password))) {
+        usage_error = 1;
+    }
+    if (!usage_error && create && !validate_password(password)) {
+        fprintf(stderr, "[ERROR] Password must be alphanumeric (case-sensitive) with maximum 10 characters.\n");
+        usage_error = 1;
+    }
+    if (usage_error) {
+        free(operands);
+        return 2;
+    }
+    
+    EncArchive* archive = NULL;
+    FILE_CRYPTO_STATUS result = create ? enc_archive_create(archive_path, password, aes_key_bits, &archive) :
+                                         enc_archive_open(archive_path, password, add, &archive);
+    memset(password, 0, sizeof(password));
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fprintf(stderr, "[FAIL] %s: %s\n", archive_path, archive_status_message(result));
+        free(operands);
+        return 1;
+    }
+    
+    long failed = 0;
+    if (create || add) {
+        for (int i = 0; i < operand_count; i++) {
+            result = enc_archive_add_file(archive, operands[i], NULL);
+            if (result == FILE_CRYPTO_SUCCESS) {
+                printf("[OK] %s\n", operands[i]);
+            } else {
+                fprintf(stderr, "[FAIL] %s: %s\n", operands[i], archive_status_message(result));
+                failed++;
+            }
+        }
+    } else if (list) {
+        ArchiveEntryInfo info;
+        for (size_t i = 0; i < enc_archive_entry_count(archive); i++) {
+            if (enc_archive_entry_info(archive, i, &info) == FILE_CRYPTO_SUCCESS) {
+                printf("%12lld  %s\n", (long long)info.size, info.name);
+            }
+        }
+    } else if (operand_count == 0) {
+        size_t extracted = 0;
+        result = enc_archive_extract_all(archive, out_dir, &extracted);
+        if (result != FILE_CRYPTO_SUCCESS) {
+            fprintf(stderr, "[FAIL] %s: %s\n", archive_path, archive_status_message(result));
+            failed++;
+        }
+        printf("%lu entr%s extracted to %s\n", (unsigned long)extracted, (extracted == 1) ? "y" : "ies", out_dir);
+    } else {
+        size_t dir_length = strlen(out_dir);
+        const char* separator = (dir_length > 0 && out_dir[dir_length - 1] != '/' && out_dir[dir_length - 1] != '\\') ? "/" : "";
+        for (int i = 0; i < operand_count; i++) {
+            char output_path[MAX_PATH_LENGTH];
+            int64_t index = enc_archive_find(archive, operands[i]);
+            int written = snprintf(output_path, sizeof(output_path), "%s%s%s", out_dir, separator, operands[i]);
+            if (index < 0) {
+                result = FILE_CRYPTO_ERR_INVALID_INPUT;
+            } else if (written < 0 || (size_t)written >= sizeof(output_path)) {
+                result = FILE_CRYPTO_ERR_INVALID_INPUT;
+            } else {
+                result = enc_archive_extract(archive, (size_t)index, output_path);
+            }
+            if (result == FILE_CRYPTO_SUCCESS) {
+                printf("[OK] %s -> %s\n", operands[i], output_path);
+            } else {
+                fprintf(stderr, "[FAIL] %s: %s\n", operands[i],
+                        (index < 0) ? "no such entry" : archive_status_message(result));
+                failed++;
+            }
+        }
+    }
+    free(operands);
+    
+    result = enc_archive_close(archive);
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fprintf(stderr, "[FAIL] %s: cannot write index (%s)\n", archive_path, archive_status_message(result));
+        return 1;
+    }
+    return (failed == 0) ? 0 : 1;
+}
+
+/**
+ * @brief 키 슬롯 함수의 에러 코드를 한 줄 메시지로 바꿉니다.
+ * @param status 에러 코드
+ * @param add 1이면 슬롯 추가 (빈 슬롯 없음), 0이면 슬롯 삭제 (빈 슬롯 또는 마지막 슬롯)
+ * @return 메시지 (정적 문자열)
+ */
+static const char* rekey_status_message(FILE_CRYPTO_STATUS status, int add) {
+    switch (status) {
+        case FILE_CRYPTO_ERR_KEY_CHECK_FAILED: return "incorrect password";
+        case FILE_CRYPTO_ERR_UNSUPPORTED_VERSION: return "not a key-slot file (encrypt with --keyslots to use rekey)";
+        case FILE_CRYPTO_ERR_INVALID_SIGNATURE:
+        case FILE_CRYPTO_ERR_INVALID_HEADER: return "not an encrypted file";
+        case FILE_CRYPTO_ERR_INVALID_INPUT: return add ? "no free key slot" : "key slot is empty or is the last one";
+        case FILE_CRYPTO_ERR_FILE_OPEN: return "cannot open file";
+        case FILE_CRYPTO_ERR_FILE_READ: return "read error";
+        case FILE_CRYPTO_ERR_FILE_WRITE: return "write error";
+        default: return "operation failed";
+    }
+}
+
+/**
+ * @brief 키 슬롯 모드를 실행합니다 (비밀번호 변경, 추가, 삭제, 상태 확인).
+ * @param argc 인자 개수
+ * @param argv 인자 배열
+ * @return 프로세스 종료 코드 (0 모두 성공, 1 하나 이상 실패, 2 사용법 오류)
+ * @note 데이터를 다시 암호화하지 않고 파일마다 키 슬롯 하나만 제자리에 기록하므로 파일 크기와 무관합니다.
+ */
+static int run_rekey_mode(int argc, char* argv[]) {
+    const char** operands = (const char**)calloc((size_t)argc, sizeof(const char*));
+    if (!operands) {
+        fprintf(stderr, "[ERROR] Memory allocation failed.\n");
+        return 1;
+    }
+    const char* password_env = CLI_PASSWORD_ENV;
+    const char* password_fd = NULL;
+    const char* password_file = NULL;
+    const char* new_password_env = CLI_NEW_PASSWORD_ENV;
+    const char* new_password_fd = NULL;
+    const char* new_password_file = NULL;
+    int add = 0;
+    int list = 0;
+    int remove_slot = -1;
+    int operand_count = 0;
+    int usage_error = 0;
+    int options_done = 0;
+    
+    for (int i = 2; i < argc && !usage_error; i++) {
+        const char* arg = argv[i];
+        if (options_done || arg[0] != '-' || arg[1] == '\0') {
+            operands[operand_count++] = arg;
+        } else if (strcmp(arg, "--") == 0) {
+            options_done = 1;
+        } else if (strcmp(arg, "--add") == 0) {
+            add = 1;
+        } else if (strcmp(arg, "--list") == 0) {
+            list = 1;
+        } else if (i + 1 >= argc) {
+            fprintf(stderr, "[ERROR] Missing value for %s\n", arg);
+            usage_error = 1;
+        } else if (strcmp(arg, "--remove") == 0) {
+            char* end = NULL;
+            long slot = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || slot < 0 || slot >= ENC_KEY_SLOT_COUNT) {
+                fprintf(stderr, "[ERROR] --remove must be a slot number from 0 to %d.\n", ENC_KEY_SLOT_COUNT - 1);
+                usage_error = 1;
+            }
+            remove_slot = (int)slot;
+        } else if (strcmp(arg, "--password-env") == 0) {
+            password_env = argv[++i];
+        } else if (strcmp(arg, "--password-fd") == 0) {
+            password_fd = argv[++i];
+        } else if (strcmp(arg, "--password-file") == 0) {
+            password_file = argv[++i];
+        } else if (strcmp(arg, "--new-password-env") == 0) {
+            new_password_env = argv[++i];
+        } else if (strcmp(arg, "--new-password-fd") == 0) {
+            new_password_fd = argv[++i];
+        } else if (strcmp(arg, "--new-password-file") == 0) {
+            new_password_file = argv[++i];
+        } else {
+            fprintf(stderr, "[ERROR] Unknown option: %s\n", arg);
+            usage_error = 1;
+        }
+    }
+    
+    int removing = (remove_slot >= 0);
+    if (!usage_error && add + list + removing > 1) {
+        fprintf(stderr, "[ERROR] Only one of --add, --remove and --list can be used.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && operand_count == 0) {
+        fprintf(stderr, "[ERROR] No input files.\n");
+        usage_error = 1;
+    }
+    
+    // 현재 비밀번호는 --list 외에, 새 비밀번호는 변경과 추가에만 필요
+    char password[MAX_PASSWORD_LENGTH];
+    char new_password[MAX_PASSWORD_LENGTH];
+    password[0] = '\0';
+    new_password[0] = '\0';
+    if (!usage_error && !list && !load_cli_password(password_env, password_fd, password_file, password, sizeof(password))) {
+        usage_error = 1;
+    }
+    if (!usage_error && !list && !removing &&
+        !load_cli_password(new_password_env, new_password_fd, new_password_file, new_password, sizeof(new_password))) {
+        usage_error = 1;
+    }
+    if (!usage_error && !list && !removing && !validate_password(new_password)) {
+        fprintf(stderr, "[ERROR] Password must be alphanumeric (case-sensitive) with maximum 10 characters.\n");
+        usage_error = 1;
+    }
+    if (usage_error) {
+        if (operand_count == 0) print_command_usage(argv[0]);
+        memset(password, 0, sizeof(password));
+        memset(new_password, 0, sizeof(new_password));
+        free(operands);
+        return 2;
+    }
+    
+    long failed = 0;
+    for (int i = 0; i < operand_count; i++) {
+        FILE_CRYPTO_STATUS result;
+        int slot = -1;
+        if (list) {
+            uint8_t states[ENC_KEY_SLOT_COUNT];
+            result = enc_key_slot_states(operands[i], states);
+            if (result == FILE_CRYPTO_SUCCESS) {
+                printf("%s:", operands[i]);
+                for (int j = 0; j < ENC_KEY_SLOT_COUNT; j++) {
+                    printf(" %d=%s", j, (states[j] == ENC_KEY_SLOT_ACTIVE) ? "active" : "empty");
+                }
+                printf("\n");
+                continue;
+            }
+        } else if (add) {
+            result = enc_add_key_slot(operands[i], password, new_password, &slot);
+        } else if (removing) {
+            result = enc_remove_key_slot(operands[i], password, remove_slot);
+        } else {
+            result = enc_rekey(operands[i], password, new_password);
+        }
+        
+        if (result == FILE_CRYPTO_SUCCESS) {
+            if (add) printf("[OK] %s (key slot %d)\n", operands[i], slot);
+            else printf("[OK] %s\n", operands[i]);
+            fflush(stdout);
+        } else {
+            fprintf(stderr, "[FAIL] %s: %s\n", operands[i], rekey_status_message(result, add));
+            failed++;
+        }
+    }
+    memset(password, 0, sizeof(password));
+    memset(new_password, 0, sizeof(new_password));
+    free(operands);
+    
+    if (!list) {
+        fprintf(stderr, "%d file(s) processed: %ld succeeded, %ld failed.\n",
+                operand_count, operand_count - failed, failed);
+    }
+    return (failed == 0) ? 0 : 1;
+}
+
+/**
+ * @brief 스트림 모드를 실행합니다 (stdin → stdout, 예: tar c dir | cli --encrypt-stream 256 | upload).
+ * @param argc 인자 개수
+ * @param argv 인자 배열 (--encrypt-stream [128|192|256] 또는 --decrypt-stream)
+ * @return 프로세스 종료 코드 (0 성공, 1 실패, 2 사용법 오류)
+ * @note stdout은 데이터 전용이므로 모든 메시지는 stderr로 출력합니다.
+ */
+static int run_stream_mode(int argc, char* argv[]) {
+    int encrypt = (strcmp(argv[1], "--encrypt-stream") == 0);
+    int decrypt = (strcmp(argv[1], "--decrypt-stream") == 0);
+    int aes_key_bits = (argc > 2) ? atoi(argv[2]) : 256;
+    
+    if ((!encrypt && !decrypt) || argc > 3 || (decrypt && argc > 2) ||
+        (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256)) {
+        fprintf(stderr, "Usage: %s --encrypt-stream [128|192|256] < input > output.enc\n", argv[0]);
+        fprintf(stderr, "       %s --decrypt-stream < input.enc > output\n", argv[0]);
+        fprintf(stderr, "Password is read from the %s environment variable.\n", CLI_PASSWORD_ENV);
+        return 2;
+    }
+    
+    const char* password = getenv(CLI_PASSWORD_ENV);
+    if (!password || password[0] == '\0') {
+        fprintf(stderr, "[ERROR] %s is not set.\n", CLI_PASSWORD_ENV);
+        return 2;
+    }
+    if (encrypt && !validate_password(password)) {
+        fprintf(stderr, "[ERROR] Password must be alphanumeric (case-sensitive) with maximum 10 characters.\n");
+        return 2;
+    }
+    
+    if (!platform_set_binary_mode(stdin) || !platform_set_binary_mode(stdout)) {
+        fprintf(stderr, "[ERROR] Cannot switch standard streams to binary mode.\n");
+        return 1;
+    }
+    
+    if (encrypt) {
+        if (!encrypt_stream(stdin, stdout, aes_key_bits, password)) {
+            fprintf(stderr, "[ERROR] Stream encryption failed.\n");
+            return 1;
+        }
+    } else if (!decrypt_stream(stdin, stdout, password)) {
+        fprintf(stderr, "[ERROR] Stream decryption failed (wrong password, unsupported format, or corrupted/truncated input).\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 추가 함수의 에러 코드를 한 줄 메시지로 바꿉니다.
+ * @param status 에러 코드
+ * @return 메시지 (정적 문자열)
+ */
+static const char* append_status_message(FILE_CRYPTO_STATUS status) {
+    switch (status) {
+        case FILE_CRYPTO_ERR_KEY_CHECK_FAILED: return "incorrect password";
+        case FILE_CRYPTO_ERR_UNSUPPORTED_VERSION: return "not a stream file; create it with append or --encrypt-stream";
+        case FILE_CRYPTO_ERR_INVALID_SIGNATURE:
+        case FILE_CRYPTO_ERR_INVALID_HEADER: return "not an encrypted file";
+        case FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED: return "last segment is corrupted or truncated";
+        case FILE_CRYPTO_ERR_FILE_OPEN: return "cannot open file";
+        case FILE_CRYPTO_ERR_FILE_READ: return "read error";
+        case FILE_CRYPTO_ERR_FILE_WRITE: return "write error";
+        default: return "operation failed";
+    }
+}
+
+/**
+ * @brief 추가 모드를 실행합니다 (stdin → FILE.enc 끝, 예: tail -f app.log | cli append app.log.enc).
+ * @param argc 인자 개수
+ * @param argv 인자 배열 (append FILE.enc [128|192|256])
+ * @return 프로세스 종료 코드 (0 성공, 1 실패, 2 사용법 오류)
+ * @note 키 길이는 파일을 새로 만들 때만 사용하고, 기존 파일은 헤더의 키 길이를 따릅니다.
+ */
+static int run_append_mode(int argc, char* argv[]) {
+    int aes_key_bits = (argc > 3) ? atoi(argv[3]) : 256;
+    
+    if (argc < 3 || argc > 4 || (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256)) {
+        fprintf(stderr, "Usage: %s append FILE.enc [128|192|256] < input\n", argv[0]);
+        fprintf(stderr, "Appends to a stream (segmented) encrypted file, creating it if missing.\n");
+        fprintf(stderr, "Password is read from the %s environment variable.\n", CLI_PASSWORD_ENV);
+        return 2;
+    }
+    
+    const char* password = getenv(CLI_PASSWORD_ENV);
+    if (!password || password[0] == '\0') {
+        fprintf(stderr, "[ERROR] %s is not set.\n", CLI_PASSWORD_ENV);
+        return 2;
+    }
+    if (!validate_password(password)) {
+        fprintf(stderr, "[ERROR] Password must be alphanumeric (case-sensitive) with maximum 10 characters.\n");
+        return 2;
+    }
+    if (!platform_set_binary_mode(stdin)) {
+        fprintf(stderr, "[ERROR] Cannot switch standard input to binary mode.\n");
+        return 1;
+    }
+    
+    FILE_CRYPTO_STATUS status = encrypt_append_stream(argv[2], stdin, aes_key_bits, password);
+    if (status != FILE_CRYPTO_SUCCESS) {
+        fprintf(stderr, "[ERROR] %s: append failed (%s).\n", argv[2], append_status_message(status));
+        return 1;
+    }
+    return 0;
+}
+
+// hash 모드에서 한 번에 해시하는 파일 수 (파일 수가 많아도 메모리 사용량이 일정하도록 이 단위로 나눠 처리)
+#define HASH_WINDOW_SIZE 1024
+
+// hash 모드 실행 상태
+typedef struct {
+    FileHashItem* items;                     // 현재 창의 항목 (HASH_WINDOW_SIZE개)
+    uint8_t (*expected)[SHA512_DIGEST_LENGTH];  // --check: 목록에 적힌 해시
+    size_t count;                            // 현재 창의 항목 수
+    int check;                               // 1이면 목록 검사 (--check)
+    int quiet;                               // --check에서 OK 줄을 출력하지 않음
+    int allow_mmap;                          // 큰 파일을 메모리 매핑으로 읽음
+    platform_thread_pool_t* pool;            // 작업 스레드 (NULL이면 호출 스레드만 사용)
+    long files;                              // 처리한 파일 수
+    long unreadable;                         // 열거나 읽지 못한 파일 수
+    long mismatched;                         // 해시가 다른 파일 수 (--check)
+    long malformed;                          // 형식이 잘못된 줄 수 (--check)
+} CliHashRun;
+
+/**
+ * @brief 결과 줄에 경로를 출력합니다 (sha512sum처럼 '\', 줄바꿈, CR은 이스케이프하고 줄 앞에 '\').
+ * @param path 파일 경로
+ * @param suffix 경로 뒤에 붙일 문자열
+ */
+static void print_hash_result(const char* path, const char* suffix) {
+    if (strpbrk(path, "\\\n\r")) {
+        putchar('\\');
+        for (const char* p = path; *p; p++) {
+            if (*p == '\\') fputs("\\\\", stdout);
+            else if (*p == '\n') fputs("\\n", stdout);
+            else if (*p == '\r') fputs("\\r", stdout);
+            else putchar(*p);
+        }
+    } else {
+        fputs(path, stdout);
+    }
+    fputs(suffix, stdout);
+}
+
+/**
+ * @brief 현재 창의 파일을 해시하고 결과를 입력 순서대로 출력합니다.
+ * @param run 실행 상태
+ */
+static void flush_hash_window(CliHashRun* run) {
+    if (run->count == 0) return;
+    file_hash_batch(run->items, run->count, run->allow_mmap, run->pool);
+    
+    char line[FILE_HASH_LINE_LENGTH];
+    for (size_t i = 0; i < run->count; i++) {
+        FileHashItem* item = &run->items[i];
+        if (item->status != FILE_CRYPTO_SUCCESS) {
+            fprintf(stderr, "[FAIL] %s: %s\n", item->path,
+                    (item->status == FILE_CRYPTO_ERR_FILE_OPEN) ? "cannot open file" : "read error");
+            if (run->check) print_hash_result(item->path, ": FAILED open or read\n");
+            run->unreadable++;
+        } else if (run->check) {
+            int match = (memcmp(item->digest, run->expected[i], SHA512_DIGEST_LENGTH) == 0);
+            if (!match) run->mismatched++;
+            if (!match || !run->quiet) print_hash_result(item->path, match ? ": OK\n" : ": FAILED\n");
+        } else if (file_hash_format_line(item->digest, item->path, line, sizeof(line))) {
+            fputs(line, stdout);
+        } else {
+            fprintf(stderr, "[FAIL] %s: path too long\n", item->path);
+            run->unreadable++;
+        }
+        free((char*)item->path);
+        item->path = NULL;
+    }
+    run->files += (long)run->count;
+    run->count = 0;
+    fflush(stdout);
+}
+
+/**
+ * @brief 해시할 파일을 현재 창에 추가합니다 (창이 차면 바로 처리).
+ * @param run 실행 상태
+ * @param path 파일 경로 (복사해서 보관)
+ * @param expected --check에서 목록에 적힌 해시 (그 외 NULL)
+ */
+static void add_hash_file(CliHashRun* run, const char* path, const uint8_t* expected) {
+    size_t length = strlen(path) + 1;
+    char* copy = (char*)malloc(length);
+    if (!copy) {
+        fprintf(stderr, "[FAIL] %s: out of memory\n", path);
+        run->unreadable++;
+        return;
+    }
+    memcpy(copy, path, length);
+    run->items[run->count].path = copy;
+    if (expected) memcpy(run->expected[run->count], expected, SHA512_DIGEST_LENGTH);
+    if (++run->count == HASH_WINDOW_SIZE) flush_hash_window(run);
+}
+
+// 디렉토리 탐색 콜백: 모든 일반 파일을 해시 대상으로 추가
+static int add_hash_directory_file(const char* file_path, void* user_data) {
+    add_hash_file((CliHashRun*)user_data, file_path, NULL);
+    return 1;
+}
+
+/**
+ * @brief 줄 단위 목록 파일을 읽습니다 (--files-from 또는 --check 목록).
+ * @param run 실행 상태
+ * @param list_path 목록 경로 ("-"이면 표준 입력)
+ * @return 1 성공, 0 목록을 열거나 읽지 못함 (메시지는 stderr에 출력)
+ * @note --check 목록에서 형식이 잘못된 줄은 sha512sum -c처럼 건너뛰고 셉니다.
+ *       목록 전체에 올바른 줄이 하나도 없으면 실패로 처리합니다.
+ */
+static int load_hash_list(CliHashRun* run, const char* list_path) {
+    int from_stdin = (strcmp(list_path, "-") == 0);
+    if (!from_stdin && platform_directory_exists(list_path)) {
+        fprintf(stderr, "[ERROR] %s: is a directory\n", list_path);
+        return 0;
+    }
+    FILE* list = from_stdin ? stdin : platform_fopen(list_path, "r");
+    if (!list) {
+        fprintf(stderr, "[ERROR] Cannot open list: %s\n", list_path);
+        return 0;
+    }
+    
+    char line[FILE_HASH_LINE_LENGTH];
+    char path[MAX_PATH_LENGTH];
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+    long line_number = 0;
+    long valid = 0;
+    int ok = 1;
+    while (fgets(line, sizeof(line), list)) {
+        line_number++;
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n' && !feof(list)) {
+            // 너무 긴 줄은 나머지를 버리고 형식 오류로 처리
+            int c;
+            while ((c = fgetc(list)) != EOF && c != '\n') {}
+            fprintf(stderr, "[ERROR] %s:%ld: line too long.\n", list_path, line_number);
+            if (run->check) run->malformed++;
+            else ok = 0;
+            continue;
+        }
+        if (line[0] == '\r' || line[0] == '\n' || line[0] == '#') continue;
+        
+        if (!run->check) {
+            line[strcspn(line, "\r\n")] = '\0';
+            add_hash_file(run, line, NULL);
+        } else if (file_hash_parse_line(line, digest, path, sizeof(path))) {
+            add_hash_file(run, path, digest);
+            valid++;
+        } else {
+            run->malformed++;
+        }
+    }
+    if (ferror(list)) {
+        fprintf(stderr, "[ERROR] Cannot read list: %s\n", list_path);
+        ok = 0;
+    }
+    if (!from_stdin) fclose(list);
+    if (ok && run->check && valid == 0) {
+        fprintf(stderr, "[ERROR] %s: no properly formatted SHA512 checksum lines found\n", list_path);
+        ok = 0;
+    }
+    return ok;
+}
+
+/**
+ * @brief 해시 모드를 실행합니다 (sha512sum과 같은 출력, --check로 목록 검사).
+ * @param argc 인자 개수
+ * @param argv 인자 배열 (hash [options] FILE|DIR... 또는 hash --check [options] [MANIFEST...])
+ * @return 프로세스 종료 코드 (0 모두 성공, 1 하나 이상 실패 또는 불일치, 2 사용법 오류)
+ * @note 여러 파일을 스레드 풀에서 동시에 해시하되 결과는 입력 순서대로 출력하므로
+ *       sha512sum 출력과 그대로 비교할 수 있습니다. 비밀번호는 필요 없습니다.
+ */
+static int run_hash_mode(int argc, char* argv[]) {
+    CliHashRun run;
+    memset(&run, 0, sizeof(run));
+    run.allow_mmap = 1;
+    
+    const char* files_from = NULL;
+    int jobs = platform_cpu_count();
+    int usage_error = 0;
+    int options_done = 0;
+    int inputs = 0;
+    
+    // 입력 처리 중에는 출력이 시작되므로 옵션을 먼저 모두 읽고 입력은 세기만 함
+    for (int i = 2; i < argc && !usage_error; i++) {
+        const char* arg = argv[i];
+        if (options_done || arg[0] != '-' || arg[1] == '\0') {
+            inputs++;
+        } else if (strcmp(arg, "--") == 0) {
+            options_done = 1;
+        } else if (strcmp(arg, "--check") == 0 || strcmp(arg, "-c") == 0) {
+            run.check = 1;
+        } else if (strcmp(arg, "--quiet") == 0) {
+            run.quiet = 1;
+        } else if (strcmp(arg, "--no-mmap") == 0) {
+            run.allow_mmap = 0;
+        } else if (i + 1 >= argc) {
+            fprintf(stderr, "[ERROR] Missing value for %s\n", arg);
+            usage_error = 1;
+        } else if (strcmp(arg, "--jobs") == 0) {
+            jobs = atoi(argv[++i]);
+            if (jobs < 1) {
+                fprintf(stderr, "[ERROR] --jobs must be at least 1.\n");
+                usage_error = 1;
+            }
+        } else if (strcmp(arg, "--files-from") == 0) {
+            files_from = argv[++i];
+        } else {
+            fprintf(stderr, "[ERROR] Unknown option: %s\n", arg);
+            usage_error = 1;
+        }
+    }
+    if (!usage_error && run.quiet && !run.check) {
+        fprintf(stderr, "[ERROR] --quiet requires --check.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && run.check && files_from) {
+        fprintf(stderr, "[ERROR] --files-from cannot be used with --check.\n");
+        usage_error = 1;
+    }
+    if (!usage_error && !run.check && !files_from && inputs == 0) {
+        fprintf(stderr, "[ERROR] No input files.\n");
+        usage_error = 1;
+    }
+    if (usage_error) {
+        print_command_usage(argv[0]);
+        return 2;
+    }
+    
+    run.items = (FileHashItem*)calloc(HASH_WINDOW_SIZE, sizeof(FileHashItem));
+    run.expected = run.check ? calloc(HASH_WINDOW_SIZE, SHA512_DIGEST_LENGTH) : NULL;
+    // 호출 스레드도 해시하므로 작업 스레드는 jobs - 1개
+    run.pool = (jobs > 1) ? platform_thread_pool_create(jobs - 1, 0) : NULL;
+    if (!run.items || (run.check && !run.expected) || (jobs > 1 && !run.pool)) {
+        fprintf(stderr, "[ERROR] Memory allocation failed.\n");
+        if (run.pool) platform_thread_pool_destroy(run.pool);
+        free(run.expected);
+        free(run.items);
+        return 1;
+    }
+    
+    long list_failed = 0;
+    options_done = 0;
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        if (!options_done && arg[0] == '-' && arg[1] != '\0') {
+            // 옵션은 위에서 처리했으므로 값까지 건너뜀
+            if (strcmp(arg, "--") == 0) options_done = 1;
+            else if (strcmp(arg, "--jobs") == 0 || strcmp(arg, "--files-from") == 0) i++;
+            continue;
+        }
+        if (run.check) {
+            if (!load_hash_list(&run, arg)) list_failed++;
+        } else if (platform_directory_exists(arg)) {
+            if (!platform_walk_directory(arg, add_hash_directory_file, &run)) {
+                fprintf(stderr, "[FAIL] %s: directory could not be read completely\n", arg);
+                list_failed++;
+            }
+        } else {
+            add_hash_file(&run, arg, NULL);
+        }
+    }
+    // 목록을 주지 않은 --check는 sha512sum -c처럼 표준 입력에서 읽음
+    if (run.check && inputs == 0 && !load_hash_list(&run, "-")) list_failed++;
+    if (files_from && !load_hash_list(&run, files_from)) list_failed++;
+    flush_hash_window(&run);
+    
+    if (run.pool) platform_thread_pool_destroy(run.pool);
+    free(run.expected);
+    free(run.items);
+    
+    if (run.malformed > 0) {
+        fprintf(stderr, "WARNING: %ld line%s improperly formatted\n",
+                run.malformed, (run.malformed == 1) ? " is" : "s are");
+    }
+    if (run.check && run.unreadable > 0) {
+        fprintf(stderr, "WARNING: %ld listed file%s could not be read\n",
+                run.unreadable, (run.unreadable == 1) ? "" : "s");
+    }
+    if (run.mismatched > 0) {
+        fprintf(stderr, "WARNING: %ld computed checksum%s did NOT match\n",
+                run.mismatched, (run.mismatched == 1) ? "" : "s");
+    }
+    return (run.unreadable + run.mismatched + list_failed == 0) ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    // 시드 초기화 (프로그램 시작 시 한 번만)
+    srand((unsigned int)time(NULL));
+    
+    // 인자가 있으면 스트림 모드 (stdin/stdout만 사용) 또는 명령 모드 (대화형 메뉴 없이 실행)
+    if (argc > 1) {
+        if (strcmp(argv[1], "--encrypt-stream") == 0 || strcmp(argv[1], "--decrypt-stream") == 0) {
+            return run_stream_mode(argc, argv);
+        }
+        if (strcmp(argv[1], "archive") == 0) return run_archive_mode(argc, argv);
+        if (strcmp(argv[1], "rekey") == 0) return run_rekey_mode(argc, argv);
+        if (strcmp(argv[1], "append") == 0) return run_append_mode(argc, argv);
+        if (strcmp(argv[1], "hash") == 0) return run_hash_mode(argc, argv);
+        return run_command_mode(argc, argv);
+    }
+    
+    // OpenSSL 활성화 여부 확인 (런타임 체크)
+    // crypto_random_bytes가 호출되면 자동으로 OpenSSL을 로드 시도함
+#ifndef NDEBUG
+    uint8_t test_buf[1];
+    if (crypto_random_bytes(test_buf, 1) == CRYPTO_SUCCESS) {
+        printf("OpenSSL enabled (loaded at runtime)\n");
+    } else {
+        printf("OpenSSL not available (will use fallback rand())\n");
+    }
+#endif
     
     int service;
     char file_path[MAX_PATH_LENGTH];
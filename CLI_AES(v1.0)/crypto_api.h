@@ -53,6 +53,8 @@ extern "C" {
     // 함수 하나로 암복호화 양방향 처리
     // length==0일 경우 성공 반환
     CRYPTO_STATUS AES_CTR_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out, uint8_t nonce_counter[AES_BLOCK_SIZE]);
+    // 카운터를 blocks 블록만큼 건너뜀 (AES_CTR_crypt로 blocks × 16바이트를 처리한 것과 같은 카운터)
+    CRYPTO_STATUS AES_CTR_seek(uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t blocks);
 
     /* --------------------------- SHA-512 context --------------------------- */
     typedef struct {
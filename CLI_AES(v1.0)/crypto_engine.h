@@ -0,0 +1,96 @@
+#ifndef CRYPTO_ENGINE_H
+#define CRYPTO_ENGINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 작업 스레드 하나당 기본 동시 작업 한도 (max_in_flight를 0 이하로 주면 스레드 수 × 이 값)
+#define CRYPTO_ENGINE_IN_FLIGHT_PER_THREAD 4
+
+typedef struct crypto_engine crypto_engine_t;
+typedef struct crypto_job crypto_job_t;
+
+// 작업 상태 (DONE 이후 상태는 바뀌지 않음)
+typedef enum {
+    CRYPTO_JOB_QUEUED = 0,       // 제출됨, 작업 스레드 대기 중
+    CRYPTO_JOB_RUNNING,          // 처리 중
+    CRYPTO_JOB_DONE,             // 성공
+    CRYPTO_JOB_FAILED,           // 실패 (crypto_job_final_path에 원인 메시지가 있을 수 있음)
+    CRYPTO_JOB_CANCELLED         // 취소됨 (시작 전이면 실행하지 않고, 처리 중이었으면 결과 파일 삭제)
+} CRYPTO_JOB_STATE;
+
+// 작업 완료 콜백 (작업 스레드에서 호출, 콜백 안에서 crypto_job_wait/crypto_engine_wait_all 호출 금지)
+typedef void (*crypto_job_callback_t)(crypto_job_t* job, CRYPTO_JOB_STATE state, void* user_data);
+
+/**
+ * @brief 비동기 암호화 엔진을 만듭니다 (작업 스레드 풀 + 동시 작업 한도).
+ * @param thread_count 작업 스레드 수 (0 이하면 CPU 수)
+ * @param max_in_flight 끝나지 않은 작업 수 한도 (0 이하면 스레드 수 × CRYPTO_ENGINE_IN_FLIGHT_PER_THREAD)
+ * @return 엔진, 실패 시 NULL
+ * @note 한도에 닿으면 제출 함수가 작업 하나가 끝날 때까지 기다리므로 (배압) 수천 개를 한 번에 넣어도
+ *       대기열과 메모리가 한도 이상으로 늘지 않습니다.
+ */
+crypto_engine_t* crypto_engine_create(int thread_count, int max_in_flight);
+
+/**
+ * @brief 파일 암호화 작업을 제출합니다 (encrypt_file_with_progress와 같은 결과).
+ * @param engine 엔진
+ * @param input_path 입력 파일 경로 (복사해 둠)
+ * @param output_path 출력 파일 경로 (복사해 둠)
+ * @param aes_key_bits AES 키 길이 (128, 192, 256)
+ * @param password 비밀번호 (복사해 두고 작업이 끝나면 지움)
+ * @param on_done 완료 콜백 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return 작업 핸들 (crypto_job_release로 놓아야 함), 실패 시 NULL
+ */
+crypto_job_t* crypto_submit_encrypt(crypto_engine_t* engine, const char* input_path, const char* output_path,
+                                    int aes_key_bits, const char* password,
+                                    crypto_job_callback_t on_done, void* user_data);
+
+/**
+ * @brief 파일 복호화 작업을 제출합니다 (decrypt_file_with_progress와 같은 결과).
+ * @param engine 엔진
+ * @param input_path 입력 파일 경로 (복사해 둠)
+ * @param output_path 출력 경로 (확장자는 헤더에서 복원, 복사해 둠)
+ * @param password 비밀번호 (복사해 두고 작업이 끝나면 지움)
+ * @param on_done 완료 콜백 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return 작업 핸들 (crypto_job_release로 놓아야 함), 실패 시 NULL
+ */
+crypto_job_t* crypto_submit_decrypt(crypto_engine_t* engine, const char* input_path, const char* output_path,
+                                    const char* password, crypto_job_callback_t on_done, void* user_data);
+
+// 현재 작업 상태
+CRYPTO_JOB_STATE crypto_job_state(crypto_job_t* job);
+
+// 진행률 조회 (입력 바이트 기준, 처리 시작 전에는 둘 다 0, NULL 인자는 건너뜀)
+void crypto_job_progress(crypto_job_t* job, int64_t* processed, int64_t* total);
+
+// 작업 취소 요청 (시작 전이면 실행하지 않음, 처리 중이면 끝난 뒤 결과 파일을 지우고 CANCELLED로 끝냄)
+void crypto_job_cancel(crypto_job_t* job);
+
+// 작업이 끝날 때까지 기다린 뒤 최종 상태 반환 (작업 스레드 안에서 호출 금지)
+CRYPTO_JOB_STATE crypto_job_wait(crypto_job_t* job);
+
+// 복호화 성공 시 확장자 포함 출력 경로, 실패 시 원인 메시지 (끝나기 전이나 없으면 빈 문자열)
+const char* crypto_job_final_path(crypto_job_t* job);
+
+// 작업 핸들 놓기 (끝나지 않은 작업은 계속 실행되며, 끝나면 엔진이 해제)
+void crypto_job_release(crypto_job_t* job);
+
+// 제출한 모든 작업이 끝날 때까지 대기 (작업 스레드 안에서 호출 금지)
+void crypto_engine_wait_all(crypto_engine_t* engine);
+
+// 남은 작업을 모두 마친 뒤 엔진 해제 (놓지 않은 작업 핸들은 계속 유효하며 crypto_job_release로 해제)
+void crypto_engine_destroy(crypto_engine_t* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRYPTO_ENGINE_H
@@ -0,0 +1,576 @@
+#include "file_checkpoint.h"
+#include "file_crypto_internal.h"
+#include "aes_ctr_hmac.h"
+#include "sha512.h"
+#include "key_derivation.h"
+#include "random_utils.h"
+#include "error_utils.h"
+#include "platform_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 체크포인트 간격 (set_checkpoint_interval로 변경)
+static int64_t g_checkpoint_interval = ENC_CHECKPOINT_INTERVAL;
+
+/**
+ * @brief 체크포인트 간격을 설정합니다 (encrypt_file_resumable, decrypt_file_resumable).
+ * @param bytes 체크포인트 사이에 처리할 바이트 수 (0 이하면 ENC_CHECKPOINT_INTERVAL)
+ */
+void set_checkpoint_interval(int64_t bytes) {
+    g_checkpoint_interval = (bytes > 0) ? bytes : ENC_CHECKPOINT_INTERVAL;
+}
+
+// 체크포인트 실행 상태 (입력 → 출력 데이터 영역을 순서대로 변환)
+typedef struct {
+    FILE* fin;                          // 입력 파일 (위치 지정 읽기)
+    FILE* fout;                         // 출력 파일 (암호화: 출력 파일, 복호화: 스테이징 파일)
+    FILE* journal;                      // 체크포인트 파일 (NULL이면 아직 없음)
+    EncCheckpoint record;               // 마지막으로 기록한(읽은) 레코드, header는 처리 중인 파일의 헤더
+    AES_CTX aes_ctx;                    // AES 컨텍스트
+    uint8_t hmac_key[HMAC_KEY_SIZE];    // HMAC 키 (파일 HMAC, 체크포인트 태그와 상태 키)
+    HMAC_SHA512_CTX hmac_ctx;           // HMAC(헤더 + 암호문) 진행 상태
+    uint8_t nonce_counter[16];          // 데이터 시작의 CTR 카운터
+    uint8_t counter[16];                // 다음 바이트의 CTR 카운터
+    int64_t input_size;                 // 입력 파일 크기 (이어서 할 때 같은 입력인지 확인)
+    int64_t in_offset;                  // 입력의 데이터 시작 위치
+    int64_t out_offset;                 // 출력의 데이터 시작 위치
+    int64_t length;                     // 데이터 크기
+    int64_t done;                       // 처리한 크기 (FILE_CHUNK_SIZE 경계)
+    uint8_t* buffer;                    // 작업 버퍼 (FILE_CHUNK_SIZE)
+    SHA512_CTX* digest_ctx;             // 암호화: 읽은 평문의 SHA-512 (NULL이면 해시하지 않음)
+} CheckpointRun;
+
+// 체크포인트 레코드 태그: HMAC(HMAC 키, 태그 앞부분)의 앞 32바이트
+static void checkpoint_tag(const uint8_t* hmac_key, const EncCheckpoint* record, uint8_t* tag) {
+    uint8_t full[ENC_HMAC_SIZE];
+    HMAC_SHA512_CTX ctx;
+    hmac_sha512_init(&ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&ctx, (const uint8_t*)record, offsetof(EncCheckpoint, tag));
+    hmac_sha512_final(&ctx, full);
+    memcpy(tag, full, sizeof(record->tag));
+}
+
+/**
+ * @brief 체크포인트 상태를 AES-256-CTR로 암호화/복호화합니다 (같은 연산).
+ * @param hmac_key 파일 HMAC 키 (상태 키 도출)
+ * @param iv CTR 초기값 (16바이트)
+ * @param data 상태 (ENC_CHECKPOINT_STATE_SIZE, 제자리 변환)
+ * @return 1 성공, 0 실패
+ * @note 상태 키는 HMAC(HMAC 키, 용도 문자열)의 앞 32바이트이므로 파일 데이터의 키 스트림과 겹치지 않습니다.
+ */
+static int checkpoint_crypt_state(const uint8_t* hmac_key, const uint8_t* iv, uint8_t* data) {
+    static const char label[] = "AESK checkpoint state";
+    uint8_t key[ENC_HMAC_SIZE];
+    uint8_t counter[16];
+    AES_CTX ctx;
+    hmac_sha512(hmac_key, HMAC_KEY_SIZE, (const uint8_t*)label, sizeof(label) - 1, key);
+    memcpy(counter, iv, sizeof(counter));
+    int ok = (AES_set_key(&ctx, key, 256) == CRYPTO_SUCCESS &&
+              AES_CTR_crypt(&ctx, data, ENC_CHECKPOINT_STATE_SIZE, data, counter) == CRYPTO_SUCCESS);
+    memset(key, 0, sizeof(key));
+    memset(&ctx, 0, sizeof(ctx));
+    return ok;
+}
+
+/**
+ * @brief 진행 상태를 레코드에 암호화해 넣습니다 (새 IV 생성).
+ * @param run 체크포인트 실행 상태
+ * @return 1 성공, 0 실패
+ */
+static int checkpoint_seal_state(CheckpointRun* run) {
+    uint8_t state[ENC_CHECKPOINT_STATE_SIZE];
+    const SHA512_CTX* inner = &run->hmac_ctx.ictx;
+    memset(state, 0, sizeof(state));
+    enc_store_be64(state, (uint64_t)run->input_size);
+    enc_store_be64(state + 8, (uint64_t)run->done);
+    memcpy(state + 16, run->counter, 16);
+    for (int i = 0; i < 8; i++) enc_store_be64(state + 32 + i * 8, inner->state[i]);
+    enc_store_be64(state + 96, inner->bitlen_high);
+    enc_store_be64(state + 104, inner->bitlen_low);
+    enc_store_be64(state + 112, (uint64_t)inner->datalen);
+    memcpy(state + 120, inner->buffer, SHA512_BLOCK_SIZE);
+    
+    int ok = (crypto_random_bytes(run->record.iv, sizeof(run->record.iv)) == CRYPTO_SUCCESS &&
+              checkpoint_crypt_state(run->hmac_key, run->record.iv, state));
+    memcpy(run->record.state, state, sizeof(state));
+    memset(state, 0, sizeof(state));
+    return ok;
+}
+
+/**
+ * @brief 레코드의 진행 상태를 복호화해 실행 상태에 적용합니다.
+ * @param run 체크포인트 실행 상태 (hmac_key, record 설정)
+ * @return 1 성공, 0 상태가 맞지 않음 (입력 크기 불일치, 범위를 벗어난 값)
+ * @note HMAC은 키로 다시 초기화한 뒤 내부 해시 상태만 바꾸므로 키 패드는 체크포인트에 기록되지 않습니다.
+ */
+static int checkpoint_open_state(CheckpointRun* run) {
+    uint8_t state[ENC_CHECKPOINT_STATE_SIZE];
+    memcpy(state, run->record.state, sizeof(state));
+    if (!checkpoint_crypt_state(run->hmac_key, run->record.iv, state)) return 0;
+    
+    int64_t done = (int64_t)enc_load_be64(state + 8);
+    uint64_t datalen = enc_load_be64(state + 112);
+    int ok = ((int64_t)enc_load_be64(state) == run->input_size && done >= 0 && done <= run->length &&
+              done % FILE_CHUNK_SIZE == 0 && datalen < SHA512_BLOCK_SIZE);
+    if (ok) {
+        SHA512_CTX* inner = &run->hmac_ctx.ictx;
+        hmac_sha512_init(&run->hmac_ctx, run->hmac_key, HMAC_KEY_SIZE);
+        for (int i = 0; i < 8; i++) inner->state[i] = enc_load_be64(state + 32 + i * 8);
+        inner->bitlen_high = enc_load_be64(state + 96);
+        inner->bitlen_low = enc_load_be64(state + 104);
+        inner->datalen = (size_t)datalen;
+        memcpy(inner->buffer, state + 120, SHA512_BLOCK_SIZE);
+        memcpy(run->counter, state + 16, 16);
+        run->done = done;
+    }
+    memset(state, 0, sizeof(state));
+    return ok;
+}
+
+/**
+ * @brief 출력을 디스크에 반영한 뒤 체크포인트를 기록합니다.
+ * @param run 체크포인트 실행 상태
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_WRITE
+ * @note 순번의 홀짝으로 두 자리에 번갈아 기록하므로 기록 도중 중단되어도 직전 체크포인트는 그대로 남습니다.
+ */
+static FILE_CRYPTO_STATUS checkpoint_write(CheckpointRun* run) {
+    if (!platform_sync_stream(run->fout)) return FILE_CRYPTO_ERR_FILE_WRITE;
+    
+    uint64_t sequence = enc_load_be64(run->record.sequence) + 1;
+    enc_store_be64(run->record.sequence, sequence);
+    if (!checkpoint_seal_state(run)) return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    checkpoint_tag(run->hmac_key, &run->record, run->record.tag);
+    
+    int64_t position = (int64_t)(sequence % 2) * (int64_t)sizeof(EncCheckpoint);
+    if (!platform_pwrite(run->journal, &run->record, sizeof(run->record), position) ||
+        !platform_sync_stream(run->journal)) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 체크포인트 파일에서 이 작업과 파일에 맞는 최신 레코드를 읽어 진행 상태를 복원합니다.
+ * @param run 체크포인트 실행 상태 (journal 열림, 키와 record.header 설정)
+ * @param operation ENC_CHECKPOINT_ENCRYPT 또는 ENC_CHECKPOINT_DECRYPT
+ * @return 1 복원함, 0 쓸 수 있는 레코드 없음
+ */
+static int checkpoint_load(CheckpointRun* run, uint8_t operation) {
+    EncCheckpoint records[2];
+    int best = -1;
+    for (int i = 0; i < 2; i++) {
+        uint8_t tag[sizeof(records[i].tag)];
+        if (platform_pread(run->journal, &records[i], sizeof(records[i]), (int64_t)i * (int64_t)sizeof(records[i])) !=
+            (int64_t)sizeof(records[i]) ||
+            memcmp(records[i].signature, ENC_CHECKPOINT_SIGNATURE, 4) != 0 || records[i].operation != operation ||
+            memcmp(&records[i].header, &run->record.header, sizeof(EncFileHeader)) != 0) {
+            continue;
+        }
+        checkpoint_tag(run->hmac_key, &records[i], tag);
+        if (memcmp(tag, records[i].tag, sizeof(tag)) != 0) continue;
+        if (best < 0 || enc_load_be64(records[i].sequence) > enc_load_be64(records[best].sequence)) best = i;
+    }
+    if (best < 0) return 0;
+    run->record = records[best];
+    return checkpoint_open_state(run);
+}
+
+/**
+ * @brief 이어서 하기 전에 출력에 남은 결과를 확인합니다.
+ * @param run 체크포인트 실행 상태 (진행 상태 복원됨)
+ * @return 1 이어서 할 수 있음 (출력을 체크포인트 위치로 자름), 0 처음부터 다시 해야 함
+ * @note 출력이 체크포인트 위치까지 있는지 보고, 체크포인트 직전 구간(최대 FILE_CHUNK_SIZE)을 입력에서
+ *       다시 변환해 출력과 비교하므로 입력이 바뀌었거나 출력이 다른 파일로 바뀌었으면 처음부터 다시 합니다.
+ *       그 앞부분은 다시 읽지 않습니다. 암호화는 체크포인트의 HMAC 중간 상태를 이어 쓰므로 중단 중에 손상된
+ *       출력 앞부분은 복호화할 때에야 HMAC 불일치로 드러나고, 복호화의 HMAC은 암호문에 대한 것이므로
+ *       스테이징 파일에 이미 쓴 평문 앞부분의 손상은 감지하지 못합니다.
+ */
+static int checkpoint_validate_output(CheckpointRun* run) {
+    int64_t output_size = (platform_fseek64(run->fout, 0, SEEK_END) == 0) ? platform_ftell64(run->fout) : -1;
+    if (output_size < run->out_offset + run->done) return 0;
+    
+    size_t window = (run->done < FILE_CHUNK_SIZE) ? (size_t)run->done : FILE_CHUNK_SIZE;
+    if (window > 0) {
+        int64_t start = run->done - (int64_t)window;
+        uint8_t* expected = (uint8_t*)malloc(window);
+        uint8_t counter[16];
+        memcpy(counter, run->nonce_counter, sizeof(counter));
+        int ok = expected &&
+                 platform_pread(run->fin, run->buffer, window, run->in_offset + start) == (int64_t)window &&
+                 platform_pread(run->fout, expected, window, run->out_offset + start) == (int64_t)window &&
+                 AES_CTR_seek(counter, (uint64_t)start / 16) == CRYPTO_SUCCESS &&
+                 AES_CTR_crypt(&run->aes_ctx, run->buffer, window, run->buffer, counter) == CRYPTO_SUCCESS &&
+                 memcmp(run->buffer, expected, window) == 0;
+        free(expected);
+        if (!ok) return 0;
+    }
+    return platform_truncate_stream(run->fout, run->out_offset + run->done);
+}
+
+/**
+ * @brief 처리한 위치부터 끝까지 변환하며 주기적으로 체크포인트를 기록합니다.
+ * @param run 체크포인트 실행 상태
+ * @param mac_mode AES_CTR_HMAC_MAC_OUTPUT (암호화: 출력이 암호문) 또는 AES_CTR_HMAC_MAC_INPUT (복호화)
+ * @param operation_name 진행률 출력 이름
+ * @param progress_cb 진행률 콜백 함수 (NULL이면 진행률 출력)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS checkpoint_process(CheckpointRun* run, AES_CTR_HMAC_ORDER mac_mode,
+                                             const char* operation_name,
+                                             progress_callback_t progress_cb, void* user_data) {
+    int64_t last_checkpoint = run->done;
+    while (run->done < run->length) {
+        size_t chunk = (run->length - run->done < FILE_CHUNK_SIZE) ?
+                       (size_t)(run->length - run->done) : FILE_CHUNK_SIZE;
+        if (platform_pread(run->fin, run->buffer, chunk, run->in_offset + run->done) != (int64_t)chunk) {
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        if (run->digest_ctx) sha512_update(run->digest_ctx, run->buffer, chunk);
+        if (AES_CTR_HMAC_crypt(&run->aes_ctx, run->buffer, chunk, run->buffer, run->counter,
+                               &run->hmac_ctx, mac_mode) != CRYPTO_SUCCESS) {
+            return (mac_mode == AES_CTR_HMAC_MAC_OUTPUT) ? FILE_CRYPTO_ERR_ENCRYPTION_FAILED :
+                                                           FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+        }
+        if (!platform_pwrite(run->fout, run->buffer, chunk, run->out_offset + run->done)) {
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        run->done += (int64_t)chunk;
+        
+        if (run->done < run->length && run->done - last_checkpoint >= g_checkpoint_interval) {
+            FILE_CRYPTO_STATUS result = checkpoint_write(run);
+            if (result != FILE_CRYPTO_SUCCESS) return result;
+            last_checkpoint = run->done;
+        }
+        update_progress_with_callback(run->done, run->length, progress_cb, user_data, operation_name, 2);
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 체크포인트 파일과 출력을 이어서 쓸 수 있게 엽니다.
+ * @param run 체크포인트 실행 상태 (키, record.header, 위치 설정)
+ * @param output_path 출력 경로
+ * @param journal_path 체크포인트 파일 경로
+ * @param operation ENC_CHECKPOINT_ENCRYPT 또는 ENC_CHECKPOINT_DECRYPT
+ * @return 1 이어서 함 (fout, journal 열림), 0 처음부터 (열었던 파일은 닫음)
+ */
+static int checkpoint_resume(CheckpointRun* run, const char* output_path, const char* journal_path, uint8_t operation) {
+    run->fout = platform_fopen(output_path, "r+b");
+    run->journal = run->fout ? platform_fopen(journal_path, "r+b") : NULL;
+    if (run->journal && checkpoint_load(run, operation) && checkpoint_validate_output(run)) return 1;
+    
+    if (run->journal) fclose(run->journal);
+    if (run->fout) fclose(run->fout);
+    run->journal = NULL;
+    run->fout = NULL;
+    return 0;
+}
+
+/**
+ * @brief 체크포인트 실행을 마칩니다 (성공하면 체크포인트 파일 삭제, 실패하면 남겨 이어서 할 수 있게 함).
+ * @param run 체크포인트 실행 상태
+ * @param journal_path 체크포인트 파일 경로
+ * @param result 작업 결과
+ * @return 최종 결과 (출력 파일을 닫다가 실패하면 FILE_CRYPTO_ERR_FILE_WRITE)
+ */
+static FILE_CRYPTO_STATUS checkpoint_close(CheckpointRun* run, const char* journal_path, FILE_CRYPTO_STATUS result) {
+    if (run->fin) fclose(run->fin);
+    if (run->fout && fclose(run->fout) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    if (run->journal) fclose(run->journal);
+    if (result == FILE_CRYPTO_SUCCESS && run->journal) platform_delete_file(journal_path);
+    free(run->buffer);
+    memset(run, 0, sizeof(*run));
+    return result;
+}
+
+/**
+ * @brief 체크포인트 암호화를 새로 시작합니다 (키 도출, 헤더와 HMAC 자리 기록, 체크포인트 파일 생성).
+ * @param run 체크포인트 실행 상태
+ * @param input_path 입력 파일 경로 (헤더에 확장자 기록)
+ * @param output_path 출력 파일 경로
+ * @param journal_path 체크포인트 파일 경로
+ * @param aes_key_bits AES 키 길이
+ * @param password 비밀번호
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS checkpoint_begin_encrypt(CheckpointRun* run, const char* input_path, const char* output_path,
+                                                   const char* journal_path, int aes_key_bits, const char* password) {
+    uint8_t salt[ENC_SALT_SIZE];
+    uint8_t aes_key[32];
+    uint8_t key_check[ENC_KCV_SIZE];
+    uint8_t nonce[8];
+    generate_salt(salt, sizeof(salt));
+    derive_keys(password, aes_key_bits, salt, sizeof(salt), aes_key, run->hmac_key);
+    derive_key_check_value(run->hmac_key, key_check, sizeof(key_check));
+    generate_nonce(nonce, sizeof(nonce));
+    int key_ok = (AES_set_key(&run->aes_ctx, aes_key, aes_key_bits) == CRYPTO_SUCCESS);
+    memset(aes_key, 0, sizeof(aes_key));
+    if (!key_ok) return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    
+    memset(&run->record, 0, sizeof(run->record));
+    FILE_CRYPTO_STATUS result = create_encryption_header(input_path, aes_key_bits, salt, nonce, key_check,
+                                                         ENC_VERSION, &run->record.header);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    memcpy(run->record.signature, ENC_CHECKPOINT_SIGNATURE, 4);
+    run->record.operation = ENC_CHECKPOINT_ENCRYPT;
+    memcpy(run->nonce_counter, nonce, 8);
+    memset(run->nonce_counter + 8, 0, 8);
+    memcpy(run->counter, run->nonce_counter, sizeof(run->counter));
+    run->done = 0;
+    
+    // [헤더 | HMAC 자리(0)], HMAC은 끝에서 기록
+    static const uint8_t hmac_placeholder[ENC_HMAC_SIZE] = { 0 };
+    run->fout = platform_fopen(output_path, "w+b");
+    if (!run->fout) return FILE_CRYPTO_ERR_FILE_OPEN;
+    if (!platform_pwrite(run->fout, &run->record.header, sizeof(EncFileHeader), 0) ||
+        !platform_pwrite(run->fout, hmac_placeholder, sizeof(hmac_placeholder), sizeof(EncFileHeader))) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    hmac_sha512_init(&run->hmac_ctx, run->hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&run->hmac_ctx, (const uint8_t*)&run->record.header, sizeof(EncFileHeader));
+    
+    run->journal = platform_fopen(journal_path, "w+b");
+    return run->journal ? FILE_CRYPTO_SUCCESS : FILE_CRYPTO_ERR_FILE_OPEN;
+}
+
+/**
+ * @brief 체크포인트 암호화를 실행합니다 (encrypt_file_resumable과 배치 처리에서 사용, 평문 해시 지원).
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 파일 경로 (체크포인트는 output_path + ENC_CHECKPOINT_SUFFIX)
+ * @param aes_key_bits AES 키 길이 (128, 192, 256, 이어서 할 때는 남은 출력의 헤더를 따름)
+ * @param password 비밀번호
+ * @param progress_cb 진행률 콜백 함수 (NULL이면 진행률과 메시지 출력)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @param plaintext_digest 출력 평문 SHA-512 (ENC_PLAINTEXT_DIGEST_SIZE, NULL이면 계산하지 않음)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ * @note 평문은 암호화하면서 같은 읽기에서 해시하고, 이어서 할 때만 앞선 실행이 처리한 앞부분을 다시 읽습니다.
+ */
+FILE_CRYPTO_STATUS checkpoint_encrypt_file(const char* input_path, const char* output_path,
+                                           int aes_key_bits, const char* password,
+                                           progress_callback_t progress_cb, void* user_data,
+                                           uint8_t* plaintext_digest) {
+    if (!input_path || !output_path || !password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) {
+        return FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    }
+    int show_error = (progress_cb == NULL);
+    
+    CheckpointRun run;
+    memset(&run, 0, sizeof(run));
+    char journal_path[MAX_PATH_LENGTH];
+    int written = snprintf(journal_path, sizeof(journal_path), "%s%s", output_path, ENC_CHECKPOINT_SUFFIX);
+    if (written < 0 || (size_t)written >= sizeof(journal_path)) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    run.fin = platform_fopen(input_path, "rb");
+    if (!run.fin) {
+        log_error(show_error, "Cannot open file: %s\n", input_path);
+        return FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+    run.input_size = (platform_fseek64(run.fin, 0, SEEK_END) == 0) ? platform_ftell64(run.fin) : -1;
+    run.buffer = (uint8_t*)malloc(FILE_CHUNK_SIZE);
+    if (run.input_size < 0) return checkpoint_close(&run, journal_path, FILE_CRYPTO_ERR_FILE_SIZE);
+    if (!run.buffer) return checkpoint_close(&run, journal_path, FILE_CRYPTO_ERR_MEMORY_ALLOCATION);
+    run.out_offset = ENC_HEADER_SIZE + ENC_HMAC_SIZE;
+    run.length = run.input_size;
+    
+    // 중단된 실행: 남은 출력의 헤더로 키를 도출 (다른 비밀번호면 출력을 건드리지 않고 거부)
+    int resumed = 0;
+    if (platform_file_exists(journal_path)) {
+        FILE* fout = platform_fopen(output_path, "rb");
+        EncFileHeader* header = &run.record.header;
+        int header_ok = fout && platform_pread(fout, header, sizeof(*header), 0) == (int64_t)sizeof(*header) &&
+                        memcmp(header->signature, ENC_SIGNATURE, 4) == 0 && header->version == ENC_VERSION &&
+                        enc_header_key_bits(header) != 0;
+        if (fout) fclose(fout);
+        if (header_ok) {
+            uint8_t aes_key[32];
+            derive_keys(password, enc_header_key_bits(header), header->salt, ENC_SALT_SIZE, aes_key, run.hmac_key);
+            FILE_CRYPTO_STATUS kcv_result = verify_key_check_value(header, run.hmac_key, show_error);
+            int key_ok = (kcv_result == FILE_CRYPTO_SUCCESS &&
+                          AES_set_key(&run.aes_ctx, aes_key, enc_header_key_bits(header)) == CRYPTO_SUCCESS);
+            memset(aes_key, 0, sizeof(aes_key));
+            if (kcv_result != FILE_CRYPTO_SUCCESS) return checkpoint_close(&run, journal_path, kcv_result);
+            memcpy(run.nonce_counter, header->nonce, 8);
+            memset(run.nonce_counter + 8, 0, 8);
+            resumed = key_ok && checkpoint_resume(&run, output_path, journal_path, ENC_CHECKPOINT_ENCRYPT);
+        }
+        if (!resumed) log_info(show_error, "Checkpoint does not match the files; starting over.\n");
+    }
+    
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    if (!resumed) {
+        result = checkpoint_begin_encrypt(&run, input_path, output_path, journal_path, aes_key_bits, password);
+    }
+    if (result == FILE_CRYPTO_SUCCESS) {
+        if (resumed) {
+            log_info(show_error, "Resuming from checkpoint (%lld of %lld bytes done)...\n",
+                     (long long)run.done, (long long)run.length);
+        } else {
+            log_info(show_error, "Encrypting...\n");
+        }
+        // 평문 해시: 이어서 하면 앞선 실행이 처리한 앞부분을 먼저 읽어 반영
+        SHA512_CTX digest_ctx;
+        if (plaintext_digest) {
+            sha512_init(&digest_ctx);
+            run.digest_ctx = &digest_ctx;
+            for (int64_t offset = 0; offset < run.done && result == FILE_CRYPTO_SUCCESS; ) {
+                size_t chunk = (run.done - offset < FILE_CHUNK_SIZE) ? (size_t)(run.done - offset) : FILE_CHUNK_SIZE;
+                if (platform_pread(run.fin, run.buffer, chunk, offset) != (int64_t)chunk) {
+                    result = FILE_CRYPTO_ERR_FILE_READ;
+                    break;
+                }
+                sha512_update(&digest_ctx, run.buffer, chunk);
+                offset += (int64_t)chunk;
+            }
+        }
+        if (result == FILE_CRYPTO_SUCCESS) {
+            result = checkpoint_process(&run, AES_CTR_HMAC_MAC_OUTPUT, "Encrypting", progress_cb, user_data);
+        }
+        if (plaintext_digest) {
+            if (result == FILE_CRYPTO_SUCCESS) sha512_final(&digest_ctx, plaintext_digest);
+            memset(&digest_ctx, 0, sizeof(digest_ctx));
+            run.digest_ctx = NULL;
+        }
+    }
+    
+    // HMAC을 자리에 기록하고 디스크에 반영한 뒤 체크포인트 삭제
+    if (result == FILE_CRYPTO_SUCCESS) {
+        uint8_t hmac[ENC_HMAC_SIZE];
+        hmac_sha512_final(&run.hmac_ctx, hmac);
+        if (!platform_pwrite(run.fout, hmac, sizeof(hmac), ENC_HEADER_SIZE) || !platform_sync_stream(run.fout)) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+    }
+    result = checkpoint_close(&run, journal_path, result);
+    if (result == FILE_CRYPTO_SUCCESS) {
+        if (progress_cb) progress_cb(run.length, run.length, user_data);
+        log_info(show_error, "Encryption completed!\n");
+    } else if (platform_file_exists(journal_path)) {
+        log_error(show_error, "Encryption failed; run the same command again to resume.\n");
+    }
+    return result;
+}
+
+FILE_CRYPTO_STATUS encrypt_file_resumable(const char* input_path, const char* output_path,
+                                          int aes_key_bits, const char* password,
+                                          progress_callback_t progress_cb, void* user_data) {
+    return checkpoint_encrypt_file(input_path, output_path, aes_key_bits, password, progress_cb, user_data, NULL);
+}
+
+FILE_CRYPTO_STATUS decrypt_file_resumable(const char* input_path, const char* output_path,
+                                          const char* password, char* final_output_path, size_t final_path_size,
+                                          progress_callback_t progress_cb, void* user_data) {
+    if (!input_path || !output_path || !password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    int show_error = (progress_cb == NULL);
+    
+    CheckpointRun run;
+    memset(&run, 0, sizeof(run));
+    char journal_path[MAX_PATH_LENGTH] = "";
+    run.fin = platform_fopen(input_path, "rb");
+    if (!run.fin) {
+        log_error(show_error, "Cannot open file: %s\n", input_path);
+        return FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+    
+    // 헤더, HMAC, 키 (잘못된 비밀번호는 출력을 만들기 전에 거부)
+    EncFileHeader* header = &run.record.header;
+    uint8_t stored_hmac[ENC_HMAC_SIZE];
+    int aes_key_bits;
+    const uint8_t* pbkdf2_salt = NULL;
+    size_t pbkdf2_salt_len = 0;
+    FILE_CRYPTO_STATUS result = read_and_validate_header(run.fin, header, &run.input_size, &run.length, show_error);
+    if (result == FILE_CRYPTO_SUCCESS && header->version != ENC_VERSION_ETM && header->version != ENC_VERSION_ALIGNED &&
+        header->version != ENC_VERSION_KEYSLOTS && header->version != ENC_VERSION_INPLACE) {
+        log_error(show_error, "Resumable decryption supports single-HMAC files only (not segmented, compressed or incremental).\n");
+        result = FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
+    }
+    if (result == FILE_CRYPTO_SUCCESS) {
+        result = read_encryption_metadata(run.fin, header, stored_hmac, &aes_key_bits,
+                                          &pbkdf2_salt, &pbkdf2_salt_len, show_error);
+    }
+    if (result == FILE_CRYPTO_SUCCESS) {
+        uint8_t aes_key[32];
+        derive_file_keys(run.fin, header, password, aes_key_bits, pbkdf2_salt, pbkdf2_salt_len, aes_key, run.hmac_key);
+        result = verify_key_check_value(header, run.hmac_key, show_error);
+        if (result == FILE_CRYPTO_SUCCESS && AES_set_key(&run.aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+            result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+        }
+        memset(aes_key, 0, sizeof(aes_key));
+        if (result == FILE_CRYPTO_ERR_KEY_CHECK_FAILED && progress_cb != NULL) {
+            format_error_message(final_output_path, final_path_size, "Incorrect password", 0);
+        }
+    }
+    if (result != FILE_CRYPTO_SUCCESS) return checkpoint_close(&run, journal_path, result);
+    
+    // 최종 경로.part에 복호화하고 체크포인트는 그 옆에 둠
+    char actual_output_path[MAX_PATH_LENGTH];
+    char staged_path[MAX_PATH_LENGTH];
+    resolve_decrypted_output_path(output_path, header, actual_output_path, sizeof(actual_output_path),
+                                  final_output_path, final_path_size);
+    int written = snprintf(staged_path, sizeof(staged_path), "%s%s", actual_output_path, ENC_CHECKPOINT_PART_SUFFIX);
+    int journal_written = snprintf(journal_path, sizeof(journal_path), "%s%s", staged_path, ENC_CHECKPOINT_SUFFIX);
+    if (written < 0 || (size_t)written >= sizeof(staged_path) ||
+        journal_written < 0 || (size_t)journal_written >= sizeof(journal_path)) {
+        journal_path[0] = '\0';
+        return checkpoint_close(&run, journal_path, FILE_CRYPTO_ERR_INVALID_INPUT);
+    }
+    
+    run.buffer = (uint8_t*)malloc(FILE_CHUNK_SIZE);
+    if (!run.buffer) return checkpoint_close(&run, journal_path, FILE_CRYPTO_ERR_MEMORY_ALLOCATION);
+    run.in_offset = enc_payload_offset(header);
+    memcpy(run.nonce_counter, header->nonce, 8);
+    memset(run.nonce_counter + 8, 0, 8);
+    memcpy(run.record.signature, ENC_CHECKPOINT_SIGNATURE, 4);
+    run.record.operation = ENC_CHECKPOINT_DECRYPT;
+    
+    int resumed = platform_file_exists(journal_path) &&
+                  checkpoint_resume(&run, staged_path, journal_path, ENC_CHECKPOINT_DECRYPT);
+    if (resumed) {
+        log_info(show_error, "Resuming from checkpoint (%lld of %lld bytes done)...\n",
+                 (long long)run.done, (long long)run.length);
+    } else {
+        if (platform_file_exists(journal_path)) log_info(show_error, "Checkpoint does not match the files; starting over.\n");
+        log_info(show_error, "Decrypting...\n");
+        memcpy(run.counter, run.nonce_counter, sizeof(run.counter));
+        run.done = 0;
+        hmac_sha512_init(&run.hmac_ctx, run.hmac_key, HMAC_KEY_SIZE);
+        hmac_sha512_update(&run.hmac_ctx, (const uint8_t*)header, sizeof(EncFileHeader));
+        run.fout = platform_fopen(staged_path, "w+b");
+        run.journal = run.fout ? platform_fopen(journal_path, "w+b") : NULL;
+        if (!run.journal) {
+            if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Cannot create output file", 1);
+            return checkpoint_close(&run, journal_path, FILE_CRYPTO_ERR_FILE_OPEN);
+        }
+    }
+    result = checkpoint_process(&run, AES_CTR_HMAC_MAC_INPUT, "Decrypting", progress_cb, user_data);
+    
+    // 암호문 전체의 HMAC이 맞을 때만 게시 (맞지 않으면 스테이징 파일과 체크포인트 삭제)
+    if (result == FILE_CRYPTO_SUCCESS) {
+        uint8_t computed_hmac[ENC_HMAC_SIZE];
+        hmac_sha512_final(&run.hmac_ctx, computed_hmac);
+        if (memcmp(computed_hmac, stored_hmac, ENC_HMAC_SIZE) != 0) {
+            log_error(show_error, "HMAC verification failed! File may be corrupted or tampered.\n");
+            if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "HMAC integrity verification failed", 0);
+            result = FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        }
+    }
+    int64_t length = run.length;
+    result = checkpoint_close(&run, journal_path, result);
+    if (result == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+        platform_delete_file(staged_path);
+        platform_delete_file(journal_path);
+    }
+    if (result == FILE_CRYPTO_SUCCESS && !platform_rename_file(staged_path, actual_output_path)) {
+        if (progress_cb != NULL) format_error_message(final_output_path, final_path_size, "Cannot create output file", 1);
+        log_error(show_error, "Cannot create output file: %s\n", actual_output_path);
+        result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    if (result == FILE_CRYPTO_SUCCESS) {
+        if (progress_cb) progress_cb(length, length, user_data);
+        log_info(show_error, "Decryption completed!\n");
+    } else if (result != FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED && platform_file_exists(journal_path)) {
+        log_error(show_error, "Decryption failed; run the same command again to resume.\n");
+    }
+    return result;
+}
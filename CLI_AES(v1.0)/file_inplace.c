@@ -0,0 +1,584 @@
+#include "file_inplace.h"
+#include "file_crypto_internal.h"
+#include "crypto_api.h"
+#include "hmac_sha512.h"
+#include "key_derivation.h"
+#include "random_utils.h"
+#include "file_chunks.h"
+#include "platform_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief v10 파일의 트레일러에서 헤더를 읽습니다 (파일 앞에 시그니처가 없을 때).
+ * @param fin 입력 파일 포인터 (위치는 바뀌지 않음)
+ * @param file_size 파일 크기
+ * @param header 출력 헤더
+ * @return 1 v10 트레일러, 0 아님
+ */
+int in_place_read_trailer(FILE* fin, int64_t file_size, EncFileHeader* header) {
+    EncFileHeader trailer;
+    if (file_size < ENC_INPLACE_TRAILER_SIZE ||
+        platform_pread(fin, &trailer, sizeof(trailer), file_size - ENC_INPLACE_TRAILER_SIZE) !=
+        (int64_t)sizeof(trailer) ||
+        memcmp(trailer.signature, ENC_SIGNATURE, 4) != 0 || trailer.version != ENC_VERSION_INPLACE) {
+        return 0;
+    }
+    *header = trailer;
+    return 1;
+}
+
+// 제자리 작업 상태 (대상 파일, 저널, 키)
+typedef struct {
+    FILE* file;                                              // 대상 파일 ("r+b", 위치 지정 읽기/쓰기만 사용)
+    FILE* journal;                                           // 저널 파일 (NULL이면 아직 없음)
+    EncInPlaceJournal record;                                // 마지막으로 기록한(읽은) 저널 레코드
+    AES_CTX aes_ctx;                                         // AES 컨텍스트
+    uint8_t hmac_key[HMAC_KEY_SIZE];                         // HMAC 키 (파일 HMAC, 저널 태그)
+    uint8_t fingerprint_key[FILE_CHUNK_FINGERPRINT_KEY_SIZE]; // 섹터 지문 키
+    uint8_t nonce_counter[16];                               // 오프셋 0의 CTR 카운터
+    uint8_t* buffer;                                         // 청크 버퍼 (ENC_INPLACE_CHUNK_SIZE)
+} InPlaceRun;
+
+/**
+ * @brief 도출한 키로 AES 컨텍스트, 지문 키, CTR 카운터를 설정합니다 (run->hmac_key는 설정된 상태).
+ * @param run 제자리 작업 상태
+ * @param header 파일 헤더 (키 길이, nonce)
+ * @param aes_key AES 키
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_ENCRYPTION_FAILED
+ */
+static FILE_CRYPTO_STATUS in_place_set_keys(InPlaceRun* run, const EncFileHeader* header, const uint8_t* aes_key) {
+    if (AES_set_key(&run->aes_ctx, aes_key, enc_header_key_bits(header)) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    file_chunk_fingerprint_key(run->hmac_key, run->fingerprint_key);
+    memcpy(run->nonce_counter, header->nonce, 8);
+    memset(run->nonce_counter + 8, 0, 8);
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 비밀번호와 헤더의 salt로 키를 도출하고 KCV로 확인합니다.
+ * @param run 제자리 작업 상태
+ * @param header 파일 헤더
+ * @param password 비밀번호
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED 등
+ */
+static FILE_CRYPTO_STATUS in_place_derive_keys(InPlaceRun* run, const EncFileHeader* header, const char* password) {
+    int aes_key_bits = enc_header_key_bits(header);
+    if (aes_key_bits == 0) return FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    
+    uint8_t aes_key[32];
+    derive_keys(password, aes_key_bits, header->salt, ENC_SALT_SIZE, aes_key, run->hmac_key);
+    FILE_CRYPTO_STATUS result = verify_key_check_value(header, run->hmac_key, 0);
+    if (result == FILE_CRYPTO_SUCCESS) result = in_place_set_keys(run, header, aes_key);
+    memset(aes_key, 0, sizeof(aes_key));
+    return result;
+}
+
+// 저널 레코드 태그: HMAC(HMAC 키, 태그 앞부분)의 앞 32바이트
+static void in_place_journal_tag(const uint8_t* hmac_key, const EncInPlaceJournal* record, uint8_t* tag) {
+    uint8_t full[ENC_HMAC_SIZE];
+    HMAC_SHA512_CTX ctx;
+    hmac_sha512_init(&ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&ctx, (const uint8_t*)record, offsetof(EncInPlaceJournal, tag));
+    hmac_sha512_final(&ctx, full);
+    memcpy(tag, full, sizeof(record->tag));
+}
+
+/**
+ * @brief 저널 레코드를 기록하고 디스크에 반영합니다.
+ * @param run 제자리 작업 상태 (record의 순번을 올려 기록)
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_WRITE
+ * @note 순번의 홀짝으로 두 자리에 번갈아 기록하므로 기록 도중 중단되어도 직전 레코드는 그대로 남습니다.
+ */
+static FILE_CRYPTO_STATUS in_place_journal_write(InPlaceRun* run) {
+    uint64_t sequence = enc_load_be64(run->record.sequence) + 1;
+    enc_store_be64(run->record.sequence, sequence);
+    in_place_journal_tag(run->hmac_key, &run->record, run->record.tag);
+    
+    int64_t position = (int64_t)(sequence % 2) * (int64_t)sizeof(EncInPlaceJournal);
+    if (!platform_pwrite(run->journal, &run->record, sizeof(run->record), position) ||
+        !platform_sync_stream(run->journal)) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 저널의 두 자리 중 태그가 맞고 순번이 큰 레코드를 읽고 그 헤더로 키를 설정합니다.
+ * @param run 제자리 작업 상태 (journal 열림)
+ * @param password 비밀번호
+ * @param found 출력: 1이면 레코드를 읽음, 0이면 기록된 레코드 없음 (첫 레코드 기록 전에 중단됨)
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED, FILE_CRYPTO_ERR_INVALID_HEADER (손상된 저널)
+ */
+static FILE_CRYPTO_STATUS in_place_journal_load(InPlaceRun* run, const char* password, int* found) {
+    EncInPlaceJournal records[2];
+    FILE_CRYPTO_STATUS failure = FILE_CRYPTO_ERR_INVALID_HEADER;
+    int written = 0;
+    int best = -1;
+    *found = 0;
+    
+    for (int i = 0; i < 2; i++) {
+        if (platform_pread(run->journal, &records[i], sizeof(records[i]), (int64_t)i * (int64_t)sizeof(records[i])) !=
+            (int64_t)sizeof(records[i]) ||
+            memcmp(records[i].signature, ENC_INPLACE_JOURNAL_SIGNATURE, 4) != 0) {
+            continue;
+        }
+        written = 1;
+        
+        // 찢어진 레코드는 헤더도 깨졌을 수 있으므로 레코드마다 자기 헤더로 키를 도출해 태그 확인
+        // (유효한 두 레코드의 헤더는 같으므로 마지막으로 도출한 키가 선택한 레코드의 키)
+        FILE_CRYPTO_STATUS result = in_place_derive_keys(run, &records[i].header, password);
+        if (result != FILE_CRYPTO_SUCCESS) {
+            failure = result;
+            continue;
+        }
+        uint8_t tag[sizeof(records[i].tag)];
+        in_place_journal_tag(run->hmac_key, &records[i], tag);
+        if (memcmp(tag, records[i].tag, sizeof(tag)) != 0) continue;
+        if (best < 0 || enc_load_be64(records[i].sequence) > enc_load_be64(records[best].sequence)) best = i;
+    }
+    
+    if (!written) return FILE_CRYPTO_SUCCESS;
+    if (best < 0) return failure;
+    if (best == 0 && memcmp(&records[0].header, &records[1].header, sizeof(EncFileHeader)) != 0) {
+        FILE_CRYPTO_STATUS result = in_place_derive_keys(run, &records[0].header, password);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+    }
+    run->record = records[best];
+    *found = 1;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+// 데이터의 섹터별 지문 (섹터 번호는 파일 전체 기준이므로 같은 내용의 섹터도 위치가 다르면 지문이 다름)
+static void in_place_sector_fingerprints(const InPlaceRun* run, int64_t offset, const uint8_t* data, size_t length,
+                                         uint8_t (*sectors)[ENC_INPLACE_FINGERPRINT_SIZE]) {
+    for (size_t i = 0; i * ENC_INPLACE_SECTOR_SIZE < length; i++) {
+        size_t start = i * ENC_INPLACE_SECTOR_SIZE;
+        size_t sector_length = (length - start < ENC_INPLACE_SECTOR_SIZE) ? length - start : ENC_INPLACE_SECTOR_SIZE;
+        uint8_t fingerprint[ENC_CHUNK_FINGERPRINT_SIZE];
+        file_chunk_fingerprint(run->fingerprint_key, (uint64_t)(offset / ENC_INPLACE_SECTOR_SIZE) + i,
+                               data + start, sector_length, fingerprint);
+        memcpy(sectors[i], fingerprint, ENC_INPLACE_FINGERPRINT_SIZE);
+    }
+}
+
+// 파일 오프셋 offset부터의 데이터를 CTR로 변환 (암호화와 복호화가 같은 연산, offset은 16의 배수)
+static FILE_CRYPTO_STATUS in_place_transform(const InPlaceRun* run, int64_t offset, uint8_t* data, size_t length) {
+    uint8_t counter[16];
+    memcpy(counter, run->nonce_counter, sizeof(counter));
+    if (AES_CTR_seek(counter, (uint64_t)offset / 16) != CRYPTO_SUCCESS ||
+        AES_CTR_crypt(&run->aes_ctx, data, length, data, counter) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 중단된 청크를 섹터마다 변환 전 상태로 맞춥니다 (버퍼 안에서).
+ * @param run 제자리 작업 상태 (record.sectors가 이 청크의 변환 전 지문)
+ * @param offset 청크 오프셋
+ * @param length 청크 길이 (run->buffer에 현재 디스크 내용)
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 어느 상태와도 맞지 않는 섹터 (찢어진 섹터 기록)
+ * @note 섹터는 변환 전이거나 변환 후 중 하나이므로 현재 내용과 한 번 더 변환한 내용 중 지문이 맞는 쪽을 씁니다.
+ */
+static FILE_CRYPTO_STATUS in_place_resolve_chunk(InPlaceRun* run, int64_t offset, size_t length) {
+    for (size_t start = 0; start < length; start += ENC_INPLACE_SECTOR_SIZE) {
+        size_t sector_length = (length - start < ENC_INPLACE_SECTOR_SIZE) ? length - start : ENC_INPLACE_SECTOR_SIZE;
+        uint64_t sector = (uint64_t)(offset + (int64_t)start) / ENC_INPLACE_SECTOR_SIZE;
+        const uint8_t* expected = run->record.sectors[start / ENC_INPLACE_SECTOR_SIZE];
+        uint8_t current[ENC_CHUNK_FINGERPRINT_SIZE];
+        
+        file_chunk_fingerprint(run->fingerprint_key, sector, run->buffer + start, sector_length, current);
+        if (memcmp(current, expected, ENC_INPLACE_FINGERPRINT_SIZE) == 0) continue;
+        
+        FILE_CRYPTO_STATUS result = in_place_transform(run, offset + (int64_t)start, run->buffer + start, sector_length);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        file_chunk_fingerprint(run->fingerprint_key, sector, run->buffer + start, sector_length, current);
+        if (memcmp(current, expected, ENC_INPLACE_FINGERPRINT_SIZE) != 0) {
+            return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        }
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 저널의 진행 위치부터 data_size까지 청크마다 제자리에서 변환합니다.
+ * @param run 제자리 작업 상태 (record 설정, journal 열림)
+ * @param resumed 1이면 저널에서 이어서 하는 실행 (첫 청크를 먼저 변환 전 상태로 맞춤)
+ * @param hmac_ctx 변환 결과로 업데이트할 HMAC 컨텍스트 (암호화: 암호문, 필요 없으면 NULL)
+ * @param progress_cb 진행률 콜백 함수 (NULL 가능)
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ * @note 청크마다 변환 전 섹터 지문을 저널에 기록 → 변환해 같은 자리에 기록 → 디스크 반영 순서이므로,
+ *       어느 시점에 중단되어도 진행 위치 앞은 모두 변환됐고 진행 중인 청크는 섹터마다 판별할 수 있습니다.
+ */
+static FILE_CRYPTO_STATUS in_place_convert(InPlaceRun* run, int resumed, HMAC_SHA512_CTX* hmac_ctx,
+                                           progress_callback_t progress_cb, void* user_data) {
+    int64_t data_size = (int64_t)enc_load_be64(run->record.data_size);
+    int64_t offset = (int64_t)enc_load_be64(run->record.done);
+    FILE_CRYPTO_STATUS result;
+    
+    while (offset < data_size) {
+        size_t length = (data_size - offset < ENC_INPLACE_CHUNK_SIZE) ?
+                        (size_t)(data_size - offset) : ENC_INPLACE_CHUNK_SIZE;
+        if (platform_pread(run->file, run->buffer, length, offset) != (int64_t)length) {
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        if (resumed) {
+            result = in_place_resolve_chunk(run, offset, length);
+            if (result != FILE_CRYPTO_SUCCESS) return result;
+            resumed = 0;
+        }
+        
+        // 변환 전 지문을 먼저 기록 (이 기록이 이전 청크의 완료도 확정)
+        in_place_sector_fingerprints(run, offset, run->buffer, length, run->record.sectors);
+        enc_store_be64(run->record.done, (uint64_t)offset);
+        result = in_place_journal_write(run);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        
+        result = in_place_transform(run, offset, run->buffer, length);
+        if (result != FILE_CRYPTO_SUCCESS) return result;
+        if (hmac_ctx) hmac_sha512_update(hmac_ctx, run->buffer, length);
+        if (!platform_pwrite(run->file, run->buffer, length, offset) || !platform_sync_stream(run->file)) {
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        
+        offset += (int64_t)length;
+        if (progress_cb) progress_cb(offset, data_size, user_data);
+    }
+    
+    // 마지막 청크 완료 확정 (진행 중인 청크 없음)
+    memset(run->record.sectors, 0, sizeof(run->record.sectors));
+    enc_store_be64(run->record.done, (uint64_t)data_size);
+    return in_place_journal_write(run);
+}
+
+/**
+ * @brief 제자리 작업을 시작합니다 (대상 파일과 버퍼를 열고, 저널이 있으면 읽음).
+ * @param run 출력 제자리 작업 상태
+ * @param path 대상 파일 경로
+ * @param password 비밀번호 (저널 태그 확인용)
+ * @param journal_path 출력 저널 경로
+ * @param journal_path_size journal_path 크기
+ * @param resumed 출력: 1이면 중단된 작업의 저널을 읽음 (run->record와 키 설정)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드 (실패해도 in_place_close로 정리)
+ */
+static FILE_CRYPTO_STATUS in_place_open(InPlaceRun* run, const char* path, const char* password,
+                                        char* journal_path, size_t journal_path_size, int* resumed) {
+    memset(run, 0, sizeof(*run));
+    *resumed = 0;
+    
+    int written = snprintf(journal_path, journal_path_size, "%s%s", path, ENC_INPLACE_JOURNAL_SUFFIX);
+    if (written < 0 || (size_t)written >= journal_path_size) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    run->buffer = (uint8_t*)malloc(ENC_INPLACE_CHUNK_SIZE);
+    if (!run->buffer) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    run->file = platform_fopen(path, "r+b");
+    if (!run->file) return FILE_CRYPTO_ERR_FILE_OPEN;
+    if (!platform_file_exists(journal_path)) return FILE_CRYPTO_SUCCESS;
+    
+    run->journal = platform_fopen(journal_path, "r+b");
+    if (!run->journal) return FILE_CRYPTO_ERR_FILE_OPEN;
+    FILE_CRYPTO_STATUS result = in_place_journal_load(run, password, resumed);
+    if (result != FILE_CRYPTO_SUCCESS || !*resumed) return result;
+    
+    // 저널 이후 파일이 잘렸으면 이어서 할 수 없음
+    int64_t file_size = (platform_fseek64(run->file, 0, SEEK_END) == 0) ? platform_ftell64(run->file) : -1;
+    if (file_size < (int64_t)enc_load_be64(run->record.data_size)) return FILE_CRYPTO_ERR_FILE_SIZE;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+// 새 저널 파일 생성 (기록된 레코드 없이 남은 저널이 있으면 덮어씀)
+static FILE_CRYPTO_STATUS in_place_create_journal(InPlaceRun* run, const char* journal_path) {
+    if (run->journal) fclose(run->journal);
+    run->journal = platform_fopen(journal_path, "w+b");
+    return run->journal ? FILE_CRYPTO_SUCCESS : FILE_CRYPTO_ERR_FILE_OPEN;
+}
+
+/**
+ * @brief 제자리 작업을 마칩니다 (성공하면 저널 삭제, 실패하면 저널을 남겨 이어서 하거나 되돌릴 수 있게 함).
+ * @param run 제자리 작업 상태
+ * @param journal_path 저널 경로
+ * @param result 작업 결과
+ * @return 최종 결과 (대상 파일을 닫다가 실패하면 FILE_CRYPTO_ERR_FILE_WRITE)
+ */
+static FILE_CRYPTO_STATUS in_place_close(InPlaceRun* run, const char* journal_path, FILE_CRYPTO_STATUS result) {
+    if (run->file && fclose(run->file) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    if (run->journal) fclose(run->journal);
+    if (result == FILE_CRYPTO_SUCCESS && run->journal) platform_delete_file(journal_path);
+    free(run->buffer);
+    memset(run, 0, sizeof(*run));
+    return result;
+}
+
+/**
+ * @brief 제자리 암호화를 새로 시작합니다 (키 도출, 헤더 생성, 저널 생성).
+ * @param run 제자리 작업 상태
+ * @param path 대상 파일 경로 (헤더에 확장자 기록)
+ * @param aes_key_bits AES 키 길이
+ * @param password 비밀번호
+ * @param journal_path 저널 경로
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS in_place_begin_encrypt(InPlaceRun* run, const char* path, int aes_key_bits,
+                                                 const char* password, const char* journal_path) {
+    int64_t data_size = (platform_fseek64(run->file, 0, SEEK_END) == 0) ? platform_ftell64(run->file) : -1;
+    if (data_size < 0) return FILE_CRYPTO_ERR_FILE_SIZE;
+    
+    // 이미 암호화된 파일은 다시 암호화하지 않음 (v10 트레일러, 또는 앞에 헤더가 있는 v2~v9 파일)
+    // 저널 삭제 후 이름 변경 전에 중단된 실행을 다시 하면 여기서 걸림
+    uint8_t head[4] = { 0 };
+    size_t head_length = (data_size < (int64_t)sizeof(head)) ? (size_t)data_size : sizeof(head);
+    if (platform_pread(run->file, head, head_length, 0) != (int64_t)head_length) return FILE_CRYPTO_ERR_FILE_READ;
+    EncFileHeader existing;
+    if (in_place_read_trailer(run->file, data_size, &existing) ||
+        (head_length == sizeof(head) && memcmp(head, ENC_SIGNATURE, 4) == 0)) {
+        return FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
+    }
+    
+    uint8_t salt[ENC_SALT_SIZE];
+    uint8_t aes_key[32];
+    uint8_t key_check[ENC_KCV_SIZE];
+    generate_salt(salt, sizeof(salt));
+    derive_keys(password, aes_key_bits, salt, sizeof(salt), aes_key, run->hmac_key);
+    derive_key_check_value(run->hmac_key, key_check, sizeof(key_check));
+    if (AES_set_key(&run->aes_ctx, aes_key, aes_key_bits) != CRYPTO_SUCCESS) {
+        memset(aes_key, 0, sizeof(aes_key));
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    
+    // 암호문 앞 4바이트가 시그니처와 같으면 앞에 헤더가 있는 파일로 읽히므로 nonce를 다시 만듦
+    uint8_t nonce[8];
+    uint8_t probe[4];
+    do {
+        uint8_t counter[16];
+        generate_nonce(nonce, sizeof(nonce));
+        memcpy(counter, nonce, 8);
+        memset(counter + 8, 0, 8);
+        AES_CTR_crypt(&run->aes_ctx, head, sizeof(head), probe, counter);
+    } while (head_length == sizeof(head) && memcmp(probe, ENC_SIGNATURE, 4) == 0);
+    
+    memset(&run->record, 0, sizeof(run->record));
+    FILE_CRYPTO_STATUS result = create_encryption_header(path, aes_key_bits, salt, nonce, key_check,
+                                                         ENC_VERSION_INPLACE, &run->record.header);
+    if (result == FILE_CRYPTO_SUCCESS) result = in_place_set_keys(run, &run->record.header, aes_key);
+    memset(aes_key, 0, sizeof(aes_key));
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    
+    memcpy(run->record.signature, ENC_INPLACE_JOURNAL_SIGNATURE, 4);
+    run->record.operation = ENC_INPLACE_ENCRYPT;
+    enc_store_be64(run->record.data_size, (uint64_t)data_size);
+    return in_place_create_journal(run, journal_path);
+}
+
+/**
+ * @brief 제자리 복호화를 새로 시작합니다 (트레일러 확인, 키 도출, 전체 HMAC 검증, 저널 생성).
+ * @param run 제자리 작업 상태
+ * @param password 비밀번호
+ * @param journal_path 저널 경로
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드 (검증에 실패하면 파일을 바꾸지 않음)
+ */
+static FILE_CRYPTO_STATUS in_place_begin_decrypt(InPlaceRun* run, const char* password, const char* journal_path) {
+    int64_t file_size = (platform_fseek64(run->file, 0, SEEK_END) == 0) ? platform_ftell64(run->file) : -1;
+    memset(&run->record, 0, sizeof(run->record));
+    EncFileHeader* header = &run->record.header;
+    if (!in_place_read_trailer(run->file, file_size, header)) {
+        // 앞에 헤더가 있는 파일은 일반 복호화로 처리
+        uint8_t signature[4];
+        if (platform_pread(run->file, signature, sizeof(signature), 0) == (int64_t)sizeof(signature) &&
+            memcmp(signature, ENC_SIGNATURE, 4) == 0) {
+            return FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
+        }
+        return FILE_CRYPTO_ERR_INVALID_SIGNATURE;
+    }
+    
+    int64_t data_size = file_size - ENC_INPLACE_TRAILER_SIZE;
+    if (platform_pread(run->file, run->record.hmac, ENC_HMAC_SIZE, file_size - ENC_HMAC_SIZE) != ENC_HMAC_SIZE) {
+        return FILE_CRYPTO_ERR_FILE_READ;
+    }
+    FILE_CRYPTO_STATUS result = in_place_derive_keys(run, header, password);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    
+    // 평문을 쓰기 전에 전체 HMAC 검증 (v4와 같이 헤더 + 암호문)
+    HMAC_SHA512_CTX hmac_ctx;
+    hmac_sha512_init(&hmac_ctx, run->hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)header, sizeof(EncFileHeader));
+    for (int64_t offset = 0; offset < data_size; ) {
+        size_t length = (data_size - offset < ENC_INPLACE_CHUNK_SIZE) ?
+                        (size_t)(data_size - offset) : ENC_INPLACE_CHUNK_SIZE;
+        if (platform_pread(run->file, run->buffer, length, offset) != (int64_t)length) return FILE_CRYPTO_ERR_FILE_READ;
+        hmac_sha512_update(&hmac_ctx, run->buffer, length);
+        offset += (int64_t)length;
+    }
+    uint8_t computed_hmac[ENC_HMAC_SIZE];
+    hmac_sha512_final(&hmac_ctx, computed_hmac);
+    if (memcmp(computed_hmac, run->record.hmac, ENC_HMAC_SIZE) != 0) return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+    
+    memcpy(run->record.signature, ENC_INPLACE_JOURNAL_SIGNATURE, 4);
+    run->record.operation = ENC_INPLACE_DECRYPT;
+    enc_store_be64(run->record.data_size, (uint64_t)data_size);
+    return in_place_create_journal(run, journal_path);
+}
+
+FILE_CRYPTO_STATUS encrypt_file_in_place(const char* path, int aes_key_bits, const char* password,
+                                         progress_callback_t progress_cb, void* user_data) {
+    if (!path || !password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) {
+        return FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    }
+    
+    InPlaceRun run;
+    char journal_path[MAX_PATH_LENGTH];
+    int resumed;
+    FILE_CRYPTO_STATUS result = in_place_open(&run, path, password, journal_path, sizeof(journal_path), &resumed);
+    if (result == FILE_CRYPTO_SUCCESS && resumed &&
+        (run.record.operation != ENC_INPLACE_ENCRYPT || run.record.flags != 0)) {
+        result = FILE_CRYPTO_ERR_INVALID_INPUT;  // 다른 작업(복호화, 되돌리기)의 저널
+    }
+    if (result == FILE_CRYPTO_SUCCESS && !resumed) {
+        result = in_place_begin_encrypt(&run, path, aes_key_bits, password, journal_path);
+    }
+    
+    // HMAC(헤더 + 암호문): 이어서 할 때는 이미 암호화한 앞부분을 다시 읽어 반영
+    HMAC_SHA512_CTX hmac_ctx;
+    if (result == FILE_CRYPTO_SUCCESS) {
+        hmac_sha512_init(&hmac_ctx, run.hmac_key, HMAC_KEY_SIZE);
+        hmac_sha512_update(&hmac_ctx, (const uint8_t*)&run.record.header, sizeof(EncFileHeader));
+        int64_t done = (int64_t)enc_load_be64(run.record.done);
+        for (int64_t offset = 0; offset < done && result == FILE_CRYPTO_SUCCESS; ) {
+            size_t length = (done - offset < ENC_INPLACE_CHUNK_SIZE) ? (size_t)(done - offset) : ENC_INPLACE_CHUNK_SIZE;
+            if (platform_pread(run.file, run.buffer, length, offset) != (int64_t)length) {
+                result = FILE_CRYPTO_ERR_FILE_READ;
+            }
+            hmac_sha512_update(&hmac_ctx, run.buffer, length);
+            offset += (int64_t)length;
+        }
+    }
+    if (result == FILE_CRYPTO_SUCCESS) result = in_place_convert(&run, resumed, &hmac_ctx, progress_cb, user_data);
+    
+    // 트레일러 기록 (기록 도중 중단되면 다시 실행해 새로 기록) 후 저널 삭제
+    if (result == FILE_CRYPTO_SUCCESS) {
+        int64_t data_size = (int64_t)enc_load_be64(run.record.data_size);
+        uint8_t trailer[ENC_INPLACE_TRAILER_SIZE];
+        memcpy(trailer, &run.record.header, sizeof(EncFileHeader));
+        hmac_sha512_final(&hmac_ctx, trailer + sizeof(EncFileHeader));
+        if (!platform_pwrite(run.file, trailer, sizeof(trailer), data_size) ||
+            !platform_truncate_stream(run.file, data_size + (int64_t)sizeof(trailer)) ||
+            !platform_sync_stream(run.file)) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+    }
+    return in_place_close(&run, journal_path, result);
+}
+
+FILE_CRYPTO_STATUS decrypt_file_in_place(const char* path, const char* password, char* extension, size_t extension_size,
+                                         progress_callback_t progress_cb, void* user_data) {
+    if (!path || !password || (extension && extension_size < 8)) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    InPlaceRun run;
+    char journal_path[MAX_PATH_LENGTH];
+    int resumed;
+    FILE_CRYPTO_STATUS result = in_place_open(&run, path, password, journal_path, sizeof(journal_path), &resumed);
+    if (result == FILE_CRYPTO_SUCCESS && resumed &&
+        (run.record.operation != ENC_INPLACE_DECRYPT || run.record.flags != 0)) {
+        result = FILE_CRYPTO_ERR_INVALID_INPUT;  // 다른 작업(암호화, 되돌리기)의 저널
+    }
+    if (result == FILE_CRYPTO_SUCCESS && !resumed) result = in_place_begin_decrypt(&run, password, journal_path);
+    if (result == FILE_CRYPTO_SUCCESS) result = in_place_convert(&run, resumed, NULL, progress_cb, user_data);
+    
+    // 트레일러를 잘라낸 뒤 저널 삭제
+    if (result == FILE_CRYPTO_SUCCESS &&
+        (!platform_truncate_stream(run.file, (int64_t)enc_load_be64(run.record.data_size)) ||
+         !platform_sync_stream(run.file))) {
+        result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    if (result == FILE_CRYPTO_SUCCESS && extension) {
+        memcpy(extension, run.record.header.format, 7);  // create_encryption_header와 같이 최대 7바이트
+        extension[7] = '\0';
+    }
+    return in_place_close(&run, journal_path, result);
+}
+
+FILE_CRYPTO_STATUS enc_in_place_rollback(const char* path, const char* password) {
+    if (!path || !password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    InPlaceRun run;
+    char journal_path[MAX_PATH_LENGTH];
+    int resumed;
+    FILE_CRYPTO_STATUS result = in_place_open(&run, path, password, journal_path, sizeof(journal_path), &resumed);
+    if (result == FILE_CRYPTO_SUCCESS && !resumed) {
+        // 저널이 없거나 첫 레코드 전에 중단됨 (파일은 바뀌지 않음)
+        if (run.journal) {
+            fclose(run.journal);
+            run.journal = NULL;
+            platform_delete_file(journal_path);
+            return in_place_close(&run, journal_path, FILE_CRYPTO_SUCCESS);
+        }
+        result = FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+    
+    if (result == FILE_CRYPTO_SUCCESS && !(run.record.flags & ENC_INPLACE_ROLLBACK)) {
+        int64_t data_size = (int64_t)enc_load_be64(run.record.data_size);
+        int64_t done = (int64_t)enc_load_be64(run.record.done);
+        
+        // 진행 중이던 청크를 변환 전 상태로 되돌림
+        if (done < data_size) {
+            size_t length = (data_size - done < ENC_INPLACE_CHUNK_SIZE) ?
+                            (size_t)(data_size - done) : ENC_INPLACE_CHUNK_SIZE;
+            if (platform_pread(run.file, run.buffer, length, done) != (int64_t)length) {
+                result = FILE_CRYPTO_ERR_FILE_READ;
+            } else {
+                result = in_place_resolve_chunk(&run, done, length);
+            }
+            if (result == FILE_CRYPTO_SUCCESS && !platform_pwrite(run.file, run.buffer, length, done)) {
+                result = FILE_CRYPTO_ERR_FILE_WRITE;
+            }
+        }
+        
+        // 암호화는 이미 붙인 트레일러를 떼고, 복호화는 이미 잘라낸 트레일러를 다시 붙임
+        if (result == FILE_CRYPTO_SUCCESS) {
+            int64_t file_size = (platform_fseek64(run.file, 0, SEEK_END) == 0) ? platform_ftell64(run.file) : -1;
+            if (run.record.operation == ENC_INPLACE_ENCRYPT) {
+                if (file_size != data_size && !platform_truncate_stream(run.file, data_size)) {
+                    result = FILE_CRYPTO_ERR_FILE_WRITE;
+                }
+            } else if (file_size == data_size) {
+                uint8_t trailer[ENC_INPLACE_TRAILER_SIZE];
+                memcpy(trailer, &run.record.header, sizeof(EncFileHeader));
+                memcpy(trailer + sizeof(EncFileHeader), run.record.hmac, ENC_HMAC_SIZE);
+                if (!platform_pwrite(run.file, trailer, sizeof(trailer), data_size)) result = FILE_CRYPTO_ERR_FILE_WRITE;
+            }
+        }
+        if (result == FILE_CRYPTO_SUCCESS && !platform_sync_stream(run.file)) result = FILE_CRYPTO_ERR_FILE_WRITE;
+        
+        // 변환한 앞부분 [0, done)을 반대로 변환하는 작업으로 바꿈 (다음 저널 기록부터 적용)
+        run.record.operation = (run.record.operation == ENC_INPLACE_ENCRYPT) ? ENC_INPLACE_DECRYPT : ENC_INPLACE_ENCRYPT;
+        run.record.flags = ENC_INPLACE_ROLLBACK;
+        enc_store_be64(run.record.data_size, (uint64_t)done);
+        enc_store_be64(run.record.done, 0);
+        resumed = 0;
+    }
+    
+    if (result == FILE_CRYPTO_SUCCESS) result = in_place_convert(&run, resumed, NULL, NULL, NULL);
+    return in_place_close(&run, journal_path, result);
+}
+
+int enc_in_place_pending(const char* path) {
+    char journal_path[MAX_PATH_LENGTH];
+    if (!path) return 0;
+    int written = snprintf(journal_path, sizeof(journal_path), "%s%s", path, ENC_INPLACE_JOURNAL_SUFFIX);
+    return (written > 0 && (size_t)written < sizeof(journal_path) && platform_file_exists(journal_path)) ? 1 : 0;
+}
+
+int enc_in_place_encrypted(const char* path) {
+    if (!path || enc_in_place_pending(path)) return 0;
+    FILE* fin = platform_fopen(path, "rb");
+    if (!fin) return 0;
+    EncFileHeader header;
+    int64_t file_size = (platform_fseek64(fin, 0, SEEK_END) == 0) ? platform_ftell64(fin) : -1;
+    int encrypted = in_place_read_trailer(fin, file_size, &header);
+    fclose(fin);
+    return encrypted;
+}
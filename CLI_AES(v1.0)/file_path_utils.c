@@ -92,3 +92,34 @@ void build_output_path(char* output_path, size_t output_size,
     }
 }
 
+// 파일 경로를 디렉토리와 확장자를 뺀 파일명으로 분리 (예: "dir/photo.png" -> "dir", "photo")
+// 구분자가 없으면 디렉토리는 "." (현재 디렉토리), 버퍼가 작으면 빈 문자열
+void split_file_path(const char* file_path, char* dir, size_t dir_size,
+                     char* stem, size_t stem_size) {
+    if (dir && dir_size > 0) dir[0] = '\0';
+    if (stem && stem_size > 0) stem[0] = '\0';
+    if (!file_path || !dir || dir_size == 0 || !stem || stem_size == 0) return;
+    
+    const char* last_slash = platform_find_last_separator(file_path);
+    const char* name = last_slash ? last_slash + 1 : file_path;
+    
+    // 디렉토리 (루트의 파일은 구분자 하나를 남김: "/a.txt" -> "/")
+    if (!last_slash) {
+        snprintf(dir, dir_size, ".");
+    } else {
+        size_t dir_len = (last_slash == file_path) ? 1 : (size_t)(last_slash - file_path);
+        if (dir_len < dir_size) {
+            memcpy(dir, file_path, dir_len);
+            dir[dir_len] = '\0';
+        }
+    }
+    
+    // 마지막 점 앞까지가 파일명 (".bashrc"처럼 점으로 시작하면 전체가 파일명)
+    const char* last_dot = strrchr(name, '.');
+    size_t stem_len = (last_dot && last_dot != name) ? (size_t)(last_dot - name) : strlen(name);
+    if (stem_len < stem_size) {
+        memcpy(stem, name, stem_len);
+        stem[stem_len] = '\0';
+    }
+}
+
@@ -0,0 +1,249 @@
+#include "file_pipeline.h"
+#include "platform_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 대기 시 sleep으로 넘어가기 전 yield 횟수
+#define PIPELINE_SPIN_LIMIT 64
+
+// 파이프라인 단계
+enum {
+    STAGE_READ = 0,
+    STAGE_DIGEST,
+    STAGE_CTR,
+    STAGE_MAC,
+    STAGE_WRITE,
+    STAGE_COUNT
+};
+
+// 링 버퍼 슬롯 (length == 0이면 스트림 끝 표시)
+typedef struct {
+    uint8_t* data;
+    size_t length;
+} PipelineSlot;
+
+typedef struct FilePipeline FilePipeline;
+
+// 단계 스레드 인자
+typedef struct {
+    FilePipeline* pipeline;
+    int stage;
+} PipelineStageArg;
+
+struct FilePipeline {
+    FilePipelineJob* job;
+    PipelineSlot slots[PIPELINE_SLOT_COUNT];
+    volatile long done[STAGE_COUNT];   // 단계별 완료한 청크 수 (해당 단계 스레드만 증가시킴)
+    volatile long status;              // 처음 발생한 에러 (FILE_CRYPTO_SUCCESS면 정상)
+    int prev[STAGE_COUNT];             // 각 단계가 기다리는 앞 단계
+    int last_stage;                    // 호출 스레드가 실행하는 마지막 단계
+    int64_t processed;                 // 마지막 단계까지 처리된 바이트 (호출 스레드 전용)
+};
+
+/**
+ * @brief 파이프라인을 에러 상태로 전환합니다 (처음 발생한 에러만 기록).
+ * @param pipeline 파이프라인
+ * @param status 에러 코드
+ */
+static void pipeline_fail(FilePipeline* pipeline, FILE_CRYPTO_STATUS status) {
+    platform_atomic_compare_exchange(&pipeline->status, FILE_CRYPTO_SUCCESS, (long)status);
+}
+
+/**
+ * @brief 지정한 단계가 target개 청크를 완료할 때까지 기다립니다.
+ * @param pipeline 파이프라인
+ * @param stage 기다릴 단계
+ * @param target 필요한 완료 청크 수
+ * @return 1 조건 충족, 0 다른 단계의 에러로 중단
+ * @note 잠깐 yield로 기다린 뒤 디스크 대기처럼 긴 대기는 sleep으로 CPU를 양보합니다.
+ */
+static int pipeline_wait(FilePipeline* pipeline, int stage, long target) {
+    int spins = 0;
+    while (platform_atomic_load(&pipeline->done[stage]) < target) {
+        if (platform_atomic_load(&pipeline->status) != FILE_CRYPTO_SUCCESS) return 0;
+        if (spins < PIPELINE_SPIN_LIMIT) {
+            spins++;
+            platform_thread_yield();
+        } else {
+            platform_sleep_ms(1);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 읽기 단계: 빈 슬롯에 입력 파일의 다음 청크를 읽어 넣습니다.
+ * @param pipeline 파이프라인
+ * @note 마지막 단계가 슬롯을 돌려준 뒤에만 재사용하므로 메모리는 슬롯 수로 제한됩니다.
+ */
+static void pipeline_read_stage(FilePipeline* pipeline) {
+    FilePipelineJob* job = pipeline->job;
+    int64_t remaining = job->length;
+    
+    for (long index = 0; ; index++) {
+        // 슬롯 index % N은 마지막 단계가 (index - N)번째 청크를 끝내야 비어 있음
+        if (!pipeline_wait(pipeline, pipeline->last_stage, index + 1 - PIPELINE_SLOT_COUNT)) return;
+        
+        PipelineSlot* slot = &pipeline->slots[index % PIPELINE_SLOT_COUNT];
+        size_t to_read = job->chunk_size;
+        if (job->length >= 0 && (uint64_t)remaining < (uint64_t)to_read) {
+            to_read = (size_t)remaining;
+        }
+        
+        size_t bytes_read = (to_read > 0) ? fread(slot->data, 1, to_read, job->fin) : 0;
+        if (bytes_read == 0 && (ferror(job->fin) || (job->length >= 0 && remaining > 0))) {
+            pipeline_fail(pipeline, FILE_CRYPTO_ERR_FILE_READ);  // 읽기 오류 또는 예상보다 짧은 파일
+            return;
+        }
+        if (job->length >= 0) remaining -= (int64_t)bytes_read;
+        
+        slot->length = bytes_read;
+        platform_atomic_store(&pipeline->done[STAGE_READ], index + 1);
+        if (bytes_read == 0) return;  // 스트림 끝 표시를 넘기고 종료
+    }
+}
+
+/**
+ * @brief 해시/CTR/HMAC/쓰기 단계의 청크 하나를 처리합니다.
+ * @param pipeline 파이프라인
+ * @param stage 단계
+ * @param slot 처리할 슬롯
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ */
+static FILE_CRYPTO_STATUS pipeline_process_slot(FilePipeline* pipeline, int stage, PipelineSlot* slot) {
+    FilePipelineJob* job = pipeline->job;
+    
+    switch (stage) {
+    case STAGE_DIGEST:
+        // CTR이 슬롯을 덮어쓰기 전에 해시 (별도 스레드라 CTR과 겹쳐 실행)
+        sha512_update(job->digest_ctx, slot->data, slot->length);
+        break;
+    case STAGE_CTR:
+        // CTR (in-place), 카운터는 이 단계만 사용하므로 순서대로 증가
+        if (AES_CTR_crypt(job->aes_ctx, slot->data, slot->length, slot->data, job->nonce_counter) != CRYPTO_SUCCESS) {
+            return job->ctr_error;
+        }
+        break;
+    case STAGE_MAC:
+        hmac_sha512_update(job->hmac_ctx, slot->data, slot->length);
+        break;
+    case STAGE_WRITE:
+        if (fwrite(slot->data, 1, slot->length, job->fout) != slot->length) {
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        break;
+    default:
+        break;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 읽기 이후 단계를 실행합니다 (앞 단계가 끝낸 청크를 순서대로 처리).
+ * @param pipeline 파이프라인
+ * @param stage 실행할 단계
+ */
+static void pipeline_compute_stage(FilePipeline* pipeline, int stage) {
+    for (long index = 0; ; index++) {
+        if (!pipeline_wait(pipeline, pipeline->prev[stage], index + 1)) return;
+        
+        PipelineSlot* slot = &pipeline->slots[index % PIPELINE_SLOT_COUNT];
+        if (slot->length > 0) {
+            FILE_CRYPTO_STATUS result = pipeline_process_slot(pipeline, stage, slot);
+            if (result != FILE_CRYPTO_SUCCESS) {
+                pipeline_fail(pipeline, result);
+                return;
+            }
+            if (stage == pipeline->last_stage) {
+                pipeline->processed += (int64_t)slot->length;
+                if (pipeline->job->on_chunk) {
+                    pipeline->job->on_chunk(pipeline->processed, pipeline->job->user_data);
+                }
+            }
+        }
+        
+        platform_atomic_store(&pipeline->done[stage], index + 1);
+        if (slot->length == 0) return;
+    }
+}
+
+// 스레드 진입점
+static void pipeline_stage_thread(void* arg) {
+    PipelineStageArg* stage_arg = (PipelineStageArg*)arg;
+    if (stage_arg->stage == STAGE_READ) {
+        pipeline_read_stage(stage_arg->pipeline);
+    } else {
+        pipeline_compute_stage(stage_arg->pipeline, stage_arg->stage);
+    }
+}
+
+/**
+ * @brief 파일 처리 파이프라인을 실행합니다.
+ * @param job 작업 설명 (processed 필드에 처리한 바이트 수 기록)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 실패 시 에러 코드
+ */
+FILE_CRYPTO_STATUS file_pipeline_run(FilePipelineJob* job) {
+    if (!job || !job->fin || job->chunk_size == 0) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (job->aes_ctx && !job->nonce_counter) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    FilePipeline pipeline;
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.job = job;
+    pipeline.status = FILE_CRYPTO_SUCCESS;
+    job->processed = 0;
+    
+    // 활성 단계 연결 (생략된 단계는 건너뜀)
+    int active[STAGE_COUNT];
+    active[STAGE_READ] = 1;
+    active[STAGE_DIGEST] = (job->digest_ctx != NULL);
+    active[STAGE_CTR] = (job->aes_ctx != NULL);
+    active[STAGE_MAC] = (job->hmac_ctx != NULL);
+    active[STAGE_WRITE] = (job->fout != NULL);
+    
+    int previous = STAGE_READ;
+    for (int stage = STAGE_DIGEST; stage < STAGE_COUNT; stage++) {
+        if (!active[stage]) continue;
+        pipeline.prev[stage] = previous;
+        previous = stage;
+    }
+    if (previous == STAGE_READ) return FILE_CRYPTO_ERR_INVALID_INPUT;  // 읽기만 하는 작업은 없음
+    pipeline.last_stage = previous;
+    
+    // 슬롯 버퍼 미리 할당 (작업 중에는 할당 없음)
+    for (int i = 0; i < PIPELINE_SLOT_COUNT; i++) {
+        pipeline.slots[i].data = (uint8_t*)malloc(job->chunk_size);
+        if (!pipeline.slots[i].data) {
+            for (int j = 0; j < i; j++) free(pipeline.slots[j].data);
+            return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+        }
+    }
+    
+    // 마지막 단계를 제외한 단계마다 스레드 생성
+    PipelineStageArg args[STAGE_COUNT];
+    platform_thread_t* threads[STAGE_COUNT] = { NULL };
+    for (int stage = STAGE_READ; stage < pipeline.last_stage; stage++) {
+        if (!active[stage]) continue;
+        args[stage].pipeline = &pipeline;
+        args[stage].stage = stage;
+        threads[stage] = platform_thread_create(pipeline_stage_thread, &args[stage]);
+        if (!threads[stage]) {
+            pipeline_fail(&pipeline, FILE_CRYPTO_ERR_MEMORY_ALLOCATION);
+            break;
+        }
+    }
+    
+    // 마지막 단계(쓰기 또는 HMAC)는 호출 스레드에서 실행하며 진행률 보고
+    if (platform_atomic_load(&pipeline.status) == FILE_CRYPTO_SUCCESS) {
+        pipeline_compute_stage(&pipeline, pipeline.last_stage);
+    }
+    
+    for (int stage = STAGE_READ; stage < STAGE_COUNT; stage++) {
+        platform_thread_join(threads[stage]);
+    }
+    for (int i = 0; i < PIPELINE_SLOT_COUNT; i++) {
+        free(pipeline.slots[i].data);
+    }
+    
+    job->processed = pipeline.processed;
+    return (FILE_CRYPTO_STATUS)platform_atomic_load(&pipeline.status);
+}
@@ -0,0 +1,48 @@
+#ifndef FILE_PIPELINE_H
+#define FILE_PIPELINE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "crypto_api.h"
+#include "hmac_sha512.h"
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 링 버퍼 슬롯 수 (메모리 사용 상한 = PIPELINE_SLOT_COUNT × chunk_size)
+#define PIPELINE_SLOT_COUNT 8
+
+// 청크 하나가 마지막 단계를 통과할 때마다 호출 (호출한 스레드에서 실행, 누적 처리 바이트 전달)
+typedef void (*pipeline_chunk_callback_t)(int64_t processed, void* user_data);
+
+// 파이프라인 작업 설명
+// 단계 순서: 읽기 → 해시 → CTR → HMAC → 쓰기 (NULL인 단계는 생략)
+// 해시는 CTR 이전(암호화 시 평문), HMAC은 CTR 이후의 버퍼 내용에 적용되므로 암호화 시 Encrypt-then-MAC과 같은 결과
+typedef struct {
+    FILE* fin;                          // 입력 파일 (현재 위치부터 읽음)
+    FILE* fout;                         // 출력 파일 (NULL이면 쓰지 않음)
+    int64_t length;                     // 읽을 바이트 수 (-1이면 EOF까지)
+    size_t chunk_size;                  // 슬롯 하나의 크기
+    SHA512_CTX* digest_ctx;             // 해시 단계 컨텍스트 (CTR 이전 내용, NULL이면 생략)
+    const AES_CTX* aes_ctx;             // CTR 단계 키 (NULL이면 CTR 생략)
+    uint8_t* nonce_counter;             // CTR 카운터 (16바이트, 처리한 만큼 증가)
+    FILE_CRYPTO_STATUS ctr_error;       // CTR 실패 시 반환할 에러 코드
+    HMAC_SHA512_CTX* hmac_ctx;          // HMAC 단계 컨텍스트 (NULL이면 HMAC 생략)
+    pipeline_chunk_callback_t on_chunk; // 진행률 콜백 (NULL 가능)
+    void* user_data;                    // 콜백에 전달할 사용자 데이터
+    int64_t processed;                  // [out] 마지막 단계까지 처리된 바이트 수
+} FilePipelineJob;
+
+// 읽기/CTR/HMAC 단계를 각각 별도 스레드에서, 마지막 단계를 호출 스레드에서 실행
+// 단계 사이는 미리 할당한 슬롯 링과 단계별 원자 카운터로 연결 (락 없음)
+// 결과는 같은 입력에 대한 단일 스레드 처리와 바이트 단위로 동일
+FILE_CRYPTO_STATUS file_pipeline_run(FilePipelineJob* job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_PIPELINE_H
@@ -0,0 +1,324 @@
+#include "file_segments.h"
+#include "aes_ctr_hmac.h"
+#include "platform_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 세그먼트 하나의 태그 포함 크기
+#define SEGMENT_RECORD_SIZE FILE_SEGMENT_BUFFER_SIZE
+
+// 해시 차례를 기다릴 때 sleep으로 넘어가기 전 yield 횟수
+#define SEGMENT_SPIN_LIMIT 64
+
+typedef struct FileSegments FileSegments;
+
+// 작업 스레드 인자
+typedef struct {
+    FileSegments* segments;
+    uint8_t* buffer;               // 세그먼트 하나 + 태그 크기 (스레드 전용)
+} SegmentWorkerArg;
+
+struct FileSegments {
+    FileSegmentJob* job;
+    uint64_t count;                // 전체 세그먼트 수 (마지막 세그먼트 포함)
+    size_t final_length;           // 마지막 세그먼트 암호문 길이
+    int64_t in_stride;             // 입력에서 세그먼트 간격
+    int64_t out_stride;            // 출력에서 세그먼트 간격
+    volatile long next;            // 다음에 가져갈 세그먼트 번호
+    volatile long done;            // 처리를 마친 세그먼트 수
+    volatile long hashed;          // 평문 해시에 넣은 세그먼트 수 (다음 해시 차례의 세그먼트 번호)
+    volatile long status;          // 처음 발생한 에러 (FILE_CRYPTO_SUCCESS면 정상)
+};
+
+void file_segment_begin_tag(const HMAC_SHA512_CTX* header_ctx, uint64_t index, int is_final,
+                            HMAC_SHA512_CTX* segment_ctx) {
+    uint8_t info[9];
+    for (int i = 0; i < 8; i++) {
+        info[i] = (uint8_t)(index >> (56 - 8 * i));  // big-endian
+    }
+    info[8] = is_final ? 1 : 0;
+    
+    *segment_ctx = *header_ctx;  // 헤더 HMAC 상태 복사 (세그먼트마다 헤더를 다시 해시하지 않음)
+    hmac_sha512_update(segment_ctx, info, sizeof(info));
+}
+
+void file_segment_counter(const uint8_t* base_counter, uint64_t index, uint8_t* counter) {
+    memcpy(counter, base_counter, 16);
+    AES_CTR_seek(counter, index * (uint64_t)(ENC_SEGMENT_SIZE / 16));
+}
+
+int file_segment_layout(int64_t segment_bytes, uint64_t* count, size_t* final_length) {
+    if (segment_bytes < ENC_HMAC_SIZE) return 0;
+    
+    int64_t full = segment_bytes / SEGMENT_RECORD_SIZE;
+    int64_t rest = segment_bytes % SEGMENT_RECORD_SIZE;
+    if (rest < ENC_HMAC_SIZE) return 0;  // 마지막 세그먼트는 항상 태그를 가짐
+    
+    if (count) *count = (uint64_t)full + 1;
+    if (final_length) *final_length = (size_t)(rest - ENC_HMAC_SIZE);
+    return 1;
+}
+
+/**
+ * @brief 작업을 에러 상태로 전환합니다 (처음 발생한 에러만 기록).
+ * @param segments 세그먼트 작업 상태
+ * @param status 에러 코드
+ * @return 1 이 에러가 처음 기록됨, 0 이미 다른 에러가 기록되어 있음
+ */
+static int segments_fail(FileSegments* segments, FILE_CRYPTO_STATUS status) {
+    return platform_atomic_compare_exchange(&segments->status, FILE_CRYPTO_SUCCESS, (long)status);
+}
+
+/**
+ * @brief 읽은 세그먼트 평문을 번호 순서대로 평문 해시에 넣습니다 (앞 세그먼트가 들어갈 때까지 기다림).
+ * @param segments 세그먼트 작업 상태
+ * @param index 세그먼트 번호
+ * @param plaintext 세그먼트 평문
+ * @param length 평문 길이
+ * @return FILE_CRYPTO_SUCCESS 또는 기다리는 동안 다른 스레드에서 발생한 에러
+ * @note 세그먼트 번호는 증가하는 순서로 나눠 주므로 앞 세그먼트를 맡은 스레드는 뒤 세그먼트를 기다리지 않습니다.
+ *       해시만 순서대로 하고 CTR과 태그 계산은 스레드마다 겹쳐 실행됩니다.
+ */
+static FILE_CRYPTO_STATUS segments_hash_in_order(FileSegments* segments, uint64_t index,
+                                                 const uint8_t* plaintext, size_t length) {
+    int spins = 0;
+    while ((uint64_t)platform_atomic_load(&segments->hashed) != index) {
+        long status = platform_atomic_load(&segments->status);
+        if (status != FILE_CRYPTO_SUCCESS) return (FILE_CRYPTO_STATUS)status;
+        if (spins < SEGMENT_SPIN_LIMIT) {
+            spins++;
+            platform_thread_yield();
+        } else {
+            platform_sleep_ms(1);
+        }
+    }
+    sha512_update(segments->job->digest_ctx, plaintext, length);
+    platform_atomic_store(&segments->hashed, (long)(index + 1));  // 다음 세그먼트 차례
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 세그먼트 하나를 읽어 암호화 또는 검증/복호화하고 결과를 씁니다.
+ * @param segments 세그먼트 작업 상태
+ * @param index 세그먼트 번호
+ * @param buffer 작업용 버퍼 (SEGMENT_RECORD_SIZE 크기)
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드
+ */
+static FILE_CRYPTO_STATUS segments_process_one(FileSegments* segments, uint64_t index, uint8_t* buffer) {
+    FileSegmentJob* job = segments->job;
+    int is_final = (index + 1 == segments->count);
+    size_t length = is_final ? segments->final_length : ENC_SEGMENT_SIZE;
+    int decrypting = (job->op == SEGMENT_OP_DECRYPT);
+    size_t in_length = decrypting ? length + ENC_HMAC_SIZE : length;
+    
+    int64_t in_pos = job->in_offset + (int64_t)index * segments->in_stride;
+    if (platform_pread(job->fin, buffer, in_length, in_pos) != (int64_t)in_length) {
+        return FILE_CRYPTO_ERR_FILE_READ;
+    }
+    
+    uint8_t counter[16];
+    file_segment_counter(job->nonce_counter, index, counter);
+    HMAC_SHA512_CTX segment_ctx;
+    file_segment_begin_tag(job->header_ctx, index, is_final, &segment_ctx);
+    
+    if (!decrypting) {
+        // 평문 해시는 버퍼가 암호문으로 바뀌기 전에
+        if (job->digest_ctx) {
+            FILE_CRYPTO_STATUS status = segments_hash_in_order(segments, index, buffer, length);
+            if (status != FILE_CRYPTO_SUCCESS) return status;
+        }
+        
+        // 암호화 + 암호문 태그 (Encrypt-then-MAC), 태그는 암호문 바로 뒤
+        if (AES_CTR_HMAC_crypt(job->aes_ctx, buffer, length, buffer, counter,
+                               &segment_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+            return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+        }
+        hmac_sha512_final(&segment_ctx, buffer + length);
+        
+        int64_t out_pos = job->out_offset + (int64_t)index * segments->out_stride;
+        if (!platform_pwrite(job->fout, buffer, length + ENC_HMAC_SIZE, out_pos)) {
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+        return FILE_CRYPTO_SUCCESS;
+    }
+    
+    // 암호문 태그 계산과 복호화를 한 패스로 (평문은 검증 전까지 버퍼에만 있음)
+    uint8_t computed_tag[ENC_HMAC_SIZE];
+    if (AES_CTR_HMAC_crypt(job->aes_ctx, buffer, length, buffer, counter,
+                           &segment_ctx, AES_CTR_HMAC_MAC_INPUT) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    }
+    hmac_sha512_final(&segment_ctx, computed_tag);
+    if (memcmp(computed_tag, buffer + length, ENC_HMAC_SIZE) != 0) {
+        return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+    }
+    
+    if (job->fout) {
+        int64_t out_pos = job->out_offset + (int64_t)index * segments->out_stride;
+        if (!platform_pwrite(job->fout, buffer, length, out_pos)) {
+            return FILE_CRYPTO_ERR_FILE_WRITE;
+        }
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 남은 세그먼트가 없거나 에러가 날 때까지 다음 세그먼트를 가져와 처리합니다.
+ * @param arg 작업 스레드 인자
+ * @param report 1이면 세그먼트마다 진행률 콜백 호출 (호출 스레드 전용)
+ */
+static void segments_work(SegmentWorkerArg* arg, int report) {
+    FileSegments* segments = arg->segments;
+    FileSegmentJob* job = segments->job;
+    
+    while (platform_atomic_load(&segments->status) == FILE_CRYPTO_SUCCESS) {
+        uint64_t index = (uint64_t)platform_atomic_fetch_add(&segments->next, 1);
+        if (index >= segments->count) break;
+        
+        FILE_CRYPTO_STATUS result = segments_process_one(segments, index, arg->buffer);
+        if (result != FILE_CRYPTO_SUCCESS) {
+            if (segments_fail(segments, result) && result == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+                job->failed_segment = (int64_t)index;  // 처음 실패한 스레드만 기록
+            }
+            break;
+        }
+        
+        long done = platform_atomic_fetch_add(&segments->done, 1) + 1;
+        if (report && job->on_progress) {
+            int64_t processed = (int64_t)done * segments->in_stride;
+            if (processed > job->data_size) processed = job->data_size;
+            job->on_progress(processed, job->user_data);
+        }
+    }
+}
+
+/**
+ * @brief 작업 스레드 진입점.
+ * @param arg SegmentWorkerArg 포인터
+ */
+static void segments_worker_thread(void* arg) {
+    segments_work((SegmentWorkerArg*)arg, 0);
+}
+
+/**
+ * @brief 작업 설명을 검사하고 세그먼트 수와 입력/출력 간격을 계산합니다.
+ * @param job 세그먼트 작업 설명
+ * @param segments 출력 세그먼트 작업 상태
+ * @return FILE_CRYPTO_SUCCESS 성공, 그 외 에러 코드 (잘린 파일은 HMAC 검증 실패)
+ */
+static FILE_CRYPTO_STATUS segments_init(FileSegmentJob* job, FileSegments* segments) {
+    if (!job || !job->fin || !job->aes_ctx || !job->nonce_counter || !job->header_ctx) {
+        return FILE_CRYPTO_ERR_INVALID_INPUT;
+    }
+    if (job->op == SEGMENT_OP_ENCRYPT && !job->fout) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (job->data_size < 0 || job->in_offset < 0 || job->out_offset < 0) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    memset(segments, 0, sizeof(*segments));
+    segments->job = job;
+    segments->status = FILE_CRYPTO_SUCCESS;
+    
+    // 세그먼트 경계는 크기만으로 정해짐 (암호화: 입력 크기가 배수면 0바이트 마지막 세그먼트)
+    if (job->op == SEGMENT_OP_ENCRYPT) {
+        segments->count = (uint64_t)(job->data_size / ENC_SEGMENT_SIZE) + 1;
+        segments->final_length = (size_t)(job->data_size % ENC_SEGMENT_SIZE);
+        segments->in_stride = ENC_SEGMENT_SIZE;
+        segments->out_stride = SEGMENT_RECORD_SIZE;
+    } else {
+        if (!file_segment_layout(job->data_size, &segments->count, &segments->final_length)) {
+            return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;  // 잘린 파일
+        }
+        segments->in_stride = SEGMENT_RECORD_SIZE;
+        segments->out_stride = ENC_SEGMENT_SIZE;
+    }
+    if (segments->count > (uint64_t)0x7FFFFFFF) return FILE_CRYPTO_ERR_INVALID_INPUT;  // long 카운터 범위
+    return FILE_CRYPTO_SUCCESS;
+}
+
+FILE_CRYPTO_STATUS file_segments_count(FileSegmentJob* job, uint64_t* count) {
+    FileSegments segments;
+    FILE_CRYPTO_STATUS status = segments_init(job, &segments);
+    if (status == FILE_CRYPTO_SUCCESS && count) *count = segments.count;
+    return status;
+}
+
+FILE_CRYPTO_STATUS file_segments_run_range(FileSegmentJob* job, uint64_t first, uint64_t last,
+                                           uint8_t* buffer, int64_t* failed_segment) {
+    if (failed_segment) *failed_segment = -1;
+    if (!buffer) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    
+    FileSegments segments;
+    FILE_CRYPTO_STATUS status = segments_init(job, &segments);
+    if (status != FILE_CRYPTO_SUCCESS) return status;
+    if (first > last || last > segments.count) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    segments.hashed = (long)first;  // 앞 범위는 호출자가 이미 처리함
+    
+    for (uint64_t index = first; index < last; index++) {
+        status = segments_process_one(&segments, index, buffer);
+        if (status != FILE_CRYPTO_SUCCESS) {
+            if (failed_segment && status == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+                *failed_segment = (int64_t)index;
+            }
+            return status;
+        }
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+FILE_CRYPTO_STATUS file_segments_run(FileSegmentJob* job) {
+    if (job) job->failed_segment = -1;
+    
+    FileSegments segments;
+    FILE_CRYPTO_STATUS init_status = segments_init(job, &segments);
+    if (init_status == FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+        job->failed_segment = (int64_t)(job->data_size / SEGMENT_RECORD_SIZE);
+    }
+    if (init_status != FILE_CRYPTO_SUCCESS) return init_status;
+    
+    // 스레드 수 결정 (세그먼트보다 많은 스레드는 만들지 않음)
+    int workers = (job->thread_count > 0) ? job->thread_count : platform_cpu_count();
+    if ((uint64_t)workers > segments.count) workers = (int)segments.count;
+    if (workers < 1) workers = 1;
+    
+    SegmentWorkerArg* args = (SegmentWorkerArg*)calloc((size_t)workers, sizeof(SegmentWorkerArg));
+    platform_thread_t** threads = (platform_thread_t**)calloc((size_t)workers, sizeof(platform_thread_t*));
+    if (!args || !threads) {
+        free(args);
+        free(threads);
+        return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    }
+    
+    // 스레드별 버퍼 미리 할당 (호출 스레드 버퍼가 없으면 실패, 추가 스레드는 가능한 만큼만)
+    int started = 0;
+    for (int i = 0; i < workers; i++) {
+        args[i].segments = &segments;
+        args[i].buffer = (uint8_t*)malloc(SEGMENT_RECORD_SIZE);
+        if (!args[i].buffer) break;
+        started++;
+    }
+    if (started == 0) {
+        free(args);
+        free(threads);
+        return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    }
+    
+    // 인덱스 0은 호출 스레드, 나머지는 작업 스레드 (생성 실패 시 남은 스레드가 나눠 처리)
+    for (int i = 1; i < started; i++) {
+        threads[i] = platform_thread_create(segments_worker_thread, &args[i]);
+    }
+    segments_work(&args[0], 1);
+    
+    for (int i = 1; i < started; i++) {
+        platform_thread_join(threads[i]);
+    }
+    for (int i = 0; i < started; i++) {
+        free(args[i].buffer);
+    }
+    free(args);
+    free(threads);
+    
+    FILE_CRYPTO_STATUS status = (FILE_CRYPTO_STATUS)platform_atomic_load(&segments.status);
+    if (status == FILE_CRYPTO_SUCCESS && job->on_progress) {
+        job->on_progress(job->data_size, job->user_data);
+    }
+    return status;
+}
@@ -0,0 +1,96 @@
+#ifndef FILE_SEGMENTS_H
+#define FILE_SEGMENTS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "crypto_api.h"
+#include "hmac_sha512.h"
+#include "sha512.h"
+#include "file_crypto.h"
+#include "file_pipeline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 세그먼트 하나와 태그를 담는 작업 버퍼 크기
+#define FILE_SEGMENT_BUFFER_SIZE (ENC_SEGMENT_SIZE + ENC_HMAC_SIZE)
+
+// 세그먼트 작업 방향
+typedef enum {
+    SEGMENT_OP_ENCRYPT = 0,    // 평문 → [암호문 | 태그] 세그먼트
+    SEGMENT_OP_DECRYPT         // [암호문 | 태그] 세그먼트 → 태그 검증 후 평문
+} SEGMENT_OP;
+
+// v6 세그먼트 병렬 처리 작업 설명
+// 세그먼트 i는 입력/출력 오프셋을 i로 바로 계산하고 CTR 카운터도 i로 바로 맞추므로
+// 순서와 무관하게 어느 스레드에서나 처리할 수 있음
+typedef struct {
+    FILE* fin;                              // 입력 파일 (위치 지정 읽기, stdio 위치는 바꾸지 않음)
+    FILE* fout;                             // 출력 파일 (위치 지정 쓰기, 복호화 시 NULL이면 검증만)
+    SEGMENT_OP op;                          // 암호화 또는 복호화
+    int64_t data_size;                      // 암호화: 평문 크기, 복호화: 세그먼트 영역 크기 (태그 포함)
+    int64_t in_offset;                      // 입력에서 첫 세그먼트 위치
+    int64_t out_offset;                     // 출력에서 첫 세그먼트 위치
+    const AES_CTX* aes_ctx;                 // AES 컨텍스트 (스레드 간 읽기 전용 공유)
+    const uint8_t* nonce_counter;           // 세그먼트 0의 CTR 카운터 (16바이트, 변경하지 않음)
+    const HMAC_SHA512_CTX* header_ctx;      // 헤더까지 업데이트된 HMAC 컨텍스트 (변경하지 않음)
+    SHA512_CTX* digest_ctx;                 // 암호화: 읽은 평문을 세그먼트 순서대로 누적 (NULL이면 계산하지 않음)
+    int thread_count;                       // 작업 스레드 수 (0 이하면 CPU 수, 호출 스레드 포함)
+    pipeline_chunk_callback_t on_progress;  // 진행률 콜백 (호출 스레드에서만 실행, NULL 가능)
+    void* user_data;                        // 콜백에 전달할 사용자 데이터
+    int64_t failed_segment;                 // [out] 태그가 맞지 않은 세그먼트 번호 (없으면 -1)
+} FileSegmentJob;
+
+/**
+ * @brief 세그먼트 태그 계산을 시작합니다 (헤더까지 반영된 HMAC 상태에 세그먼트 정보를 더함).
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트 (변경하지 않음)
+ * @param index 세그먼트 번호 (0부터)
+ * @param is_final 마지막 세그먼트 여부
+ * @param segment_ctx 출력 세그먼트용 HMAC 컨텍스트 (이어서 암호문으로 업데이트)
+ * @note 번호와 마지막 여부를 태그에 묶어 세그먼트 재배치, 중복, 뒤쪽 잘림을 검출합니다.
+ */
+void file_segment_begin_tag(const HMAC_SHA512_CTX* header_ctx, uint64_t index, int is_final,
+                            HMAC_SHA512_CTX* segment_ctx);
+
+/**
+ * @brief 세그먼트 시작 위치의 CTR 카운터를 계산합니다.
+ * @param base_counter 세그먼트 0의 카운터 (16바이트)
+ * @param index 세그먼트 번호
+ * @param counter 출력 카운터 (16바이트)
+ * @note 세그먼트 i는 i × (ENC_SEGMENT_SIZE / 16)번째 블록에서 시작합니다 (128비트 big-endian 덧셈).
+ */
+void file_segment_counter(const uint8_t* base_counter, uint64_t index, uint8_t* counter);
+
+/**
+ * @brief 세그먼트 영역 크기에서 세그먼트 수와 마지막 세그먼트 평문 길이를 구합니다.
+ * @param segment_bytes 헤더 뒤 세그먼트 영역 크기 (태그 포함)
+ * @param count 출력 세그먼트 수 (마지막 세그먼트 포함)
+ * @param final_length 출력 마지막 세그먼트의 암호문 길이
+ * @return 1 올바른 구조, 0 마지막 세그먼트의 태그가 들어갈 자리가 없음 (잘린 파일)
+ */
+int file_segment_layout(int64_t segment_bytes, uint64_t* count, size_t* final_length);
+
+// 세그먼트를 여러 스레드에 나눠 암호화 또는 검증/복호화 (다음 세그먼트 번호를 원자적으로 가져감)
+// 스레드마다 세그먼트 하나 크기의 버퍼만 사용, 처음 발생한 에러에서 모두 멈춤
+// digest_ctx가 있으면 읽은 세그먼트를 암호화하기 전에 번호 순서대로 해시에 넣음 (앞 세그먼트 차례를 기다림)
+// 결과 파일은 encrypt_stream/decrypt_stream의 순차 처리와 바이트 단위로 동일
+FILE_CRYPTO_STATUS file_segments_run(FileSegmentJob* job);
+
+// 작업의 전체 세그먼트 수 (thread_count, on_progress, failed_segment는 사용하지 않음)
+// 복호화에서 마지막 태그 자리가 없는 잘린 영역이면 FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED
+FILE_CRYPTO_STATUS file_segments_count(FileSegmentJob* job, uint64_t* count);
+
+// 세그먼트 [first, last)만 호출 스레드에서 순서대로 처리 (buffer는 FILE_SEGMENT_BUFFER_SIZE)
+// job을 바꾸지 않으므로 같은 작업의 서로 다른 범위를 여러 스레드가 동시에 처리할 수 있음
+// (digest_ctx가 있으면 범위를 앞에서부터 차례로 한 번에 하나씩만 처리해야 해시가 평문 순서와 같음)
+// 태그 불일치 시 failed_segment에 해당 세그먼트 번호 (NULL 가능, 그 외 실패는 -1)
+FILE_CRYPTO_STATUS file_segments_run_range(FileSegmentJob* job, uint64_t first, uint64_t last,
+                                           uint8_t* buffer, int64_t* failed_segment);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_SEGMENTS_H
@@ -0,0 +1,72 @@
+#ifndef LZ_CODEC_H
+#define LZ_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LZ4 블록 형식 호환 압축기 (외부 라이브러리 없이 내장, 64 KiB 창)
+// 압축 스트림은 프레임의 연속: [프레임 헤더 4바이트 big-endian | 페이로드]
+// 프레임 헤더 = 페이로드 길이 (하위 31비트) | LZ_FRAME_RAW (원본 그대로 저장한 프레임)
+#define LZ_BLOCK_SIZE (64 * 1024)                          // 프레임 하나의 최대 원본 크기
+#define LZ_FRAME_HEADER_SIZE 4
+#define LZ_FRAME_RAW 0x80000000u
+#define LZ_FRAME_BOUND (LZ_FRAME_HEADER_SIZE + LZ_BLOCK_SIZE)  // 프레임 하나의 최대 크기
+
+// 이미 압축된 데이터를 건너뛰는 상태 (연속으로 줄지 않은 블록이 많을수록 더 많은 블록을 시도 없이 저장)
+typedef struct {
+    unsigned int misses;       // 연속으로 압축 효과가 없던 블록 수
+    unsigned int skip;         // 압축을 시도하지 않고 그대로 저장할 남은 블록 수
+} LzFrameEncoder;
+
+/**
+ * @brief 블록 하나를 LZ4 블록 형식으로 압축합니다.
+ * @param src 원본
+ * @param src_length 원본 길이
+ * @param dst 출력 버퍼
+ * @param dst_capacity 출력 버퍼 크기
+ * @return 압축된 길이, 출력 버퍼에 들어가지 않으면 0
+ * @note 일치를 찾지 못할수록 탐색 간격을 넓혀 (LZ4의 skip trigger) 압축되지 않는 데이터에서도 빠르게 끝납니다.
+ */
+size_t lz_compress(const uint8_t* src, size_t src_length, uint8_t* dst, size_t dst_capacity);
+
+/**
+ * @brief LZ4 블록 형식 데이터를 복원합니다 (잘못된 입력에도 버퍼 밖을 읽거나 쓰지 않음).
+ * @param src 압축 데이터
+ * @param src_length 압축 데이터 길이
+ * @param dst 출력 버퍼
+ * @param dst_capacity 출력 버퍼 크기
+ * @return 복원된 길이, 형식 오류나 출력 초과 시 -1
+ */
+int64_t lz_decompress(const uint8_t* src, size_t src_length, uint8_t* dst, size_t dst_capacity);
+
+// 프레임 인코더 초기화
+void lz_frame_encoder_init(LzFrameEncoder* encoder);
+
+/**
+ * @brief 원본 블록 하나를 프레임으로 만듭니다 (압축 효과가 없으면 원본 그대로 저장).
+ * @param encoder 프레임 인코더
+ * @param src 원본 (LZ_BLOCK_SIZE 이하)
+ * @param src_length 원본 길이
+ * @param dst 출력 버퍼 (LZ_FRAME_BOUND 이상)
+ * @return 기록한 프레임 길이 (헤더 포함)
+ */
+size_t lz_frame_encode(LzFrameEncoder* encoder, const uint8_t* src, size_t src_length, uint8_t* dst);
+
+/**
+ * @brief 프레임 헤더를 해석합니다.
+ * @param header 프레임 헤더 (LZ_FRAME_HEADER_SIZE 바이트)
+ * @param raw 출력: 1이면 원본 그대로 저장한 프레임
+ * @param payload_length 출력: 페이로드 길이
+ * @return 1 성공, 0 잘못된 헤더 (페이로드가 LZ_BLOCK_SIZE보다 큼)
+ */
+int lz_frame_parse_header(const uint8_t* header, int* raw, size_t* payload_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LZ_CODEC_H
@@ -6,14 +6,14 @@
 static int fill_random_bytes(uint8_t* buffer, size_t len, const char* purpose) {
     if (crypto_random_bytes(buffer, len) == CRYPTO_SUCCESS) {
 #ifndef NDEBUG
-        printf("[DEBUG] OpenSSL RAND_bytes random number generation succeeded (%s)\n", purpose);
+        fprintf(stderr, "[DEBUG] OpenSSL RAND_bytes random number generation succeeded (%s)\n", purpose);
 #endif
         return 1;
     }
     
     // OpenSSL이 없는 경우 fallback (보안상 권장하지 않음)
 #ifndef NDEBUG
-    printf("[DEBUG] OpenSSL RAND_bytes failed for %s, using fallback rand()\n", purpose);
+    fprintf(stderr, "[DEBUG] OpenSSL RAND_bytes failed for %s, using fallback rand()\n", purpose);
 #endif
     for (size_t i = 0; i < len; i++) {
         buffer[i] = (uint8_t)(rand() & 0xFF);
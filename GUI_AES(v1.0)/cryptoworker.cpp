@@ -3,6 +3,8 @@
 #include <QByteArray>
 #include <QFileInfo>
 #include <QDir>
+#include <QVector>
+#include <cstring>
 
 CryptoWorker::CryptoWorker(QObject *parent)
     : QObject(parent)
@@ -10,11 +12,11 @@ CryptoWorker::CryptoWorker(QObject *parent)
 }
 
 // C 콜백을 Qt 시그널로 변환
-void CryptoWorker::progressCallback(long processed, long total, void *userData)
+void CryptoWorker::progressCallback(int64_t processed, int64_t total, void *userData)
 {
     CryptoWorker *worker = static_cast<CryptoWorker*>(userData);
     if (worker && total > 0 && processed >= 0) {
-        // long을 qint64로 변환 (오버플로우 방지)
+        // int64_t를 qint64로 그대로 전달 (2 GiB 넘는 파일도 잘리지 않음)
         // Qt의 시그널/슬롯은 스레드 안전하므로 직접 emit 가능
         emit worker->progressUpdated(static_cast<qint64>(processed), static_cast<qint64>(total), worker->currentFileName);
     }
@@ -26,57 +28,6 @@ QByteArray CryptoWorker::toNativePathBytes(const QString &path)
     return QDir::toNativeSeparators(path).toUtf8();
 }
 
-// 암호화 공통 로직
-bool CryptoWorker::performEncryption(const QString &inputPath, const QString &outputPath, 
-                                     int aesKeyBits, const QString &password)
-{
-    // 경로를 네이티브 형식으로 변환 후 UTF-8 바이트 배열로 변환
-    QByteArray inputBytes = toNativePathBytes(inputPath);
-    QByteArray outputBytes = toNativePathBytes(outputPath);
-    QByteArray passwordBytes = password.toUtf8();
-    
-    currentFileName = inputPath;
-    
-    // 암호화 실행 (콜백 전달)
-    int result = encrypt_file_with_progress(
-        inputBytes.constData(),
-        outputBytes.constData(),
-        aesKeyBits,
-        passwordBytes.constData(),
-        progressCallback,
-        this  // user_data로 this 전달
-    );
-    
-    return (result != 0);
-}
-
-// 복호화 공통 로직
-bool CryptoWorker::performDecryption(const QString &inputPath, const QString &outputPath,
-                                     const QString &password)
-{
-    // 경로를 네이티브 형식으로 변환 후 UTF-8 바이트 배열로 변환
-    QByteArray inputBytes = toNativePathBytes(inputPath);
-    QByteArray outputBytes = toNativePathBytes(outputPath);
-    QByteArray passwordBytes = password.toUtf8();
-    
-    char finalPath[512];
-    memset(finalPath, 0, sizeof(finalPath));  // 초기화
-    
-    currentFileName = inputPath;
-    
-    int result = decrypt_file_with_progress(
-        inputBytes.constData(),
-        outputBytes.constData(),
-        passwordBytes.constData(),
-        finalPath,
-        sizeof(finalPath),
-        progressCallback,
-        this
-    );
-    
-    return (result != 0);
-}
-
 void CryptoWorker::processFileList(const QList<QPair<QString, QString>> &fileList,
                                    bool isEncrypt, int aesKeyBits, const QString &password)
 {
@@ -85,16 +36,17 @@ void CryptoWorker::processFileList(const QList<QPair<QString, QString>> &fileLis
     QStringList successFiles;
     QStringList failFiles;
     
+    // 경로 바이트 배열은 배치가 끝날 때까지 유지 (FileBatchItem은 포인터만 가짐)
+    QList<QByteArray> inputBytes;
+    QList<QByteArray> outputBytes;
+    QList<int> itemFileIndex;  // 배치 항목 → fileList 번호
+    
     for (int i = 0; i < fileList.size(); ++i) {
         const QPair<QString, QString> &filePair = fileList[i];
         QString inputPath = filePair.first;
         QString outputPath = filePair.second;
         
-        bool success = false;
-        
-        if (isEncrypt) {
-            success = performEncryption(inputPath, outputPath, aesKeyBits, password);
-        } else {
+        if (!isEncrypt) {
             // Windows 네이티브 경로로 변환 (구분자 통일) - 검증용
             QString nativeInputPath = QDir::toNativeSeparators(inputPath);
             QString nativeOutputPath = QDir::toNativeSeparators(outputPath);
@@ -126,29 +78,57 @@ void CryptoWorker::processFileList(const QList<QPair<QString, QString>> &fileLis
                 failFiles.append(QFileInfo(inputPath).fileName());
                 continue;
             }
-            
-            // 복호화 실행
-            success = performDecryption(inputPath, outputPath, password);
-            
-            if (!success) {
-                // 복호화 실패 시 구체적인 에러 메시지 emit
-                QString errorMsg = QString(
-                    "Decryption failed: %1\n\nPossible causes:\n"
-                    "- Wrong password\n- File is corrupted\n"
-                    "- Invalid file format (not a .enc file)\n"
-                    "- Output path not writable")
-                    .arg(QFileInfo(inputPath).fileName());
-                qDebug() << "Decryption error:" << errorMsg;
-                emit error(errorMsg);
-            }
         }
         
-        if (success) {
+        inputBytes.append(toNativePathBytes(inputPath));
+        outputBytes.append(toNativePathBytes(outputPath));
+        itemFileIndex.append(i);
+    }
+    
+    // 작은 파일은 파일 단위로, 큰 세그먼트 형식 파일은 세그먼트 범위로 나눠 모든 코어에서 처리
+    QVector<FileBatchItem> items(itemFileIndex.size());
+    for (int i = 0; i < items.size(); ++i) {
+        memset(&items[i], 0, sizeof(FileBatchItem));
+        items[i].input_path = inputBytes[i].constData();
+        items[i].output_path = outputBytes[i].constData();
+    }
+    
+    QByteArray passwordBytes = password.toUtf8();
+    currentFileName = (fileList.size() == 1) ? fileList[0].first : QString("%1 files").arg(fileList.size());
+    
+    FileBatchJob job;
+    memset(&job, 0, sizeof(job));
+    job.op = isEncrypt ? FILE_BATCH_ENCRYPT : FILE_BATCH_DECRYPT;
+    job.aes_key_bits = aesKeyBits;
+    job.password = passwordBytes.constData();
+    job.items = items.data();
+    job.count = static_cast<size_t>(items.size());
+    job.on_progress = progressCallback;  // 배치 전체 진행률 (작업 스레드에서 호출되지만 겹치지 않음)
+    job.user_data = this;
+    if (job.count > 0) {
+        process_file_batch(&job);
+    }
+    
+    for (int i = 0; i < items.size(); ++i) {
+        QString inputPath = fileList[itemFileIndex[i]].first;
+        if (items[i].result) {
             successCount++;
             successFiles.append(QFileInfo(inputPath).fileName());
-        } else {
-            failCount++;
-            failFiles.append(QFileInfo(inputPath).fileName());
+            continue;
+        }
+        
+        failCount++;
+        failFiles.append(QFileInfo(inputPath).fileName());
+        if (!isEncrypt) {
+            // 복호화 실패 시 구체적인 에러 메시지 emit
+            QString errorMsg = QString(
+                "Decryption failed: %1\n\nPossible causes:\n"
+                "- Wrong password\n- File is corrupted\n"
+                "- Invalid file format (not a .enc file)\n"
+                "- Output path not writable")
+                .arg(QFileInfo(inputPath).fileName());
+            qDebug() << "Decryption error:" << errorMsg;
+            emit error(errorMsg);
         }
     }
     
@@ -175,3 +155,61 @@ void CryptoWorker::processFileList(const QList<QPair<QString, QString>> &fileLis
     
     emit finished(successCount > 0, message);
 }
+
+void CryptoWorker::verifyFileList(const QStringList &fileList, const QString &password)
+{
+    // 경로 바이트 배열은 배치가 끝날 때까지 유지 (FileBatchItem은 포인터만 가짐)
+    QList<QByteArray> inputBytes;
+    for (const QString &inputPath : fileList) {
+        inputBytes.append(toNativePathBytes(inputPath));
+    }
+    
+    // 검증은 출력 경로 없이 읽기만 하므로 디스크에 아무것도 쓰지 않음
+    QVector<FileBatchItem> items(inputBytes.size());
+    for (int i = 0; i < items.size(); ++i) {
+        memset(&items[i], 0, sizeof(FileBatchItem));
+        items[i].input_path = inputBytes[i].constData();
+    }
+    
+    QByteArray passwordBytes = password.toUtf8();
+    currentFileName = (fileList.size() == 1) ? fileList[0] : QString("%1 files").arg(fileList.size());
+    
+    FileBatchJob job;
+    memset(&job, 0, sizeof(job));
+    job.op = FILE_BATCH_VERIFY;
+    job.password = passwordBytes.constData();
+    job.items = items.data();
+    job.count = static_cast<size_t>(items.size());
+    job.on_progress = progressCallback;
+    job.user_data = this;
+    if (job.count > 0) {
+        process_file_batch(&job);
+    }
+    
+    // 파일별 결과 (실패 원인은 라이브러리가 final_path에 기록)
+    const int maxListedFailures = 20;  // 메시지 상자가 너무 커지지 않도록
+    int successCount = 0;
+    QStringList failLines;
+    for (int i = 0; i < items.size(); ++i) {
+        if (items[i].result) {
+            successCount++;
+            continue;
+        }
+        if (failLines.size() < maxListedFailures) {
+            QString reason = items[i].final_path[0] ? QString::fromUtf8(items[i].final_path)
+                                                    : QString("Verification failed");
+            failLines.append(QString("%1: %2").arg(QDir::toNativeSeparators(fileList[i])).arg(reason));
+        }
+    }
+    int failCount = items.size() - successCount;
+    
+    QString message = QString("Verification completed: %1 passed, %2 failed").arg(successCount).arg(failCount);
+    if (failCount > 0) {
+        message += "\n\nFailed files:\n" + failLines.join("\n");
+        if (failCount > failLines.size()) {
+            message += QString("\n... and %1 more").arg(failCount - failLines.size());
+        }
+    }
+    
+    emit finished(failCount == 0 && successCount > 0, message);
+}
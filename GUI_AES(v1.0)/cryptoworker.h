@@ -5,6 +5,7 @@
 #include <QString>
 #include <QPair>
 #include <QList>
+#include <QStringList>
 #include "file_crypto.h"
 
 class CryptoWorker : public QObject
@@ -17,6 +18,8 @@ public:
 public slots:
     void processFileList(const QList<QPair<QString, QString>> &fileList,
                          bool isEncrypt, int aesKeyBits, const QString &password);
+    // 평문을 쓰지 않고 여러 .enc 파일을 병렬 검증 (파일별 결과를 finished 메시지로 보고)
+    void verifyFileList(const QStringList &fileList, const QString &password);
 
 signals:
     void progressUpdated(qint64 processed, qint64 total, const QString &fileName);
@@ -24,18 +27,13 @@ signals:
     void error(const QString &errorMessage);
     void processFileListRequested(const QList<QPair<QString, QString>> &fileList,
                                   bool isEncrypt, int aesKeyBits, const QString &password);
+    void verifyFileListRequested(const QStringList &fileList, const QString &password);
 
 private:
     QString currentFileName;  // 현재 처리 중인 파일명 (진행률 표시용)
     
     // C 콜백을 Qt 시그널로 변환하는 정적 함수
-    static void progressCallback(long processed, long total, void *userData);
-    
-    // 암호화/복호화 공통 로직
-    bool performEncryption(const QString &inputPath, const QString &outputPath, 
-                          int aesKeyBits, const QString &password);
-    bool performDecryption(const QString &inputPath, const QString &outputPath,
-                          const QString &password);
+    static void progressCallback(int64_t processed, int64_t total, void *userData);
     
     // 경로 변환 유틸리티 함수
     QByteArray toNativePathBytes(const QString &path);
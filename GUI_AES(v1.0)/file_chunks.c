@@ -0,0 +1,147 @@
+#include "file_chunks.h"
+#include "aes_ctr_hmac.h"
+#include "platform_utils.h"
+#include <string.h>
+
+// 지문 키 도출 레이블
+static const char CHUNK_FINGERPRINT_LABEL[] = "AESC chunk fingerprint";
+
+static void chunk_put_be64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (56 - 8 * i));
+    }
+}
+
+void file_chunk_fingerprint_key(const uint8_t* hmac_key, uint8_t* fingerprint_key) {
+    hmac_sha512(hmac_key, HMAC_KEY_SIZE, (const uint8_t*)CHUNK_FINGERPRINT_LABEL,
+                sizeof(CHUNK_FINGERPRINT_LABEL) - 1, fingerprint_key);
+}
+
+void file_chunk_fingerprint(const uint8_t* fingerprint_key, uint64_t index, const uint8_t* data, size_t length,
+                            uint8_t* fingerprint) {
+    uint8_t info[8];
+    uint8_t mac[HMAC_SHA512_DIGEST_SIZE];
+    chunk_put_be64(info, index);
+    
+    HMAC_SHA512_CTX ctx;
+    hmac_sha512_init(&ctx, fingerprint_key, FILE_CHUNK_FINGERPRINT_KEY_SIZE);
+    hmac_sha512_update(&ctx, info, sizeof(info));
+    hmac_sha512_update(&ctx, data, length);
+    hmac_sha512_final(&ctx, mac);
+    memcpy(fingerprint, mac, ENC_CHUNK_FINGERPRINT_SIZE);
+}
+
+void file_chunk_make_nonce(const uint8_t* run_nonce, uint64_t index, uint8_t* nonce) {
+    memcpy(nonce, run_nonce, ENC_NONCE_SIZE);
+    for (int i = 0; i < 4; i++) {
+        nonce[ENC_NONCE_SIZE + i] = (uint8_t)(index >> (24 - 8 * i));
+    }
+}
+
+/**
+ * @brief 청크 태그 계산을 시작합니다 (헤더 상태에 번호, nonce, 지문을 더함).
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트
+ * @param index 청크 번호
+ * @param meta 청크 메타데이터
+ * @param chunk_ctx 출력 HMAC 컨텍스트 (이어서 암호문으로 업데이트)
+ * @param counter 출력 청크 시작 CTR 카운터 (16바이트)
+ */
+static void chunk_begin(const HMAC_SHA512_CTX* header_ctx, uint64_t index, const EncChunkMeta* meta,
+                        HMAC_SHA512_CTX* chunk_ctx, uint8_t* counter) {
+    uint8_t info[8];
+    chunk_put_be64(info, index);
+    
+    *chunk_ctx = *header_ctx;  // 헤더 HMAC 상태 복사 (청크마다 헤더를 다시 해시하지 않음)
+    hmac_sha512_update(chunk_ctx, info, sizeof(info));
+    hmac_sha512_update(chunk_ctx, meta->nonce, ENC_CHUNK_NONCE_SIZE + sizeof(meta->reserved) + ENC_CHUNK_FINGERPRINT_SIZE);
+    
+    memcpy(counter, meta->nonce, ENC_CHUNK_NONCE_SIZE);
+    memset(counter + ENC_CHUNK_NONCE_SIZE, 0, 16 - ENC_CHUNK_NONCE_SIZE);
+}
+
+FILE_CRYPTO_STATUS file_chunk_seal(const AES_CTX* aes_ctx, const HMAC_SHA512_CTX* header_ctx, uint64_t index,
+                                   EncChunkMeta* meta, uint8_t* data, size_t length) {
+    HMAC_SHA512_CTX chunk_ctx;
+    uint8_t counter[16];
+    memset(meta->reserved, 0, sizeof(meta->reserved));
+    chunk_begin(header_ctx, index, meta, &chunk_ctx, counter);
+    
+    // 암호문에 HMAC (Encrypt-then-MAC)
+    if (AES_CTR_HMAC_crypt(aes_ctx, data, length, data, counter, &chunk_ctx,
+                           AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    hmac_sha512_final(&chunk_ctx, meta->tag);
+    return FILE_CRYPTO_SUCCESS;
+}
+
+FILE_CRYPTO_STATUS file_chunk_open(const AES_CTX* aes_ctx, const HMAC_SHA512_CTX* header_ctx, uint64_t index,
+                                   const EncChunkMeta* meta, uint8_t* data, size_t length) {
+    HMAC_SHA512_CTX chunk_ctx;
+    uint8_t counter[16];
+    uint8_t computed_tag[ENC_HMAC_SIZE];
+    chunk_begin(header_ctx, index, meta, &chunk_ctx, counter);
+    
+    if (AES_CTR_HMAC_crypt(aes_ctx, data, length, data, counter, &chunk_ctx,
+                           AES_CTR_HMAC_MAC_INPUT) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+    }
+    hmac_sha512_final(&chunk_ctx, computed_tag);
+    if (memcmp(computed_tag, meta->tag, ENC_HMAC_SIZE) != 0) return FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+int64_t file_chunk_position(uint64_t index) {
+    return (int64_t)index * FILE_CHUNK_RECORD_SIZE;
+}
+
+void file_chunk_count(int64_t plaintext_size, uint64_t* count, size_t* final_length) {
+    uint64_t chunks = (uint64_t)(plaintext_size / ENC_CHUNK_SIZE);
+    size_t rest = (size_t)(plaintext_size % ENC_CHUNK_SIZE);
+    if (rest > 0 || chunks == 0) {
+        chunks++;
+    } else {
+        rest = ENC_CHUNK_SIZE;  // 크기가 청크 배수면 마지막 청크는 가득 참
+    }
+    *count = chunks;
+    *final_length = rest;
+}
+
+int file_chunk_layout(int64_t record_bytes, uint64_t* count, size_t* final_length) {
+    if (record_bytes < ENC_CHUNK_META_SIZE) return 0;
+    
+    int64_t full = (record_bytes - ENC_CHUNK_META_SIZE) / FILE_CHUNK_RECORD_SIZE;
+    int64_t rest = record_bytes - full * FILE_CHUNK_RECORD_SIZE;  // 마지막 레코드 (메타데이터 포함)
+    if (rest == ENC_CHUNK_META_SIZE && full > 0) {
+        // 빈 마지막 청크는 빈 입력일 때만 (배수 크기 입력은 가득 찬 청크로 끝남)
+        return 0;
+    }
+    
+    *count = (uint64_t)full + 1;
+    *final_length = (size_t)(rest - ENC_CHUNK_META_SIZE);
+    return 1;
+}
+
+FILE_CRYPTO_STATUS file_chunks_read_meta(FILE* fin, int64_t records_offset, uint64_t count, EncChunkMeta* metas) {
+    for (uint64_t i = 0; i < count; i++) {
+        if (platform_pread(fin, &metas[i], sizeof(EncChunkMeta), records_offset + file_chunk_position(i)) !=
+            (int64_t)sizeof(EncChunkMeta)) {
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+void file_chunks_root(const HMAC_SHA512_CTX* header_ctx, const EncChunkMeta* metas, uint64_t count,
+                      size_t final_length, uint8_t* root) {
+    uint8_t info[16];
+    chunk_put_be64(info, count);
+    chunk_put_be64(info + 8, (uint64_t)final_length);
+    
+    HMAC_SHA512_CTX root_ctx = *header_ctx;
+    hmac_sha512_update(&root_ctx, info, sizeof(info));
+    for (uint64_t i = 0; i < count; i++) {
+        hmac_sha512_update(&root_ctx, metas[i].tag, ENC_HMAC_SIZE);
+    }
+    hmac_sha512_final(&root_ctx, root);
+}
@@ -0,0 +1,222 @@
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64  // 32비트 빌드에서도 2 GiB 넘는 파일 크기를 구하도록
+#endif
+#include "file_hash.h"
+#include "sha512.h"
+#include <stdio.h>
+#include <string.h>
+
+// BSD 태그 형식의 앞부분 ("SHA512 (경로) = 해시")
+#define FILE_HASH_TAG_PREFIX "SHA512 ("
+#define FILE_HASH_TAG_SEPARATOR ") = "
+
+static const char file_hash_hex_digits[] = "0123456789abcdef";
+
+static int file_hash_hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief 16진수 128자를 해시로 바꿉니다.
+ * @param hex 16진수 문자열 (FILE_HASH_HEX_LENGTH자 이상)
+ * @param digest 출력 해시
+ * @return 1 성공, 0 16진수가 아닌 문자
+ */
+static int file_hash_decode_hex(const char* hex, uint8_t* digest) {
+    for (size_t i = 0; i < SHA512_DIGEST_LENGTH; i++) {
+        int high = file_hash_hex_value(hex[2 * i]);
+        int low = file_hash_hex_value(hex[2 * i + 1]);
+        if (high < 0 || low < 0) return 0;
+        digest[i] = (uint8_t)((high << 4) | low);
+    }
+    return 1;
+}
+
+/**
+ * @brief 경로 이스케이프를 풉니다 ("\\" → '\', "\n" → 줄바꿈, "\r" → CR).
+ * @param in 이스케이프된 경로
+ * @param length in의 길이
+ * @param out 출력 버퍼
+ * @param out_size 출력 버퍼 크기
+ * @return 1 성공, 0 잘못된 이스케이프 또는 버퍼 부족
+ */
+static int file_hash_unescape(const char* in, size_t length, char* out, size_t out_size) {
+    size_t used = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = in[i];
+        if (c == '\\') {
+            if (++i == length) return 0;
+            if (in[i] == '\\') c = '\\';
+            else if (in[i] == 'n') c = '\n';
+            else if (in[i] == 'r') c = '\r';
+            else return 0;
+        }
+        if (used + 1 >= out_size) return 0;
+        out[used++] = c;
+    }
+    out[used] = '\0';
+    return 1;
+}
+
+/**
+ * @brief 스트림을 끝까지 읽어 해시에 넣습니다.
+ * @param file 입력 스트림
+ * @param ctx SHA-512 컨텍스트
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_READ
+ */
+static FILE_CRYPTO_STATUS file_hash_stream(FILE* file, SHA512_CTX* ctx) {
+    uint8_t buffer[FILE_HASH_READ_SIZE];
+    size_t bytes_read;
+    while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        sha512_update(ctx, buffer, bytes_read);
+    }
+    return ferror(file) ? FILE_CRYPTO_ERR_FILE_READ : FILE_CRYPTO_SUCCESS;
+}
+
+FILE_CRYPTO_STATUS file_sha512(const char* path, int allow_mmap, uint8_t* digest) {
+    if (!path || !digest) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    FILE* file = platform_fopen(path, "rb");
+    if (!file) return FILE_CRYPTO_ERR_FILE_OPEN;
+
+    SHA512_CTX ctx;
+    sha512_init(&ctx);
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    int hashed = 0;
+
+    if (allow_mmap) {
+        int64_t size = (platform_fseek64(file, 0, SEEK_END) == 0) ? platform_ftell64(file) : -1;
+        platform_file_map_t map;
+        if (size >= FILE_HASH_MMAP_THRESHOLD && platform_map_stream(file, (uint64_t)size, 0, &map)) {
+            sha512_update(&ctx, map.data, map.size);
+            platform_unmap_stream(&map);
+            hashed = 1;
+        }
+        // 매핑하지 않았으면 처음부터 스트리밍 (크기를 구할 수 없는 파이프 등 포함)
+        if (!hashed && platform_fseek64(file, 0, SEEK_SET) != 0) result = FILE_CRYPTO_ERR_FILE_READ;
+    }
+    if (!hashed && result == FILE_CRYPTO_SUCCESS) result = file_hash_stream(file, &ctx);
+    fclose(file);
+
+    if (result == FILE_CRYPTO_SUCCESS) sha512_final(&ctx, digest);
+    memset(&ctx, 0, sizeof(ctx));
+    return result;
+}
+
+// 배치 실행 상태 (작업 스레드가 공유)
+typedef struct {
+    FileHashItem* items;
+    long count;
+    int allow_mmap;
+    volatile long next;      // 다음에 처리할 항목 번호
+} FileHashRun;
+
+// 작업 스레드 본체: 남은 항목이 없을 때까지 다음 항목을 가져가 해시
+static void file_hash_worker(void* arg) {
+    FileHashRun* run = (FileHashRun*)arg;
+    long index;
+    while ((index = platform_atomic_fetch_add(&run->next, 1)) < run->count) {
+        FileHashItem* item = &run->items[index];
+        item->status = file_sha512(item->path, run->allow_mmap, item->digest);
+    }
+}
+
+size_t file_hash_batch(FileHashItem* items, size_t count, int allow_mmap, platform_thread_pool_t* pool) {
+    if (!items || count == 0) return 0;
+
+    FileHashRun run;
+    run.items = items;
+    run.count = (long)count;
+    run.allow_mmap = allow_mmap;
+    run.next = 0;
+
+    // 항목보다 많은 작업은 만들지 않음 (호출 스레드가 하나를 맡음)
+    if (pool) {
+        long workers = platform_thread_pool_size(pool);
+        if (workers > run.count - 1) workers = run.count - 1;
+        for (long i = 0; i < workers; i++) {
+            if (!platform_thread_pool_submit(pool, file_hash_worker, &run)) break;
+        }
+    }
+    file_hash_worker(&run);
+    if (pool) platform_thread_pool_wait(pool);
+
+    size_t succeeded = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (items[i].status == FILE_CRYPTO_SUCCESS) succeeded++;
+    }
+    return succeeded;
+}
+
+int file_hash_format_line(const uint8_t* digest, const char* path, char* line, size_t line_size) {
+    if (!digest || !path || !line) return 0;
+    int escaped = (strpbrk(path, "\\\n\r") != NULL);
+    size_t used = 0;
+
+    // 최악의 경우 크기를 먼저 확인 ('\' + 16진수 + 구분자 + 경로 두 배 + 줄바꿈 + NUL)
+    size_t path_length = strlen(path);
+    if (line_size < 1 + FILE_HASH_HEX_LENGTH + 2 + 2 * path_length + 2) return 0;
+
+    if (escaped) line[used++] = '\\';
+    for (size_t i = 0; i < SHA512_DIGEST_LENGTH; i++) {
+        line[used++] = file_hash_hex_digits[digest[i] >> 4];
+        line[used++] = file_hash_hex_digits[digest[i] & 0x0F];
+    }
+    line[used++] = ' ';
+    line[used++] = ' ';  // 텍스트 모드 표시 (sha512sum 기본 출력)
+    for (size_t i = 0; i < path_length; i++) {
+        char c = path[i];
+        if (c == '\\' || c == '\n' || c == '\r') {
+            line[used++] = '\\';
+            c = (c == '\\') ? '\\' : (c == '\n') ? 'n' : 'r';
+        }
+        line[used++] = c;
+    }
+    line[used++] = '\n';
+    line[used] = '\0';
+    return 1;
+}
+
+int file_hash_parse_line(const char* line, uint8_t* digest, char* path, size_t path_size) {
+    if (!line || !digest || !path || path_size == 0) return 0;
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) length--;
+
+    int escaped = (length > 0 && line[0] == '\\');
+    const char* p = line + escaped;
+    size_t rest = length - (size_t)escaped;
+
+    // BSD 태그 형식: SHA512 (경로) = 해시
+    size_t prefix_length = strlen(FILE_HASH_TAG_PREFIX);
+    size_t separator_length = strlen(FILE_HASH_TAG_SEPARATOR);
+    if (rest > prefix_length && memcmp(p, FILE_HASH_TAG_PREFIX, prefix_length) == 0) {
+        if (rest < prefix_length + 1 + separator_length + FILE_HASH_HEX_LENGTH) return 0;
+        const char* hex = p + rest - FILE_HASH_HEX_LENGTH;
+        const char* separator = hex - separator_length;
+        if (memcmp(separator, FILE_HASH_TAG_SEPARATOR, separator_length) != 0) return 0;
+        const char* name = p + prefix_length;
+        size_t name_length = (size_t)(separator - name);
+        if (!file_hash_decode_hex(hex, digest)) return 0;
+        if (escaped) return file_hash_unescape(name, name_length, path, path_size);
+        if (name_length + 1 > path_size) return 0;
+        memcpy(path, name, name_length);
+        path[name_length] = '\0';
+        return 1;
+    }
+
+    // GNU 형식: 해시, 공백, ' ' 또는 '*', 경로 (빈 경로는 형식 오류)
+    if (rest < FILE_HASH_HEX_LENGTH + 3) return 0;
+    if (p[FILE_HASH_HEX_LENGTH] != ' ' || (p[FILE_HASH_HEX_LENGTH + 1] != ' ' && p[FILE_HASH_HEX_LENGTH + 1] != '*')) {
+        return 0;
+    }
+    if (!file_hash_decode_hex(p, digest)) return 0;
+    const char* name = p + FILE_HASH_HEX_LENGTH + 2;
+    size_t name_length = rest - FILE_HASH_HEX_LENGTH - 2;
+    if (escaped) return file_hash_unescape(name, name_length, path, path_size);
+    if (name_length + 1 > path_size) return 0;
+    memcpy(path, name, name_length);
+    path[name_length] = '\0';
+    return 1;
+}
@@ -0,0 +1,84 @@
+#ifndef FILE_HASH_H
+#define FILE_HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "crypto_api.h"
+#include "file_crypto.h"
+#include "platform_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 파일 SHA-512 체크섬 (sha512sum 호환 줄 형식)
+// 한 줄: [\]<16진수 128자><공백><' ' 텍스트 | '*' 바이너리><경로>
+// 경로에 '\', 줄바꿈, CR이 있으면 줄 앞에 '\'를 붙이고 경로 안에서 "\\", "\n", "\r"로 바꿈 (GNU coreutils 규칙)
+#define FILE_HASH_HEX_LENGTH (SHA512_DIGEST_LENGTH * 2)
+
+// 이 크기 이상인 파일은 메모리 매핑으로 해시 (작은 파일은 매핑 비용이 읽기보다 큼)
+#define FILE_HASH_MMAP_THRESHOLD (1024 * 1024)
+
+// 스트리밍 읽기 버퍼 크기 (작업 스레드 스택에 둠)
+#define FILE_HASH_READ_SIZE (64 * 1024)
+
+// 체크섬 한 줄 최대 길이 ('\' + 16진수 + 구분자 2자 + 이스케이프로 최대 두 배가 된 경로 + 줄바꿈 + NUL)
+#define FILE_HASH_LINE_LENGTH (1 + FILE_HASH_HEX_LENGTH + 2 + 2 * MAX_PATH_LENGTH + 2)
+
+// 배치 항목
+typedef struct {
+    const char* path;                        // 파일 경로
+    uint8_t digest[SHA512_DIGEST_LENGTH];    // [out] SHA-512
+    FILE_CRYPTO_STATUS status;               // [out] FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_OPEN/READ
+} FileHashItem;
+
+/**
+ * @brief 파일 하나의 SHA-512를 계산합니다.
+ * @param path 파일 경로
+ * @param allow_mmap 1이면 FILE_HASH_MMAP_THRESHOLD 이상인 파일을 메모리 매핑으로 읽음 (매핑할 수 없으면 스트리밍)
+ * @param digest 출력 해시 (SHA512_DIGEST_LENGTH)
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_FILE_OPEN, FILE_CRYPTO_ERR_FILE_READ
+ * @note 매핑한 파일이 해시 도중 다른 프로세스에 의해 잘리면 SIGBUS가 날 수 있으므로
+ *       네트워크 파일시스템처럼 바뀔 수 있는 파일은 allow_mmap 0으로 스트리밍합니다.
+ */
+FILE_CRYPTO_STATUS file_sha512(const char* path, int allow_mmap, uint8_t* digest);
+
+/**
+ * @brief 여러 파일의 SHA-512를 스레드 풀에서 동시에 계산합니다.
+ * @param items 항목 목록 (digest, status가 채워짐)
+ * @param count 항목 수
+ * @param allow_mmap file_sha512와 같음
+ * @param pool 스레드 풀 (NULL이면 호출 스레드에서 차례로 처리)
+ * @return 성공한 항목 수
+ * @note 작업 스레드마다 다음 항목 번호를 원자적으로 가져가므로 큰 파일 하나가 나머지를 막지 않습니다.
+ *       호출 스레드도 함께 처리합니다. 작업 안에서 호출하지 않습니다 (platform_thread_pool_wait 사용).
+ */
+size_t file_hash_batch(FileHashItem* items, size_t count, int allow_mmap, platform_thread_pool_t* pool);
+
+/**
+ * @brief sha512sum 형식의 한 줄을 만듭니다 (줄바꿈 포함).
+ * @param digest 해시 (SHA512_DIGEST_LENGTH)
+ * @param path 파일 경로
+ * @param line 출력 버퍼 (FILE_HASH_LINE_LENGTH 이상이면 항상 충분)
+ * @param line_size 버퍼 크기
+ * @return 1 성공, 0 버퍼 부족
+ */
+int file_hash_format_line(const uint8_t* digest, const char* path, char* line, size_t line_size);
+
+/**
+ * @brief 체크섬 목록의 한 줄을 해석합니다 (sha512sum -c와 같은 입력).
+ * @param line 한 줄 (끝의 줄바꿈과 CR은 무시)
+ * @param digest 출력 해시 (SHA512_DIGEST_LENGTH)
+ * @param path 출력 경로 (이스케이프 해제)
+ * @param path_size 경로 버퍼 크기
+ * @return 1 성공, 0 형식 오류 (경로가 너무 긴 경우 포함)
+ * @note GNU 형식("해시  경로", "해시 *경로")과 BSD 태그 형식("SHA512 (경로) = 해시")을 모두 받습니다.
+ *       16진수는 대소문자를 구분하지 않습니다.
+ */
+int file_hash_parse_line(const char* line, uint8_t* digest, char* path, size_t path_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_HASH_H
@@ -13,6 +13,10 @@ void derive_keys(const char* password, int aes_key_bits,
                  const uint8_t* salt, size_t salt_len,
                  uint8_t* aes_key, uint8_t* hmac_key);
 
+// 키 확인 값(KCV): HMAC 키로 고정 레이블을 MAC한 값의 앞 kcv_len 바이트
+// 복호화 시 전체 데이터를 읽기 전에 비밀번호가 맞는지 확인하는 데 사용
+void derive_key_check_value(const uint8_t* hmac_key, uint8_t* kcv, size_t kcv_len);
+
 #ifdef __cplusplus
 }
 #endif
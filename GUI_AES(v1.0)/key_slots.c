@@ -0,0 +1,266 @@
+#include "key_slots.h"
+#include "crypto_api.h"
+#include "hmac_sha512.h"
+#include "key_derivation.h"
+#include "platform_utils.h"
+#include <string.h>
+
+// 슬롯 표 위치 (헤더 + HMAC 다음)
+#define KEY_SLOT_TABLE_OFFSET ((int64_t)sizeof(EncFileHeader) + ENC_HMAC_SIZE)
+
+// 슬롯 태그가 덮는 슬롯 앞부분 (state ~ wrapped_key)
+#define KEY_SLOT_SEALED_SIZE (ENC_KEY_SLOT_SIZE - 32)
+
+static int key_slot_bits(const EncFileHeader* header) {
+    if (header->key_length_code == KEY_LENGTH_CODE_128) return 128;
+    if (header->key_length_code == KEY_LENGTH_CODE_192) return 192;
+    if (header->key_length_code == KEY_LENGTH_CODE_256) return 256;
+    return 0;
+}
+
+/**
+ * @brief 슬롯 키로 데이터 키를 암호화/복호화하고 슬롯 태그를 계산합니다.
+ * @param header 파일 헤더
+ * @param index 슬롯 번호
+ * @param password 슬롯 비밀번호
+ * @param slot 슬롯 (salt 설정됨, state와 wrapped_key는 태그 입력)
+ * @param in 입력 (데이터 키 또는 wrapped_key)
+ * @param out 출력 (ENC_DATA_KEY_SIZE, slot->wrapped_key 가능)
+ * @param tag 출력 태그 (32바이트)
+ * @note 암호화 후 태그를 계산하므로 out이 slot->wrapped_key면 감싼 키에 대한 태그가 됩니다.
+ *       슬롯 키는 salt마다 다르고 salt는 슬롯을 기록할 때마다 새로 만들므로 CTR 카운터는 0부터 시작합니다.
+ */
+static void key_slot_apply(const EncFileHeader* header, int index, const char* password, const EncKeySlot* slot,
+                           const uint8_t* in, uint8_t* out, uint8_t* tag) {
+    int bits = key_slot_bits(header);
+    uint8_t slot_aes_key[32];
+    uint8_t slot_hmac_key[HMAC_KEY_SIZE];
+    derive_keys(password, bits, slot->salt, sizeof(slot->salt), slot_aes_key, slot_hmac_key);
+
+    AES_CTX aes_ctx;
+    uint8_t counter[AES_BLOCK_SIZE] = { 0 };
+    AES_set_key(&aes_ctx, slot_aes_key, bits);
+    AES_CTR_crypt(&aes_ctx, in, ENC_DATA_KEY_SIZE, out, counter);
+    memset(&aes_ctx, 0, sizeof(aes_ctx));
+
+    uint8_t slot_index = (uint8_t)index;
+    uint8_t mac[HMAC_SHA512_DIGEST_SIZE];
+    HMAC_SHA512_CTX ctx;
+    hmac_sha512_init(&ctx, slot_hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&ctx, (const uint8_t*)header, sizeof(EncFileHeader));
+    hmac_sha512_update(&ctx, &slot_index, 1);
+    hmac_sha512_update(&ctx, (const uint8_t*)slot, KEY_SLOT_SEALED_SIZE);
+    hmac_sha512_final(&ctx, mac);
+    memcpy(tag, mac, sizeof(slot->tag));
+
+    memset(slot_aes_key, 0, sizeof(slot_aes_key));
+    memset(slot_hmac_key, 0, sizeof(slot_hmac_key));
+}
+
+FILE_CRYPTO_STATUS key_slot_seal(const EncFileHeader* header, int index, const char* password,
+                                 const uint8_t* data_key, EncKeySlot* slot) {
+    if (!header || !password || !data_key || !slot || index < 0 || index >= ENC_KEY_SLOT_COUNT) {
+        return FILE_CRYPTO_ERR_INVALID_INPUT;
+    }
+    if (key_slot_bits(header) == 0) return FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+
+    memset(slot, 0, sizeof(EncKeySlot));
+    slot->state = ENC_KEY_SLOT_ACTIVE;
+    if (crypto_random_bytes(slot->salt, sizeof(slot->salt)) != CRYPTO_SUCCESS) {
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    key_slot_apply(header, index, password, slot, data_key, slot->wrapped_key, slot->tag);
+    return FILE_CRYPTO_SUCCESS;
+}
+
+int key_slots_unlock(const EncFileHeader* header, const EncKeySlot* slots, const char* password,
+                     uint8_t* data_key) {
+    if (!header || !slots || !password || !data_key) return -1;
+    if (key_slot_bits(header) == 0) return -1;
+
+    for (int i = 0; i < ENC_KEY_SLOT_COUNT; i++) {
+        if (slots[i].state != ENC_KEY_SLOT_ACTIVE) continue;
+
+        uint8_t tag[sizeof(slots[i].tag)];
+        key_slot_apply(header, i, password, &slots[i], slots[i].wrapped_key, data_key, tag);
+        if (memcmp(tag, slots[i].tag, sizeof(tag)) != 0) continue;
+
+        // 슬롯이 다른 파일에서 옮겨 온 것이 아닌지 헤더의 KCV로 확인
+        uint8_t key_check[ENC_KCV_SIZE];
+        derive_key_check_value(data_key + 32, key_check, sizeof(key_check));
+        if (memcmp(key_check, header->reserved, ENC_KCV_SIZE) == 0) return i;
+    }
+    memset(data_key, 0, ENC_DATA_KEY_SIZE);
+    return -1;
+}
+
+FILE_CRYPTO_STATUS key_slots_read(FILE* fin, EncKeySlot* slots) {
+    if (!fin || !slots) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (platform_pread(fin, slots, KEY_SLOT_TABLE_SIZE, KEY_SLOT_TABLE_OFFSET) != KEY_SLOT_TABLE_SIZE) {
+        return FILE_CRYPTO_ERR_FILE_READ;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief v9 파일을 열어 헤더와 슬롯 표를 읽고, 비밀번호가 있으면 데이터 키를 꺼냅니다.
+ * @param path 파일 경로
+ * @param password 비밀번호 (NULL이면 슬롯을 열지 않음)
+ * @param writable 1이면 읽기/쓰기로 열기
+ * @param file 출력 파일 (성공 시에만 열려 있음)
+ * @param header 출력 헤더
+ * @param slots 출력 슬롯 표
+ * @param data_key 출력 데이터 키 (password가 있을 때)
+ * @param unlocked 출력: 열린 슬롯 번호 (NULL 가능)
+ * @return FILE_CRYPTO_SUCCESS 또는 에러 코드
+ */
+static FILE_CRYPTO_STATUS key_slots_open_file(const char* path, const char* password, int writable, FILE** file,
+                                              EncFileHeader* header, EncKeySlot* slots, uint8_t* data_key,
+                                              int* unlocked) {
+    *file = platform_fopen(path, writable ? "r+b" : "rb");
+    if (!*file) return FILE_CRYPTO_ERR_FILE_OPEN;
+
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    if (fread(header, 1, sizeof(EncFileHeader), *file) != sizeof(EncFileHeader)) {
+        result = FILE_CRYPTO_ERR_INVALID_HEADER;
+    } else if (memcmp(header->signature, ENC_SIGNATURE, 4) != 0) {
+        result = FILE_CRYPTO_ERR_INVALID_SIGNATURE;
+    } else if (header->version != ENC_VERSION_KEYSLOTS) {
+        result = FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
+    } else if (key_slot_bits(header) == 0) {
+        result = FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    } else {
+        result = key_slots_read(*file, slots);
+    }
+
+    if (result == FILE_CRYPTO_SUCCESS && password) {
+        int index = key_slots_unlock(header, slots, password, data_key);
+        if (index < 0) result = FILE_CRYPTO_ERR_KEY_CHECK_FAILED;
+        if (unlocked) *unlocked = index;
+    }
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fclose(*file);
+        *file = NULL;
+    }
+    return result;
+}
+
+/**
+ * @brief 슬롯 하나를 제자리에 기록하고 디스크에 반영합니다.
+ * @param file 읽기/쓰기로 연 파일
+ * @param index 슬롯 번호
+ * @param slot 기록할 슬롯
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_WRITE
+ */
+static FILE_CRYPTO_STATUS key_slot_write(FILE* file, int index, const EncKeySlot* slot) {
+    int64_t position = KEY_SLOT_TABLE_OFFSET + (int64_t)index * ENC_KEY_SLOT_SIZE;
+    if (!platform_pwrite(file, slot, ENC_KEY_SLOT_SIZE, position) || !platform_sync_stream(file)) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+static int key_slot_find_empty(const EncKeySlot* slots) {
+    for (int i = 0; i < ENC_KEY_SLOT_COUNT; i++) {
+        if (slots[i].state != ENC_KEY_SLOT_ACTIVE) return i;
+    }
+    return -1;
+}
+
+FILE_CRYPTO_STATUS enc_rekey(const char* path, const char* old_password, const char* new_password) {
+    if (!path || !old_password || !new_password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE* file = NULL;
+    EncFileHeader header;
+    EncKeySlot slots[ENC_KEY_SLOT_COUNT];
+    uint8_t data_key[ENC_DATA_KEY_SIZE];
+    int old_index = -1;
+    FILE_CRYPTO_STATUS result = key_slots_open_file(path, old_password, 1, &file, &header, slots, data_key,
+                                                    &old_index);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+
+    // 빈 슬롯이 있으면 새 슬롯을 먼저 기록하고 이전 슬롯을 지움 (빈 슬롯이 없으면 제자리 교체)
+    int new_index = key_slot_find_empty(slots);
+    if (new_index < 0) new_index = old_index;
+
+    EncKeySlot slot;
+    result = key_slot_seal(&header, new_index, new_password, data_key, &slot);
+    if (result == FILE_CRYPTO_SUCCESS) result = key_slot_write(file, new_index, &slot);
+    if (result == FILE_CRYPTO_SUCCESS && new_index != old_index) {
+        memset(&slot, 0, sizeof(slot));
+        result = key_slot_write(file, old_index, &slot);
+    }
+
+    memset(data_key, 0, sizeof(data_key));
+    if (fclose(file) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    return result;
+}
+
+FILE_CRYPTO_STATUS enc_add_key_slot(const char* path, const char* password, const char* new_password, int* slot) {
+    if (!path || !password || !new_password) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE* file = NULL;
+    EncFileHeader header;
+    EncKeySlot slots[ENC_KEY_SLOT_COUNT];
+    uint8_t data_key[ENC_DATA_KEY_SIZE];
+    FILE_CRYPTO_STATUS result = key_slots_open_file(path, password, 1, &file, &header, slots, data_key, NULL);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+
+    int index = key_slot_find_empty(slots);
+    EncKeySlot added;
+    if (index < 0) {
+        result = FILE_CRYPTO_ERR_INVALID_INPUT;  // 빈 슬롯 없음
+    } else {
+        result = key_slot_seal(&header, index, new_password, data_key, &added);
+        if (result == FILE_CRYPTO_SUCCESS) result = key_slot_write(file, index, &added);
+    }
+    if (result == FILE_CRYPTO_SUCCESS && slot) *slot = index;
+
+    memset(data_key, 0, sizeof(data_key));
+    if (fclose(file) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    return result;
+}
+
+FILE_CRYPTO_STATUS enc_remove_key_slot(const char* path, const char* password, int slot) {
+    if (!path || !password || slot < 0 || slot >= ENC_KEY_SLOT_COUNT) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE* file = NULL;
+    EncFileHeader header;
+    EncKeySlot slots[ENC_KEY_SLOT_COUNT];
+    uint8_t data_key[ENC_DATA_KEY_SIZE];
+    FILE_CRYPTO_STATUS result = key_slots_open_file(path, password, 1, &file, &header, slots, data_key, NULL);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+    memset(data_key, 0, sizeof(data_key));
+
+    // 마지막 남은 슬롯을 지우면 아무도 열 수 없으므로 거부
+    int active = 0;
+    for (int i = 0; i < ENC_KEY_SLOT_COUNT; i++) {
+        if (slots[i].state == ENC_KEY_SLOT_ACTIVE) active++;
+    }
+    if (slots[slot].state != ENC_KEY_SLOT_ACTIVE || active <= 1) {
+        result = FILE_CRYPTO_ERR_INVALID_INPUT;
+    } else {
+        EncKeySlot cleared;
+        memset(&cleared, 0, sizeof(cleared));
+        result = key_slot_write(file, slot, &cleared);
+    }
+
+    if (fclose(file) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    return result;
+}
+
+FILE_CRYPTO_STATUS enc_key_slot_states(const char* path, uint8_t* states) {
+    if (!path || !states) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE* file = NULL;
+    EncFileHeader header;
+    EncKeySlot slots[ENC_KEY_SLOT_COUNT];
+    FILE_CRYPTO_STATUS result = key_slots_open_file(path, NULL, 0, &file, &header, slots, NULL, NULL);
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+
+    for (int i = 0; i < ENC_KEY_SLOT_COUNT; i++) {
+        states[i] = (slots[i].state == ENC_KEY_SLOT_ACTIVE) ? ENC_KEY_SLOT_ACTIVE : ENC_KEY_SLOT_EMPTY;
+    }
+    fclose(file);
+    return FILE_CRYPTO_SUCCESS;
+}
@@ -0,0 +1,95 @@
+#ifndef KEY_SLOTS_H
+#define KEY_SLOTS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// v9 키 슬롯 표 크기 (HMAC 바로 다음)
+#define KEY_SLOT_TABLE_SIZE (ENC_KEY_SLOT_COUNT * ENC_KEY_SLOT_SIZE)
+
+/**
+ * @brief 데이터 키를 비밀번호로 감싸 슬롯을 만듭니다 (새 salt 생성).
+ * @param header 파일 헤더 (슬롯 태그에 포함)
+ * @param index 슬롯 번호 (0 ~ ENC_KEY_SLOT_COUNT - 1)
+ * @param password 이 슬롯의 비밀번호
+ * @param data_key 데이터 키 (ENC_DATA_KEY_SIZE)
+ * @param slot 출력 슬롯
+ * @return FILE_CRYPTO_SUCCESS 또는 에러 코드
+ * @note PBKDF2를 한 번 수행합니다.
+ */
+FILE_CRYPTO_STATUS key_slot_seal(const EncFileHeader* header, int index, const char* password,
+                                 const uint8_t* data_key, EncKeySlot* slot);
+
+/**
+ * @brief 비밀번호로 열리는 슬롯을 찾아 데이터 키를 꺼냅니다.
+ * @param header 파일 헤더
+ * @param slots 슬롯 표 (ENC_KEY_SLOT_COUNT개)
+ * @param password 비밀번호
+ * @param data_key 출력 데이터 키 (ENC_DATA_KEY_SIZE, 실패 시 0으로 채움)
+ * @return 열린 슬롯 번호, 맞는 슬롯이 없으면 -1
+ * @note 사용 중인 슬롯마다 PBKDF2를 한 번 수행하고, 꺼낸 키는 헤더의 KCV로 한 번 더 확인합니다.
+ */
+int key_slots_unlock(const EncFileHeader* header, const EncKeySlot* slots, const char* password,
+                     uint8_t* data_key);
+
+/**
+ * @brief 파일의 슬롯 표를 읽습니다.
+ * @param fin 파일 (위치는 바뀌지 않음)
+ * @param slots 출력 슬롯 표 (ENC_KEY_SLOT_COUNT개)
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_READ
+ */
+FILE_CRYPTO_STATUS key_slots_read(FILE* fin, EncKeySlot* slots);
+
+/**
+ * @brief v9 파일의 비밀번호를 바꿉니다 (old_password가 여는 슬롯을 new_password 슬롯으로 교체).
+ * @param path v9 암호화 파일 경로
+ * @param old_password 현재 비밀번호
+ * @param new_password 새 비밀번호
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED (맞는 슬롯 없음),
+ *         FILE_CRYPTO_ERR_UNSUPPORTED_VERSION (v9가 아님) 등
+ * @note 헤더, HMAC, 암호문은 그대로 두고 슬롯만 제자리에 기록하므로 파일 크기와 무관합니다.
+ *       빈 슬롯이 있으면 새 슬롯을 먼저 기록해 디스크에 반영한 뒤 이전 슬롯을 지우므로,
+ *       도중에 중단되어도 두 비밀번호 중 하나로는 항상 열립니다.
+ */
+FILE_CRYPTO_STATUS enc_rekey(const char* path, const char* old_password, const char* new_password);
+
+/**
+ * @brief v9 파일에 비밀번호를 추가합니다 (빈 슬롯에 기록).
+ * @param path v9 암호화 파일 경로
+ * @param password 이미 등록된 비밀번호
+ * @param new_password 추가할 비밀번호
+ * @param slot 출력: 기록한 슬롯 번호 (NULL 가능)
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED, FILE_CRYPTO_ERR_INVALID_INPUT (빈 슬롯 없음) 등
+ */
+FILE_CRYPTO_STATUS enc_add_key_slot(const char* path, const char* password, const char* new_password, int* slot);
+
+/**
+ * @brief v9 파일에서 슬롯 하나를 지웁니다.
+ * @param path v9 암호화 파일 경로
+ * @param password 등록된 비밀번호 중 하나 (지울 슬롯의 비밀번호가 아니어도 됨)
+ * @param slot 지울 슬롯 번호
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED,
+ *         FILE_CRYPTO_ERR_INVALID_INPUT (빈 슬롯이거나 마지막 남은 슬롯) 등
+ * @note 지운 비밀번호로는 이 파일을 더 이상 열 수 없지만, 지우기 전에 복사된 파일은 그대로 열립니다.
+ */
+FILE_CRYPTO_STATUS enc_remove_key_slot(const char* path, const char* password, int slot);
+
+/**
+ * @brief v9 파일의 슬롯 사용 상태를 읽습니다 (비밀번호 불필요).
+ * @param path v9 암호화 파일 경로
+ * @param states 출력 슬롯 상태 (ENC_KEY_SLOT_COUNT개, ENC_KEY_SLOT_ACTIVE/ENC_KEY_SLOT_EMPTY)
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_UNSUPPORTED_VERSION (v9가 아님) 등
+ */
+FILE_CRYPTO_STATUS enc_key_slot_states(const char* path, uint8_t* states);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KEY_SLOTS_H
@@ -10,6 +10,7 @@
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QDir>
+#include <QDirIterator>
 #include "file_crypto.h"
 #include "platform_utils.h"
 #include "password_utils.h"
@@ -42,6 +43,8 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onError);
     connect(worker, &CryptoWorker::processFileListRequested,
             worker, &CryptoWorker::processFileList, Qt::QueuedConnection);
+    connect(worker, &CryptoWorker::verifyFileListRequested,
+            worker, &CryptoWorker::verifyFileList, Qt::QueuedConnection);
     
     workerThread->start();
     
@@ -63,6 +66,7 @@ void MainWindow::setupUI()
     
     // 버튼 연결
     connect(ui->selectFilesButton, &QPushButton::clicked, this, &MainWindow::onSelectFiles);
+    connect(ui->selectFolderButton, &QPushButton::clicked, this, &MainWindow::onSelectFolder);
     connect(ui->removeFileButton, &QPushButton::clicked, this, &MainWindow::onRemoveFile);
     connect(ui->browseOutputButton, &QPushButton::clicked, this, &MainWindow::onBrowseOutputPath);
     connect(ui->outputPathEdit, &QLineEdit::textChanged, this, &MainWindow::onOutputPathChanged);
@@ -70,6 +74,7 @@ void MainWindow::setupUI()
             this, &MainWindow::onFileListSelectionChanged);
     connect(ui->encryptButton, &QPushButton::clicked, this, &MainWindow::onEncrypt);
     connect(ui->decryptButton, &QPushButton::clicked, this, &MainWindow::onDecrypt);
+    connect(ui->verifyButton, &QPushButton::clicked, this, &MainWindow::onVerify);
     
     // 패스워드 입력 필드 설정
     ui->passwordEdit->setEchoMode(QLineEdit::Password);
@@ -81,10 +86,12 @@ void MainWindow::setupUI()
 void MainWindow::enableButtons(bool enabled)
 {
     ui->selectFilesButton->setEnabled(enabled);
+    ui->selectFolderButton->setEnabled(enabled);
     ui->removeFileButton->setEnabled(enabled);
     ui->browseOutputButton->setEnabled(enabled);
     ui->encryptButton->setEnabled(enabled);
     ui->decryptButton->setEnabled(enabled);
+    ui->verifyButton->setEnabled(enabled);
     ui->aes128Radio->setEnabled(enabled);
     ui->aes192Radio->setEnabled(enabled);
     ui->aes256Radio->setEnabled(enabled);
@@ -110,6 +117,9 @@ void MainWindow::dropEvent(QDropEvent *event)
                 QFileInfo fileInfo(filePath);
                 if (fileInfo.isFile()) {
                     filePaths.append(filePath);
+                } else if (fileInfo.isDir()) {
+                    // 폴더는 그 안의 .enc 파일을 추가 (백업 폴더 검증용)
+                    filePaths.append(collectEncryptedFiles(filePath));
                 }
             }
         }
@@ -130,6 +140,34 @@ void MainWindow::onSelectFiles()
     }
 }
 
+void MainWindow::onSelectFolder()
+{
+    QString dirPath = QFileDialog::getExistingDirectory(this, DialogTitles::SELECT_FOLDER);
+    if (dirPath.isEmpty()) {
+        return;
+    }
+    
+    QStringList files = collectEncryptedFiles(dirPath);
+    if (files.isEmpty()) {
+        showInfo(QString("No .enc files found in %1").arg(toNativePath(dirPath)));
+        return;
+    }
+    addFilesToList(files);
+}
+
+QStringList MainWindow::collectEncryptedFiles(const QString &dirPath)
+{
+    // 이름 필터는 대소문자를 구분하지 않고, 심볼릭 링크는 따라가지 않음
+    QStringList files;
+    QDirIterator it(dirPath, QStringList() << "*.enc", QDir::Files | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files.append(it.next());
+    }
+    files.sort();
+    return files;
+}
+
 void MainWindow::addFilesToList(const QStringList &filePaths)
 {
     for (const QString &filePath : filePaths) {
@@ -657,6 +695,37 @@ void MainWindow::onDecrypt()
     emit worker->processFileListRequested(filePairs, false, 0, password);
 }
 
+void MainWindow::onVerify()
+{
+    // 목록의 .enc 파일을 모두 검증 (선택과 무관, 출력 경로 사용하지 않음)
+    QStringList files;
+    for (const FileInfo &fi : fileList) {
+        if (fi.isEncrypted) {
+            files.append(fi.inputPath);
+        }
+    }
+    if (files.isEmpty()) {
+        showError(ErrorMessages::ADD_FILES_TO_VERIFY);
+        return;
+    }
+    
+    QString password = ui->passwordEdit->text();
+    if (password.isEmpty()) {
+        showError(ErrorMessages::ENTER_PASSWORD_FOR_DECRYPT);
+        return;
+    }
+    
+    // 검증은 파일을 바꾸지 않으므로 완료 후 목록에서 제거하지 않음
+    processingFileIndex = -1;
+    
+    ui->progressBar->setValue(0);
+    ui->statusLabel->setText(StatusMessages::PREPARING_VERIFICATION);
+    enableButtons(false);
+    
+    // 워커 스레드에서 병렬 검증 실행 (시그널 사용)
+    emit worker->verifyFileListRequested(files, password);
+}
+
 void MainWindow::onProgressUpdated(qint64 processed, qint64 total, const QString &fileName)
 {
     // total이 0이거나 음수인 경우 처리
@@ -24,6 +24,7 @@ namespace ErrorMessages {
     constexpr const char* SELECT_FILE_FIRST = "Please select a file first.";
     constexpr const char* SELECT_FILE_TO_ENCRYPT = "Please select a file to encrypt.";
     constexpr const char* SELECT_FILE_TO_DECRYPT = "Please select a file to decrypt.";
+    constexpr const char* ADD_FILES_TO_VERIFY = "Please add .enc files (or a folder containing them) to verify.";
     constexpr const char* ENTER_PASSWORD = "Please enter a password.";
     constexpr const char* ENTER_PASSWORD_FOR_DECRYPT = "Please enter the password used for encryption.";
     constexpr const char* INVALID_FILE_SELECTION = "Invalid file selection.";
@@ -38,6 +39,7 @@ namespace FileFilters {
 
 namespace DialogTitles {
     constexpr const char* SELECT_FILES = "Select Files";
+    constexpr const char* SELECT_FOLDER = "Select Folder (all .enc files inside are added)";
     constexpr const char* SAVE_ENCRYPTED_FILE = "Save Encrypted File";
     constexpr const char* SAVE_DECRYPTED_FILE = "Save Decrypted File";
 }
@@ -46,6 +48,7 @@ namespace StatusMessages {
     constexpr const char* READY = "Ready";
     constexpr const char* PREPARING_ENCRYPTION = "Preparing encryption...";
     constexpr const char* PREPARING_DECRYPTION = "Preparing decryption...";
+    constexpr const char* PREPARING_VERIFICATION = "Preparing verification...";
     constexpr const char* PROCESSING_TEMPLATE = "Processing %1...";
 }
 
@@ -75,12 +78,14 @@ protected:
 
 private slots:
     void onSelectFiles();
+    void onSelectFolder();
     void onRemoveFile();
     void onFileListSelectionChanged();
     void onBrowseOutputPath();
     void onOutputPathChanged();
     void onEncrypt();
     void onDecrypt();
+    void onVerify();
     void onProgressUpdated(qint64 processed, qint64 total, const QString &fileName);
     void onFinished(bool success, const QString &message);
     void onError(const QString &errorMessage);
@@ -97,6 +102,7 @@ private:
     void setupUI();
     void enableButtons(bool enabled);
     void addFilesToList(const QStringList &filePaths);
+    static QStringList collectEncryptedFiles(const QString &dirPath);  // 폴더 아래 .enc 파일 (하위 폴더 포함)
     void updateFileListDisplay();
     void updateOutputPathForCurrentFile();
     QString generateDefaultOutputPath(const QString &inputPath, bool isEncrypt) const;
@@ -1,14 +1,38 @@
 #define _CRT_SECURE_NO_WARNINGS
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // -std=c99에서도 mkstemp, nanosleep, sysconf 선언 사용
+#endif
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64  // 32비트 빌드에서도 off_t/fseeko/fopen이 2 GiB 넘는 파일을 다루도록
+#endif
 #include "platform_utils.h"
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
 
 #ifdef PLATFORM_WINDOWS
 #include <io.h>
+#include <fcntl.h>
 #elif defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
 #include <unistd.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
+// Linux io_uring (커널 헤더만 사용, liburing 없이 시스템 콜 직접 호출)
+#if defined(PLATFORM_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PLATFORM_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
 #endif
 
 // Cross-platform file deletion implementation
@@ -22,6 +46,96 @@ int platform_delete_file(const char* file_path) {
 #endif
 }
 
+// Cross-platform atomic rename implementation
+int platform_rename_file(const char* src_path, const char* dst_path) {
+    if (!src_path || !dst_path) return 0;
+    
+#ifdef PLATFORM_WINDOWS
+    wchar_t wsrc[512];
+    wchar_t wdst[512];
+    if (MultiByteToWideChar(CP_UTF8, 0, src_path, -1, wsrc, 512) == 0 ||
+        MultiByteToWideChar(CP_UTF8, 0, dst_path, -1, wdst, 512) == 0) {
+        return 0;
+    }
+    return (MoveFileExW(wsrc, wdst, MOVEFILE_REPLACE_EXISTING) != 0) ? 1 : 0;
+#else
+    // POSIX rename()은 같은 파일시스템 안에서 원자적으로 교체
+    return (rename(src_path, dst_path) == 0) ? 1 : 0;
+#endif
+}
+
+// Cross-platform staged temporary file (same directory as target) implementation
+FILE* platform_create_temp_file_near(const char* target_path, char* temp_path, size_t temp_path_size) {
+    if (!target_path) return NULL;
+    
+    // 대상 파일의 디렉토리 추출 (구분자가 없으면 현재 디렉토리)
+    char dir[512];
+    const char* last_sep = platform_find_last_separator(target_path);
+    if (last_sep) {
+        size_t dir_len = (size_t)(last_sep - target_path) + 1;  // 구분자 포함
+        if (dir_len >= sizeof(dir)) return NULL;
+        memcpy(dir, target_path, dir_len);
+        dir[dir_len] = '\0';
+    } else {
+        dir[0] = '\0';
+    }
+    
+#ifdef PLATFORM_WINDOWS
+    wchar_t wdir[512];
+    wchar_t wtemp[MAX_PATH];
+    if (MultiByteToWideChar(CP_UTF8, 0, dir[0] ? dir : ".", -1, wdir, 512) == 0) {
+        return NULL;
+    }
+    
+    // 임시 파일명 생성 (대상과 같은 디렉토리에 파일이 생성됨)
+    if (GetTempFileNameW(wdir, L"dec", 0, wtemp) == 0) {
+        return NULL;
+    }
+    
+    char temp_file[512];
+    if (WideCharToMultiByte(CP_UTF8, 0, wtemp, -1, temp_file, (int)sizeof(temp_file), NULL, NULL) == 0) {
+        DeleteFileW(wtemp);
+        return NULL;
+    }
+    
+    if (temp_path && temp_path_size > 0) {
+        strncpy(temp_path, temp_file, temp_path_size - 1);
+        temp_path[temp_path_size - 1] = '\0';
+    }
+    
+    FILE* f = _wfopen(wtemp, L"w+b");
+    if (!f) {
+        DeleteFileW(wtemp);
+    }
+    return f;
+#else
+    // 숨김 파일로 스테이징 (mkstemp는 0600 권한으로 생성)
+    char template_path[600];
+    int written = snprintf(template_path, sizeof(template_path), "%s.decrypt_XXXXXX", dir);
+    if (written < 0 || (size_t)written >= sizeof(template_path)) {
+        return NULL;
+    }
+    
+    int fd = mkstemp(template_path);
+    if (fd == -1) {
+        return NULL;
+    }
+    
+    if (temp_path && temp_path_size > 0) {
+        strncpy(temp_path, template_path, temp_path_size - 1);
+        temp_path[temp_path_size - 1] = '\0';
+    }
+    
+    FILE* f = fdopen(fd, "w+b");
+    if (!f) {
+        close(fd);
+        unlink(template_path);
+        return NULL;
+    }
+    return f;
+#endif
+}
+
 // Find last path separator (both / and \) implementation
 const char* platform_find_last_separator(const char* path) {
     if (!path) return NULL;
@@ -73,6 +187,167 @@ int platform_file_exists(const char* file_path) {
 #endif
 }
 
+// Recursive walk of regular files (path buffer shared down the recursion)
+#define PLATFORM_WALK_PATH_LENGTH 4096
+
+static int platform_walk_recursive(char* path, size_t length, platform_walk_callback callback, void* user_data) {
+#ifdef PLATFORM_WINDOWS
+    // 깊은 디렉토리에서 스택을 아끼도록 넓은 문자 패턴은 힙에 둠
+    if (length + 3 > PLATFORM_WALK_PATH_LENGTH) return 0;
+    wchar_t* wpattern = (wchar_t*)malloc(PLATFORM_WALK_PATH_LENGTH * sizeof(wchar_t));
+    if (!wpattern) return 0;
+    memcpy(path + length, "\\*", 3);
+    int converted = MultiByteToWideChar(CP_UTF8, 0, path, -1, wpattern, PLATFORM_WALK_PATH_LENGTH);
+    path[length] = '\0';
+    
+    WIN32_FIND_DATAW entry;
+    HANDLE find = converted ? FindFirstFileW(wpattern, &entry) : INVALID_HANDLE_VALUE;
+    free(wpattern);
+    if (find == INVALID_HANDLE_VALUE) return 0;
+    int ok = 1;
+    do {
+        if (wcscmp(entry.cFileName, L".") == 0 || wcscmp(entry.cFileName, L"..") == 0) continue;
+        if (entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;  // 링크는 따라가지 않음 (순환 방지)
+        char name[MAX_PATH * 3];
+        if (WideCharToMultiByte(CP_UTF8, 0, entry.cFileName, -1, name, sizeof(name), NULL, NULL) == 0) {
+            ok = 0;
+            continue;
+        }
+        size_t name_length = strlen(name);
+        if (length + 1 + name_length >= PLATFORM_WALK_PATH_LENGTH) {
+            ok = 0;
+            continue;
+        }
+        path[length] = '\\';
+        memcpy(path + length + 1, name, name_length + 1);
+        if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (!platform_walk_recursive(path, length + 1 + name_length, callback, user_data)) ok = 0;
+        } else if (!callback(path, user_data)) {
+            path[length] = '\0';
+            FindClose(find);
+            return 0;
+        }
+        path[length] = '\0';
+    } while (FindNextFileW(find, &entry));
+    FindClose(find);
+    return ok;
+#else
+    DIR* dir = opendir(path);
+    if (!dir) return 0;
+    int ok = 1;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        size_t name_length = strlen(entry->d_name);
+        if (length + 1 + name_length >= PLATFORM_WALK_PATH_LENGTH) {
+            ok = 0;
+            continue;
+        }
+        path[length] = '/';
+        memcpy(path + length + 1, entry->d_name, name_length + 1);
+        
+        // lstat: 심볼릭 링크는 따라가지 않음 (순환 방지)
+        struct stat st;
+        if (lstat(path, &st) != 0) {
+            ok = 0;
+        } else if (S_ISDIR(st.st_mode)) {
+            if (!platform_walk_recursive(path, length + 1 + name_length, callback, user_data)) ok = 0;
+        } else if (S_ISREG(st.st_mode) && !callback(path, user_data)) {
+            path[length] = '\0';
+            closedir(dir);
+            return 0;
+        }
+        path[length] = '\0';
+    }
+    closedir(dir);
+    return ok;
+#endif
+}
+
+// Cross-platform recursive directory walk implementation
+int platform_walk_directory(const char* dir_path, platform_walk_callback callback, void* user_data) {
+    if (!dir_path || !callback) return 0;
+    
+    char path[PLATFORM_WALK_PATH_LENGTH];
+    size_t length = strlen(dir_path);
+    if (length == 0 || length >= sizeof(path)) return 0;
+    memcpy(path, dir_path, length + 1);
+    // 끝의 구분자 제거 (루트 "/"는 빈 접두어로 두고 항목마다 구분자를 붙임)
+    while (length > 1 && (path[length - 1] == '/' || path[length - 1] == '\\')) path[--length] = '\0';
+    if (length == 1 && path[0] == '/') length = 0;
+    return platform_walk_recursive(path, length, callback, user_data);
+}
+
+// Cross-platform binary stream mode implementation
+int platform_set_binary_mode(FILE* stream) {
+    if (!stream) return 0;
+    
+#ifdef PLATFORM_WINDOWS
+    // 텍스트 모드는 0x0A를 CR/LF로 바꾸고 0x1A에서 읽기를 멈춤
+    return (_setmode(_fileno(stream), _O_BINARY) != -1) ? 1 : 0;
+#else
+    return 1;
+#endif
+}
+
+// Cross-platform fdopen implementation
+FILE* platform_fdopen(int fd, const char* mode) {
+    if (fd < 0 || !mode) return NULL;
+    
+#ifdef PLATFORM_WINDOWS
+    return _fdopen(fd, mode);
+#else
+    return fdopen(fd, mode);
+#endif
+}
+
+// Cross-platform 64-bit seek implementation
+int platform_fseek64(FILE* stream, int64_t offset, int whence) {
+    if (!stream) return -1;
+    
+#ifdef PLATFORM_WINDOWS
+    // long이 32비트(LLP64)라 fseek은 2 GiB까지만 다룸
+    return _fseeki64(stream, offset, whence);
+#else
+    if ((int64_t)(off_t)offset != offset) return -1;  // off_t 범위 초과
+    return fseeko(stream, (off_t)offset, whence);
+#endif
+}
+
+// Cross-platform 64-bit tell implementation
+int64_t platform_ftell64(FILE* stream) {
+    if (!stream) return -1;
+    
+#ifdef PLATFORM_WINDOWS
+    return (int64_t)_ftelli64(stream);
+#else
+    return (int64_t)ftello(stream);
+#endif
+}
+
+// Cross-platform stream truncation implementation
+int platform_truncate_stream(FILE* stream, int64_t size) {
+    if (!stream || size < 0) return 0;
+    if (fflush(stream) != 0) return 0;
+    
+#ifdef PLATFORM_WINDOWS
+    return (_chsize_s(_fileno(stream), size) == 0) ? 1 : 0;
+#else
+    return (ftruncate(fileno(stream), (off_t)size) == 0) ? 1 : 0;
+#endif
+}
+
+int platform_sync_stream(FILE* stream) {
+    if (!stream) return 0;
+    if (fflush(stream) != 0) return 0;
+    
+#ifdef PLATFORM_WINDOWS
+    return (_commit(_fileno(stream)) == 0) ? 1 : 0;
+#else
+    return (fsync(fileno(stream)) == 0) ? 1 : 0;
+#endif
+}
+
 #ifdef PLATFORM_WINDOWS
 #include <windows.h>
 #ifndef CP_UTF8
@@ -208,3 +483,1319 @@ FILE* platform_create_temp_file(char* temp_path, size_t temp_path_size) {
 }
 #endif
 
+// ========================================
+// 스레드 / 원자 연산 (파이프라인 처리용 최소 기능)
+// ========================================
+
+struct platform_thread {
+    platform_thread_func func;
+    void* arg;
+#ifdef PLATFORM_WINDOWS
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+};
+
+#ifdef PLATFORM_WINDOWS
+static DWORD WINAPI platform_thread_entry(LPVOID param) {
+    platform_thread_t* thread = (platform_thread_t*)param;
+    thread->func(thread->arg);
+    return 0;
+}
+#else
+static void* platform_thread_entry(void* param) {
+    platform_thread_t* thread = (platform_thread_t*)param;
+    thread->func(thread->arg);
+    return NULL;
+}
+#endif
+
+// Cross-platform thread creation implementation
+platform_thread_t* platform_thread_create(platform_thread_func func, void* arg) {
+    if (!func) return NULL;
+    
+    platform_thread_t* thread = (platform_thread_t*)malloc(sizeof(platform_thread_t));
+    if (!thread) return NULL;
+    thread->func = func;
+    thread->arg = arg;
+    
+#ifdef PLATFORM_WINDOWS
+    thread->handle = CreateThread(NULL, 0, platform_thread_entry, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        free(thread);
+        return NULL;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, platform_thread_entry, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+#endif
+    return thread;
+}
+
+// Cross-platform thread join implementation
+void platform_thread_join(platform_thread_t* thread) {
+    if (!thread) return;
+    
+#ifdef PLATFORM_WINDOWS
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+}
+
+// Cross-platform thread yield implementation
+void platform_thread_yield(void) {
+#ifdef PLATFORM_WINDOWS
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Cross-platform sleep implementation
+void platform_sleep_ms(unsigned int ms) {
+#ifdef PLATFORM_WINDOWS
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+struct platform_mutex {
+#ifdef PLATFORM_WINDOWS
+    CRITICAL_SECTION handle;
+#else
+    pthread_mutex_t handle;
+#endif
+};
+
+struct platform_cond {
+#ifdef PLATFORM_WINDOWS
+    CONDITION_VARIABLE handle;
+#else
+    pthread_cond_t handle;
+#endif
+};
+
+// Cross-platform mutex implementation
+platform_mutex_t* platform_mutex_create(void) {
+    platform_mutex_t* mutex = (platform_mutex_t*)malloc(sizeof(platform_mutex_t));
+    if (!mutex) return NULL;
+    
+#ifdef PLATFORM_WINDOWS
+    InitializeCriticalSection(&mutex->handle);
+#else
+    if (pthread_mutex_init(&mutex->handle, NULL) != 0) {
+        free(mutex);
+        return NULL;
+    }
+#endif
+    return mutex;
+}
+
+void platform_mutex_destroy(platform_mutex_t* mutex) {
+    if (!mutex) return;
+    
+#ifdef PLATFORM_WINDOWS
+    DeleteCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_destroy(&mutex->handle);
+#endif
+    free(mutex);
+}
+
+void platform_mutex_lock(platform_mutex_t* mutex) {
+#ifdef PLATFORM_WINDOWS
+    EnterCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void platform_mutex_unlock(platform_mutex_t* mutex) {
+#ifdef PLATFORM_WINDOWS
+    LeaveCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+// Cross-platform condition variable implementation
+platform_cond_t* platform_cond_create(void) {
+    platform_cond_t* cond = (platform_cond_t*)malloc(sizeof(platform_cond_t));
+    if (!cond) return NULL;
+    
+#ifdef PLATFORM_WINDOWS
+    InitializeConditionVariable(&cond->handle);
+#else
+    if (pthread_cond_init(&cond->handle, NULL) != 0) {
+        free(cond);
+        return NULL;
+    }
+#endif
+    return cond;
+}
+
+void platform_cond_destroy(platform_cond_t* cond) {
+    if (!cond) return;
+    
+#ifndef PLATFORM_WINDOWS
+    pthread_cond_destroy(&cond->handle);  // Windows 조건 변수는 해제할 자원이 없음
+#endif
+    free(cond);
+}
+
+void platform_cond_wait(platform_cond_t* cond, platform_mutex_t* mutex) {
+#ifdef PLATFORM_WINDOWS
+    SleepConditionVariableCS(&cond->handle, &mutex->handle, INFINITE);
+#else
+    pthread_cond_wait(&cond->handle, &mutex->handle);
+#endif
+}
+
+void platform_cond_broadcast(platform_cond_t* cond) {
+#ifdef PLATFORM_WINDOWS
+    WakeAllConditionVariable(&cond->handle);
+#else
+    pthread_cond_broadcast(&cond->handle);
+#endif
+}
+
+// Cross-platform CPU count implementation
+int platform_cpu_count(void) {
+#ifdef PLATFORM_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0) ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+#endif
+}
+
+// Cross-platform atomic operations implementation
+long platform_atomic_load(volatile long* value) {
+#ifdef PLATFORM_WINDOWS
+    return InterlockedCompareExchange(value, 0, 0);  // 전체 메모리 배리어 포함
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void platform_atomic_store(volatile long* value, long new_value) {
+#ifdef PLATFORM_WINDOWS
+    InterlockedExchange(value, new_value);
+#else
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+#endif
+}
+
+int platform_atomic_compare_exchange(volatile long* value, long expected, long desired) {
+#ifdef PLATFORM_WINDOWS
+    return (InterlockedCompareExchange(value, desired, expected) == expected) ? 1 : 0;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ? 1 : 0;
+#endif
+}
+
+long platform_atomic_fetch_add(volatile long* value, long delta) {
+#ifdef PLATFORM_WINDOWS
+    return InterlockedExchangeAdd(value, delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_ACQ_REL);
+#endif
+}
+
+// ========================================
+// 스레드 풀 (작업 스레드별 Chase-Lev 작업 훔치기 덱)
+// ========================================
+
+// 덱 배열 초기 크기 (2의 거듭제곱, 가득 차면 두 배로 늘림)
+#define POOL_DEQUE_INITIAL_CAPACITY 256
+
+// 작업 스레드를 식별하기 위한 스레드 지역 변수
+#ifdef PLATFORM_WINDOWS
+#define POOL_THREAD_LOCAL __declspec(thread)
+#else
+#define POOL_THREAD_LOCAL __thread
+#endif
+
+typedef struct pool_task {
+    platform_task_func func;
+    void* arg;
+} pool_task;
+
+// 덱 원형 배열 (늘릴 때 이전 배열은 훔치는 스레드가 아직 읽을 수 있으므로 풀 해제 시까지 보관)
+typedef struct pool_array {
+    int64_t mask;                        // 크기 - 1
+    struct pool_array* retired;          // 이전 배열 목록
+    pool_task* volatile slots[1];        // 크기만큼 할당
+} pool_array;
+
+// Chase-Lev 덱: 소유 스레드만 bottom에서 넣고 빼며, 다른 스레드는 top에서 CAS로 훔침
+typedef struct {
+    volatile int64_t top;
+    volatile int64_t bottom;
+    pool_array* volatile array;
+} pool_deque;
+
+typedef struct {
+    platform_thread_pool_t* pool;
+    int index;
+    int pin_cpu;                         // 고정할 CPU (-1이면 고정하지 않음)
+    platform_thread_t* thread;
+} pool_worker;
+
+struct platform_thread_pool {
+    int count;                           // 작업 스레드 수
+    pool_worker* workers;
+    pool_deque* deques;                  // 작업 스레드마다 하나
+    
+    // 외부 스레드에서 제출한 작업 (FIFO, mutex 보호)
+    pool_task** injected;
+    size_t injected_head;
+    volatile int64_t injected_count;     // 잠금 없이도 원자적으로 읽어 비었는지 확인
+    size_t injected_capacity;
+    
+    volatile int64_t queued;             // 덱/주입 큐에 있는 작업 수 (잠든 스레드를 깨울지 판단)
+    volatile int64_t unfinished;         // 제출했지만 끝나지 않은 작업 수 (wait 조건)
+    volatile int64_t sleeping;           // 작업을 기다리며 잠든 스레드 수
+    volatile long cancelled;             // 취소 요청됨 (다음 wait에서 해제)
+    volatile long shutdown;              // 해제 중
+    
+#ifdef PLATFORM_WINDOWS
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE work_available;
+    CONDITION_VARIABLE all_done;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    pthread_cond_t all_done;
+#endif
+};
+
+static POOL_THREAD_LOCAL pool_worker* tls_pool_worker = NULL;
+
+// 덱 알고리즘에 필요한 순차 일관(seq_cst) 64비트 원자 연산
+static int64_t pool_load(volatile int64_t* value) {
+#ifdef PLATFORM_WINDOWS
+    return InterlockedCompareExchange64((volatile LONG64*)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static void pool_store(volatile int64_t* value, int64_t new_value) {
+#ifdef PLATFORM_WINDOWS
+    InterlockedExchange64((volatile LONG64*)value, new_value);
+#else
+    __atomic_store_n(value, new_value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static int pool_compare_exchange(volatile int64_t* value, int64_t expected, int64_t desired) {
+#ifdef PLATFORM_WINDOWS
+    return (InterlockedCompareExchange64((volatile LONG64*)value, desired, expected) == expected) ? 1 : 0;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1 : 0;
+#endif
+}
+
+static int64_t pool_fetch_add(volatile int64_t* value, int64_t delta) {
+#ifdef PLATFORM_WINDOWS
+    return InterlockedExchangeAdd64((volatile LONG64*)value, delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static void* pool_load_ptr(void* volatile* value) {
+#ifdef PLATFORM_WINDOWS
+    return InterlockedCompareExchangePointer(value, NULL, NULL);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static void pool_store_ptr(void* volatile* value, void* new_value) {
+#ifdef PLATFORM_WINDOWS
+    InterlockedExchangePointer(value, new_value);
+#else
+    __atomic_store_n(value, new_value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static void pool_lock(platform_thread_pool_t* pool) {
+#ifdef PLATFORM_WINDOWS
+    EnterCriticalSection(&pool->lock);
+#else
+    pthread_mutex_lock(&pool->lock);
+#endif
+}
+
+static void pool_unlock(platform_thread_pool_t* pool) {
+#ifdef PLATFORM_WINDOWS
+    LeaveCriticalSection(&pool->lock);
+#else
+    pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
+static pool_array* pool_array_create(int64_t capacity) {
+    pool_array* array = (pool_array*)calloc(1, sizeof(pool_array) + (size_t)(capacity - 1) * sizeof(pool_task*));
+    if (array) array->mask = capacity - 1;
+    return array;
+}
+
+// 소유 스레드: bottom에 작업 추가 (배열이 가득 차면 두 배 크기로 복사)
+static int pool_deque_push(pool_deque* deque, pool_task* task) {
+    int64_t bottom = pool_load(&deque->bottom);
+    int64_t top = pool_load(&deque->top);
+    pool_array* array = (pool_array*)pool_load_ptr((void* volatile*)&deque->array);
+    
+    if (bottom - top > array->mask) {
+        pool_array* grown = pool_array_create((array->mask + 1) * 2);
+        if (!grown) return 0;
+        for (int64_t i = top; i < bottom; i++) {
+            grown->slots[i & grown->mask] = array->slots[i & array->mask];
+        }
+        grown->retired = array;
+        pool_store_ptr((void* volatile*)&deque->array, grown);
+        array = grown;
+    }
+    pool_store_ptr((void* volatile*)&array->slots[bottom & array->mask], task);
+    pool_store(&deque->bottom, bottom + 1);
+    return 1;
+}
+
+// 소유 스레드: bottom에서 가장 최근 작업 꺼내기 (마지막 하나는 훔치는 스레드와 CAS로 경쟁)
+static pool_task* pool_deque_take(pool_deque* deque) {
+    int64_t bottom = pool_load(&deque->bottom) - 1;
+    pool_array* array = (pool_array*)pool_load_ptr((void* volatile*)&deque->array);
+    pool_store(&deque->bottom, bottom);
+    int64_t top = pool_load(&deque->top);
+    
+    if (top > bottom) {
+        pool_store(&deque->bottom, bottom + 1);
+        return NULL;
+    }
+    pool_task* task = (pool_task*)pool_load_ptr((void* volatile*)&array->slots[bottom & array->mask]);
+    if (top == bottom) {
+        if (!pool_compare_exchange(&deque->top, top, top + 1)) task = NULL;
+        pool_store(&deque->bottom, bottom + 1);
+    }
+    return task;
+}
+
+// 다른 스레드: top에서 가장 오래된 작업 훔치기 (경쟁에서 지면 NULL, 호출자가 다른 덱을 시도)
+static pool_task* pool_deque_steal(pool_deque* deque) {
+    int64_t top = pool_load(&deque->top);
+    int64_t bottom = pool_load(&deque->bottom);
+    if (top >= bottom) return NULL;
+    
+    pool_array* array = (pool_array*)pool_load_ptr((void* volatile*)&deque->array);
+    pool_task* task = (pool_task*)pool_load_ptr((void* volatile*)&array->slots[top & array->mask]);
+    if (!pool_compare_exchange(&deque->top, top, top + 1)) return NULL;
+    return task;
+}
+
+// 주입 큐에서 작업 하나 꺼내기 (mutex 보호)
+static pool_task* pool_take_injected(platform_thread_pool_t* pool) {
+    pool_task* task = NULL;
+    pool_lock(pool);
+    if (pool_load(&pool->injected_count) > 0) {
+        task = pool->injected[pool->injected_head];
+        pool->injected_head = (pool->injected_head + 1) % pool->injected_capacity;
+        pool_store(&pool->injected_count, pool->injected_count - 1);
+    }
+    pool_unlock(pool);
+    return task;
+}
+
+// 실행할 작업 찾기: 자기 덱 → 주입 큐 → 다른 덱 훔치기
+static pool_task* pool_find_task(platform_thread_pool_t* pool, int self) {
+    pool_task* task = pool_deque_take(&pool->deques[self]);
+    if (!task && pool_load(&pool->injected_count) > 0) task = pool_take_injected(pool);
+    for (int i = 1; !task && i < pool->count; i++) {
+        task = pool_deque_steal(&pool->deques[(self + i) % pool->count]);
+    }
+    if (task) pool_fetch_add(&pool->queued, -1);
+    return task;
+}
+
+// 작업 하나 끝남 (마지막이면 wait 중인 스레드를 깨움)
+static void pool_task_done(platform_thread_pool_t* pool, pool_task* task) {
+    free(task);
+    if (pool_fetch_add(&pool->unfinished, -1) == 1) {
+        pool_lock(pool);
+#ifdef PLATFORM_WINDOWS
+        WakeAllConditionVariable(&pool->all_done);
+#else
+        pthread_cond_broadcast(&pool->all_done);
+#endif
+        pool_unlock(pool);
+    }
+}
+
+static void pool_worker_main(void* arg) {
+    pool_worker* worker = (pool_worker*)arg;
+    platform_thread_pool_t* pool = worker->pool;
+    tls_pool_worker = worker;
+    if (worker->pin_cpu >= 0) platform_thread_pin_current(worker->pin_cpu);
+    
+    for (;;) {
+        pool_task* task = pool_find_task(pool, worker->index);
+        if (task) {
+            // 취소된 뒤 남은 작업은 실행하지 않고 완료 처리
+            if (!platform_atomic_load(&pool->cancelled)) task->func(task->arg);
+            pool_task_done(pool, task);
+            continue;
+        }
+        
+        // 작업이 없으면 잠듦 (sleeping을 먼저 올리고 queued를 확인하므로 깨우기 신호를 놓치지 않음)
+        pool_lock(pool);
+        pool_fetch_add(&pool->sleeping, 1);
+        while (pool_load(&pool->queued) <= 0 && !platform_atomic_load(&pool->shutdown)) {
+#ifdef PLATFORM_WINDOWS
+            SleepConditionVariableCS(&pool->work_available, &pool->lock, INFINITE);
+#else
+            pthread_cond_wait(&pool->work_available, &pool->lock);
+#endif
+        }
+        pool_fetch_add(&pool->sleeping, -1);
+        int stop = platform_atomic_load(&pool->shutdown) && pool_load(&pool->queued) <= 0;
+        pool_unlock(pool);
+        if (stop) break;
+    }
+    tls_pool_worker = NULL;
+}
+
+// Cross-platform thread affinity implementation
+int platform_thread_pin_current(int cpu) {
+    if (cpu < 0) return 0;
+    cpu %= platform_cpu_count();
+#ifdef PLATFORM_WINDOWS
+    if (cpu >= (int)(sizeof(DWORD_PTR) * 8)) return 0;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0 ? 1 : 0;
+#elif defined(PLATFORM_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) ? 1 : 0;
+#else
+    return 0;  // macOS는 스레드를 특정 코어에 고정하는 API가 없음 (스케줄러 힌트만 제공)
+#endif
+}
+
+// Cross-platform thread pool creation implementation
+platform_thread_pool_t* platform_thread_pool_create(int thread_count, int pin_threads) {
+    if (thread_count <= 0) thread_count = platform_cpu_count();
+    
+    platform_thread_pool_t* pool = (platform_thread_pool_t*)calloc(1, sizeof(platform_thread_pool_t));
+    if (!pool) return NULL;
+    pool->count = thread_count;
+    pool->workers = (pool_worker*)calloc((size_t)thread_count, sizeof(pool_worker));
+    pool->deques = (pool_deque*)calloc((size_t)thread_count, sizeof(pool_deque));
+    int ok = (pool->workers && pool->deques);
+    for (int i = 0; ok && i < thread_count; i++) {
+        pool->deques[i].array = pool_array_create(POOL_DEQUE_INITIAL_CAPACITY);
+        if (!pool->deques[i].array) ok = 0;
+    }
+    if (!ok) {
+        for (int i = 0; pool->deques && i < thread_count; i++) free(pool->deques[i].array);
+        free(pool->deques);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    
+#ifdef PLATFORM_WINDOWS
+    InitializeCriticalSection(&pool->lock);
+    InitializeConditionVariable(&pool->work_available);
+    InitializeConditionVariable(&pool->all_done);
+#else
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_available, NULL);
+    pthread_cond_init(&pool->all_done, NULL);
+#endif
+    
+    // 스레드 생성에 실패한 작업 스레드의 덱은 비어 있으므로 남은 스레드만으로 동작
+    int started = 0;
+    for (int i = 0; i < thread_count; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        pool->workers[i].pin_cpu = pin_threads ? i : -1;
+        pool->workers[i].thread = platform_thread_create(pool_worker_main, &pool->workers[i]);
+        if (pool->workers[i].thread) started++;
+    }
+    if (started == 0) {
+        platform_thread_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+// Cross-platform thread pool submit implementation
+int platform_thread_pool_submit(platform_thread_pool_t* pool, platform_task_func func, void* arg) {
+    if (!pool || !func || platform_atomic_load(&pool->cancelled) || platform_atomic_load(&pool->shutdown)) return 0;
+    
+    pool_task* task = (pool_task*)malloc(sizeof(pool_task));
+    if (!task) return 0;
+    task->func = func;
+    task->arg = arg;
+    pool_fetch_add(&pool->unfinished, 1);
+    
+    pool_worker* worker = tls_pool_worker;
+    int queued;
+    if (worker && worker->pool == pool) {
+        // 작업 안에서 제출: 자기 덱 (LIFO로 이어서 실행, 다른 스레드는 반대쪽에서 훔침)
+        queued = pool_deque_push(&pool->deques[worker->index], task);
+    } else {
+        // 외부 스레드에서 제출: 주입 큐 (FIFO)
+        pool_lock(pool);
+        queued = 1;
+        if ((size_t)pool->injected_count == pool->injected_capacity) {
+            size_t capacity = pool->injected_capacity ? pool->injected_capacity * 2 : POOL_DEQUE_INITIAL_CAPACITY;
+            pool_task** injected = (pool_task**)malloc(capacity * sizeof(pool_task*));
+            if (injected) {
+                for (size_t i = 0; i < (size_t)pool->injected_count; i++) {
+                    injected[i] = pool->injected[(pool->injected_head + i) % pool->injected_capacity];
+                }
+                free(pool->injected);
+                pool->injected = injected;
+                pool->injected_head = 0;
+                pool->injected_capacity = capacity;
+            } else {
+                queued = 0;
+            }
+        }
+        if (queued) {
+            pool->injected[(pool->injected_head + (size_t)pool->injected_count) % pool->injected_capacity] = task;
+            pool_store(&pool->injected_count, pool->injected_count + 1);
+        }
+        pool_unlock(pool);
+    }
+    if (!queued) {
+        free(task);
+        pool_fetch_add(&pool->unfinished, -1);
+        return 0;
+    }
+    
+    // queued를 먼저 올린 뒤 잠든 스레드가 있으면 깨움 (잠드는 쪽은 반대 순서로 확인)
+    pool_fetch_add(&pool->queued, 1);
+    if (pool_load(&pool->sleeping) > 0) {
+        pool_lock(pool);
+#ifdef PLATFORM_WINDOWS
+        WakeConditionVariable(&pool->work_available);
+#else
+        pthread_cond_signal(&pool->work_available);
+#endif
+        pool_unlock(pool);
+    }
+    return 1;
+}
+
+// Cross-platform thread pool wait implementation
+int platform_thread_pool_wait(platform_thread_pool_t* pool) {
+    if (!pool) return 0;
+    
+    pool_lock(pool);
+    while (pool_load(&pool->unfinished) > 0) {
+#ifdef PLATFORM_WINDOWS
+        SleepConditionVariableCS(&pool->all_done, &pool->lock, INFINITE);
+#else
+        pthread_cond_wait(&pool->all_done, &pool->lock);
+#endif
+    }
+    pool_unlock(pool);
+    
+    // 취소 상태 해제 (다음 작업부터 다시 제출 가능)
+    long cancelled = platform_atomic_load(&pool->cancelled);
+    platform_atomic_store(&pool->cancelled, 0);
+    return cancelled ? 0 : 1;
+}
+
+// Cross-platform thread pool cancel implementation
+void platform_thread_pool_cancel(platform_thread_pool_t* pool) {
+    if (!pool) return;
+    platform_atomic_store(&pool->cancelled, 1);
+    
+    // 잠든 스레드를 깨워 남은 작업을 실행 없이 완료 처리하게 함
+    pool_lock(pool);
+#ifdef PLATFORM_WINDOWS
+    WakeAllConditionVariable(&pool->work_available);
+#else
+    pthread_cond_broadcast(&pool->work_available);
+#endif
+    pool_unlock(pool);
+}
+
+int platform_thread_pool_cancelled(platform_thread_pool_t* pool) {
+    return (pool && platform_atomic_load(&pool->cancelled)) ? 1 : 0;
+}
+
+int platform_thread_pool_size(const platform_thread_pool_t* pool) {
+    return pool ? pool->count : 0;
+}
+
+int platform_thread_pool_worker_index(const platform_thread_pool_t* pool) {
+    pool_worker* worker = tls_pool_worker;
+    return (pool && worker && worker->pool == pool) ? worker->index : -1;
+}
+
+// Cross-platform thread pool destruction implementation
+void platform_thread_pool_destroy(platform_thread_pool_t* pool) {
+    if (!pool) return;
+    
+    platform_thread_pool_wait(pool);
+    
+    pool_lock(pool);
+    platform_atomic_store(&pool->shutdown, 1);
+#ifdef PLATFORM_WINDOWS
+    WakeAllConditionVariable(&pool->work_available);
+#else
+    pthread_cond_broadcast(&pool->work_available);
+#endif
+    pool_unlock(pool);
+    
+    for (int i = 0; i < pool->count; i++) {
+        platform_thread_join(pool->workers[i].thread);
+    }
+    
+    for (int i = 0; i < pool->count; i++) {
+        pool_array* array = pool->deques[i].array;
+        while (array) {
+            pool_array* retired = array->retired;
+            free(array);
+            array = retired;
+        }
+    }
+#ifdef PLATFORM_WINDOWS
+    DeleteCriticalSection(&pool->lock);
+#else
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_available);
+    pthread_cond_destroy(&pool->all_done);
+#endif
+    free(pool->injected);
+    free(pool->deques);
+    free(pool->workers);
+    free(pool);
+}
+
+// ========================================
+// 메모리 매핑 파일 I/O
+// ========================================
+
+// Cross-platform stream mapping implementation
+int platform_map_stream(FILE* stream, uint64_t size, int writable, platform_file_map_t* map) {
+    if (!stream || !map || size == 0) return 0;
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+    
+    // 32비트 빌드는 주소 공간보다 큰 파일을 매핑할 수 없음
+    if (size > (uint64_t)SIZE_MAX) return 0;
+    
+    // 쓰기 스트림은 stdio 버퍼에 남은 데이터를 먼저 파일에 반영 (매핑과 일관성 유지)
+    if (writable && fflush(stream) != 0) return 0;
+    
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(stream));
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    
+    // 쓰기 매핑은 CreateFileMapping이 파일을 size까지 늘림 (디스크 공간 확보)
+    HANDLE mapping = CreateFileMappingW(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFu), NULL);
+    if (mapping == NULL) return 0;
+    
+    void* view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)size);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        return 0;
+    }
+    map->handle = mapping;
+    map->data = (uint8_t*)view;
+#else
+    int fd = fileno(stream);
+    if (fd < 0) return 0;
+    
+    if (writable) {
+        // 출력 크기만큼 미리 할당 (매핑에 쓰는 도중 디스크 부족으로 SIGBUS가 나지 않도록)
+#if defined(PLATFORM_LINUX)
+        if (fallocate(fd, 0, 0, (off_t)size) != 0 && errno != EOPNOTSUPP) {
+            return 0;
+        }
+#elif defined(PLATFORM_MAC)
+        fstore_t store = { F_ALLOCATEALL, F_PEOFPOSMODE, 0, (off_t)size, 0 };
+        if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+            return 0;
+        }
+#endif
+        if (ftruncate(fd, (off_t)size) != 0) return 0;
+    }
+    
+    void* view = mmap(NULL, (size_t)size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) return 0;
+    
+    // 순차 접근 힌트: 미리 읽기를 늘리고 지나간 페이지는 빨리 회수
+    madvise(view, (size_t)size, MADV_SEQUENTIAL);
+#if defined(PLATFORM_LINUX)
+    posix_fadvise(fd, 0, (off_t)size, POSIX_FADV_SEQUENTIAL);
+#elif defined(PLATFORM_MAC)
+    fcntl(fd, F_RDAHEAD, 1);
+#endif
+    map->data = (uint8_t*)view;
+#endif
+    
+    map->size = (size_t)size;
+    return 1;
+}
+
+// Cross-platform unmap implementation
+void platform_unmap_stream(platform_file_map_t* map) {
+    if (!map || !map->data) return;
+    
+#ifdef PLATFORM_WINDOWS
+    UnmapViewOfFile(map->data);
+    CloseHandle((HANDLE)map->handle);
+#else
+    munmap(map->data, map->size);
+#endif
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+}
+
+// ========================================
+// 위치 지정 파일 I/O
+// ========================================
+
+// Cross-platform positional read implementation
+int64_t platform_pread(FILE* stream, void* buffer, size_t length, int64_t offset) {
+    if (!stream || (!buffer && length > 0) || offset < 0) return -1;
+    
+    uint8_t* dst = (uint8_t*)buffer;
+    size_t total = 0;
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(stream));
+    if (file == INVALID_HANDLE_VALUE) return -1;
+    
+    while (total < length) {
+        // OVERLAPPED의 오프셋으로 읽으면 다른 스레드의 읽기와 파일 포인터를 공유하지 않음
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        uint64_t pos = (uint64_t)offset + total;
+        ov.Offset = (DWORD)(pos & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(pos >> 32);
+        size_t want = length - total;
+        DWORD chunk = (want > 0x40000000u) ? 0x40000000u : (DWORD)want;
+        DWORD got = 0;
+        if (!ReadFile(file, dst + total, chunk, &got, &ov)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            return -1;
+        }
+        if (got == 0) break;  // EOF
+        total += got;
+    }
+#else
+    int fd = fileno(stream);
+    if (fd < 0) return -1;
+    
+    while (total < length) {
+        ssize_t got = pread(fd, dst + total, length - total, (off_t)(offset + (int64_t)total));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) break;  // EOF
+        total += (size_t)got;
+    }
+#endif
+    return (int64_t)total;
+}
+
+// Cross-platform positional write implementation
+int platform_pwrite(FILE* stream, const void* buffer, size_t length, int64_t offset) {
+    if (!stream || (!buffer && length > 0) || offset < 0) return 0;
+    
+    const uint8_t* src = (const uint8_t*)buffer;
+    size_t total = 0;
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(stream));
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    
+    while (total < length) {
+        OVERLAPPED ov;
+        memset(&ov, 0, sizeof(ov));
+        uint64_t pos = (uint64_t)offset + total;
+        ov.Offset = (DWORD)(pos & 0xFFFFFFFFu);
+        ov.OffsetHigh = (DWORD)(pos >> 32);
+        size_t want = length - total;
+        DWORD chunk = (want > 0x40000000u) ? 0x40000000u : (DWORD)want;
+        DWORD written = 0;
+        if (!WriteFile(file, src + total, chunk, &written, &ov) || written == 0) return 0;
+        total += written;
+    }
+#else
+    int fd = fileno(stream);
+    if (fd < 0) return 0;
+    
+    while (total < length) {
+        ssize_t written = pwrite(fd, src + total, length - total, (off_t)(offset + (int64_t)total));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        if (written == 0) return 0;
+        total += (size_t)written;
+    }
+#endif
+    return 1;
+}
+
+// ========================================
+// io_uring 스트리밍 엔진 (Linux 전용)
+// ========================================
+
+// O_DIRECT 정렬 단위 (오프셋, 길이, 버퍼 주소)
+#define URING_DIRECT_ALIGNMENT 4096
+
+#ifdef PLATFORM_HAS_IO_URING
+
+// 버퍼 상태
+enum {
+    URING_BUFFER_IDLE = 0,   // 비어 있음 (다음 읽기 가능)
+    URING_BUFFER_READING,    // 읽기 진행 중
+    URING_BUFFER_READY,      // 읽기 완료, 호출자 처리 대기
+    URING_BUFFER_WRITING     // 쓰기 진행 중
+};
+
+typedef struct {
+    uint8_t* data;
+    size_t length;       // 청크의 실제 데이터 길이
+    size_t io_length;    // 요청 길이 (O_DIRECT면 정렬 단위로 올림)
+    size_t done;         // 완료된 바이트 수 (짧은 읽기/쓰기 재요청용)
+    uint64_t chunk;      // 청크 번호
+    int state;
+    struct iovec iov;    // 버퍼 등록 실패 시 READV/WRITEV용
+} uring_buffer_t;
+
+struct platform_uring_stream {
+    int ring_fd;
+    
+    // 제출 큐 (SQ)
+    void* sq_ring;
+    size_t sq_ring_size;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned to_submit;
+    
+    // 완료 큐 (CQ)
+    void* cq_ring;
+    size_t cq_ring_size;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    
+    int in_fd;
+    int out_fd;
+    int in_flags;        // 원래 파일 상태 플래그 (O_DIRECT 해제 시 복원)
+    int out_flags;
+    int direct;
+    int fixed_buffers;   // 등록 버퍼 사용 여부 (READ_FIXED/WRITE_FIXED)
+    
+    uint64_t in_offset;
+    uint64_t out_offset;
+    uint64_t length;
+    size_t chunk_size;
+    unsigned int depth;
+    uint64_t chunk_count;
+    uint64_t next_read;      // 다음에 읽기를 요청할 청크
+    uint64_t next_consume;   // 다음에 호출자에게 넘길 청크
+    uring_buffer_t* buffers;
+    int failed;
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int uring_register(int ring_fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+// 버퍼의 남은 구간에 대한 읽기/쓰기를 제출 큐에 넣습니다 (제출은 uring_flush에서).
+static void uring_queue_io(platform_uring_stream_t* stream, unsigned index, int is_write) {
+    uring_buffer_t* buffer = &stream->buffers[index];
+    unsigned tail = *stream->sq_tail;
+    unsigned slot = tail & *stream->sq_mask;
+    struct io_uring_sqe* sqe = &stream->sqes[slot];
+    
+    uint64_t base = is_write ? stream->out_offset : stream->in_offset;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = is_write ? stream->out_fd : stream->in_fd;
+    sqe->off = base + buffer->chunk * stream->chunk_size + buffer->done;
+    sqe->user_data = index;
+    
+    if (stream->fixed_buffers) {
+        sqe->opcode = is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->addr = (uint64_t)(uintptr_t)(buffer->data + buffer->done);
+        sqe->len = (unsigned)(buffer->io_length - buffer->done);
+        sqe->buf_index = (uint16_t)index;
+    } else {
+        buffer->iov.iov_base = buffer->data + buffer->done;
+        buffer->iov.iov_len = buffer->io_length - buffer->done;
+        sqe->opcode = is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->addr = (uint64_t)(uintptr_t)&buffer->iov;
+        sqe->len = 1;
+    }
+    
+    stream->sq_array[slot] = slot;
+    __atomic_store_n(stream->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    stream->to_submit++;
+}
+
+// 빈 버퍼가 있는 동안 다음 청크 읽기를 요청합니다.
+static void uring_issue_reads(platform_uring_stream_t* stream) {
+    while (stream->next_read < stream->chunk_count) {
+        unsigned index = (unsigned)(stream->next_read % stream->depth);
+        uring_buffer_t* buffer = &stream->buffers[index];
+        if (buffer->state != URING_BUFFER_IDLE) break;
+        
+        uint64_t start = stream->next_read * stream->chunk_size;
+        uint64_t remaining = stream->length - start;
+        buffer->chunk = stream->next_read;
+        buffer->length = (remaining < stream->chunk_size) ? (size_t)remaining : stream->chunk_size;
+        buffer->io_length = stream->direct ?
+            (buffer->length + URING_DIRECT_ALIGNMENT - 1) / URING_DIRECT_ALIGNMENT * URING_DIRECT_ALIGNMENT :
+            buffer->length;
+        buffer->done = 0;
+        buffer->state = URING_BUFFER_READING;
+        uring_queue_io(stream, index, 0);
+        stream->next_read++;
+    }
+}
+
+// 완료된 요청을 처리합니다 (짧은 읽기/쓰기는 남은 구간을 다시 요청).
+static void uring_reap(platform_uring_stream_t* stream) {
+    unsigned head = *stream->cq_head;
+    while (head != __atomic_load_n(stream->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe* cqe = &stream->cqes[head & *stream->cq_mask];
+        unsigned index = (unsigned)cqe->user_data;
+        int res = cqe->res;
+        head++;
+        
+        if (index >= stream->depth) continue;
+        uring_buffer_t* buffer = &stream->buffers[index];
+        int is_write = (buffer->state == URING_BUFFER_WRITING);
+        
+        if (res == -EAGAIN || res == -EINTR) {
+            uring_queue_io(stream, index, is_write);
+            continue;
+        }
+        if (res < 0) {
+            stream->failed = 1;
+            buffer->state = URING_BUFFER_IDLE;
+            continue;
+        }
+        
+        buffer->done += (size_t)res;
+        if (!is_write) {
+            if (buffer->done >= buffer->length) {
+                buffer->state = URING_BUFFER_READY;
+            } else if (res == 0 || (stream->direct && buffer->done % URING_DIRECT_ALIGNMENT != 0)) {
+                stream->failed = 1;  // 예상보다 짧은 파일
+                buffer->state = URING_BUFFER_IDLE;
+            } else {
+                uring_queue_io(stream, index, 0);
+            }
+        } else {
+            if (buffer->done >= buffer->io_length) {
+                buffer->state = URING_BUFFER_IDLE;
+            } else if (res == 0) {
+                stream->failed = 1;
+                buffer->state = URING_BUFFER_IDLE;
+            } else {
+                uring_queue_io(stream, index, 1);
+            }
+        }
+    }
+    __atomic_store_n(stream->cq_head, head, __ATOMIC_RELEASE);
+}
+
+// 쌓인 요청을 제출하고, wait이면 완료가 하나 이상 올 때까지 기다립니다.
+static int uring_flush(platform_uring_stream_t* stream, int wait) {
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    if (stream->to_submit == 0 && !wait) return 1;
+    
+    int ret = uring_enter(stream->ring_fd, stream->to_submit, wait ? 1 : 0, flags);
+    if (ret < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) return 1;
+        stream->failed = 1;
+        return 0;
+    }
+    stream->to_submit -= ((unsigned)ret < stream->to_submit) ? (unsigned)ret : stream->to_submit;
+    return 1;
+}
+
+// 진행 중인 요청 수
+static unsigned uring_inflight(const platform_uring_stream_t* stream) {
+    unsigned count = 0;
+    for (unsigned i = 0; i < stream->depth; i++) {
+        int state = stream->buffers[i].state;
+        if (state == URING_BUFFER_READING || state == URING_BUFFER_WRITING) count++;
+    }
+    return count;
+}
+
+// O_DIRECT 설정/해제 (실패 시 0)
+static int uring_set_direct(int fd, int original_flags, int enable) {
+    int flags = enable ? (original_flags | O_DIRECT) : original_flags;
+    return (fcntl(fd, F_SETFL, flags) == 0) ? 1 : 0;
+}
+
+static void uring_destroy(platform_uring_stream_t* stream) {
+    if (stream->sqes) munmap(stream->sqes, stream->sqes_size);
+    if (stream->cq_ring && stream->cq_ring != stream->sq_ring) munmap(stream->cq_ring, stream->cq_ring_size);
+    if (stream->sq_ring) munmap(stream->sq_ring, stream->sq_ring_size);
+    if (stream->ring_fd >= 0) close(stream->ring_fd);
+    if (stream->buffers) {
+        for (unsigned i = 0; i < stream->depth; i++) free(stream->buffers[i].data);
+        free(stream->buffers);
+    }
+    free(stream);
+}
+
+// io_uring stream open implementation
+platform_uring_stream_t* platform_uring_stream_open(const platform_uring_config_t* config) {
+    if (!config || !config->in || config->chunk_size == 0 || config->depth == 0) return NULL;
+    if (config->chunk_size % URING_DIRECT_ALIGNMENT != 0) return NULL;
+    if (config->in_offset < 0 || config->out_offset < 0 || config->length <= 0) return NULL;
+    if (config->out && fflush(config->out) != 0) return NULL;
+    
+    platform_uring_stream_t* stream = (platform_uring_stream_t*)calloc(1, sizeof(platform_uring_stream_t));
+    if (!stream) return NULL;
+    stream->ring_fd = -1;
+    stream->in_fd = fileno(config->in);
+    stream->out_fd = config->out ? fileno(config->out) : -1;
+    stream->in_offset = (uint64_t)config->in_offset;
+    stream->out_offset = (uint64_t)config->out_offset;
+    stream->length = (uint64_t)config->length;
+    stream->chunk_size = config->chunk_size;
+    stream->depth = config->depth;
+    stream->chunk_count = (stream->length + stream->chunk_size - 1) / stream->chunk_size;
+    
+    // 링 생성 (커널 미지원/권한 없음이면 여기서 실패 → 호출자가 stdio로 처리)
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    stream->ring_fd = uring_setup(config->depth, &params);
+    if (stream->ring_fd < 0) {
+        stream->ring_fd = -1;
+        uring_destroy(stream);
+        return NULL;
+    }
+    
+    stream->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    stream->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (stream->cq_ring_size > stream->sq_ring_size) stream->sq_ring_size = stream->cq_ring_size;
+        stream->cq_ring_size = stream->sq_ring_size;
+    }
+    stream->sq_ring = mmap(NULL, stream->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           stream->ring_fd, IORING_OFF_SQ_RING);
+    if (stream->sq_ring == MAP_FAILED) {
+        stream->sq_ring = NULL;
+        uring_destroy(stream);
+        return NULL;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        stream->cq_ring = stream->sq_ring;
+    } else {
+        stream->cq_ring = mmap(NULL, stream->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               stream->ring_fd, IORING_OFF_CQ_RING);
+        if (stream->cq_ring == MAP_FAILED) {
+            stream->cq_ring = NULL;
+            uring_destroy(stream);
+            return NULL;
+        }
+    }
+    stream->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    stream->sqes = (struct io_uring_sqe*)mmap(NULL, stream->sqes_size, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, stream->ring_fd, IORING_OFF_SQES);
+    if (stream->sqes == MAP_FAILED) {
+        stream->sqes = NULL;
+        uring_destroy(stream);
+        return NULL;
+    }
+    
+    uint8_t* sq = (uint8_t*)stream->sq_ring;
+    uint8_t* cq = (uint8_t*)stream->cq_ring;
+    stream->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    stream->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    stream->sq_array = (unsigned*)(sq + params.sq_off.array);
+    stream->cq_head = (unsigned*)(cq + params.cq_off.head);
+    stream->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    stream->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    stream->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    
+    // 정렬된 버퍼 할당 (O_DIRECT 요구 사항) 후 커널에 등록
+    stream->buffers = (uring_buffer_t*)calloc(config->depth, sizeof(uring_buffer_t));
+    struct iovec* iovecs = (struct iovec*)calloc(config->depth, sizeof(struct iovec));
+    if (!stream->buffers || !iovecs) {
+        free(iovecs);
+        uring_destroy(stream);
+        return NULL;
+    }
+    for (unsigned i = 0; i < config->depth; i++) {
+        void* data = NULL;
+        if (posix_memalign(&data, URING_DIRECT_ALIGNMENT, config->chunk_size) != 0) {
+            free(iovecs);
+            uring_destroy(stream);
+            return NULL;
+        }
+        stream->buffers[i].data = (uint8_t*)data;
+        iovecs[i].iov_base = data;
+        iovecs[i].iov_len = config->chunk_size;
+    }
+    // 등록 실패(잠금 메모리 한도 등) 시 READV/WRITEV로 계속 진행
+    stream->fixed_buffers = (uring_register(stream->ring_fd, IORING_REGISTER_BUFFERS, iovecs, config->depth) == 0);
+    free(iovecs);
+    
+    // O_DIRECT: 모든 오프셋이 정렬되어 있고 파일시스템이 지원할 때만 (아니면 페이지 캐시 경유)
+    stream->in_flags = fcntl(stream->in_fd, F_GETFL);
+    stream->out_flags = (stream->out_fd >= 0) ? fcntl(stream->out_fd, F_GETFL) : 0;
+    if (config->direct &&
+        stream->in_offset % URING_DIRECT_ALIGNMENT == 0 && stream->out_offset % URING_DIRECT_ALIGNMENT == 0 &&
+        stream->in_flags != -1 && stream->out_flags != -1) {
+        if (uring_set_direct(stream->in_fd, stream->in_flags, 1)) {
+            if (stream->out_fd < 0 || uring_set_direct(stream->out_fd, stream->out_flags, 1)) {
+                stream->direct = 1;
+            } else {
+                uring_set_direct(stream->in_fd, stream->in_flags, 0);
+            }
+        }
+    }
+    
+    uring_issue_reads(stream);
+    uring_flush(stream, 0);
+    return stream;
+}
+
+// io_uring stream next chunk implementation
+int platform_uring_stream_next(platform_uring_stream_t* stream, uint8_t** data, size_t* length) {
+    if (!stream || !data || !length) return -1;
+    if (stream->failed) return -1;
+    if (stream->next_consume >= stream->chunk_count) return 0;
+    
+    uring_buffer_t* buffer = &stream->buffers[stream->next_consume % stream->depth];
+    while (buffer->state != URING_BUFFER_READY || buffer->chunk != stream->next_consume) {
+        if (!uring_flush(stream, 1)) return -1;
+        uring_reap(stream);
+        uring_issue_reads(stream);
+        if (stream->failed) return -1;
+        if (uring_inflight(stream) == 0 && buffer->state != URING_BUFFER_READY) {
+            stream->failed = 1;  // 기다릴 요청이 없음 (내부 상태 오류)
+            return -1;
+        }
+    }
+    
+    *data = buffer->data;
+    *length = buffer->length;
+    return 1;
+}
+
+// io_uring stream commit implementation
+int platform_uring_stream_commit(platform_uring_stream_t* stream) {
+    if (!stream || stream->failed || stream->next_consume >= stream->chunk_count) return 0;
+    
+    unsigned index = (unsigned)(stream->next_consume % stream->depth);
+    uring_buffer_t* buffer = &stream->buffers[index];
+    if (buffer->state != URING_BUFFER_READY) return 0;
+    
+    if (stream->out_fd >= 0) {
+        // O_DIRECT 마지막 청크: 정렬 단위까지 0으로 채워 쓰고 닫을 때 파일 길이를 잘라냄
+        if (buffer->io_length > buffer->length) {
+            memset(buffer->data + buffer->length, 0, buffer->io_length - buffer->length);
+        }
+        buffer->done = 0;
+        buffer->state = URING_BUFFER_WRITING;
+        uring_queue_io(stream, index, 1);
+    } else {
+        buffer->state = URING_BUFFER_IDLE;
+    }
+    stream->next_consume++;
+    
+    uring_reap(stream);
+    uring_issue_reads(stream);
+    return uring_flush(stream, 0);
+}
+
+// io_uring stream close implementation
+int platform_uring_stream_close(platform_uring_stream_t* stream) {
+    if (!stream) return 0;
+    
+    // 남은 쓰기 완료 대기
+    while (uring_inflight(stream) > 0) {
+        if (!uring_flush(stream, 1)) break;
+        uring_reap(stream);
+    }
+    
+    int ok = !stream->failed && stream->next_consume == stream->chunk_count;
+    
+    if (stream->direct) {
+        uring_set_direct(stream->in_fd, stream->in_flags, 0);
+        if (stream->out_fd >= 0) {
+            uring_set_direct(stream->out_fd, stream->out_flags, 0);
+            // 정렬 단위로 올려 쓴 마지막 청크의 여분 제거
+            if (ok && ftruncate(stream->out_fd, (off_t)(stream->out_offset + stream->length)) != 0) ok = 0;
+        }
+    }
+    
+    uring_destroy(stream);
+    return ok;
+}
+
+#else
+
+// io_uring을 지원하지 않는 플랫폼: 항상 NULL (호출자가 stdio로 처리)
+platform_uring_stream_t* platform_uring_stream_open(const platform_uring_config_t* config) {
+    (void)config;
+    return NULL;
+}
+
+int platform_uring_stream_next(platform_uring_stream_t* stream, uint8_t** data, size_t* length) {
+    (void)stream;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+int platform_uring_stream_commit(platform_uring_stream_t* stream) {
+    (void)stream;
+    return 0;
+}
+
+int platform_uring_stream_close(platform_uring_stream_t* stream) {
+    (void)stream;
+    return 0;
+}
+
+#endif
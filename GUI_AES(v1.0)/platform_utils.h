@@ -31,6 +31,16 @@ int platform_path_to_utf8(const char* input_path, char* output_path, size_t outp
 // temp_path will contain the path to the temporary file (can be NULL if path is not needed)
 FILE* platform_create_temp_file(char* temp_path, size_t temp_path_size);
 
+// Cross-platform temporary file creation in the directory of target_path
+// Used to stage output next to its final location so it can be published with
+// platform_rename_file (same filesystem, no copy). Returns FILE* on success, NULL on failure.
+// temp_path will contain the path to the staged file
+FILE* platform_create_temp_file_near(const char* target_path, char* temp_path, size_t temp_path_size);
+
+// Cross-platform atomic rename (replaces dst_path if it exists)
+// Returns 1 on success, 0 on failure (e.g. src and dst on different filesystems)
+int platform_rename_file(const char* src_path, const char* dst_path);
+
 // Cross-platform file deletion
 // Returns 1 on success, 0 on failure
 int platform_delete_file(const char* file_path);
@@ -47,6 +57,139 @@ int platform_directory_exists(const char* dir_path);
 // Returns 1 if file exists, 0 if not
 int platform_file_exists(const char* file_path);
 
+// Recursively walk the regular files under dir_path (symbolic links and reparse points are not followed)
+// callback gets each file path (dir_path + separator + relative path); returning 0 stops the walk
+// Returns 1 if every entry was visited, 0 if a directory could not be read or the callback stopped the walk
+typedef int (*platform_walk_callback)(const char* file_path, void* user_data);
+int platform_walk_directory(const char* dir_path, platform_walk_callback callback, void* user_data);
+
+// Switch a standard stream (stdin/stdout) to binary mode
+// Windows translates CR/LF on text-mode streams; POSIX streams are always binary (no-op)
+// Returns 1 on success, 0 on failure
+int platform_set_binary_mode(FILE* stream);
+
+// Open a stdio stream on an inherited file descriptor (fdopen; _fdopen on Windows)
+// Closing the stream also closes the descriptor. Returns NULL on failure.
+FILE* platform_fdopen(int fd, const char* mode);
+
+// Cross-platform 64-bit stream positioning (files larger than 2 GiB on LLP64 and 32-bit builds)
+// platform_fseek64 returns 0 on success like fseek; platform_ftell64 returns -1 on failure like ftell
+int platform_fseek64(FILE* stream, int64_t offset, int whence);
+int64_t platform_ftell64(FILE* stream);
+
+// Truncate (or extend with zeros) an open read/write stream to size bytes, flushing pending output first
+// Returns 1 on success, 0 on failure
+int platform_truncate_stream(FILE* stream, int64_t size);
+
+// Flush pending output and ask the OS to write the file to stable storage (fsync; _commit on Windows)
+// Returns 1 on success, 0 on failure
+int platform_sync_stream(FILE* stream);
+
+// Cross-platform threads (minimal create/join for pipelined file processing)
+// platform_thread_create returns NULL on failure; platform_thread_join waits and releases the handle
+typedef struct platform_thread platform_thread_t;
+typedef void (*platform_thread_func)(void* arg);
+platform_thread_t* platform_thread_create(platform_thread_func func, void* arg);
+void platform_thread_join(platform_thread_t* thread);
+void platform_thread_yield(void);
+void platform_sleep_ms(unsigned int ms);
+
+// Cross-platform mutex / condition variable (heap handles like platform_thread_t)
+// *_create returns NULL on failure; platform_cond_wait may wake spuriously, so callers loop on a condition
+typedef struct platform_mutex platform_mutex_t;
+typedef struct platform_cond platform_cond_t;
+platform_mutex_t* platform_mutex_create(void);
+void platform_mutex_destroy(platform_mutex_t* mutex);
+void platform_mutex_lock(platform_mutex_t* mutex);
+void platform_mutex_unlock(platform_mutex_t* mutex);
+platform_cond_t* platform_cond_create(void);
+void platform_cond_destroy(platform_cond_t* cond);
+void platform_cond_wait(platform_cond_t* cond, platform_mutex_t* mutex);
+void platform_cond_broadcast(platform_cond_t* cond);
+
+// Number of online logical CPUs (at least 1)
+int platform_cpu_count(void);
+
+// Cross-platform atomic operations on long (load = acquire, store = release)
+// platform_atomic_compare_exchange returns 1 if *value was expected and is now desired, 0 otherwise
+// platform_atomic_fetch_add returns the value before the addition
+long platform_atomic_load(volatile long* value);
+void platform_atomic_store(volatile long* value, long new_value);
+int platform_atomic_compare_exchange(volatile long* value, long expected, long desired);
+long platform_atomic_fetch_add(volatile long* value, long delta);
+
+// Pins the calling thread to one logical CPU (cpu is taken modulo the CPU count).
+// Returns 1 on success, 0 if unsupported (macOS) or refused.
+int platform_thread_pin_current(int cpu);
+
+// Cross-platform thread pool with per-worker Chase-Lev work-stealing deques
+// thread_count <= 0 uses platform_cpu_count(); pin_threads pins worker i to CPU i.
+// Tasks submitted from inside a task go to the worker's own deque (run LIFO, stolen FIFO by
+// idle workers); tasks submitted from other threads go to a shared FIFO injection queue.
+// platform_thread_pool_submit returns 0 if the pool is cancelled or out of memory (task not queued).
+// platform_thread_pool_wait blocks until every submitted task has finished or been dropped;
+// it must not be called from inside a task. Returns 0 if the pool was cancelled since the last
+// wait (the cancel flag is cleared so the pool can be reused), 1 otherwise.
+// platform_thread_pool_cancel drops queued tasks without running them; running tasks finish.
+// platform_thread_pool_worker_index returns 0..size-1 on a worker of this pool, -1 elsewhere.
+typedef struct platform_thread_pool platform_thread_pool_t;
+typedef void (*platform_task_func)(void* arg);
+platform_thread_pool_t* platform_thread_pool_create(int thread_count, int pin_threads);
+int platform_thread_pool_submit(platform_thread_pool_t* pool, platform_task_func func, void* arg);
+int platform_thread_pool_wait(platform_thread_pool_t* pool);
+void platform_thread_pool_cancel(platform_thread_pool_t* pool);
+int platform_thread_pool_cancelled(platform_thread_pool_t* pool);
+int platform_thread_pool_size(const platform_thread_pool_t* pool);
+int platform_thread_pool_worker_index(const platform_thread_pool_t* pool);
+void platform_thread_pool_destroy(platform_thread_pool_t* pool);
+
+// Cross-platform memory-mapped file I/O
+// Maps [0, size) of an open stream. Read maps need the stream opened for
+// reading; writable maps need read/write ("w+b", "r+b"), flush pending stdio output and
+// resize/preallocate the file to size.
+// Returns 1 on success, 0 on failure, including sizes beyond the address space on
+// 32-bit builds (caller falls back to fread/fwrite).
+typedef struct {
+    uint8_t* data;   // 파일 오프셋 0에 해당하는 주소
+    size_t size;     // 매핑 크기
+    void* handle;    // Windows 매핑 객체 (내부용)
+} platform_file_map_t;
+int platform_map_stream(FILE* stream, uint64_t size, int writable, platform_file_map_t* map);
+void platform_unmap_stream(platform_file_map_t* map);
+
+// Cross-platform positional I/O (pread/pwrite; ReadFile/WriteFile with an explicit offset on Windows)
+// Does not use or move the stdio position, so several threads can share one stream.
+// Flush pending stdio output before mixing with fwrite on the same stream.
+// platform_pread returns the bytes read (short only at EOF) or -1; platform_pwrite returns 1 on success, 0 on failure
+int64_t platform_pread(FILE* stream, void* buffer, size_t length, int64_t offset);
+int platform_pwrite(FILE* stream, const void* buffer, size_t length, int64_t offset);
+
+// Asynchronous streaming I/O engine (Linux io_uring; other platforms always fail to open)
+// Keeps up to depth chunk reads/writes in flight on registered, 4 KiB-aligned buffers.
+// Chunk k is read from in_offset + k * chunk_size, handed to the caller by
+// platform_uring_stream_next (transform in place), and written back to out_offset + k * chunk_size
+// by platform_uring_stream_commit (or just released when out is NULL).
+// With direct = 1, O_DIRECT is used when both offsets are 4 KiB aligned and the filesystem allows it.
+typedef struct platform_uring_stream platform_uring_stream_t;
+typedef struct {
+    FILE* in;             // 입력 스트림
+    int64_t in_offset;    // 입력 시작 오프셋
+    int64_t length;       // 처리할 바이트 수
+    FILE* out;            // 출력 스트림 (NULL이면 읽기만)
+    int64_t out_offset;   // 출력 시작 오프셋
+    size_t chunk_size;    // 버퍼 하나의 크기 (4 KiB 배수)
+    unsigned int depth;   // 동시에 진행할 버퍼 수
+    int direct;           // 1이면 O_DIRECT 시도
+} platform_uring_config_t;
+// Returns NULL if io_uring is unavailable (caller falls back to stdio)
+platform_uring_stream_t* platform_uring_stream_open(const platform_uring_config_t* config);
+// Returns 1 with the next chunk, 0 at end of stream, -1 on I/O error
+int platform_uring_stream_next(platform_uring_stream_t* stream, uint8_t** data, size_t* length);
+// Returns 1 on success, 0 on failure
+int platform_uring_stream_commit(platform_uring_stream_t* stream);
+// Waits for outstanding writes and releases the engine. Returns 1 if every chunk was read and written
+int platform_uring_stream_close(platform_uring_stream_t* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -593,6 +593,28 @@ CRYPTO_STATUS AES_CTR_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length
     return CRYPTO_SUCCESS;
 }
 
+/**
+ * @brief AES_CTR_seek: 카운터를 지정한 블록 수만큼 앞으로 옮깁니다.
+ * * 키스트림 블록 i는 카운터 (시작값 + i)를 암호화한 값이므로, 앞부분을 처리하지 않고도
+ * 임의의 16바이트 경계에서 암복호화를 시작할 수 있습니다 (부분 복호화, 병렬 처리).
+ * * @param nonce_counter 16바이트 Nonce+Counter 블록 (제자리에서 갱신)
+ * @param blocks 건너뛸 블록 수 (바이트 오프셋 / 16)
+ * @return 성공 시 CRYPTO_SUCCESS
+ */
+CRYPTO_STATUS AES_CTR_seek(uint8_t nonce_counter[AES_BLOCK_SIZE], uint64_t blocks) {
+    if (!nonce_counter) return CRYPTO_ERR_INVALID_INPUT;
+    
+    // 128비트 big-endian 덧셈 (AES_CTR_crypt의 블록마다 1 증가와 같은 자리올림)
+    unsigned carry = 0;
+    for (int i = AES_BLOCK_SIZE - 1; i >= 0; i--) {
+        unsigned sum = (unsigned)nonce_counter[i] + (unsigned)(blocks & 0xFF) + carry;
+        nonce_counter[i] = (uint8_t)sum;
+        carry = sum >> 8;
+        blocks >>= 8;
+    }
+    return CRYPTO_SUCCESS;
+}
+
 #ifdef PLATFORM_MAC
 // OpenSSL 동적 로딩 관련 전역 변수
 static void* g_openssl_handle = NULL;
@@ -632,14 +654,14 @@ static int load_openssl_mac(void) {
             dlclose(g_openssl_handle);
             g_openssl_handle = NULL;
 #ifndef NDEBUG
-            printf("[DEBUG] RAND_bytes not found in: %s\n", openssl_paths[i]);
+            fprintf(stderr, "[DEBUG] RAND_bytes not found in: %s\n", openssl_paths[i]);
 #endif
         } else {
             // dlopen 실패 시 에러 메시지 출력 (디버깅용)
 #ifndef NDEBUG
             const char* error = dlerror();
             if (error) {
-                printf("[DEBUG] Failed to load %s: %s\n", openssl_paths[i], error);
+                fprintf(stderr, "[DEBUG] Failed to load %s: %s\n", openssl_paths[i], error);
             }
 #endif
         }
@@ -0,0 +1,49 @@
+#include <stdint.h>
+#include <string.h>
+#include "aes.h"
+#include "aes_ctr_hmac.h"
+
+/**
+ * @brief AES_CTR_HMAC_crypt: AES-CTR과 HMAC-SHA512 업데이트를 타일 단위로 묶어 한 번에 수행합니다.
+ * * 청크 전체를 HMAC으로 한 번, CTR로 또 한 번 훑으면 1MB 청크가 L2 캐시를 넘어
+ * 데이터가 메모리에서 두 번 올라옵니다. 이 함수는 청크를 L1 크기 타일로 나누어
+ * 각 타일이 캐시에 있는 동안 HMAC과 키스트림 XOR를 모두 적용합니다.
+ * * 타일 크기가 AES 블록(16바이트)의 배수이므로 카운터는 한 번에 처리한 것과 같게 증가합니다.
+ * @param ctx 초기화된 AES 컨텍스트
+ * @param in 입력 데이터 (평문 또는 암호문)
+ * @param length 입력 데이터의 길이 (바이트)
+ * @param out 출력 데이터가 저장될 버퍼 (in과 같아도 됨)
+ * @param nonce_counter 16바이트 Nonce+Counter 블록 (처리한 블록 수만큼 증가)
+ * @param hmac_ctx 초기화된 HMAC 컨텍스트
+ * @param order AES_CTR_HMAC_MAC_INPUT (입력에 HMAC) 또는 AES_CTR_HMAC_MAC_OUTPUT (출력에 HMAC)
+ * @return 성공 시 CRYPTO_SUCCESS
+ */
+CRYPTO_STATUS AES_CTR_HMAC_crypt(const AES_CTX* ctx, const uint8_t* in, size_t length, uint8_t* out,
+	uint8_t nonce_counter[AES_BLOCK_SIZE], HMAC_SHA512_CTX* hmac_ctx, AES_CTR_HMAC_ORDER order) {
+	if (!ctx) return CRYPTO_ERR_NULL_CONTEXT;
+	if (!hmac_ctx || !nonce_counter) return CRYPTO_ERR_INVALID_INPUT;
+	if ((!in || !out) && length > 0) return CRYPTO_ERR_INVALID_INPUT;
+	if (!hmac_ctx->initialized) return CRYPTO_ERR_NOT_INITIALIZED;
+	if (order != AES_CTR_HMAC_MAC_INPUT && order != AES_CTR_HMAC_MAC_OUTPUT) return CRYPTO_ERR_INVALID_ARGUMENT;
+
+	size_t offset = 0;
+	while (offset < length) {
+		size_t tile_len = (length - offset < AES_CTR_HMAC_TILE_SIZE) ? (length - offset) : AES_CTR_HMAC_TILE_SIZE;
+
+		// 입력 타일에 HMAC (CTR 전에 읽어 두어야 in == out일 때도 원래 입력이 반영됨)
+		if (order == AES_CTR_HMAC_MAC_INPUT) {
+			hmac_sha512_update(hmac_ctx, in + offset, tile_len);
+		}
+
+		CRYPTO_STATUS status = AES_CTR_crypt(ctx, in + offset, tile_len, out + offset, nonce_counter);
+		if (status != CRYPTO_SUCCESS) return status;
+
+		// 방금 쓴 출력 타일에 HMAC (아직 L1에 있음)
+		if (order == AES_CTR_HMAC_MAC_OUTPUT) {
+			hmac_sha512_update(hmac_ctx, out + offset, tile_len);
+		}
+
+		offset += tile_len;
+	}
+	return CRYPTO_SUCCESS;
+}
@@ -0,0 +1,314 @@
+#include "crypto_engine.h"
+#include "crypto_api.h"
+#include "platform_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 작업 종류
+typedef enum {
+    ENGINE_JOB_ENCRYPT = 0,
+    ENGINE_JOB_DECRYPT
+} ENGINE_JOB_KIND;
+
+struct crypto_engine {
+    platform_thread_pool_t* pool;
+    platform_mutex_t* lock;              // 작업 상태/진행률/카운터 보호
+    platform_cond_t* changed;            // 작업이 끝날 때마다 알림 (배압 대기, wait 대기)
+    int max_in_flight;                   // 끝나지 않은 작업 수 한도
+    int in_flight;                       // 제출했지만 끝나지 않은 작업 수 (lock 보호)
+    int refs;                            // 엔진 소유자 1 + 놓지 않은 작업 수 (0이 되면 해제, lock 보호)
+};
+
+struct crypto_job {
+    crypto_engine_t* engine;
+    ENGINE_JOB_KIND kind;
+    int aes_key_bits;
+    char* password;                      // 작업이 끝나면 지우고 해제
+    char input_path[MAX_PATH_LENGTH];
+    char output_path[MAX_PATH_LENGTH];
+    char final_path[MAX_PATH_LENGTH];    // 복호화 결과 경로 또는 실패 메시지
+    crypto_job_callback_t on_done;
+    void* user_data;
+    CRYPTO_JOB_STATE state;              // lock 보호
+    int64_t processed;                   // lock 보호
+    int64_t total;                       // lock 보호
+    int cancel_requested;                // lock 보호
+    int finished;                        // 완료 콜백까지 끝남 (lock 보호)
+    int refs;                            // 사용자 핸들 1 + 실행 중 1 (lock 보호)
+};
+
+/**
+ * @brief 엔진 참조를 놓고 마지막이면 해제합니다 (lock을 잡은 상태에서 호출, 해제 시 lock도 정리).
+ * @param engine 엔진
+ */
+static void engine_unref_locked(crypto_engine_t* engine) {
+    engine->refs--;
+    int last = (engine->refs == 0);
+    platform_mutex_unlock(engine->lock);
+    if (last) {
+        platform_cond_destroy(engine->changed);
+        platform_mutex_destroy(engine->lock);
+        free(engine);
+    }
+}
+
+/**
+ * @brief 작업 참조를 놓고 마지막이면 작업을 해제합니다.
+ * @param job 작업
+ */
+static void engine_job_unref(crypto_job_t* job) {
+    crypto_engine_t* engine = job->engine;
+    platform_mutex_lock(engine->lock);
+    job->refs--;
+    if (job->refs > 0) {
+        platform_mutex_unlock(engine->lock);
+        return;
+    }
+    free(job);
+    engine_unref_locked(engine);
+}
+
+/**
+ * @brief 라이브러리 진행률을 작업에 기록합니다 (폴링용).
+ * @param processed 처리한 누적 바이트
+ * @param total 전체 바이트
+ * @param user_data crypto_job_t 포인터
+ * @note 콜백을 넘기면 라이브러리 메시지 출력도 꺼지므로 엔진 작업은 항상 조용히 실행됩니다.
+ */
+static void engine_job_progress(int64_t processed, int64_t total, void* user_data) {
+    crypto_job_t* job = (crypto_job_t*)user_data;
+    platform_mutex_lock(job->engine->lock);
+    job->processed = processed;
+    job->total = total;
+    platform_mutex_unlock(job->engine->lock);
+}
+
+/**
+ * @brief 스레드 풀 작업 본체: 작업 하나를 실행하고 완료를 알립니다.
+ * @param arg crypto_job_t 포인터
+ */
+static void engine_job_main(void* arg) {
+    crypto_job_t* job = (crypto_job_t*)arg;
+    crypto_engine_t* engine = job->engine;
+    
+    platform_mutex_lock(engine->lock);
+    int run = !job->cancel_requested;
+    job->state = run ? CRYPTO_JOB_RUNNING : CRYPTO_JOB_CANCELLED;
+    platform_mutex_unlock(engine->lock);
+    
+    CRYPTO_JOB_STATE state = CRYPTO_JOB_CANCELLED;
+    if (run) {
+        int success;
+        if (job->kind == ENGINE_JOB_ENCRYPT) {
+            success = encrypt_file_with_progress(job->input_path, job->output_path, job->aes_key_bits,
+                                                 job->password, engine_job_progress, job);
+        } else {
+            success = decrypt_file_with_progress(job->input_path, job->output_path, job->password,
+                                                 job->final_path, sizeof(job->final_path),
+                                                 engine_job_progress, job);
+        }
+        
+        // 처리 중 취소되었으면 결과를 남기지 않음 (라이브러리 함수는 도중에 멈출 수 없음)
+        platform_mutex_lock(engine->lock);
+        int cancelled = job->cancel_requested;
+        platform_mutex_unlock(engine->lock);
+        if (success && cancelled) {
+            platform_delete_file((job->kind == ENGINE_JOB_ENCRYPT) ? job->output_path : job->final_path);
+            job->final_path[0] = '\0';
+        }
+        state = cancelled ? CRYPTO_JOB_CANCELLED : (success ? CRYPTO_JOB_DONE : CRYPTO_JOB_FAILED);
+    }
+    memset(job->password, 0, strlen(job->password));
+    free(job->password);
+    job->password = NULL;
+    
+    platform_mutex_lock(engine->lock);
+    job->state = state;
+    platform_mutex_unlock(engine->lock);
+    
+    if (job->on_done) job->on_done(job, state, job->user_data);
+    
+    // 콜백까지 끝난 뒤 한도 슬롯을 돌려주고 대기 중인 제출/wait를 깨움
+    platform_mutex_lock(engine->lock);
+    job->finished = 1;
+    engine->in_flight--;
+    platform_cond_broadcast(engine->changed);
+    platform_mutex_unlock(engine->lock);
+    engine_job_unref(job);
+}
+
+/**
+ * @brief 작업을 만들어 제출합니다 (한도에 닿았으면 슬롯이 빌 때까지 대기).
+ * @param engine 엔진
+ * @param kind 작업 종류
+ * @param input_path 입력 파일 경로
+ * @param output_path 출력 경로
+ * @param aes_key_bits AES 키 길이 (암호화만)
+ * @param password 비밀번호
+ * @param on_done 완료 콜백
+ * @param user_data 콜백에 전달할 사용자 데이터
+ * @return 작업 핸들, 실패 시 NULL
+ * @note 작업 스레드(완료 콜백) 안에서 제출하면 기다리지 않고 한도를 넘겨 넣습니다 (모든 작업 스레드가
+ *       서로를 기다리는 교착 방지).
+ */
+static crypto_job_t* engine_submit(crypto_engine_t* engine, ENGINE_JOB_KIND kind,
+                                   const char* input_path, const char* output_path,
+                                   int aes_key_bits, const char* password,
+                                   crypto_job_callback_t on_done, void* user_data) {
+    if (!engine || !input_path || !output_path || !password) return NULL;
+    if (strlen(input_path) >= MAX_PATH_LENGTH || strlen(output_path) >= MAX_PATH_LENGTH) return NULL;
+    
+    crypto_job_t* job = (crypto_job_t*)calloc(1, sizeof(crypto_job_t));
+    if (!job) return NULL;
+    size_t password_length = strlen(password);
+    job->password = (char*)malloc(password_length + 1);
+    if (!job->password) {
+        free(job);
+        return NULL;
+    }
+    memcpy(job->password, password, password_length + 1);
+    job->engine = engine;
+    job->kind = kind;
+    job->aes_key_bits = aes_key_bits;
+    strcpy(job->input_path, input_path);
+    strcpy(job->output_path, output_path);
+    job->on_done = on_done;
+    job->user_data = user_data;
+    job->state = CRYPTO_JOB_QUEUED;
+    job->refs = 2;  // 사용자 핸들 + 실행
+    
+    platform_mutex_lock(engine->lock);
+    if (platform_thread_pool_worker_index(engine->pool) < 0) {
+        while (engine->in_flight >= engine->max_in_flight) {
+            platform_cond_wait(engine->changed, engine->lock);
+        }
+    }
+    engine->in_flight++;
+    engine->refs++;
+    platform_mutex_unlock(engine->lock);
+    
+    if (!platform_thread_pool_submit(engine->pool, engine_job_main, job)) {
+        memset(job->password, 0, password_length);
+        free(job->password);
+        free(job);
+        platform_mutex_lock(engine->lock);
+        engine->in_flight--;
+        platform_cond_broadcast(engine->changed);
+        engine_unref_locked(engine);
+        return NULL;
+    }
+    return job;
+}
+
+crypto_engine_t* crypto_engine_create(int thread_count, int max_in_flight) {
+    crypto_engine_t* engine = (crypto_engine_t*)calloc(1, sizeof(crypto_engine_t));
+    if (!engine) return NULL;
+    
+    engine->lock = platform_mutex_create();
+    engine->changed = platform_cond_create();
+    engine->pool = platform_thread_pool_create(thread_count, 0);
+    if (!engine->lock || !engine->changed || !engine->pool) {
+        platform_thread_pool_destroy(engine->pool);
+        platform_cond_destroy(engine->changed);
+        platform_mutex_destroy(engine->lock);
+        free(engine);
+        return NULL;
+    }
+    engine->max_in_flight = (max_in_flight > 0) ? max_in_flight :
+                            platform_thread_pool_size(engine->pool) * CRYPTO_ENGINE_IN_FLIGHT_PER_THREAD;
+    engine->refs = 1;
+    
+    // 난수 생성기와 AES 테이블을 작업보다 먼저 준비 (지연 초기화가 작업 스레드 사이에서 겹치지 않도록)
+    uint8_t warmup[AES_BLOCK_SIZE] = { 0 };
+    uint8_t counter[AES_BLOCK_SIZE] = { 0 };
+    AES_CTX aes_ctx;
+    crypto_random_bytes(warmup, 1);
+    AES_set_key(&aes_ctx, warmup, 128);
+    AES_CTR_crypt(&aes_ctx, warmup, sizeof(warmup), warmup, counter);
+    return engine;
+}
+
+crypto_job_t* crypto_submit_encrypt(crypto_engine_t* engine, const char* input_path, const char* output_path,
+                                    int aes_key_bits, const char* password,
+                                    crypto_job_callback_t on_done, void* user_data) {
+    return engine_submit(engine, ENGINE_JOB_ENCRYPT, input_path, output_path, aes_key_bits, password,
+                         on_done, user_data);
+}
+
+crypto_job_t* crypto_submit_decrypt(crypto_engine_t* engine, const char* input_path, const char* output_path,
+                                    const char* password, crypto_job_callback_t on_done, void* user_data) {
+    return engine_submit(engine, ENGINE_JOB_DECRYPT, input_path, output_path, 0, password,
+                         on_done, user_data);
+}
+
+CRYPTO_JOB_STATE crypto_job_state(crypto_job_t* job) {
+    if (!job) return CRYPTO_JOB_FAILED;
+    
+    platform_mutex_lock(job->engine->lock);
+    CRYPTO_JOB_STATE state = job->state;
+    platform_mutex_unlock(job->engine->lock);
+    return state;
+}
+
+void crypto_job_progress(crypto_job_t* job, int64_t* processed, int64_t* total) {
+    if (!job) return;
+    
+    platform_mutex_lock(job->engine->lock);
+    if (processed) *processed = job->processed;
+    if (total) *total = job->total;
+    platform_mutex_unlock(job->engine->lock);
+}
+
+void crypto_job_cancel(crypto_job_t* job) {
+    if (!job) return;
+    
+    platform_mutex_lock(job->engine->lock);
+    job->cancel_requested = 1;
+    platform_mutex_unlock(job->engine->lock);
+}
+
+CRYPTO_JOB_STATE crypto_job_wait(crypto_job_t* job) {
+    if (!job) return CRYPTO_JOB_FAILED;
+    
+    // 완료 콜백이 돌아온 뒤에 반환 (상태는 콜백 전에 바뀜)
+    crypto_engine_t* engine = job->engine;
+    platform_mutex_lock(engine->lock);
+    while (!job->finished) {
+        platform_cond_wait(engine->changed, engine->lock);
+    }
+    CRYPTO_JOB_STATE state = job->state;
+    platform_mutex_unlock(engine->lock);
+    return state;
+}
+
+const char* crypto_job_final_path(crypto_job_t* job) {
+    if (!job) return "";
+    
+    CRYPTO_JOB_STATE state = crypto_job_state(job);
+    return (state == CRYPTO_JOB_QUEUED || state == CRYPTO_JOB_RUNNING) ? "" : job->final_path;
+}
+
+void crypto_job_release(crypto_job_t* job) {
+    if (job) engine_job_unref(job);
+}
+
+void crypto_engine_wait_all(crypto_engine_t* engine) {
+    if (!engine) return;
+    
+    platform_mutex_lock(engine->lock);
+    while (engine->in_flight > 0) {
+        platform_cond_wait(engine->changed, engine->lock);
+    }
+    platform_mutex_unlock(engine->lock);
+}
+
+void crypto_engine_destroy(crypto_engine_t* engine) {
+    if (!engine) return;
+    
+    crypto_engine_wait_all(engine);
+    platform_thread_pool_destroy(engine->pool);
+    
+    platform_mutex_lock(engine->lock);
+    engine->pool = NULL;
+    engine_unref_locked(engine);
+}
@@ -0,0 +1,694 @@
+#include "file_archive.h"
+#include "crypto_api.h"
+#include "aes_ctr_hmac.h"
+#include "hmac_sha512.h"
+#include "key_derivation.h"
+#include "platform_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 항목 키 / 색인 키 도출 레이블 (뒤에 항목 번호 8바이트 big-endian)
+static const char ARCHIVE_ENTRY_LABEL[] = "AESA entry key";
+static const char ARCHIVE_INDEX_LABEL[] = "AESA index key";
+
+// 마스터 키 길이 (아카이브 키 길이와 무관하게 PBKDF2 출력의 AES 쪽 32바이트 전체 사용)
+#define ARCHIVE_MASTER_KEY_SIZE 32
+
+// 색인 항목 하나의 고정 부분 (번호, 위치, 크기, nonce, 이름 길이)
+#define ARCHIVE_INDEX_RECORD_SIZE (8 + 8 + 8 + ENC_NONCE_SIZE + 2)
+
+// 색인 배열 초기 크기 (가득 차면 두 배로 늘림)
+#define ARCHIVE_INITIAL_CAPACITY 64
+
+// 색인 항목
+typedef struct {
+    char* name;                          // 항목 이름 (NUL 종료)
+    uint64_t id;                         // 항목 번호 (키 도출 입력, 아카이브 안에서 유일)
+    int64_t offset;                      // 암호문 위치
+    int64_t size;                        // 평문 크기 (= 암호문 크기)
+    uint8_t nonce[ENC_NONCE_SIZE];       // CTR nonce
+} ArchiveEntry;
+
+struct EncArchive {
+    FILE* file;
+    int writable;
+    int modified;                        // 항목을 추가했음 (닫을 때 새 색인 기록)
+    ArchiveHeader header;
+    int aes_key_bits;
+    uint8_t master_key[ARCHIVE_MASTER_KEY_SIZE];
+    ArchiveEntry* entries;
+    size_t count;
+    size_t capacity;
+    uint64_t next_entry_id;
+    int64_t committed_size;              // 마지막으로 기록한 트레일러의 끝 (그 뒤는 색인에 없는 바이트)
+    int64_t write_offset;                // 다음 항목(또는 색인)을 쓸 위치
+    uint8_t* buffer;                     // FILE_BUFFER_SIZE 작업 버퍼
+};
+
+static void archive_put_be64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (56 - 8 * i));
+    }
+}
+
+static uint64_t archive_get_be64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+/**
+ * @brief 항목(또는 색인) 키를 마스터 키에서 도출합니다.
+ * @param archive 아카이브
+ * @param label 도출 레이블
+ * @param label_length 레이블 길이
+ * @param id 항목 번호
+ * @param aes_ctx 출력 AES 컨텍스트
+ * @param hmac_key 출력 HMAC 키 (HMAC_KEY_SIZE)
+ * @note HMAC-SHA512(마스터 키, 레이블 || 번호) 한 번이라 PBKDF2 없이 항목마다 다른 키를 얻습니다.
+ */
+static void archive_derive_keys(const EncArchive* archive, const char* label, size_t label_length, uint64_t id,
+                                AES_CTX* aes_ctx, uint8_t* hmac_key) {
+    uint8_t info[32];
+    uint8_t okm[HMAC_SHA512_DIGEST_SIZE];
+    memcpy(info, label, label_length);
+    archive_put_be64(info + label_length, id);
+    hmac_sha512(archive->master_key, sizeof(archive->master_key), info, label_length + 8, okm);
+
+    AES_set_key(aes_ctx, okm, archive->aes_key_bits);
+    memcpy(hmac_key, okm + ARCHIVE_MASTER_KEY_SIZE, HMAC_KEY_SIZE);
+    memset(okm, 0, sizeof(okm));
+}
+
+/**
+ * @brief 비밀번호에서 마스터 키를 도출하고 KCV를 계산합니다 (아카이브당 한 번).
+ * @param archive 아카이브 (header.salt 설정됨)
+ * @param password 비밀번호
+ * @param key_check 출력 KCV (ENC_KCV_SIZE)
+ */
+static void archive_derive_master(EncArchive* archive, const char* password, uint8_t* key_check) {
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    derive_keys(password, ARCHIVE_MASTER_KEY_SIZE * 8, archive->header.salt, sizeof(archive->header.salt),
+                archive->master_key, hmac_key);
+    derive_key_check_value(hmac_key, key_check, ENC_KCV_SIZE);
+    memset(hmac_key, 0, sizeof(hmac_key));
+}
+
+static EncArchive* archive_alloc(void) {
+    EncArchive* archive = (EncArchive*)calloc(1, sizeof(EncArchive));
+    if (!archive) return NULL;
+    archive->buffer = (uint8_t*)malloc(FILE_BUFFER_SIZE);
+    if (!archive->buffer) {
+        free(archive);
+        return NULL;
+    }
+    return archive;
+}
+
+static void archive_clear_entries(EncArchive* archive) {
+    for (size_t i = 0; i < archive->count; i++) {
+        free(archive->entries[i].name);
+    }
+    archive->count = 0;
+}
+
+static void archive_free(EncArchive* archive) {
+    archive_clear_entries(archive);
+    free(archive->entries);
+    free(archive->buffer);
+    memset(archive->master_key, 0, sizeof(archive->master_key));
+    free(archive);
+}
+
+/**
+ * @brief 색인 배열에 항목을 추가합니다 (이름은 복사).
+ * @param archive 아카이브
+ * @param entry 항목 (name은 호출자 소유)
+ * @return 1 성공, 0 메모리 부족
+ */
+static int archive_push_entry(EncArchive* archive, const ArchiveEntry* entry) {
+    if (archive->count == archive->capacity) {
+        size_t capacity = archive->capacity ? archive->capacity * 2 : ARCHIVE_INITIAL_CAPACITY;
+        ArchiveEntry* entries = (ArchiveEntry*)realloc(archive->entries, capacity * sizeof(ArchiveEntry));
+        if (!entries) return 0;
+        archive->entries = entries;
+        archive->capacity = capacity;
+    }
+
+    size_t name_length = strlen(entry->name);
+    char* name = (char*)malloc(name_length + 1);
+    if (!name) return 0;
+    memcpy(name, entry->name, name_length + 1);
+
+    archive->entries[archive->count] = *entry;
+    archive->entries[archive->count].name = name;
+    archive->count++;
+    return 1;
+}
+
+/**
+ * @brief 항목 이름이 추출 디렉토리 밖을 가리키지 않는 단일 파일 이름인지 확인합니다.
+ * @param name 항목 이름
+ * @return 1 올바름, 0 잘못됨
+ * @note 만드는 플랫폼과 관계없이 Windows 파일 이름에 쓸 수 없는 문자(제어 문자, < > : " / \\ | ? *)를 거부합니다.
+ *       ':'를 허용하면 Windows에서 "C:evil"은 드라이브 상대 경로, "name:stream"은 대체 데이터 스트림이 됩니다.
+ */
+static int archive_valid_name(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length > ARCHIVE_MAX_NAME_LENGTH) return 0;
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) return 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)name[i];
+        if (c < 0x20 || strchr("<>:\"/\\|?*", c) != NULL) return 0;
+    }
+    return 1;
+}
+
+FILE_CRYPTO_STATUS enc_archive_create(const char* archive_path, const char* password, int aes_key_bits,
+                                      EncArchive** archive) {
+    if (!archive_path || !password || !archive) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    *archive = NULL;
+    if (aes_key_bits != 128 && aes_key_bits != 192 && aes_key_bits != 256) {
+        return FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    }
+
+    EncArchive* created = archive_alloc();
+    if (!created) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+
+    ArchiveHeader* header = &created->header;
+    memcpy(header->signature, ARCHIVE_SIGNATURE, 4);
+    header->version = ARCHIVE_VERSION;
+    header->key_length_code = (aes_key_bits == 128) ? KEY_LENGTH_CODE_128 :
+                              (aes_key_bits == 192) ? KEY_LENGTH_CODE_192 : KEY_LENGTH_CODE_256;
+    if (crypto_random_bytes(header->salt, sizeof(header->salt)) != CRYPTO_SUCCESS) {
+        archive_free(created);
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    created->aes_key_bits = aes_key_bits;
+    archive_derive_master(created, password, header->key_check);
+
+    created->file = platform_fopen(archive_path, "w+b");
+    if (!created->file) {
+        archive_free(created);
+        return FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+    if (fwrite(header, 1, sizeof(ArchiveHeader), created->file) != sizeof(ArchiveHeader)) {
+        fclose(created->file);
+        archive_free(created);
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    created->writable = 1;
+    created->modified = 1;  // 항목이 없어도 빈 색인을 기록
+    created->write_offset = ARCHIVE_HEADER_SIZE;
+    *archive = created;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief 복호화한 색인을 항목 배열로 읽어 들입니다.
+ * @param archive 아카이브
+ * @param index 색인 평문
+ * @param length 색인 길이
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_INVALID_HEADER (형식 오류)
+ */
+static FILE_CRYPTO_STATUS archive_parse_index(EncArchive* archive, const uint8_t* index, size_t length) {
+    size_t position = 0;
+    char name[ARCHIVE_MAX_NAME_LENGTH + 1];
+    while (position < length) {
+        if (length - position < ARCHIVE_INDEX_RECORD_SIZE) return FILE_CRYPTO_ERR_INVALID_HEADER;
+        const uint8_t* record = index + position;
+        ArchiveEntry entry;
+        entry.id = archive_get_be64(record);
+        entry.offset = (int64_t)archive_get_be64(record + 8);
+        entry.size = (int64_t)archive_get_be64(record + 16);
+        memcpy(entry.nonce, record + 24, ENC_NONCE_SIZE);
+        size_t name_length = ((size_t)record[32] << 8) | record[33];
+        position += ARCHIVE_INDEX_RECORD_SIZE;
+
+        if (name_length > ARCHIVE_MAX_NAME_LENGTH || length - position < name_length) {
+            return FILE_CRYPTO_ERR_INVALID_HEADER;
+        }
+        memcpy(name, index + position, name_length);
+        name[name_length] = '\0';
+        position += name_length;
+        if (!archive_valid_name(name) || entry.offset < ARCHIVE_HEADER_SIZE || entry.size < 0 ||
+            entry.id >= archive->next_entry_id) {
+            return FILE_CRYPTO_ERR_INVALID_HEADER;
+        }
+        entry.name = name;
+        if (!archive_push_entry(archive, &entry)) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+/**
+ * @brief trailer_end에서 끝나는 트레일러를 읽고 색인 태그를 검증한 뒤 색인을 복호화해 읽어 들입니다.
+ * @param archive 아카이브 (헤더 검증, 마스터 키 도출 완료)
+ * @param trailer_end 트레일러 끝 위치
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_INVALID_HEADER (트레일러 아님),
+ *         FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED (색인 변조) 등
+ */
+static FILE_CRYPTO_STATUS archive_load_index(EncArchive* archive, int64_t trailer_end) {
+    ArchiveTrailer trailer;
+    if (trailer_end < ARCHIVE_HEADER_SIZE + ENC_HMAC_SIZE + ARCHIVE_TRAILER_SIZE ||
+        platform_fseek64(archive->file, trailer_end - ARCHIVE_TRAILER_SIZE, SEEK_SET) != 0 ||
+        fread(&trailer, 1, sizeof(trailer), archive->file) != sizeof(trailer) ||
+        memcmp(trailer.signature, ARCHIVE_TRAILER_SIGNATURE, 4) != 0) {
+        return FILE_CRYPTO_ERR_INVALID_HEADER;
+    }
+    uint64_t index_offset = archive_get_be64(trailer.index_offset);
+    uint64_t index_length = archive_get_be64(trailer.index_length);
+    archive->next_entry_id = archive_get_be64(trailer.next_entry_id);
+    if (index_offset < ARCHIVE_HEADER_SIZE || index_length > (uint64_t)trailer_end ||
+        index_offset + index_length + ENC_HMAC_SIZE + ARCHIVE_TRAILER_SIZE != (uint64_t)trailer_end) {
+        return FILE_CRYPTO_ERR_INVALID_HEADER;
+    }
+
+    // 색인: 태그 검증 후 복호화
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    uint8_t* index = (uint8_t*)malloc(index_length ? (size_t)index_length : 1);
+    if (!index || index_length > (uint64_t)SIZE_MAX) {
+        result = FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    } else if (platform_fseek64(archive->file, (int64_t)index_offset, SEEK_SET) != 0 ||
+               fread(index, 1, (size_t)index_length, archive->file) != (size_t)index_length) {
+        result = FILE_CRYPTO_ERR_FILE_READ;
+    }
+    if (result == FILE_CRYPTO_SUCCESS) {
+        AES_CTX aes_ctx;
+        uint8_t hmac_key[HMAC_KEY_SIZE];
+        uint8_t stored_tag[ENC_HMAC_SIZE];
+        uint8_t tag[ENC_HMAC_SIZE];
+        HMAC_SHA512_CTX hmac_ctx;
+        archive_derive_keys(archive, ARCHIVE_INDEX_LABEL, sizeof(ARCHIVE_INDEX_LABEL) - 1, 0, &aes_ctx, hmac_key);
+        hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+        hmac_sha512_update(&hmac_ctx, (const uint8_t*)&archive->header, sizeof(ArchiveHeader));
+        hmac_sha512_update(&hmac_ctx, (const uint8_t*)&trailer, sizeof(trailer));
+        hmac_sha512_update(&hmac_ctx, index, (size_t)index_length);
+        hmac_sha512_final(&hmac_ctx, tag);
+        memset(hmac_key, 0, sizeof(hmac_key));
+
+        if (fread(stored_tag, 1, sizeof(stored_tag), archive->file) != sizeof(stored_tag)) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+        } else if (memcmp(tag, stored_tag, sizeof(tag)) != 0) {
+            result = FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        } else {
+            uint8_t nonce_counter[AES_BLOCK_SIZE];
+            memcpy(nonce_counter, trailer.index_nonce, ENC_NONCE_SIZE);
+            memset(nonce_counter + ENC_NONCE_SIZE, 0, AES_BLOCK_SIZE - ENC_NONCE_SIZE);
+            if (AES_CTR_crypt(&aes_ctx, index, (size_t)index_length, index, nonce_counter) != CRYPTO_SUCCESS) {
+                result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+            } else {
+                result = archive_parse_index(archive, index, (size_t)index_length);
+            }
+        }
+    }
+    free(index);
+    if (result != FILE_CRYPTO_SUCCESS) archive_clear_entries(archive);
+    return result;
+}
+
+/**
+ * @brief 파일 끝에 트레일러가 없을 때 (추가 도중 중단) 마지막으로 완료된 트레일러를 뒤에서부터 찾습니다.
+ * @param archive 아카이브 (헤더 검증, 마스터 키 도출 완료)
+ * @param file_size 파일 크기
+ * @param trailer_end 출력: 찾은 트레일러의 끝 위치
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_INVALID_HEADER (완료된 트레일러 없음)
+ * @note 추가는 기존 트레일러 뒤에만 쓰므로 중단된 추가의 바이트는 모두 마지막 완료 트레일러 뒤에 있습니다.
+ *       서명이 우연히 맞는 암호문은 색인 태그 검증에서 걸러집니다.
+ */
+static FILE_CRYPTO_STATUS archive_recover_index(EncArchive* archive, int64_t file_size, int64_t* trailer_end) {
+    const int64_t lowest = ARCHIVE_HEADER_SIZE + ENC_HMAC_SIZE;  // 빈 색인 트레일러의 위치
+    int64_t stop = file_size - ARCHIVE_TRAILER_SIZE + 4;         // 검색 구간 끝 (서명 4바이트 포함)
+    while (stop - lowest >= 4) {
+        int64_t start = (stop - lowest > FILE_BUFFER_SIZE) ? stop - FILE_BUFFER_SIZE : lowest;
+        size_t length = (size_t)(stop - start);
+        if (platform_fseek64(archive->file, start, SEEK_SET) != 0 ||
+            fread(archive->buffer, 1, length, archive->file) != length) {
+            return FILE_CRYPTO_ERR_FILE_READ;
+        }
+        for (size_t i = length - 3; i-- > 0;) {
+            if (memcmp(archive->buffer + i, ARCHIVE_TRAILER_SIGNATURE, 4) != 0) continue;
+            int64_t candidate_end = start + (int64_t)i + ARCHIVE_TRAILER_SIZE;
+            FILE_CRYPTO_STATUS result = archive_load_index(archive, candidate_end);
+            if (result == FILE_CRYPTO_SUCCESS) {
+                *trailer_end = candidate_end;
+                return FILE_CRYPTO_SUCCESS;
+            }
+            if (result != FILE_CRYPTO_ERR_INVALID_HEADER && result != FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+                return result;
+            }
+        }
+        if (start == lowest) break;
+        stop = start + 3;  // 구간 경계에 걸친 서명
+    }
+    return FILE_CRYPTO_ERR_INVALID_HEADER;
+}
+
+FILE_CRYPTO_STATUS enc_archive_open(const char* archive_path, const char* password, int writable,
+                                    EncArchive** archive) {
+    if (!archive_path || !password || !archive) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    *archive = NULL;
+
+    EncArchive* opened = archive_alloc();
+    if (!opened) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    opened->writable = writable ? 1 : 0;
+    opened->file = platform_fopen(archive_path, writable ? "r+b" : "rb");
+    if (!opened->file) {
+        archive_free(opened);
+        return FILE_CRYPTO_ERR_FILE_OPEN;
+    }
+
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    ArchiveHeader* header = &opened->header;
+    if (fread(header, 1, sizeof(ArchiveHeader), opened->file) != sizeof(ArchiveHeader)) {
+        result = FILE_CRYPTO_ERR_INVALID_HEADER;
+    } else if (memcmp(header->signature, ARCHIVE_SIGNATURE, 4) != 0) {
+        result = FILE_CRYPTO_ERR_INVALID_SIGNATURE;
+    } else if (header->version != ARCHIVE_VERSION) {
+        result = FILE_CRYPTO_ERR_UNSUPPORTED_VERSION;
+    } else if (header->key_length_code == KEY_LENGTH_CODE_128) {
+        opened->aes_key_bits = 128;
+    } else if (header->key_length_code == KEY_LENGTH_CODE_192) {
+        opened->aes_key_bits = 192;
+    } else if (header->key_length_code == KEY_LENGTH_CODE_256) {
+        opened->aes_key_bits = 256;
+    } else {
+        result = FILE_CRYPTO_ERR_UNSUPPORTED_KEY_LENGTH;
+    }
+
+    // 비밀번호 확인 (색인을 읽기 전에 KCV로 판별)
+    if (result == FILE_CRYPTO_SUCCESS) {
+        uint8_t key_check[ENC_KCV_SIZE];
+        archive_derive_master(opened, password, key_check);
+        if (memcmp(key_check, header->key_check, ENC_KCV_SIZE) != 0) result = FILE_CRYPTO_ERR_KEY_CHECK_FAILED;
+    }
+
+    // 트레일러는 보통 파일 끝에 있고, 없으면 중단된 추가 앞의 마지막 트레일러를 사용
+    int64_t file_size = -1;
+    int64_t trailer_end = -1;
+    if (result == FILE_CRYPTO_SUCCESS) {
+        if (platform_fseek64(opened->file, 0, SEEK_END) != 0 || (file_size = platform_ftell64(opened->file)) < 0) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+        } else {
+            trailer_end = file_size;
+            result = archive_load_index(opened, trailer_end);
+            if (result == FILE_CRYPTO_ERR_INVALID_HEADER) result = archive_recover_index(opened, file_size, &trailer_end);
+        }
+    }
+
+    if (result != FILE_CRYPTO_SUCCESS) {
+        fclose(opened->file);
+        archive_free(opened);
+        return result;
+    }
+    // 추가하는 항목은 기존 트레일러 뒤에 기록 (새 트레일러를 기록할 때까지 기존 색인 유지)
+    opened->committed_size = trailer_end;
+    opened->write_offset = trailer_end;
+    *archive = opened;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+FILE_CRYPTO_STATUS enc_archive_add_file(EncArchive* archive, const char* input_path, const char* entry_name) {
+    if (!archive || !input_path) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    if (!archive->writable) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    if (!entry_name) {
+        const char* separator = platform_find_last_separator(input_path);
+        entry_name = separator ? separator + 1 : input_path;
+    }
+    if (!archive_valid_name(entry_name)) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE* fin = platform_fopen(input_path, "rb");
+    if (!fin) return FILE_CRYPTO_ERR_FILE_OPEN;
+
+    ArchiveEntry entry;
+    entry.name = (char*)entry_name;
+    entry.id = archive->next_entry_id;
+    entry.offset = archive->write_offset;
+    entry.size = 0;
+    if (crypto_random_bytes(entry.nonce, sizeof(entry.nonce)) != CRYPTO_SUCCESS) {
+        fclose(fin);
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+
+    // 마지막 트레일러 뒤에만 쓰므로 실패하거나 중단되어도 기존 항목과 색인은 그대로 남음
+    if (platform_fseek64(archive->file, entry.offset, SEEK_SET) != 0) {
+        fclose(fin);
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+
+    AES_CTX aes_ctx;
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    HMAC_SHA512_CTX hmac_ctx;
+    uint8_t nonce_counter[AES_BLOCK_SIZE];
+    archive_derive_keys(archive, ARCHIVE_ENTRY_LABEL, sizeof(ARCHIVE_ENTRY_LABEL) - 1, entry.id, &aes_ctx, hmac_key);
+    hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&hmac_ctx, entry.nonce, sizeof(entry.nonce));
+    memset(hmac_key, 0, sizeof(hmac_key));
+    memcpy(nonce_counter, entry.nonce, ENC_NONCE_SIZE);
+    memset(nonce_counter + ENC_NONCE_SIZE, 0, AES_BLOCK_SIZE - ENC_NONCE_SIZE);
+
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    size_t bytes_read;
+    while ((bytes_read = fread(archive->buffer, 1, FILE_BUFFER_SIZE, fin)) > 0) {
+        if (AES_CTR_HMAC_crypt(&aes_ctx, archive->buffer, bytes_read, archive->buffer, nonce_counter,
+                               &hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+            result = FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+            break;
+        }
+        if (fwrite(archive->buffer, 1, bytes_read, archive->file) != bytes_read) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+            break;
+        }
+        entry.size += (int64_t)bytes_read;
+    }
+    if (result == FILE_CRYPTO_SUCCESS && ferror(fin)) result = FILE_CRYPTO_ERR_FILE_READ;
+    fclose(fin);
+
+    // 태그 = HMAC(nonce || 암호문 || 평문 크기)
+    uint8_t size_bytes[8];
+    uint8_t tag[ENC_HMAC_SIZE];
+    archive_put_be64(size_bytes, (uint64_t)entry.size);
+    hmac_sha512_update(&hmac_ctx, size_bytes, sizeof(size_bytes));
+    hmac_sha512_final(&hmac_ctx, tag);
+    if (result == FILE_CRYPTO_SUCCESS && fwrite(tag, 1, sizeof(tag), archive->file) != sizeof(tag)) {
+        result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    if (result != FILE_CRYPTO_SUCCESS) return result;
+
+    if (!archive_push_entry(archive, &entry)) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+    archive->modified = 1;
+    archive->next_entry_id++;
+    archive->write_offset = entry.offset + entry.size + ENC_HMAC_SIZE;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+size_t enc_archive_entry_count(const EncArchive* archive) {
+    return archive ? archive->count : 0;
+}
+
+FILE_CRYPTO_STATUS enc_archive_entry_info(const EncArchive* archive, size_t index, ArchiveEntryInfo* info) {
+    if (!archive || !info || index >= archive->count) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    info->name = archive->entries[index].name;
+    info->size = archive->entries[index].size;
+    return FILE_CRYPTO_SUCCESS;
+}
+
+int64_t enc_archive_find(const EncArchive* archive, const char* name) {
+    if (!archive || !name) return -1;
+    for (size_t i = archive->count; i > 0; i--) {
+        if (strcmp(archive->entries[i - 1].name, name) == 0) return (int64_t)(i - 1);
+    }
+    return -1;
+}
+
+FILE_CRYPTO_STATUS enc_archive_extract(EncArchive* archive, size_t index, const char* output_path) {
+    if (!archive || !output_path || index >= archive->count) return FILE_CRYPTO_ERR_INVALID_INPUT;
+    const ArchiveEntry* entry = &archive->entries[index];
+
+    if (platform_fseek64(archive->file, entry->offset, SEEK_SET) != 0) return FILE_CRYPTO_ERR_FILE_READ;
+
+    char staged_path[MAX_PATH_LENGTH];
+    FILE* fout = platform_create_temp_file_near(output_path, staged_path, sizeof(staged_path));
+    if (!fout) return FILE_CRYPTO_ERR_TEMP_FILE_CREATE;
+
+    AES_CTX aes_ctx;
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    HMAC_SHA512_CTX hmac_ctx;
+    uint8_t nonce_counter[AES_BLOCK_SIZE];
+    archive_derive_keys(archive, ARCHIVE_ENTRY_LABEL, sizeof(ARCHIVE_ENTRY_LABEL) - 1, entry->id, &aes_ctx, hmac_key);
+    hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&hmac_ctx, entry->nonce, sizeof(entry->nonce));
+    memset(hmac_key, 0, sizeof(hmac_key));
+    memcpy(nonce_counter, entry->nonce, ENC_NONCE_SIZE);
+    memset(nonce_counter + ENC_NONCE_SIZE, 0, AES_BLOCK_SIZE - ENC_NONCE_SIZE);
+
+    // 스테이징 파일에 복호화하고 태그가 맞을 때만 게시 (변조된 평문이 최종 경로에 나타나지 않음)
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    int64_t remaining = entry->size;
+    while (remaining > 0) {
+        size_t chunk = (remaining < FILE_BUFFER_SIZE) ? (size_t)remaining : FILE_BUFFER_SIZE;
+        if (fread(archive->buffer, 1, chunk, archive->file) != chunk) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+            break;
+        }
+        if (AES_CTR_HMAC_crypt(&aes_ctx, archive->buffer, chunk, archive->buffer, nonce_counter,
+                               &hmac_ctx, AES_CTR_HMAC_MAC_INPUT) != CRYPTO_SUCCESS) {
+            result = FILE_CRYPTO_ERR_DECRYPTION_FAILED;
+            break;
+        }
+        if (fwrite(archive->buffer, 1, chunk, fout) != chunk) {
+            result = FILE_CRYPTO_ERR_FILE_WRITE;
+            break;
+        }
+        remaining -= (int64_t)chunk;
+    }
+
+    if (result == FILE_CRYPTO_SUCCESS) {
+        uint8_t size_bytes[8];
+        uint8_t tag[ENC_HMAC_SIZE];
+        uint8_t stored_tag[ENC_HMAC_SIZE];
+        archive_put_be64(size_bytes, (uint64_t)entry->size);
+        hmac_sha512_update(&hmac_ctx, size_bytes, sizeof(size_bytes));
+        hmac_sha512_final(&hmac_ctx, tag);
+        if (fread(stored_tag, 1, sizeof(stored_tag), archive->file) != sizeof(stored_tag)) {
+            result = FILE_CRYPTO_ERR_FILE_READ;
+        } else if (memcmp(tag, stored_tag, sizeof(tag)) != 0) {
+            result = FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED;
+        }
+    }
+
+    if (fclose(fout) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    if (result == FILE_CRYPTO_SUCCESS && !platform_rename_file(staged_path, output_path)) {
+        result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    if (result != FILE_CRYPTO_SUCCESS) platform_delete_file(staged_path);
+    return result;
+}
+
+FILE_CRYPTO_STATUS enc_archive_extract_all(EncArchive* archive, const char* output_dir, size_t* extracted) {
+    if (extracted) *extracted = 0;
+    if (!archive || !output_dir) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE_CRYPTO_STATUS first_error = FILE_CRYPTO_SUCCESS;
+    size_t dir_length = strlen(output_dir);
+    int needs_separator = (dir_length > 0 && output_dir[dir_length - 1] != '/' && output_dir[dir_length - 1] != '\\');
+    for (size_t i = 0; i < archive->count; i++) {
+        // 같은 이름의 뒤 항목이 있으면 건너뜀 (나중에 추가한 항목이 우선)
+        if (enc_archive_find(archive, archive->entries[i].name) != (int64_t)i) continue;
+
+        char output_path[MAX_PATH_LENGTH];
+        int written = snprintf(output_path, sizeof(output_path), "%s%s%s", output_dir,
+                               needs_separator ? "/" : "", archive->entries[i].name);
+        FILE_CRYPTO_STATUS result = (written < 0 || (size_t)written >= sizeof(output_path)) ?
+                                    FILE_CRYPTO_ERR_INVALID_INPUT : enc_archive_extract(archive, i, output_path);
+        if (result == FILE_CRYPTO_SUCCESS) {
+            if (extracted) (*extracted)++;
+        } else if (first_error == FILE_CRYPTO_SUCCESS) {
+            first_error = result;
+        }
+    }
+    return first_error;
+}
+
+/**
+ * @brief 색인을 암호화해 write_offset에 기록하고 태그와 트레일러를 붙입니다.
+ * @param archive 쓰기 가능한 아카이브
+ * @return FILE_CRYPTO_SUCCESS 또는 에러 코드
+ * @note 항목, 색인, 태그를 디스크에 내린 뒤 트레일러를 쓰고 다시 내립니다. 새 트레일러가 보이면
+ *       그것이 가리키는 데이터도 모두 기록된 상태이고, 그 전까지는 이전 트레일러가 유효합니다.
+ */
+static FILE_CRYPTO_STATUS archive_write_index(EncArchive* archive) {
+    size_t index_length = 0;
+    for (size_t i = 0; i < archive->count; i++) {
+        index_length += ARCHIVE_INDEX_RECORD_SIZE + strlen(archive->entries[i].name);
+    }
+    uint8_t* index = (uint8_t*)malloc(index_length ? index_length : 1);
+    if (!index) return FILE_CRYPTO_ERR_MEMORY_ALLOCATION;
+
+    size_t position = 0;
+    for (size_t i = 0; i < archive->count; i++) {
+        const ArchiveEntry* entry = &archive->entries[i];
+        size_t name_length = strlen(entry->name);
+        archive_put_be64(index + position, entry->id);
+        archive_put_be64(index + position + 8, (uint64_t)entry->offset);
+        archive_put_be64(index + position + 16, (uint64_t)entry->size);
+        memcpy(index + position + 24, entry->nonce, ENC_NONCE_SIZE);
+        index[position + 32] = (uint8_t)(name_length >> 8);
+        index[position + 33] = (uint8_t)name_length;
+        memcpy(index + position + ARCHIVE_INDEX_RECORD_SIZE, entry->name, name_length);
+        position += ARCHIVE_INDEX_RECORD_SIZE + name_length;
+    }
+
+    ArchiveTrailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    memcpy(trailer.signature, ARCHIVE_TRAILER_SIGNATURE, 4);
+    archive_put_be64(trailer.next_entry_id, archive->next_entry_id);
+    archive_put_be64(trailer.index_offset, (uint64_t)archive->write_offset);
+    archive_put_be64(trailer.index_length, (uint64_t)index_length);
+    if (crypto_random_bytes(trailer.index_nonce, sizeof(trailer.index_nonce)) != CRYPTO_SUCCESS) {
+        free(index);
+        return FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+
+    AES_CTX aes_ctx;
+    uint8_t hmac_key[HMAC_KEY_SIZE];
+    HMAC_SHA512_CTX hmac_ctx;
+    uint8_t nonce_counter[AES_BLOCK_SIZE];
+    uint8_t tag[ENC_HMAC_SIZE];
+    archive_derive_keys(archive, ARCHIVE_INDEX_LABEL, sizeof(ARCHIVE_INDEX_LABEL) - 1, 0, &aes_ctx, hmac_key);
+    memcpy(nonce_counter, trailer.index_nonce, ENC_NONCE_SIZE);
+    memset(nonce_counter + ENC_NONCE_SIZE, 0, AES_BLOCK_SIZE - ENC_NONCE_SIZE);
+    hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)&archive->header, sizeof(ArchiveHeader));
+    hmac_sha512_update(&hmac_ctx, (const uint8_t*)&trailer, sizeof(trailer));
+    memset(hmac_key, 0, sizeof(hmac_key));
+
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    if (AES_CTR_HMAC_crypt(&aes_ctx, index, index_length, index, nonce_counter,
+                           &hmac_ctx, AES_CTR_HMAC_MAC_OUTPUT) != CRYPTO_SUCCESS) {
+        result = FILE_CRYPTO_ERR_ENCRYPTION_FAILED;
+    }
+    hmac_sha512_final(&hmac_ctx, tag);
+
+    if (result == FILE_CRYPTO_SUCCESS &&
+        (!platform_truncate_stream(archive->file, archive->write_offset) ||  // 실패한 추가가 남긴 뒤쪽 바이트 제거
+         platform_fseek64(archive->file, archive->write_offset, SEEK_SET) != 0 ||
+         fwrite(index, 1, index_length, archive->file) != index_length ||
+         fwrite(tag, 1, sizeof(tag), archive->file) != sizeof(tag) ||
+         !platform_sync_stream(archive->file) ||
+         fwrite(&trailer, 1, sizeof(trailer), archive->file) != sizeof(trailer) ||
+         !platform_sync_stream(archive->file))) {
+        result = FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    free(index);
+    return result;
+}
+
+/**
+ * @brief 항목을 추가하지 않고 닫을 때 마지막 트레일러 뒤의 바이트(실패하거나 중단된 추가)를 잘라 냅니다.
+ * @param archive 쓰기 가능한 아카이브
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_FILE_WRITE
+ */
+static FILE_CRYPTO_STATUS archive_drop_uncommitted(EncArchive* archive) {
+    int64_t file_size;
+    if (platform_fseek64(archive->file, 0, SEEK_END) != 0 || (file_size = platform_ftell64(archive->file)) < 0) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    if (file_size > archive->committed_size && !platform_truncate_stream(archive->file, archive->committed_size)) {
+        return FILE_CRYPTO_ERR_FILE_WRITE;
+    }
+    return FILE_CRYPTO_SUCCESS;
+}
+
+FILE_CRYPTO_STATUS enc_archive_close(EncArchive* archive) {
+    if (!archive) return FILE_CRYPTO_ERR_INVALID_INPUT;
+
+    FILE_CRYPTO_STATUS result = FILE_CRYPTO_SUCCESS;
+    if (archive->writable) result = archive->modified ? archive_write_index(archive) : archive_drop_uncommitted(archive);
+    if (fclose(archive->file) != 0 && result == FILE_CRYPTO_SUCCESS) result = FILE_CRYPTO_ERR_FILE_WRITE;
+    archive_free(archive);
+    return result;
+}
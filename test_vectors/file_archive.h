@@ -0,0 +1,130 @@
+#ifndef FILE_ARCHIVE_H
+#define FILE_ARCHIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 아카이브 파일 구조 (여러 파일을 하나의 암호화 컨테이너에 저장)
+// [헤더 64바이트] [항목 0: 암호문 | 태그] [항목 1: 암호문 | 태그] ... [색인 암호문 | 색인 태그] [트레일러 40바이트]
+// 비밀번호 도출(PBKDF2)은 아카이브당 한 번, 항목 키는 마스터 키에서 항목 번호로 HMAC 도출 (항목마다 다른 키와 nonce)
+// 항목 태그 = HMAC(항목 HMAC 키, nonce || 암호문 || 평문 크기(8바이트 big-endian))
+// 색인 태그 = HMAC(색인 HMAC 키, 헤더 || 트레일러 || 색인 암호문): 항목 목록, 위치, 크기를 함께 인증
+// 기존 아카이브에 추가한 항목과 새 색인은 이전 트레일러 뒤에 기록 (이전 색인과 트레일러는 쓰지 않는 공간으로 남음)
+#define ARCHIVE_SIGNATURE "AESA"
+#define ARCHIVE_VERSION 0x01
+#define ARCHIVE_HEADER_SIZE 64
+#define ARCHIVE_TRAILER_SIGNATURE "AESI"
+#define ARCHIVE_TRAILER_SIZE 40
+#define ARCHIVE_MAX_NAME_LENGTH (MAX_FILENAME_LENGTH - 1)  // 항목 이름 최대 바이트 수
+
+// 아카이브 헤더
+typedef struct {
+    uint8_t signature[4];      // [0:4] "AESA"
+    uint8_t version;           // [4:5] 0x01
+    uint8_t key_length_code;   // [5:6] 0x01=128, 0x02=192, 0x03=256
+    uint8_t reserved[2];       // [6:8] 0
+    uint8_t salt[16];          // [8:24] PBKDF2 salt
+    uint8_t key_check[16];     // [24:40] 키 확인 값 (KCV, 색인을 읽기 전에 비밀번호 확인)
+    uint8_t padding[24];       // [40:64] 0
+} ArchiveHeader;
+
+// 아카이브 트레일러 (파일 끝, 색인 위치를 찾는 데 사용)
+typedef struct {
+    uint8_t signature[4];      // [0:4] "AESI"
+    uint8_t reserved[4];       // [4:8] 0
+    uint8_t next_entry_id[8];  // [8:16] 다음 항목 번호 (big-endian, 항목 키 도출에 사용)
+    uint8_t index_offset[8];   // [16:24] 색인 암호문 위치 (big-endian)
+    uint8_t index_length[8];   // [24:32] 색인 암호문 길이 (big-endian, 태그 제외)
+    uint8_t index_nonce[8];    // [32:40] 색인 CTR nonce
+} ArchiveTrailer;
+
+// 항목 정보
+typedef struct {
+    const char* name;          // 항목 이름 (아카이브를 닫을 때까지 유효)
+    int64_t size;              // 평문 크기
+} ArchiveEntryInfo;
+
+// 열린 아카이브 (한 핸들을 여러 스레드에서 동시에 사용하지 않음)
+typedef struct EncArchive EncArchive;
+
+/**
+ * @brief 새 아카이브를 만듭니다 (같은 경로의 파일은 덮어씀).
+ * @param archive_path 아카이브 경로
+ * @param password 비밀번호
+ * @param aes_key_bits AES 키 길이 (128, 192, 256)
+ * @param archive 출력 핸들
+ * @return FILE_CRYPTO_SUCCESS 또는 에러 코드
+ */
+FILE_CRYPTO_STATUS enc_archive_create(const char* archive_path, const char* password, int aes_key_bits,
+                                      EncArchive** archive);
+
+/**
+ * @brief 기존 아카이브를 엽니다 (KCV로 비밀번호 확인 후 색인 태그 검증, 색인 복호화).
+ * @param archive_path 아카이브 경로
+ * @param password 비밀번호
+ * @param writable 1이면 항목 추가 가능 (새 항목은 마지막 트레일러 뒤에 기록)
+ * @param archive 출력 핸들
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_KEY_CHECK_FAILED (잘못된 비밀번호),
+ *         FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED (색인 변조) 등
+ * @note 파일 끝에 트레일러가 없으면 (추가 도중 중단) 마지막으로 완료된 트레일러를 찾아 추가 전 상태로 엽니다.
+ *       쓰기 가능으로 열면 닫을 때 그 뒤의 바이트를 잘라 냅니다.
+ */
+FILE_CRYPTO_STATUS enc_archive_open(const char* archive_path, const char* password, int writable,
+                                    EncArchive** archive);
+
+/**
+ * @brief 파일 하나를 아카이브에 추가합니다.
+ * @param archive 쓰기 가능한 아카이브
+ * @param input_path 입력 파일 경로
+ * @param entry_name 항목 이름 (NULL이면 입력 파일 이름, 경로 구분자, ":" 등 Windows 파일 이름에 쓸 수 없는 문자나 "."/".." 불가)
+ * @return FILE_CRYPTO_SUCCESS 또는 에러 코드
+ * @note 같은 이름을 다시 추가하면 뒤 항목이 이름 검색과 전체 추출에서 앞 항목을 대신합니다.
+ *       색인은 enc_archive_close에서 기록되며, 그 전에 중단되면 아카이브는 추가 전 항목만 가진 채로 열립니다.
+ */
+FILE_CRYPTO_STATUS enc_archive_add_file(EncArchive* archive, const char* input_path, const char* entry_name);
+
+// 항목 수
+size_t enc_archive_entry_count(const EncArchive* archive);
+
+// 항목 정보 (index: 0부터, 추가한 순서)
+FILE_CRYPTO_STATUS enc_archive_entry_info(const EncArchive* archive, size_t index, ArchiveEntryInfo* info);
+
+// 이름으로 항목 찾기 (같은 이름이 여러 개면 마지막 항목, 없으면 -1)
+int64_t enc_archive_find(const EncArchive* archive, const char* name);
+
+/**
+ * @brief 항목 하나를 추출합니다 (그 항목의 암호문만 읽음).
+ * @param archive 아카이브
+ * @param index 항목 번호
+ * @param output_path 출력 파일 경로
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED (항목 변조) 등
+ * @note 출력 옆의 스테이징 파일에 복호화한 뒤 태그가 맞을 때만 최종 경로로 옮깁니다.
+ */
+FILE_CRYPTO_STATUS enc_archive_extract(EncArchive* archive, size_t index, const char* output_path);
+
+/**
+ * @brief 모든 항목을 디렉토리에 추출합니다 (같은 이름은 마지막 항목만).
+ * @param archive 아카이브
+ * @param output_dir 출력 디렉토리 (이미 있어야 함)
+ * @param extracted 추출한 항목 수 (NULL 가능)
+ * @return FILE_CRYPTO_SUCCESS 또는 처음 실패한 항목의 에러 코드 (나머지 항목은 계속 추출)
+ */
+FILE_CRYPTO_STATUS enc_archive_extract_all(EncArchive* archive, const char* output_dir, size_t* extracted);
+
+/**
+ * @brief 아카이브를 닫습니다 (항목을 추가했으면 새 색인과 트레일러를 기록).
+ * @param archive 아카이브 (항상 해제됨)
+ * @return FILE_CRYPTO_SUCCESS 또는 색인 기록 에러 코드
+ */
+FILE_CRYPTO_STATUS enc_archive_close(EncArchive* archive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_ARCHIVE_H
@@ -0,0 +1,25 @@
+#ifndef FILE_CHECKPOINT_H
+#define FILE_CHECKPOINT_H
+
+#include <stdint.h>
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 체크포인트 (v4 재개 가능) 엔진: encrypt_file_resumable, decrypt_file_resumable,
+// set_checkpoint_interval (file_crypto.h)을 구현
+
+// encrypt_file_resumable + 평문 SHA-512 (plaintext_digest는 ENC_PLAINTEXT_DIGEST_SIZE, NULL이면 계산하지 않음)
+// 평문은 암호화하면서 같은 읽기에서 해시하고, 이어서 할 때만 앞선 실행이 처리한 앞부분을 다시 읽음
+FILE_CRYPTO_STATUS checkpoint_encrypt_file(const char* input_path, const char* output_path,
+                                           int aes_key_bits, const char* password,
+                                           progress_callback_t progress_cb, void* user_data,
+                                           uint8_t* plaintext_digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_CHECKPOINT_H
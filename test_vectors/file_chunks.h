@@ -0,0 +1,101 @@
+#ifndef FILE_CHUNKS_H
+#define FILE_CHUNKS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "crypto_api.h"
+#include "hmac_sha512.h"
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// v8 청크 레코드 하나의 최대 크기 (메타데이터 + 청크)
+#define FILE_CHUNK_RECORD_SIZE (ENC_CHUNK_META_SIZE + ENC_CHUNK_SIZE)
+
+// 지문 키 길이
+#define FILE_CHUNK_FINGERPRINT_KEY_SIZE 64
+
+/**
+ * @brief 지문 키를 HMAC 키에서 도출합니다 (태그와 다른 키로 지문 계산).
+ * @param hmac_key 파일 HMAC 키 (HMAC_KEY_SIZE)
+ * @param fingerprint_key 출력 지문 키 (FILE_CHUNK_FINGERPRINT_KEY_SIZE)
+ */
+void file_chunk_fingerprint_key(const uint8_t* hmac_key, uint8_t* fingerprint_key);
+
+/**
+ * @brief 청크 평문의 지문을 계산합니다.
+ * @param fingerprint_key 지문 키
+ * @param index 청크 번호
+ * @param data 평문
+ * @param length 평문 길이
+ * @param fingerprint 출력 지문 (ENC_CHUNK_FINGERPRINT_SIZE)
+ * @note 번호를 함께 넣어 같은 내용의 청크도 위치가 다르면 지문이 다릅니다.
+ */
+void file_chunk_fingerprint(const uint8_t* fingerprint_key, uint64_t index, const uint8_t* data, size_t length,
+                            uint8_t* fingerprint);
+
+/**
+ * @brief 청크 nonce를 만듭니다 (실행마다 한 번 만든 임의 nonce 8바이트 || 청크 번호 4바이트 big-endian).
+ * @param run_nonce 이번 갱신의 임의 nonce (ENC_NONCE_SIZE)
+ * @param index 청크 번호 (2^32 미만)
+ * @param nonce 출력 nonce (ENC_CHUNK_NONCE_SIZE)
+ * @note 한 실행 안에서는 번호로, 실행 사이에서는 임의 nonce로 (청크, 내용)마다 다른 키스트림을 씁니다.
+ */
+void file_chunk_make_nonce(const uint8_t* run_nonce, uint64_t index, uint8_t* nonce);
+
+/**
+ * @brief 청크를 암호화하고 태그를 계산합니다 (제자리).
+ * @param aes_ctx AES 컨텍스트
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트 (변경하지 않음)
+ * @param index 청크 번호
+ * @param meta 청크 메타데이터 (nonce, 지문 설정됨, 태그를 기록)
+ * @param data 평문 → 암호문
+ * @param length 청크 길이
+ * @return FILE_CRYPTO_SUCCESS 또는 FILE_CRYPTO_ERR_ENCRYPTION_FAILED
+ */
+FILE_CRYPTO_STATUS file_chunk_seal(const AES_CTX* aes_ctx, const HMAC_SHA512_CTX* header_ctx, uint64_t index,
+                                   EncChunkMeta* meta, uint8_t* data, size_t length);
+
+/**
+ * @brief 청크 태그를 검증하고 복호화합니다 (제자리).
+ * @param aes_ctx AES 컨텍스트
+ * @param header_ctx 헤더까지 업데이트된 HMAC 컨텍스트 (변경하지 않음)
+ * @param index 청크 번호
+ * @param meta 청크 메타데이터
+ * @param data 암호문 → 평문 (태그가 맞지 않으면 내용은 정의되지 않음)
+ * @param length 청크 길이
+ * @return FILE_CRYPTO_SUCCESS, FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 태그 불일치
+ */
+FILE_CRYPTO_STATUS file_chunk_open(const AES_CTX* aes_ctx, const HMAC_SHA512_CTX* header_ctx, uint64_t index,
+                                   const EncChunkMeta* meta, uint8_t* data, size_t length);
+
+// 청크 i의 레코드 위치 (첫 레코드 기준)
+int64_t file_chunk_position(uint64_t index);
+
+// 평문 크기에서 청크 수와 마지막 청크 길이 (빈 입력도 청크 하나)
+void file_chunk_count(int64_t plaintext_size, uint64_t* count, size_t* final_length);
+
+/**
+ * @brief 레코드 영역 크기에서 청크 수와 마지막 청크 길이를 구합니다.
+ * @param record_bytes 루트 태그 뒤 레코드 영역 크기
+ * @param count 출력 청크 수
+ * @param final_length 출력 마지막 청크 길이
+ * @return 1 올바른 구조, 0 마지막 레코드에 메타데이터 자리가 없음 (잘린 파일)
+ */
+int file_chunk_layout(int64_t record_bytes, uint64_t* count, size_t* final_length);
+
+// 레코드 영역의 청크 메타데이터를 모두 읽음 (청크 하나에 위치 지정 읽기 한 번, 암호문은 읽지 않음)
+FILE_CRYPTO_STATUS file_chunks_read_meta(FILE* fin, int64_t records_offset, uint64_t count, EncChunkMeta* metas);
+
+// 루트 태그 계산 (청크 수, 마지막 청크 길이, 모든 청크 태그)
+void file_chunks_root(const HMAC_SHA512_CTX* header_ctx, const EncChunkMeta* metas, uint64_t count,
+                      size_t final_length, uint8_t* root);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_CHUNKS_H
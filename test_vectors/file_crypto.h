@@ -5,18 +5,94 @@
 extern "C" {
 #endif
 
+#include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
 
 // .enc 파일 헤더 구조
 #define ENC_SIGNATURE "AESC"
-#define ENC_VERSION 0x02
+#define ENC_VERSION_LEGACY 0x02      // v2: 키 확인 값 없음, HMAC(헤더 + 평문)
+#define ENC_VERSION_KCV 0x03         // v3: reserved에 키 확인 값(KCV) 저장, HMAC(헤더 + 평문)
+#define ENC_VERSION_ETM 0x04         // v4: KCV + Encrypt-then-MAC, HMAC(헤더 + 암호문)
+#define ENC_VERSION_ALIGNED 0x05     // v5: v4 + 암호문을 4 KiB 경계에서 시작 (O_DIRECT 입출력용)
+#define ENC_VERSION_STREAM 0x06      // v6: 세그먼트 형식, 세그먼트마다 태그 (탐색 없는 스트리밍용)
+#define ENC_VERSION_COMPRESSED 0x07  // v7: v4 + 압축 후 암호화, HMAC(헤더 + 암호문 + 압축 정보)
+#define ENC_VERSION_INCREMENTAL 0x08 // v8: 청크마다 nonce/지문/태그, 바뀐 청크만 다시 암호화 (증분 갱신용)
+#define ENC_VERSION_KEYSLOTS 0x09    // v9: v4 + 무작위 데이터 키를 비밀번호별 키 슬롯에 감싸 저장 (비밀번호 변경 시 슬롯만 다시 기록)
+#define ENC_VERSION_INPLACE 0x0A     // v10: 제자리 암호화, 암호문이 평문 자리에 있고 [헤더 | HMAC]은 파일 끝 (HMAC은 v4와 같음)
+#define ENC_VERSION ENC_VERSION_ETM  // 암호화 시 기록하는 기본 버전
+#define ENC_VERSION_MAX ENC_VERSION_INPLACE  // 복호화할 수 있는 최신 버전
 #define ENC_MODE_CTR 0x02
 #define ENC_HMAC_ENABLED 0x01
 #define ENC_HEADER_SIZE 56
 #define ENC_NONCE_SIZE 8
 #define ENC_SALT_SIZE 16
 #define ENC_HMAC_SIZE 64
+#define ENC_KCV_SIZE 16
+#define ENC_PLAINTEXT_DIGEST_SIZE 64  // 평문 SHA-512 크기 (encrypt_file_with_digest)
+#define ENC_ALIGNED_PAYLOAD_OFFSET 4096  // v5 암호문 시작 오프셋 (헤더 + HMAC 뒤는 0으로 채움)
+
+// v6 세그먼트 형식: 헤더 뒤에 [암호문 세그먼트 | 태그(ENC_HMAC_SIZE)]가 반복됨
+// 마지막 세그먼트만 ENC_SEGMENT_SIZE보다 짧음 (입력이 세그먼트 크기의 배수면 0바이트 세그먼트)
+// 태그 = HMAC(헤더 || 세그먼트 번호(8바이트 big-endian) || 마지막 여부(1바이트) || 암호문)
+#define ENC_SEGMENT_SIZE (1024 * 1024)
+
+// v6 추가 저널 (경로 + ENC_APPEND_JOURNAL_SUFFIX): [레코드 | 추가 전 마지막 세그먼트의 암호문과 태그]
+// 마지막 세그먼트를 다시 쓰기 전에 디스크에 반영하고, 추가가 끝나면 삭제 (중단되면 다음 추가가 꼬리를 되돌림)
+#define ENC_APPEND_JOURNAL_SIGNATURE "AEST"
+#define ENC_APPEND_JOURNAL_SUFFIX ".aest"
+
+// v7 압축 형식: [헤더 | HMAC | 압축 정보 24바이트 | 암호문], 암호문은 lz_codec 프레임 스트림의 CTR 암호문
+// 압축 정보는 암호문을 다 쓴 뒤에 크기가 정해지므로 HMAC에서 암호문 다음에 들어감
+#define ENC_CODEC_LZ 0x01                 // LZ4 블록 형식 프레임 (lz_codec.h)
+#define ENC_COMPRESSION_INFO_SIZE 24
+
+// v8 증분 형식: [헤더 | 루트 태그(ENC_HMAC_SIZE)] 뒤에 [청크 메타데이터 | 암호문 청크] 레코드가 반복됨
+// 마지막 청크만 ENC_CHUNK_SIZE보다 짧음 (빈 입력은 0바이트 청크 하나), 청크 i의 위치는 i로 바로 계산
+// 지문 = HMAC(지문 키, 청크 번호 || 평문)의 앞 32바이트 (키 없이는 평문을 추측해 맞춰 볼 수 없음)
+// 청크 태그 = HMAC(헤더 || 청크 번호(8바이트 big-endian) || nonce || 지문 || 암호문)
+// 루트 태그 = HMAC(헤더 || 청크 수 || 마지막 청크 길이 || 청크 태그...): 재배치, 잘림, 중단된 갱신 검출
+#define ENC_CHUNK_SIZE (64 * 1024)
+#define ENC_CHUNK_NONCE_SIZE 12
+#define ENC_CHUNK_FINGERPRINT_SIZE 32
+#define ENC_CHUNK_META_SIZE 112
+
+// v9 키 슬롯 형식: [헤더 | HMAC | 키 슬롯 ENC_KEY_SLOT_COUNT개 | 암호문], HMAC(헤더 + 암호문)은 v4와 같음
+// 데이터 키(AES 32바이트 + HMAC 24바이트)는 무작위, 헤더의 KCV는 데이터 키로 계산하고 salt는 0
+// 슬롯 = 슬롯마다 salt로 비밀번호에서 도출한 키로 데이터 키를 CTR 암호화 + 슬롯 태그
+// 슬롯 태그 = HMAC(슬롯 HMAC 키, 헤더 || 슬롯 번호(1바이트) || 슬롯 앞 80바이트)의 앞 32바이트
+// 슬롯은 HMAC에 들어가지 않으므로 비밀번호를 바꿔도 헤더, HMAC, 암호문은 그대로 (enc_rekey, key_slots.h)
+#define ENC_KEY_SLOT_COUNT 4
+#define ENC_KEY_SLOT_SIZE 112
+#define ENC_DATA_KEY_SIZE (32 + HMAC_KEY_SIZE)
+#define ENC_KEY_SLOT_EMPTY 0x00
+#define ENC_KEY_SLOT_ACTIVE 0x01
+
+// v10 제자리 형식: [암호문 | 헤더 | HMAC], 파일 앞에 시그니처가 없으면 끝의 트레일러를 헤더로 읽음
+// 변환 중에는 저널(경로 + ENC_INPLACE_JOURNAL_SUFFIX)에 진행 위치와 진행 중인 청크의 섹터 지문을 기록
+// 저널은 기록이 찢어져도 직전 레코드가 남도록 두 자리에 번갈아 기록하고, 작업이 끝나면 삭제
+#define ENC_INPLACE_TRAILER_SIZE (ENC_HEADER_SIZE + ENC_HMAC_SIZE)
+#define ENC_INPLACE_CHUNK_SIZE (4 * 1024 * 1024)   // 저널 기록 단위 (청크마다 데이터와 저널을 디스크에 반영)
+#define ENC_INPLACE_SECTOR_SIZE 4096               // 중단 시 변환 여부를 판별하는 단위
+#define ENC_INPLACE_SECTOR_COUNT (ENC_INPLACE_CHUNK_SIZE / ENC_INPLACE_SECTOR_SIZE)
+#define ENC_INPLACE_FINGERPRINT_SIZE 8
+#define ENC_INPLACE_JOURNAL_SIGNATURE "AESJ"
+#define ENC_INPLACE_JOURNAL_SUFFIX ".aesj"
+#define ENC_INPLACE_ENCRYPT 0x01
+#define ENC_INPLACE_DECRYPT 0x02
+#define ENC_INPLACE_ROLLBACK 0x01                  // 저널 flags: 중단된 작업을 되돌리는 중
+
+// 체크포인트: 이어서 할 수 있는 암호화/복호화 (v4/v5/v9/v10, 파일 형식은 그대로)
+// 기록 중인 파일 옆의 체크포인트 파일(경로 + ENC_CHECKPOINT_SUFFIX)에 주기적으로 진행 위치, CTR 카운터,
+// HMAC 내부 해시 중간 상태를 파일 키에서 도출한 키로 암호화해 기록 (기록 전에 출력을 디스크에 반영)
+// 두 자리에 번갈아 기록하고 태그로 확인하므로 기록 도중 중단되어도 직전 체크포인트가 남음
+#define ENC_CHECKPOINT_SIGNATURE "AESK"
+#define ENC_CHECKPOINT_SUFFIX ".aesc"
+#define ENC_CHECKPOINT_PART_SUFFIX ".part"                    // 복호화 출력 스테이징 파일 (HMAC 검증 후 rename)
+#define ENC_CHECKPOINT_INTERVAL ((int64_t)256 * 1024 * 1024)  // 기본 체크포인트 간격
+#define ENC_CHECKPOINT_STATE_SIZE 256
+#define ENC_CHECKPOINT_ENCRYPT 0x01
+#define ENC_CHECKPOINT_DECRYPT 0x02
 
 // 키 길이 코드 상수
 #define KEY_LENGTH_CODE_128 0x01
@@ -70,24 +146,115 @@ typedef enum {
     
     // 입력 검증 에러
     FILE_CRYPTO_ERR_INVALID_PASSWORD,            // 잘못된 비밀번호: 비밀번호 형식이 올바르지 않음 (validate_password 실패)
-    FILE_CRYPTO_ERR_INVALID_INPUT               // 잘못된 입력: 함수 파라미터가 NULL이거나 유효하지 않음
+    FILE_CRYPTO_ERR_INVALID_INPUT,              // 잘못된 입력: 함수 파라미터가 NULL이거나 유효하지 않음
+    
+    // 키 확인 에러 (기존 코드 값이 바뀌지 않도록 끝에 추가)
+    FILE_CRYPTO_ERR_KEY_CHECK_FAILED             // 키 확인 값 불일치: 헤더의 KCV와 도출한 키가 맞지 않음 (잘못된 비밀번호)
 } FILE_CRYPTO_STATUS;
 
 // 헤더 구조
 typedef struct {
     uint8_t signature[4];      // [0:4] "AESC"
-    uint8_t version;           // [4:5] 0x02 (current)
+    uint8_t version;           // [4:5] 0x02=legacy, 0x03=KCV, 0x04=EtM (current), 0x05=aligned, 0x06=segmented, 0x07=compressed, 0x08=incremental, 0x09=key slots, 0x0A=in-place (trailer)
     uint8_t key_length_code;   // [5:6] 0x01=128, 0x02=192, 0x03=256
     uint8_t mode_code;         // [6:7] 0x02=CTR
     uint8_t hmac_enabled;      // [7:8] 0x01=enabled
     uint8_t nonce[8];          // [8:16] Nonce
     uint8_t format[8];         // [16:24] Original file extension/signature (e.g., ".hwp", ".png", ".jpeg", ".txt")
-    uint8_t salt[16];          // [24:40] PBKDF2 salt (16 bytes)
-    uint8_t reserved[16];      // [40:56] Reserved for future use
+    uint8_t salt[16];          // [24:40] PBKDF2 salt (16 bytes, v9: zero, each key slot has its own salt)
+    uint8_t reserved[16];      // [40:56] v3+: key check value (KCV), v2: zero
 } EncFileHeader;
 
-// 진행률 콜백 함수 타입
-typedef void (*progress_callback_t)(long processed, long total, void* user_data);
+// v7 압축 정보 (HMAC 다음, 평문으로 저장하지만 HMAC으로 인증)
+typedef struct {
+    uint8_t codec;             // [0:1] ENC_CODEC_LZ
+    uint8_t reserved[7];       // [1:8] 0
+    uint8_t original_size[8];  // [8:16] 원본 크기 (big-endian)
+    uint8_t stored_size[8];    // [16:24] 압축 스트림(= 암호문) 크기 (big-endian)
+} EncCompressionInfo;
+
+// v8 청크 메타데이터 (암호문 청크 바로 앞)
+typedef struct {
+    uint8_t nonce[ENC_CHUNK_NONCE_SIZE];              // [0:12] 청크 CTR nonce (카운터 = nonce || 0 4바이트)
+    uint8_t reserved[4];                              // [12:16] 0
+    uint8_t fingerprint[ENC_CHUNK_FINGERPRINT_SIZE];  // [16:48] 평문 지문
+    uint8_t tag[ENC_HMAC_SIZE];                       // [48:112] 청크 태그
+} EncChunkMeta;
+
+// v9 키 슬롯 (HMAC 다음에 ENC_KEY_SLOT_COUNT개)
+typedef struct {
+    uint8_t state;                             // [0:1] ENC_KEY_SLOT_ACTIVE 또는 ENC_KEY_SLOT_EMPTY (빈 슬롯은 전부 0)
+    uint8_t reserved[7];                       // [1:8] 0
+    uint8_t salt[ENC_SALT_SIZE];               // [8:24] 이 슬롯의 PBKDF2 salt
+    uint8_t wrapped_key[ENC_DATA_KEY_SIZE];    // [24:80] 슬롯 키로 암호화한 데이터 키
+    uint8_t tag[32];                           // [80:112] 슬롯 태그
+} EncKeySlot;
+
+// v10 제자리 작업 저널 레코드 (저널 파일의 두 자리 중 sequence가 큰 유효한 레코드가 현재 상태)
+typedef struct {
+    uint8_t signature[4];                          // [0:4] "AESJ"
+    uint8_t operation;                             // [4:5] ENC_INPLACE_ENCRYPT 또는 ENC_INPLACE_DECRYPT (이번 실행의 변환 방향)
+    uint8_t flags;                                 // [5:6] ENC_INPLACE_ROLLBACK
+    uint8_t reserved[2];                           // [6:8] 0
+    uint8_t sequence[8];                           // [8:16] 기록 순번 (big-endian)
+    uint8_t data_size[8];                          // [16:24] 변환할 앞부분 크기 (big-endian)
+    uint8_t done[8];                               // [24:32] 변환을 마친 크기 (big-endian, 청크 경계)
+    EncFileHeader header;                          // [32:88] 파일 헤더 (같은 salt와 nonce로 이어서 변환)
+    uint8_t hmac[ENC_HMAC_SIZE];                   // [88:152] 복호화: 검증한 HMAC (되돌릴 때 트레일러를 다시 기록)
+    uint8_t sectors[ENC_INPLACE_SECTOR_COUNT][ENC_INPLACE_FINGERPRINT_SIZE];  // [152:8344] done 위치 청크의 변환 전 섹터 지문
+    uint8_t tag[32];                               // [8344:8376] HMAC(HMAC 키, 앞부분)의 앞 32바이트
+} EncInPlaceJournal;
+
+// v6 추가 저널 레코드 (뒤에 file_size - tail_offset바이트의 기존 꼬리가 따름)
+typedef struct {
+    uint8_t signature[4];                          // [0:4] "AEST"
+    uint8_t reserved[4];                           // [4:8] 0
+    uint8_t file_size[8];                          // [8:16] 추가 전 파일 크기 (big-endian)
+    uint8_t tail_offset[8];                        // [16:24] 마지막 세그먼트 위치 (big-endian)
+    uint8_t tag[32];                               // [24:56] HMAC(HMAC 키, 앞부분 || 꼬리)의 앞 32바이트
+} EncAppendJournal;
+
+// 체크포인트 레코드 (체크포인트 파일의 두 자리 중 sequence가 큰 유효한 레코드가 현재 상태)
+// 상태(평문): 입력 크기, 처리한 크기, CTR 카운터, HMAC 내부 SHA-512 상태/비트 길이/버퍼 (정수는 big-endian)
+typedef struct {
+    uint8_t signature[4];                          // [0:4] "AESK"
+    uint8_t operation;                             // [4:5] ENC_CHECKPOINT_ENCRYPT 또는 ENC_CHECKPOINT_DECRYPT
+    uint8_t reserved[3];                           // [5:8] 0
+    uint8_t sequence[8];                           // [8:16] 기록 순번 (big-endian)
+    EncFileHeader header;                          // [16:72] 암호화 파일 헤더 (체크포인트가 속한 파일 확인)
+    uint8_t iv[16];                                // [72:88] 상태 암호화 CTR 초기값 (기록마다 새로 생성)
+    uint8_t state[ENC_CHECKPOINT_STATE_SIZE];      // [88:344] 암호화된 진행 상태
+    uint8_t tag[32];                               // [344:376] HMAC(HMAC 키, 앞부분)의 앞 32바이트
+} EncCheckpoint;
+
+// 증분 암호화 결과 (encrypt_file_incremental)
+typedef struct {
+    uint64_t chunk_count;        // 입력의 청크 수
+    uint64_t chunks_written;     // 새로 암호화해 기록한 청크 수 (나머지는 지문이 같아 그대로 둠)
+    int full_rewrite;            // 1이면 기존 출력을 재사용하지 못해 모든 청크를 암호화함
+} EncIncrementalStats;
+
+// 파일 I/O 모드
+typedef enum {
+    FILE_IO_MODE_AUTO = 0,       // 자동: 큰 파일이면 CPU 2개 이상은 파이프라인, 1개는 메모리 매핑, 작은 파일은 단일 스레드
+    FILE_IO_MODE_SERIAL,         // 단일 스레드: 읽기 → 연산 → 쓰기를 한 버퍼로 순차 처리
+    FILE_IO_MODE_PIPELINED,      // 파이프라인: 읽기/CTR/HMAC/쓰기 단계를 별도 스레드에서 겹쳐 처리
+    FILE_IO_MODE_MMAP,           // 메모리 매핑: 입력/출력 페이지에서 바로 처리 (매핑 불가 시 단일 스레드)
+    FILE_IO_MODE_IO_URING,       // io_uring 비동기 I/O (Linux, 미지원 시 단일 스레드)
+    FILE_IO_MODE_DIRECT          // io_uring + O_DIRECT, 암호화는 v5(정렬) 형식으로 기록 (페이지 캐시 우회)
+} FILE_IO_MODE;
+
+// 파일 암호화 형식
+typedef enum {
+    ENC_FORMAT_DEFAULT = 0,      // 단일 HMAC (v4, FILE_IO_MODE_DIRECT에서는 v5)
+    ENC_FORMAT_SEGMENTED,        // v6 세그먼트별 태그: 암호화/검증/복호화를 세그먼트 단위로 여러 코어에서 병렬 처리
+    ENC_FORMAT_COMPRESSED,       // v7 압축 후 암호화: 로그/CSV 등 압축되는 입력의 암호문 크기를 줄임 (압축되지 않는 블록은 그대로 저장)
+    ENC_FORMAT_INCREMENTAL,      // v8 증분: 출력이 같은 비밀번호의 v8 파일이면 지문이 바뀐 청크만 다시 암호화
+    ENC_FORMAT_KEYSLOTS          // v9 키 슬롯: 비밀번호 변경/추가/삭제가 파일 크기와 무관하게 슬롯 하나만 다시 기록
+} ENC_FORMAT;
+
+// 진행률 콜백 함수 타입 (바이트 단위, 2 GiB 넘는 파일도 표현하도록 64비트)
+typedef void (*progress_callback_t)(int64_t processed, int64_t total, void* user_data);
 
 // 파일 암호화
 int encrypt_file(const char* input_path, const char* output_path,
@@ -98,6 +265,20 @@ int encrypt_file_with_progress(const char* input_path, const char* output_path,
                                int aes_key_bits, const char* password,
                                progress_callback_t progress_cb, void* user_data);
 
+// 파일 암호화 + 평문 SHA-512: encrypt_file_with_progress와 같은 파일을 만들면서 같은 패스에서 입력을 해시
+// plaintext_digest(ENC_PLAINTEXT_DIGEST_SIZE)는 sha512sum 결과와 같고 성공 시에만 유효
+// v6 형식은 세그먼트를 읽은 스레드가 번호 순서대로 해시에 넣고 암호화는 여러 스레드에서 겹쳐 실행
+int encrypt_file_with_digest(const char* input_path, const char* output_path,
+                             int aes_key_bits, const char* password,
+                             progress_callback_t progress_cb, void* user_data,
+                             uint8_t* plaintext_digest);
+
+// 증분 암호화 (v8): 출력이 같은 비밀번호와 키 길이의 v8 파일이면 지문이 바뀐 청크만 새 nonce로 다시 암호화해
+// 제자리에 기록 (나머지 청크는 읽지도 쓰지도 않음), 아니면 새로 만듦. stats는 NULL 가능
+// 갱신이 중단된 파일은 루트 태그가 맞지 않아 복호화가 거부되고, 다음 실행이 모든 청크를 다시 암호화함
+int encrypt_file_incremental(const char* input_path, const char* output_path,
+                             int aes_key_bits, const char* password, EncIncrementalStats* stats);
+
 // 파일 복호화
 int decrypt_file(const char* input_path, const char* output_path,
                  const char* password, char* final_output_path, size_t final_path_size);
@@ -107,6 +288,146 @@ int decrypt_file_with_progress(const char* input_path, const char* output_path,
                                const char* password, char* final_output_path, size_t final_path_size,
                                progress_callback_t progress_cb, void* user_data);
 
+// 스트림 암호화 (v6 세그먼트 형식, 탐색 없이 순차 읽기/쓰기: stdin/stdout, 파이프, 소켓)
+// 메모리 사용은 세그먼트 하나 크기로 고정, 메시지는 출력하지 않음
+int encrypt_stream(FILE* in, FILE* out, int aes_key_bits, const char* password);
+
+// 스트림 복호화 (v6만 지원, 세그먼트마다 태그를 검증한 뒤 평문 출력)
+// 실패 시 0을 반환하며, 그때까지 출력된 평문은 검증을 통과한 앞부분 세그먼트임
+int decrypt_stream(FILE* in, FILE* out, const char* password);
+
+// 추가 암호화 (v6): path의 v6 파일 끝에 data를 이어 붙임, 파일이 없으면 aes_key_bits로 새로 만듦
+// 마지막 세그먼트의 태그를 검증한 뒤 그 세그먼트의 새 바이트와 새 세그먼트만 기록하므로 비용은 기존 크기와 무관
+// 마지막 세그먼트를 다시 쓰기 전에 기존 꼬리를 저널에 보관하고, 파일을 디스크에 반영한 뒤 성공을 반환
+// 기록 도중 중단된 파일은 다음 추가(빈 데이터도 가능)가 저널로 추가 전 상태로 되돌린 뒤 이어 붙임
+FILE_CRYPTO_STATUS encrypt_append(const char* path, const void* data, size_t length,
+                                  int aes_key_bits, const char* password);
+
+// 스트림 추가 암호화: in을 끝까지 읽어 encrypt_append와 같이 이어 붙임 (stdin 파이프용)
+FILE_CRYPTO_STATUS encrypt_append_stream(const char* path, FILE* in, int aes_key_bits, const char* password);
+
+// 제자리 암호화 (v10): path의 평문을 청크마다 같은 자리의 암호문으로 덮어쓰고 끝에 [헤더 | HMAC]을 붙임
+// 두 번째 파일을 만들지 않으므로 추가 공간은 트레일러와 저널뿐, 파일 이름은 바꾸지 않음
+// 저널이 남아 있으면 (중단된 실행) 같은 비밀번호로 이어서 변환. progress_cb는 NULL 가능
+// 이미 암호화된 파일 (v10 트레일러 또는 앞에 시그니처가 있는 파일)은 FILE_CRYPTO_ERR_UNSUPPORTED_VERSION
+FILE_CRYPTO_STATUS encrypt_file_in_place(const char* path, int aes_key_bits, const char* password,
+                                         progress_callback_t progress_cb, void* user_data);
+
+// 제자리 복호화 (v10만): 전체 HMAC을 먼저 검증한 뒤 청크마다 평문으로 덮어쓰고 트레일러를 잘라냄
+// extension은 헤더에 기록된 원본 확장자 (NULL 가능, 8바이트 이상), 중단된 실행은 encrypt_file_in_place와 같이 이어서 변환
+FILE_CRYPTO_STATUS decrypt_file_in_place(const char* path, const char* password, char* extension, size_t extension_size,
+                                         progress_callback_t progress_cb, void* user_data);
+
+// 중단된 제자리 작업을 되돌림 (저널의 진행 위치까지 반대로 변환해 시작 전 파일로 복원하고 저널 삭제)
+// 저널이 없으면 FILE_CRYPTO_ERR_FILE_OPEN
+FILE_CRYPTO_STATUS enc_in_place_rollback(const char* path, const char* password);
+
+// path에 중단된 제자리 작업의 저널이 있으면 1
+int enc_in_place_pending(const char* path);
+
+// path가 변환을 마친 v10 파일이면 1 (저널이 남아 있으면 0, 이름 변경 전에 중단된 암호화 확인용)
+int enc_in_place_encrypted(const char* path);
+
+// 체크포인트 암호화 (v4): encrypt_file과 같은 파일을 만들면서 주기적으로 체크포인트를 기록
+// output_path의 체크포인트가 남아 있으면 (중단된 실행) 마지막 체크포인트 직전 구간을 입력에서 다시 암호화해
+// 출력과 비교한 뒤 그 위치부터 이어서 암호화 (키 길이는 남은 출력의 헤더를 따름)
+// 입력이 바뀌었거나 체크포인트가 손상되었으면 처음부터 다시 암호화, 다른 비밀번호면 FILE_CRYPTO_ERR_KEY_CHECK_FAILED
+// 이어서 할 때는 체크포인트 직전 구간만 다시 확인하고 HMAC 중간 상태를 이어 쓰므로,
+// 중단 중에 손상된 출력 앞부분은 여기서 감지되지 않고 복호화(검증) 시 HMAC 불일치로 거부됨
+// progress_cb가 NULL이면 진행률과 메시지를 출력
+FILE_CRYPTO_STATUS encrypt_file_resumable(const char* input_path, const char* output_path,
+                                          int aes_key_bits, const char* password,
+                                          progress_callback_t progress_cb, void* user_data);
+
+// 체크포인트 복호화 (v4/v5/v9/v10): 최종 경로 + ENC_CHECKPOINT_PART_SUFFIX에 복호화하면서 암호문 HMAC을 계산하고,
+// 끝에서 HMAC이 맞을 때만 최종 경로로 rename (맞지 않으면 스테이징 파일 삭제)
+// 체크포인트가 남아 있으면 encrypt_file_resumable과 같이 확인한 뒤 이어서 복호화
+// final_output_path는 decrypt_file과 같음 (progress_cb가 있으면 실패 시 원인 메시지)
+// 주의: 중단되면 스테이징 파일에 검증 전 평문이 남음 (복호화 전에 검증하려면 verify_file 후 decrypt_file 사용)
+// HMAC은 암호문에 대한 것이므로 이어서 할 때 스테이징 파일에 이미 쓴 평문 앞부분의 손상은 감지하지 못함
+FILE_CRYPTO_STATUS decrypt_file_resumable(const char* input_path, const char* output_path,
+                                          const char* password, char* final_output_path, size_t final_path_size,
+                                          progress_callback_t progress_cb, void* user_data);
+
+// 체크포인트 간격 설정 (바이트, 0 이하면 기본값 ENC_CHECKPOINT_INTERVAL)
+void set_checkpoint_interval(int64_t bytes);
+
+// 임의 위치 복호화 읽기 핸들 (키 도출은 enc_open에서 한 번, AES 컨텍스트를 핸들에 보관)
+// 무결성: v6은 읽는 세그먼트마다, v8은 enc_open에서 루트 태그 후 읽는 청크마다 태그 검증,
+// v2~v5, v7은 전체 HMAC 하나뿐이므로 enc_open에서 한 번 검증
+// 한 핸들을 여러 스레드에서 동시에 사용하지 않음 (스레드마다 enc_open)
+typedef struct EncReader EncReader;
+
+// 실패(파일/형식 오류, 잘못된 비밀번호, 무결성 실패) 시 NULL, 메시지는 출력하지 않음
+EncReader* enc_open(const char* path, const char* password);
+
+// 평문 offset부터 최대 len 바이트를 buf에 복호화 (필요한 암호문만 읽음)
+// 읽은 바이트 수 반환 (offset이 끝 이후면 0), 읽기 오류나 세그먼트 태그 불일치 시 -1
+int64_t enc_pread(EncReader* reader, void* buf, size_t len, int64_t offset);
+
+// 평문 전체 크기
+int64_t enc_size(const EncReader* reader);
+
+void enc_close(EncReader* reader);
+
+// 평문을 쓰지 않고 비밀번호와 무결성만 확인 (v6은 모든 세그먼트 태그를 여러 코어에서 검증)
+// 1 검증 성공, 0 실패, 메시지는 출력하지 않음
+int verify_file(const char* input_path, const char* password);
+
+// verify_file과 같은 검증 (복호화한 평문은 메모리에서 버리고 디스크에 아무것도 쓰지 않음)
+// 실패 원인을 반환: FILE_CRYPTO_ERR_KEY_CHECK_FAILED 잘못된 비밀번호,
+// FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED 손상/변조, 그 외 파일/형식 오류 (메시지는 출력하지 않음)
+// progress_cb의 전체 크기는 암호화 파일 크기
+FILE_CRYPTO_STATUS verify_file_with_progress(const char* input_path, const char* password,
+                                             progress_callback_t progress_cb, void* user_data);
+
+// 파일 배치 작업 종류
+typedef enum {
+    FILE_BATCH_ENCRYPT = 0,      // encrypt_file과 같은 결과 (형식은 set_encryption_format 설정)
+    FILE_BATCH_DECRYPT,          // decrypt_file과 같은 결과
+    FILE_BATCH_VERIFY            // verify_file_with_progress와 같은 결과 (출력 없음, 실패 원인은 final_path)
+} FILE_BATCH_OP;
+
+// 배치 항목
+typedef struct {
+    const char* input_path;              // 입력 파일 경로
+    const char* output_path;             // 출력 경로 (복호화는 기본 경로, 검증은 사용하지 않음)
+    char final_path[MAX_PATH_LENGTH];    // [out] 복호화 성공 시 확장자 포함 경로, 복호화/검증 실패 시 원인 메시지 (비어 있을 수 있음)
+    int result;                          // [out] 1 성공, 0 실패
+    uint8_t plaintext_digest[ENC_PLAINTEXT_DIGEST_SIZE];  // [out] 암호화 성공 시 평문 SHA-512 (job의 plaintext_digest가 1일 때)
+} FileBatchItem;
+
+// 항목 완료 콜백 (작업 스레드에서 호출되지만 콜백끼리, 진행률 콜백과도 겹치지 않음)
+typedef void (*batch_item_callback_t)(size_t index, const FileBatchItem* item, void* user_data);
+
+// 파일 배치 작업 설명
+typedef struct {
+    FILE_BATCH_OP op;                    // 작업 종류
+    int aes_key_bits;                    // 암호화 키 길이 (128, 192, 256)
+    const char* password;                // 모든 파일에 공통인 비밀번호
+    FileBatchItem* items;                // 항목 목록
+    size_t count;                        // 항목 수
+    int thread_count;                    // 작업 스레드 수 (0 이하면 CPU 수)
+    progress_callback_t on_progress;     // 배치 전체 진행률 (입력 바이트 기준, NULL 가능)
+    batch_item_callback_t on_item_done;  // 항목 완료 콜백 (NULL 가능)
+    void* user_data;                     // 콜백에 전달할 사용자 데이터
+    int resumable;                       // 1이면 encrypt_file_resumable/decrypt_file_resumable로 처리 (검증은 무시)
+    int plaintext_digest;                // 1이면 암호화하면서 항목의 plaintext_digest 계산 (복호화/검증은 무시)
+                                         // (v6 파일은 해시가 순서대로 쌓이도록 세그먼트 범위로 나누지 않음)
+} FileBatchJob;
+
+// 여러 파일을 작업 훔치기(work-stealing) 스케줄러로 처리하고 성공한 항목 수를 반환
+// 작업 스레드마다 덱을 두고 파일 하나를 작업 하나로 넣으며, v6 파일은 세그먼트 범위 작업으로 나눠
+// 다른 스레드가 훔쳐 가므로 큰 파일 하나가 나머지 파일을 막지 않고 모든 코어를 사용함
+// 메시지는 출력하지 않음
+size_t process_file_batch(FileBatchJob* job);
+
+// 파일 I/O 모드 설정 (기본값 FILE_IO_MODE_AUTO, 출력 결과는 모드와 무관하게 동일)
+void set_file_io_mode(FILE_IO_MODE mode);
+
+// 파일 암호화 형식 설정 (기본값 ENC_FORMAT_DEFAULT, 복호화는 헤더 버전으로 자동 판별)
+void set_encryption_format(ENC_FORMAT format);
+
 // 헤더에서 AES 키 길이 읽기
 int read_aes_key_length(const char* input_path);
 
@@ -0,0 +1,71 @@
+#ifndef FILE_CRYPTO_INTERNAL_H
+#define FILE_CRYPTO_INTERNAL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// cli.c의 파일 형식 공통 함수 (file_inplace.c, file_checkpoint.c에서 사용, 외부 API 아님)
+
+// 청크 크기 정의 (1MB - 성능 최적화)
+#define FILE_CHUNK_SIZE (1024 * 1024)
+
+// show_error가 0이 아니면 [ERROR] 접두사와 함께 stderr로 / 정보 메시지를 stdout으로 출력
+void log_error(int show_error, const char* format, ...);
+void log_info(int show_error, const char* format, ...);
+
+// 진행률 갱신 (progress_cb가 있으면 콜백, 없으면 진행 막대 출력)
+void update_progress_with_callback(int64_t processed, int64_t total,
+                                   progress_callback_t progress_cb, void* user_data,
+                                   const char* operation, int update_interval);
+
+// 암호화 파일 헤더 생성 (input_path의 확장자를 format에 기록, key_check는 reserved에 저장)
+FILE_CRYPTO_STATUS create_encryption_header(const char* input_path, int aes_key_bits,
+                                             const uint8_t* salt, const uint8_t* nonce,
+                                             const uint8_t* key_check, uint8_t version,
+                                             EncFileHeader* header);
+
+// 헤더를 읽고 검증 (ciphertext_size는 헤더와 HMAC을 뺀 크기, v10은 트레일러에서 읽음)
+FILE_CRYPTO_STATUS read_and_validate_header(FILE* fin, EncFileHeader* header, int64_t* file_size, 
+                                             int64_t* ciphertext_size, int show_error);
+
+// 저장된 HMAC, 키 길이, salt를 읽음 (salt는 헤더 내부를 가리킴)
+FILE_CRYPTO_STATUS read_encryption_metadata(FILE* fin, const EncFileHeader* header,
+                                             uint8_t* stored_hmac, int* aes_key_bits,
+                                             const uint8_t** pbkdf2_salt, size_t* pbkdf2_salt_len,
+                                             int show_error);
+
+// 복호화 키 도출 (v9는 키 슬롯에서 데이터 키를 꺼내고, 그 외는 비밀번호에서 바로 도출)
+void derive_file_keys(FILE* fin, const EncFileHeader* header, const char* password, int aes_key_bits,
+                      const uint8_t* pbkdf2_salt, size_t pbkdf2_salt_len,
+                      uint8_t* aes_key, uint8_t* hmac_key);
+
+// 헤더 버전에 따른 암호문 시작 오프셋
+int64_t enc_payload_offset(const EncFileHeader* header);
+
+// 헤더에 저장된 원본 확장자를 붙여 실제 출력 경로를 만듦 (final_output_path는 NULL 가능)
+void resolve_decrypted_output_path(const char* output_path, const EncFileHeader* header,
+                                   char* actual_output_path, size_t actual_path_size,
+                                   char* final_output_path, size_t final_path_size);
+
+// 헤더의 키 확인 값(KCV)으로 비밀번호 검증 (v2는 KCV가 없으므로 FILE_CRYPTO_SUCCESS)
+FILE_CRYPTO_STATUS verify_key_check_value(const EncFileHeader* header, const uint8_t* hmac_key,
+                                          int show_error);
+
+// 헤더의 키 길이 코드 → AES 키 길이 (알 수 없는 코드면 0)
+int enc_header_key_bits(const EncFileHeader* header);
+
+// 64비트 값을 big-endian 8바이트로 저장 / 읽기
+void enc_store_be64(uint8_t* out, uint64_t value);
+uint64_t enc_load_be64(const uint8_t* in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_CRYPTO_INTERNAL_H
@@ -0,0 +1,23 @@
+#ifndef FILE_INPLACE_H
+#define FILE_INPLACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "file_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 제자리 암호화 (v10) 엔진: encrypt_file_in_place, decrypt_file_in_place, enc_in_place_rollback,
+// enc_in_place_pending, enc_in_place_encrypted (file_crypto.h)를 구현
+
+// v10 파일의 트레일러에서 헤더를 읽음 (파일 앞에 시그니처가 없을 때, fin의 위치는 바뀌지 않음)
+// 1 v10 트레일러, 0 아님
+int in_place_read_trailer(FILE* fin, int64_t file_size, EncFileHeader* header);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILE_INPLACE_H
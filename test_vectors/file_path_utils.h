@@ -18,6 +18,11 @@ void build_output_path(char* output_path, size_t output_size,
                        const char* save_path, const char* file_name,
                        const char* extension);
 
+// 파일 경로를 디렉토리와 확장자를 뺀 파일명으로 분리 (예: "dir/photo.png" -> "dir", "photo")
+// 구분자가 없으면 디렉토리는 "." (현재 디렉토리), 버퍼가 작으면 빈 문자열
+void split_file_path(const char* file_path, char* dir, size_t dir_size,
+                     char* stem, size_t stem_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,6 @@
 #include "key_derivation.h"
 #include "kdf.h"
+#include "hmac_sha512.h"
 #include <string.h>
 
 // PBKDF2 반복 횟수
@@ -11,6 +12,9 @@
 // KDF 출력에서 HMAC 키 시작 오프셋
 #define KDF_AES_KEY_OFFSET 32
 
+// KCV 계산용 레이블 (파일 HMAC 입력은 "AESC" 헤더로 시작하므로 도메인이 겹치지 않음)
+static const char KCV_LABEL[] = "AES file key check value";
+
 // 키 도출: PBKDF2-SHA512 -> AES 키 + HMAC 키
 void derive_keys(const char* password, int aes_key_bits,
                  const uint8_t* salt, size_t salt_len,
@@ -28,3 +32,12 @@ void derive_keys(const char* password, int aes_key_bits,
     memcpy(hmac_key, kdf_output + KDF_AES_KEY_OFFSET, HMAC_KEY_SIZE);
 }
 
+
+// 키 확인 값(KCV) 계산: HMAC-SHA512(hmac_key, 레이블)의 앞부분
+void derive_key_check_value(const uint8_t* hmac_key, uint8_t* kcv, size_t kcv_len) {
+    uint8_t mac[HMAC_SHA512_DIGEST_SIZE];
+    hmac_sha512(hmac_key, HMAC_KEY_SIZE, (const uint8_t*)KCV_LABEL, sizeof(KCV_LABEL) - 1, mac);
+    
+    if (kcv_len > sizeof(mac)) kcv_len = sizeof(mac);
+    memcpy(kcv, mac, kcv_len);
+}
@@ -0,0 +1,219 @@
+#include "lz_codec.h"
+#include <string.h>
+
+#define LZ_MIN_MATCH 4             // 최소 일치 길이
+#define LZ_LAST_LITERALS 5         // 블록 끝 5바이트는 항상 리터럴 (LZ4 형식 규칙)
+#define LZ_MATCH_FIND_LIMIT 12     // 마지막 일치는 블록 끝 12바이트 전에 시작해야 함
+#define LZ_MAX_DISTANCE 65535      // 오프셋 2바이트
+#define LZ_HASH_LOG 12             // 해시 테이블 4096칸 (스택 16 KiB)
+#define LZ_SKIP_TRIGGER 6          // 일치 없이 2^6번 탐색할 때마다 탐색 간격 1 증가
+
+// 압축 결과가 원본보다 1/LZ_MIN_SAVING_DIVISOR 이상 줄지 않으면 원본 그대로 저장
+#define LZ_MIN_SAVING_DIVISOR 16
+
+// 연속으로 압축되지 않은 블록이 있을 때 시도 없이 건너뛸 블록 수 상한 (2^5 - 1 = 31블록, 약 2 MiB)
+#define LZ_MAX_SKIP_SHIFT 5
+
+static uint32_t lz_read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t lz_hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_LOG);
+}
+
+/**
+ * @brief 리터럴 길이나 일치 길이의 15 이상 부분을 255 단위로 기록합니다.
+ * @param op 출력 위치
+ * @param length 토큰 니블(15)을 뺀 나머지 길이
+ * @return 다음 출력 위치
+ */
+static uint8_t* lz_write_length(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+/**
+ * @brief 시퀀스 하나(리터럴 + 일치)를 기록합니다.
+ * @param op 출력 위치
+ * @param op_end 출력 버퍼 끝
+ * @param literals 리터럴 시작
+ * @param literal_length 리터럴 길이
+ * @param offset 일치 거리 (0이면 마지막 시퀀스: 리터럴만)
+ * @param match_length 일치 길이 (LZ_MIN_MATCH 이상)
+ * @return 다음 출력 위치, 공간이 부족하면 NULL
+ */
+static uint8_t* lz_write_sequence(uint8_t* op, const uint8_t* op_end, const uint8_t* literals,
+                                  size_t literal_length, size_t offset, size_t match_length) {
+    size_t match_code = offset ? match_length - LZ_MIN_MATCH : 0;
+    size_t needed = 1 + (literal_length >= 15 ? literal_length / 255 + 1 : 0) + literal_length +
+                    (offset ? 2 + (match_code >= 15 ? match_code / 255 + 1 : 0) : 0);
+    if ((size_t)(op_end - op) < needed) return NULL;
+
+    uint8_t* token = op++;
+    *token = (uint8_t)(((literal_length < 15) ? literal_length : 15) << 4);
+    if (literal_length >= 15) op = lz_write_length(op, literal_length - 15);
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+    if (!offset) return op;
+
+    *op++ = (uint8_t)(offset & 0xFF);  // 오프셋은 little-endian (LZ4 형식)
+    *op++ = (uint8_t)(offset >> 8);
+    *token |= (uint8_t)((match_code < 15) ? match_code : 15);
+    if (match_code >= 15) op = lz_write_length(op, match_code - 15);
+    return op;
+}
+
+size_t lz_compress(const uint8_t* src, size_t src_length, uint8_t* dst, size_t dst_capacity) {
+    if (!src || !dst) return 0;
+    uint8_t* op = dst;
+    const uint8_t* op_end = dst + dst_capacity;
+    size_t anchor = 0;
+
+    if (src_length > LZ_MATCH_FIND_LIMIT) {
+        uint32_t table[1 << LZ_HASH_LOG];
+        memset(table, 0, sizeof(table));
+        size_t limit = src_length - LZ_MATCH_FIND_LIMIT;     // 일치 시작 위치 상한 (포함하지 않음)
+        size_t match_end_limit = src_length - LZ_LAST_LITERALS;
+        size_t ip = 1;
+
+        while (ip < limit) {
+            // 일치 탐색: 실패가 이어질수록 간격을 넓혀 압축되지 않는 구간을 빠르게 지나감
+            size_t reference = 0;
+            size_t searches = (size_t)1 << LZ_SKIP_TRIGGER;
+            int found = 0;
+            while (ip < limit) {
+                uint32_t hash = lz_hash(lz_read32(src + ip));
+                reference = table[hash];
+                table[hash] = (uint32_t)ip;
+                if (ip - reference <= LZ_MAX_DISTANCE && lz_read32(src + reference) == lz_read32(src + ip)) {
+                    found = 1;
+                    break;
+                }
+                ip += searches++ >> LZ_SKIP_TRIGGER;
+            }
+            if (!found) break;
+
+            // 일치를 앞쪽으로 넓힘 (리터럴을 줄임)
+            while (ip > anchor && reference > 0 && src[ip - 1] == src[reference - 1]) {
+                ip--;
+                reference--;
+            }
+            size_t match_length = LZ_MIN_MATCH;
+            while (ip + match_length < match_end_limit && src[ip + match_length] == src[reference + match_length]) {
+                match_length++;
+            }
+
+            op = lz_write_sequence(op, op_end, src + anchor, ip - anchor, ip - reference, match_length);
+            if (!op) return 0;
+            ip += match_length;
+            anchor = ip;
+            if (ip < limit) table[lz_hash(lz_read32(src + ip - 2))] = (uint32_t)(ip - 2);
+        }
+    }
+
+    // 마지막 시퀀스: 남은 리터럴
+    op = lz_write_sequence(op, op_end, src + anchor, src_length - anchor, 0, 0);
+    return op ? (size_t)(op - dst) : 0;
+}
+
+int64_t lz_decompress(const uint8_t* src, size_t src_length, uint8_t* dst, size_t dst_capacity) {
+    if (!src || !dst) return -1;
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < src_length) {
+        uint8_t token = src[ip++];
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15) {
+            uint8_t extra;
+            do {
+                if (ip >= src_length) return -1;
+                extra = src[ip++];
+                literal_length += extra;
+            } while (extra == 255);
+        }
+        if (literal_length > src_length - ip || literal_length > dst_capacity - op) return -1;
+        memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+        if (ip == src_length) break;  // 마지막 시퀀스는 리터럴만
+
+        if (src_length - ip < 2) return -1;
+        size_t offset = (size_t)src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return -1;
+
+        size_t match_length = token & 0x0F;
+        if (match_length == 15) {
+            uint8_t extra;
+            do {
+                if (ip >= src_length) return -1;
+                extra = src[ip++];
+                match_length += extra;
+            } while (extra == 255);
+        }
+        match_length += LZ_MIN_MATCH;
+        if (match_length > dst_capacity - op) return -1;
+
+        // 겹치는 일치 (offset < 길이)는 직전 출력의 반복이므로 offset 바이트씩 겹치지 않게 나눠 복사
+        for (size_t copied = 0; copied < match_length; ) {
+            size_t count = (match_length - copied < offset) ? match_length - copied : offset;
+            memcpy(dst + op + copied, dst + op + copied - offset, count);
+            copied += count;
+        }
+        op += match_length;
+    }
+    return (int64_t)op;
+}
+
+void lz_frame_encoder_init(LzFrameEncoder* encoder) {
+    if (!encoder) return;
+    encoder->misses = 0;
+    encoder->skip = 0;
+}
+
+size_t lz_frame_encode(LzFrameEncoder* encoder, const uint8_t* src, size_t src_length, uint8_t* dst) {
+    size_t payload_length = 0;
+    if (encoder->skip > 0) {
+        encoder->skip--;
+    } else {
+        // 최소 절감량을 넘는 결과만 받아들임 (넘지 못하면 출력 공간 부족으로 0)
+        size_t capacity = src_length - src_length / LZ_MIN_SAVING_DIVISOR;
+        payload_length = lz_compress(src, src_length, dst + LZ_FRAME_HEADER_SIZE, capacity);
+        if (payload_length == 0 || payload_length >= capacity) {
+            payload_length = 0;
+            if (encoder->misses < LZ_MAX_SKIP_SHIFT) encoder->misses++;
+            encoder->skip = (1u << encoder->misses) - 1;
+        } else {
+            encoder->misses = 0;
+        }
+    }
+
+    uint32_t header = (uint32_t)payload_length;
+    if (payload_length == 0) {
+        memcpy(dst + LZ_FRAME_HEADER_SIZE, src, src_length);
+        header = (uint32_t)src_length | LZ_FRAME_RAW;
+        payload_length = src_length;
+    }
+    dst[0] = (uint8_t)(header >> 24);
+    dst[1] = (uint8_t)(header >> 16);
+    dst[2] = (uint8_t)(header >> 8);
+    dst[3] = (uint8_t)header;
+    return LZ_FRAME_HEADER_SIZE + payload_length;
+}
+
+int lz_frame_parse_header(const uint8_t* header, int* raw, size_t* payload_length) {
+    uint32_t value = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) |
+                     ((uint32_t)header[2] << 8) | header[3];
+    *raw = (value & LZ_FRAME_RAW) ? 1 : 0;
+    *payload_length = value & ~LZ_FRAME_RAW;
+    return *payload_length <= LZ_BLOCK_SIZE;
+}
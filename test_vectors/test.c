@@ -7,16 +7,25 @@
 #include "aes.h"
 #include "sha512.h"
 #include "hmac_sha512.h"
+#include "aes_ctr_hmac.h"
 #include "kdf.h"
+#include "key_derivation.h"
 #include "file_crypto.h"
 #include "platform_utils.h"
+#include "file_path_utils.h"
+#include "crypto_engine.h"
+#include "file_archive.h"
+#include "key_slots.h"
+#include "file_hash.h"
 
 #ifdef PLATFORM_WINDOWS
 #include <windows.h>
 #include <psapi.h>
 #include <io.h>
+#include <direct.h>
 #define access _access
 #define F_OK 0
+#define rmdir _rmdir
 #else
 #include <sys/resource.h>
 #include <unistd.h>
@@ -675,6 +684,58 @@ int test_aes(void) {
         }
     }
 
+    // AES-CTR + HMAC 결합 처리: 따로 호출한 결과와 동일해야 함 (타일 경계를 넘는 길이)
+    {
+        printf("--- AES-CTR + HMAC-SHA512 Fused Test ---\n");
+        const size_t fused_len = 3 * AES_CTR_HMAC_TILE_SIZE + 21;
+        uint8_t* data = (uint8_t*)malloc(fused_len);
+        uint8_t* expected = (uint8_t*)malloc(fused_len);
+        uint8_t* fused = (uint8_t*)malloc(fused_len);
+        uint8_t aes_key[32], mac_key[24], nonce[AES_BLOCK_SIZE];
+        for (size_t i = 0; i < fused_len && data; i++) data[i] = (uint8_t)(i * 31 + 7);
+        for (int i = 0; i < 32; i++) aes_key[i] = (uint8_t)i;
+        for (int i = 0; i < 24; i++) mac_key[i] = (uint8_t)(0xA0 + i);
+        
+        const AES_CTR_HMAC_ORDER orders[2] = { AES_CTR_HMAC_MAC_INPUT, AES_CTR_HMAC_MAC_OUTPUT };
+        const char* order_names[2] = { "MAC over input", "MAC over output" };
+        for (int o = 0; o < 2; o++) {
+            total_count++;
+            if (!data || !expected || !fused) {
+                printf("AES-CTR + HMAC (%s): FAIL (malloc)\n", order_names[o]);
+                continue;
+            }
+            
+            // 기준: AES_CTR_crypt + hmac_sha512_update 분리 호출
+            AES_set_key(&ctx, aes_key, 256);
+            HMAC_SHA512_CTX ref_hmac, fused_hmac;
+            uint8_t ref_mac[64], fused_mac[64];
+            memset(nonce, 0x5A, sizeof(nonce));
+            hmac_sha512_init(&ref_hmac, mac_key, sizeof(mac_key));
+            if (orders[o] == AES_CTR_HMAC_MAC_INPUT) hmac_sha512_update(&ref_hmac, data, fused_len);
+            AES_CTR_crypt(&ctx, data, fused_len, expected, nonce);
+            if (orders[o] == AES_CTR_HMAC_MAC_OUTPUT) hmac_sha512_update(&ref_hmac, expected, fused_len);
+            hmac_sha512_final(&ref_hmac, ref_mac);
+            
+            // 결합 처리 (in-place)
+            memcpy(fused, data, fused_len);
+            memset(nonce, 0x5A, sizeof(nonce));
+            hmac_sha512_init(&fused_hmac, mac_key, sizeof(mac_key));
+            CRYPTO_STATUS st = AES_CTR_HMAC_crypt(&ctx, fused, fused_len, fused, nonce, &fused_hmac, orders[o]);
+            hmac_sha512_final(&fused_hmac, fused_mac);
+            
+            if (st == CRYPTO_SUCCESS && memcmp(expected, fused, fused_len) == 0 &&
+                compare_hex(ref_mac, fused_mac, 64)) {
+                printf("AES-CTR + HMAC (%s): PASS\n", order_names[o]);
+                pass_count++;
+            } else {
+                printf("AES-CTR + HMAC (%s): FAIL\n", order_names[o]);
+            }
+        }
+        free(data);
+        free(expected);
+        free(fused);
+    }
+
     printf("\nAES Tests: %d/%d passed\n\n", pass_count, total_count);
     return (pass_count == total_count) ? 0 : 1;
 }
@@ -770,7 +831,7 @@ static MemoryUsage get_memory_usage(void) {
     return mem;
 }
 
-// 테스트 파일 생성
+// 테스트 파일 생성 (2 GiB/4 GiB 경계를 넘는 크기도 만들 수 있도록 64비트로 계산)
 static int create_test_file(const char* filename, size_t size_mb) {
     FILE* f = fopen(filename, "wb");
     if (!f) return 0;
@@ -786,10 +847,11 @@ static int create_test_file(const char* filename, size_t size_mb) {
     // 랜덤 시드 설정
     srand((unsigned int)time(NULL));
     
-    size_t written = 0;
-    while (written < size_mb * 1024 * 1024) {
-        size_t to_write = (size_mb * 1024 * 1024 - written < buffer_size) ?
-                         (size_mb * 1024 * 1024 - written) : buffer_size;
+    uint64_t total_size = (uint64_t)size_mb * 1024 * 1024;
+    uint64_t written = 0;
+    while (written < total_size) {
+        size_t to_write = (total_size - written < buffer_size) ?
+                         (size_t)(total_size - written) : buffer_size;
         
         // 랜덤 데이터 생성
         for (size_t i = 0; i < to_write; i++) {
@@ -810,12 +872,17 @@ static int create_test_file(const char* filename, size_t size_mb) {
 }
 
 // 파일 크기 확인
-static size_t get_file_size(const char* filename) {
-    struct stat st;
-    if (stat(filename, &st) == 0) {
-        return (size_t)st.st_size;
+static uint64_t get_file_size(const char* filename) {
+    // stat의 st_size는 Windows에서 32비트이므로 64비트 위치 함수로 확인
+    FILE* f = platform_fopen(filename, "rb");
+    if (!f) return 0;
+    
+    int64_t size = -1;
+    if (platform_fseek64(f, 0, SEEK_END) == 0) {
+        size = platform_ftell64(f);
     }
-    return 0;
+    fclose(f);
+    return (size > 0) ? (uint64_t)size : 0;
 }
 
 // 암호화/복호화 성능 테스트
@@ -868,8 +935,8 @@ static PerformanceMetrics test_file_operation(const char* input_file,
     }
     
     // 파일 크기 확인
-    size_t input_size = get_file_size(input_file);
-    size_t encrypted_size = get_file_size(encrypted_file);
+    uint64_t input_size = get_file_size(input_file);
+    uint64_t encrypted_size = get_file_size(encrypted_file);
     
     // 속도 계산 (MB/s)
     double encrypt_wall_time = encrypt_end_wall - encrypt_start_wall;
@@ -933,7 +1000,7 @@ static PerformanceMetrics test_file_operation(const char* input_file,
     
     if (input_size > 0) {
         // 파일 크기를 KB로 변환
-        size_t file_size_kb = input_size / 1024;
+        double file_size_kb = (double)(input_size / 1024);
         
         // 비율 계산
         double memory_ratio = (double)memory_increase / file_size_kb;
@@ -955,6 +1022,233 @@ static PerformanceMetrics test_file_operation(const char* input_file,
     return metrics;
 }
 
+// ========================================
+// 스레드 풀 테스트 (Thread Pool Stress Tests)
+// ========================================
+
+// 스레드 풀 테스트 공유 상태
+typedef struct {
+    platform_thread_pool_t* pool;
+    volatile long executed;        // 실행된 작업 수
+    volatile long spawned;         // 제출에 성공한 작업 수
+    volatile long wrong_worker;    // 작업 스레드 번호가 범위를 벗어난 횟수
+} PoolTestState;
+
+// 카운터만 올리는 작업 (스케줄링 오버헤드 측정용)
+static void pool_count_task(void* arg) {
+    PoolTestState* state = (PoolTestState*)arg;
+    platform_atomic_fetch_add(&state->executed, 1);
+}
+
+// 재귀 분할 작업 인자 (깊이만큼 두 갈래로 나뉨)
+typedef struct {
+    PoolTestState* state;
+    int depth;
+} PoolTreeTask;
+
+// 작업 안에서 하위 작업 두 개를 제출 (자기 덱 push, 다른 스레드의 steal, 덱 확장을 함께 시험)
+static void pool_tree_task(void* arg) {
+    PoolTreeTask* task = (PoolTreeTask*)arg;
+    PoolTestState* state = task->state;
+    int index = platform_thread_pool_worker_index(state->pool);
+    if (index < 0 || index >= platform_thread_pool_size(state->pool)) {
+        platform_atomic_fetch_add(&state->wrong_worker, 1);
+    }
+    platform_atomic_fetch_add(&state->executed, 1);
+    
+    for (int i = 0; i < 2 && task->depth > 0; i++) {
+        PoolTreeTask* child = (PoolTreeTask*)malloc(sizeof(PoolTreeTask));
+        if (!child) continue;
+        child->state = state;
+        child->depth = task->depth - 1;
+        if (platform_thread_pool_submit(state->pool, pool_tree_task, child)) {
+            platform_atomic_fetch_add(&state->spawned, 1);
+        } else {
+            free(child);
+        }
+    }
+    free(task);
+}
+
+// 작업 안에서 같은 작업을 많이 제출 (내부 제출 오버헤드 측정용)
+static void pool_fan_out_task(void* arg) {
+    PoolTestState* state = (PoolTestState*)arg;
+    for (long i = 0; i < 100000; i++) {
+        if (platform_thread_pool_submit(state->pool, pool_count_task, state)) {
+            platform_atomic_fetch_add(&state->spawned, 1);
+        }
+    }
+}
+
+// 천천히 끝나는 작업 (취소 테스트용)
+static void pool_slow_task(void* arg) {
+    PoolTestState* state = (PoolTestState*)arg;
+    platform_sleep_ms(1);
+    platform_atomic_fetch_add(&state->executed, 1);
+}
+
+int test_thread_pool(void) {
+    printf("=======================================\n");
+    printf("  Thread Pool / Work-Stealing Deque Tests\n");
+    printf("=======================================\n");
+    
+    int pass_count = 0;
+    int total_count = 0;
+    int threads = platform_cpu_count();
+    if (threads < 4) threads = 4;  // 코어가 적어도 훔치기 경쟁이 일어나도록
+    
+    platform_thread_pool_t* pool = platform_thread_pool_create(threads, 0);
+    if (!pool) {
+        printf("Thread pool creation: FAIL\n");
+        return 1;
+    }
+    printf("Workers: %d (CPUs: %d)\n", platform_thread_pool_size(pool), platform_cpu_count());
+    
+    // --- 외부 제출 스트레스 테스트 ---
+    {
+        total_count++;
+        PoolTestState state;
+        memset(&state, 0, sizeof(state));
+        state.pool = pool;
+        
+        const long task_count = 100000;
+        long submitted = 0;
+        double start = get_wall_time();
+        for (long i = 0; i < task_count; i++) {
+            submitted += platform_thread_pool_submit(pool, pool_count_task, &state);
+        }
+        int waited = platform_thread_pool_wait(pool);
+        double elapsed = get_wall_time() - start;
+        
+        if (waited && submitted == task_count && platform_atomic_load(&state.executed) == task_count) {
+            printf("External submit (%ld tasks): PASS\n", task_count);
+            pass_count++;
+        } else {
+            printf("External submit: FAIL (submitted %ld, executed %ld)\n",
+                   submitted, platform_atomic_load(&state.executed));
+        }
+        printf("  Scheduling overhead (external): %.1f ns/task\n", elapsed * 1e9 / task_count);
+    }
+    
+    // --- 작업 안에서 재귀 제출 (push/steal/덱 확장) ---
+    {
+        total_count++;
+        PoolTestState state;
+        memset(&state, 0, sizeof(state));
+        state.pool = pool;
+        
+        // 깊이 16 이진 트리 = 131071개 작업
+        const int depth = 16;
+        const long expected = (1L << (depth + 1)) - 1;
+        PoolTreeTask* root = (PoolTreeTask*)malloc(sizeof(PoolTreeTask));
+        int waited = 0;
+        if (root) {
+            root->state = &state;
+            root->depth = depth;
+            state.spawned = 1;  // 제출 전에 세어야 하위 작업의 증가와 겹치지 않음
+            if (!platform_thread_pool_submit(pool, pool_tree_task, root)) {
+                state.spawned = 0;
+                free(root);
+            }
+            waited = platform_thread_pool_wait(pool);
+        }
+        
+        if (waited && platform_atomic_load(&state.spawned) == expected &&
+            platform_atomic_load(&state.executed) == expected && state.wrong_worker == 0) {
+            printf("Recursive spawn (%ld tasks): PASS\n", expected);
+            pass_count++;
+        } else {
+            printf("Recursive spawn: FAIL (spawned %ld, executed %ld, expected %ld)\n",
+                   platform_atomic_load(&state.spawned), platform_atomic_load(&state.executed), expected);
+        }
+    }
+    
+    // --- 내부 제출 오버헤드 (한 덱에 몰아 넣고 다른 스레드가 훔침) ---
+    {
+        total_count++;
+        PoolTestState state;
+        memset(&state, 0, sizeof(state));
+        state.pool = pool;
+        
+        double start = get_wall_time();
+        int submitted = platform_thread_pool_submit(pool, pool_fan_out_task, &state);
+        int waited = platform_thread_pool_wait(pool);
+        double elapsed = get_wall_time() - start;
+        
+        if (submitted && waited && platform_atomic_load(&state.spawned) == 100000 &&
+            platform_atomic_load(&state.executed) == 100000) {
+            printf("Internal submit (100000 tasks): PASS\n");
+            pass_count++;
+        } else {
+            printf("Internal submit: FAIL (spawned %ld, executed %ld)\n",
+                   platform_atomic_load(&state.spawned), platform_atomic_load(&state.executed));
+        }
+        printf("  Scheduling overhead (internal): %.1f ns/task\n", elapsed * 1e9 / 100000);
+    }
+    
+    // --- 취소: 대기 중인 작업은 실행되지 않고, 취소 후 풀을 다시 쓸 수 있어야 함 ---
+    {
+        total_count++;
+        PoolTestState state;
+        memset(&state, 0, sizeof(state));
+        state.pool = pool;
+        
+        const long task_count = 2000;
+        long submitted = 0;
+        for (long i = 0; i < task_count; i++) {
+            submitted += platform_thread_pool_submit(pool, pool_slow_task, &state);
+        }
+        platform_thread_pool_cancel(pool);
+        int rejected = !platform_thread_pool_submit(pool, pool_count_task, &state);
+        int waited = platform_thread_pool_wait(pool);
+        long executed = platform_atomic_load(&state.executed);
+        
+        // 취소 해제 후 재사용
+        state.executed = 0;
+        int reused = platform_thread_pool_submit(pool, pool_count_task, &state) &&
+                     platform_thread_pool_wait(pool) && platform_atomic_load(&state.executed) == 1;
+        
+        if (submitted == task_count && rejected && !waited && executed < task_count && reused) {
+            printf("Cancel (%ld of %ld ran): PASS\n", executed, task_count);
+            pass_count++;
+        } else {
+            printf("Cancel: FAIL (submitted %ld, executed %ld, rejected %d, wait %d, reused %d)\n",
+                   submitted, executed, rejected, waited, reused);
+        }
+    }
+    
+    platform_thread_pool_destroy(pool);
+    
+    // --- 생성/해제 반복 (작업 없이 해제, 작업 중 해제) ---
+    {
+        total_count++;
+        int ok = 1;
+        for (int round = 0; round < 50 && ok; round++) {
+            PoolTestState state;
+            memset(&state, 0, sizeof(state));
+            state.pool = platform_thread_pool_create(1 + round % 8, round % 2);
+            if (!state.pool) {
+                ok = 0;
+                break;
+            }
+            for (int i = 0; i < round * 10; i++) {
+                platform_thread_pool_submit(state.pool, pool_count_task, &state);
+            }
+            platform_thread_pool_destroy(state.pool);  // 남은 작업을 마친 뒤 해제
+            if (platform_atomic_load(&state.executed) != round * 10) ok = 0;
+        }
+        if (ok) {
+            printf("Create/destroy cycles: PASS\n");
+            pass_count++;
+        } else {
+            printf("Create/destroy cycles: FAIL\n");
+        }
+    }
+    
+    printf("\nThread Pool Tests: %d/%d passed\n\n", pass_count, total_count);
+    return (pass_count == total_count) ? 0 : 1;
+}
+
 // 통합 테스트 메인 함수
 int test_integration_performance(void) {
     printf("=======================================\n");
@@ -986,7 +1280,8 @@ int test_integration_performance(void) {
     printf("워밍업 완료.\n\n");
     
     // 테스트 파일 크기 (MB)
-    size_t test_sizes[] = {10, 100, 500, 1024};  // 10MB, 100MB, 500MB, 1GB
+    // 2.5GB는 32비트 long 범위(2 GiB)를, 4.5GB는 32비트 size_t 범위(4 GiB)를 넘음
+    size_t test_sizes[] = {10, 100, 500, 1024, 2560, 4608};  // 10MB, 100MB, 500MB, 1GB, 2.5GB, 4.5GB
     int num_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
     
     PerformanceMetrics* results = (PerformanceMetrics*)malloc(num_sizes * sizeof(PerformanceMetrics));
@@ -1057,7 +1352,7 @@ int test_integration_performance(void) {
     
     // 부하 증가율 계산 (선형성 검증)
     printf("--- CPU 부하 증가율 분석 ---\n");
-    double cpu_increase_rates[3];  // 4개 파일이면 3개의 증가율
+    double cpu_increase_rates[sizeof(test_sizes) / sizeof(test_sizes[0])];  // 인접한 크기 쌍마다 증가율 1개
     int valid_rates = 0;
     
     for (int i = 1; i < num_sizes; i++) {
@@ -1187,6 +1482,86 @@ static int compare_files(const char* file1, const char* file2) {
     return result;
 }
 
+// 파일 복사 (체크포인트 테스트에서 중단 시점의 파일 상태를 저장/복원)
+static int copy_test_file(const char* from, const char* to) {
+    FILE* fin = fopen(from, "rb");
+    FILE* fout = fin ? fopen(to, "wb") : NULL;
+    int ok = (fout != NULL);
+    unsigned char buf[4096];
+    size_t n;
+    while (ok && (n = fread(buf, 1, sizeof(buf), fin)) > 0) {
+        if (fwrite(buf, 1, n, fout) != n) ok = 0;
+    }
+    if (fin) fclose(fin);
+    if (fout && fclose(fout) != 0) ok = 0;
+    return ok;
+}
+
+// 테스트용 디렉토리 생성 (이미 있으면 성공)
+static int make_test_directory(const char* path) {
+#ifdef PLATFORM_WINDOWS
+    if (_mkdir(path) == 0) return 1;
+#else
+    if (mkdir(path, 0700) == 0) return 1;
+#endif
+    return platform_directory_exists(path);
+}
+
+// 체크포인트 테스트: 진행률이 기준을 처음 넘을 때 기록 중인 파일과 체크포인트 파일을 복사해 둠
+// (복사본을 되돌려 놓으면 그 시점에 프로세스가 죽은 것과 같은 상태)
+typedef struct {
+    const char* paths[2];        // 기록 중인 파일, 체크포인트 파일
+    const char* snapshots[2];    // 복사본 경로
+    int64_t trigger;             // 복사할 진행 위치
+    int taken;                   // 1이면 복사함
+} CheckpointSnapshot;
+
+static void checkpoint_snapshot_progress(int64_t processed, int64_t total, void* user_data) {
+    CheckpointSnapshot* snapshot = (CheckpointSnapshot*)user_data;
+    (void)total;
+    if (snapshot->taken || processed < snapshot->trigger) return;
+    snapshot->taken = copy_test_file(snapshot->paths[0], snapshot->snapshots[0]) &&
+                      copy_test_file(snapshot->paths[1], snapshot->snapshots[1]);
+}
+
+// 복사본을 원래 경로로 되돌리고 복사본 삭제
+static int checkpoint_snapshot_restore(const CheckpointSnapshot* snapshot) {
+    int ok = snapshot->taken;
+    for (int i = 0; i < 2; i++) {
+        if (ok && !copy_test_file(snapshot->snapshots[i], snapshot->paths[i])) ok = 0;
+        remove(snapshot->snapshots[i]);
+    }
+    return ok;
+}
+
+// 검증 테스트: 진행률 콜백이 받은 마지막 처리량과 전체 크기
+typedef struct {
+    int64_t last;
+    int64_t total;
+} VerifyProgress;
+
+static void verify_progress_record(int64_t processed, int64_t total, void* user_data) {
+    VerifyProgress* progress = (VerifyProgress*)user_data;
+    if (processed > progress->last) progress->last = processed;
+    progress->total = total;
+}
+
+// 검증 테스트: 디렉토리 탐색으로 파일 수를 세고, 이름이 prefix로 시작하는 파일은 따로 셈
+typedef struct {
+    const char* prefix;
+    long files;
+    long matched;
+} VerifyWalkCount;
+
+static int verify_walk_count(const char* file_path, void* user_data) {
+    VerifyWalkCount* count = (VerifyWalkCount*)user_data;
+    const char* separator = platform_find_last_separator(file_path);
+    const char* name = separator ? separator + 1 : file_path;
+    count->files++;
+    if (strncmp(name, count->prefix, strlen(count->prefix)) == 0) count->matched++;
+    return 1;
+}
+
 // E2E 테스트 케이스 구조체
 typedef struct {
     const char* test_name;
@@ -1274,6 +1649,13 @@ static int run_e2e_test(const E2ETestCase* test_case) {
     return 1;
 }
 
+// 비동기 엔진 완료 콜백 (호출 횟수만 셈)
+static void async_count_callback(crypto_job_t* job, CRYPTO_JOB_STATE state, void* user_data) {
+    (void)job;
+    (void)state;
+    platform_atomic_fetch_add((volatile long*)user_data, 1);
+}
+
 // E2E 통합 테스트
 int test_e2e_cli(void) {
     printf("=======================================\n");
@@ -1412,6 +1794,2364 @@ int test_e2e_cli(void) {
     }
     printf("\n");
     
+    // I/O 모드 교차 테스트 (한 모드로 암호화, 다른 모드로 복호화)
+    printf("--- I/O 모드 교차 테스트 ---\n");
+    {
+        const char* pipe_input = "e2e_pipeline_input.bin";
+        const char* pipe_encrypted = "e2e_pipeline_encrypted.enc";
+        const char* pipe_decrypted = "e2e_pipeline_decrypted.bin";
+        const FILE_IO_MODE modes[7][2] = {
+            { FILE_IO_MODE_PIPELINED, FILE_IO_MODE_SERIAL },
+            { FILE_IO_MODE_SERIAL, FILE_IO_MODE_PIPELINED },
+            { FILE_IO_MODE_MMAP, FILE_IO_MODE_SERIAL },
+            { FILE_IO_MODE_SERIAL, FILE_IO_MODE_MMAP },
+            { FILE_IO_MODE_IO_URING, FILE_IO_MODE_SERIAL },
+            { FILE_IO_MODE_DIRECT, FILE_IO_MODE_SERIAL },
+            { FILE_IO_MODE_SERIAL, FILE_IO_MODE_DIRECT }
+        };
+        const char* mode_names[7] = { "파이프라인 암호화 → 단일 스레드 복호화",
+                                      "단일 스레드 암호화 → 파이프라인 복호화",
+                                      "메모리 매핑 암호화 → 단일 스레드 복호화",
+                                      "단일 스레드 암호화 → 메모리 매핑 복호화",
+                                      "io_uring 암호화 → 단일 스레드 복호화",
+                                      "O_DIRECT(v5) 암호화 → 단일 스레드 복호화",
+                                      "단일 스레드 암호화 → O_DIRECT 복호화" };
+        
+        // 청크 크기로 나누어떨어지지 않는 크기 (5MB + 7바이트)
+        int created = create_test_file(pipe_input, 5);
+        FILE* fa = created ? fopen(pipe_input, "ab") : NULL;
+        if (fa) {
+            fwrite("pipeline", 1, 7, fa);
+            fclose(fa);
+        }
+        
+        for (int m = 0; m < 7; m++) {
+            total_count++;
+            printf("  [테스트] %s\n", mode_names[m]);
+            if (!fa) {
+                printf("  [ERROR] 테스트 파일 생성 실패\n");
+                continue;
+            }
+            
+            char final_path[512];
+            set_file_io_mode(modes[m][0]);
+            int encrypt_result = encrypt_file(pipe_input, pipe_encrypted, 128, "TestPass123");
+            set_file_io_mode(modes[m][1]);
+            int decrypt_result = encrypt_result &&
+                                 decrypt_file(pipe_encrypted, pipe_decrypted, "TestPass123",
+                                              final_path, sizeof(final_path));
+            
+            if (decrypt_result && compare_files(pipe_input, final_path)) {
+                printf("  [PASS] 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 교차 암복호화 실패\n");
+            }
+            if (decrypt_result) remove(final_path);
+            remove(pipe_encrypted);
+        }
+        set_file_io_mode(FILE_IO_MODE_AUTO);
+        remove(pipe_input);
+    }
+    printf("\n");
+    
+    // 스트림 형식 테스트 (v6: 세그먼트마다 태그, 탐색 없이 순차 읽기/쓰기)
+    printf("--- 스트림(v6 세그먼트) 형식 테스트 ---\n");
+    {
+        const char* stream_input = "e2e_stream_input.bin";
+        const char* stream_encrypted = "e2e_stream_encrypted.enc";
+        const char* stream_decrypted = "e2e_stream_decrypted.bin";
+        const char* stream_truncated = "e2e_stream_truncated.enc";
+        
+        // 세그먼트 3개 (2MB + 5바이트)와 세그먼트 크기의 배수 (1MB, 마지막 세그먼트가 0바이트)
+        const size_t sizes_mb[2] = { 2, 1 };
+        const size_t extra[2] = { 5, 0 };
+        for (int t = 0; t < 2; t++) {
+            total_count++;
+            printf("  [테스트] encrypt_stream → decrypt_stream (%zuMB + %zu바이트)\n", sizes_mb[t], extra[t]);
+            int created = create_test_file(stream_input, sizes_mb[t]);
+            FILE* fa = created ? fopen(stream_input, "ab") : NULL;
+            if (fa) {
+                fwrite("stream", 1, extra[t], fa);
+                fclose(fa);
+            }
+            
+            FILE* in = fopen(stream_input, "rb");
+            FILE* out = fopen(stream_encrypted, "wb");
+            int encrypt_result = in && out && encrypt_stream(in, out, 256, "TestPass123");
+            if (in) fclose(in);
+            if (out) fclose(out);
+            
+            in = fopen(stream_encrypted, "rb");
+            out = fopen(stream_decrypted, "wb");
+            int decrypt_result = encrypt_result && in && out && decrypt_stream(in, out, "TestPass123");
+            if (in) fclose(in);
+            if (out) fclose(out);
+            
+            if (decrypt_result && compare_files(stream_input, stream_decrypted)) {
+                printf("  [PASS] 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 스트림 암복호화 실패\n");
+            }
+            remove(stream_decrypted);
+        }
+        
+        // 파일 API도 v6을 복호화 (마지막 반복의 1MB 입력)
+        total_count++;
+        printf("  [테스트] decrypt_file로 v6 파일 복호화\n");
+        {
+            char final_path[512];
+            int decrypt_result = decrypt_file(stream_encrypted, stream_decrypted, "TestPass123",
+                                              final_path, sizeof(final_path));
+            if (decrypt_result && compare_files(stream_input, final_path)) {
+                printf("  [PASS] 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] v6 파일 복호화 실패\n");
+            }
+            if (decrypt_result) remove(final_path);
+        }
+        
+        // 세그먼트 경계에서 잘린 스트림 (첫 세그먼트 + 태그까지만 남김): 마지막 세그먼트가 없으므로 거부
+        total_count++;
+        printf("  [테스트] 세그먼트 경계에서 잘린 스트림 거부\n");
+        {
+            FILE* src = fopen(stream_encrypted, "rb");
+            FILE* dst = fopen(stream_truncated, "wb");
+            long keep = (long)(ENC_HEADER_SIZE + ENC_SEGMENT_SIZE + ENC_HMAC_SIZE);
+            int copied = 0;
+            if (src && dst) {
+                unsigned char buf[4096];
+                long left = keep;
+                size_t n;
+                while (left > 0 && (n = fread(buf, 1, left < (long)sizeof(buf) ? (size_t)left : sizeof(buf), src)) > 0) {
+                    fwrite(buf, 1, n, dst);
+                    left -= (long)n;
+                }
+                copied = (left == 0);
+            }
+            if (src) fclose(src);
+            if (dst) fclose(dst);
+            
+            FILE* in = fopen(stream_truncated, "rb");
+            FILE* out = fopen(stream_decrypted, "wb");
+            int decrypt_result = in && out && decrypt_stream(in, out, "TestPass123");
+            if (in) fclose(in);
+            if (out) fclose(out);
+            
+            if (copied && !decrypt_result) {
+                printf("  [PASS] 잘림 감지\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 잘린 스트림이 거부되지 않았습니다\n");
+            }
+        }
+        
+        remove(stream_input);
+        remove(stream_encrypted);
+        remove(stream_decrypted);
+        remove(stream_truncated);
+    }
+    printf("\n");
+    
+    // 세그먼트 형식 파일 테스트 (v6을 파일 API로 기록, 세그먼트 단위 병렬 암호화/검증)
+    printf("--- 세그먼트 형식 병렬 암복호화 테스트 ---\n");
+    {
+        const char* seg_input = "e2e_segmented_input.bin";
+        const char* seg_encrypted = "e2e_segmented_encrypted.enc";
+        const char* seg_decrypted = "e2e_segmented_decrypted.bin";
+        
+        set_encryption_format(ENC_FORMAT_SEGMENTED);
+        int created = create_test_file(seg_input, 3);
+        FILE* fa = created ? fopen(seg_input, "ab") : NULL;
+        if (fa) {
+            fwrite("segment", 1, 7, fa);  // 세그먼트 4개 (3MB + 7바이트)
+            fclose(fa);
+        }
+        int encrypt_result = created && encrypt_file(seg_input, seg_encrypted, 256, "TestPass123");
+        set_encryption_format(ENC_FORMAT_DEFAULT);
+        
+        // 헤더 버전이 v6이고 순차 스트림 복호화로도 같은 평문이 나와야 함
+        total_count++;
+        printf("  [테스트] encrypt_file(세그먼트) → decrypt_stream\n");
+        {
+            unsigned char header_bytes[5] = { 0 };
+            FILE* in = fopen(seg_encrypted, "rb");
+            int header_ok = in && fread(header_bytes, 1, 5, in) == 5 && header_bytes[4] == ENC_VERSION_STREAM;
+            if (in) rewind(in);
+            FILE* out = fopen(seg_decrypted, "wb");
+            int decrypt_result = encrypt_result && header_ok && in && out && decrypt_stream(in, out, "TestPass123");
+            if (in) fclose(in);
+            if (out) fclose(out);
+            
+            if (decrypt_result && compare_files(seg_input, seg_decrypted)) {
+                printf("  [PASS] v6 헤더, 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 세그먼트 형식 암호화 결과가 스트림 형식과 다릅니다\n");
+            }
+            remove(seg_decrypted);
+        }
+        
+        total_count++;
+        printf("  [테스트] decrypt_file(세그먼트 병렬 검증/복호화)\n");
+        {
+            char final_path[512];
+            int decrypt_result = encrypt_result && decrypt_file(seg_encrypted, seg_decrypted, "TestPass123",
+                                                                final_path, sizeof(final_path));
+            if (decrypt_result && compare_files(seg_input, final_path)) {
+                printf("  [PASS] 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 세그먼트 병렬 복호화 실패\n");
+            }
+            if (decrypt_result) remove(final_path);
+        }
+        
+        // 두 번째 세그먼트 한 바이트 변조: 해당 세그먼트 태그가 맞지 않아 출력 파일 없이 거부
+        total_count++;
+        printf("  [테스트] 중간 세그먼트 변조 거부\n");
+        {
+            FILE* ft = fopen(seg_encrypted, "r+b");
+            long position = (long)(ENC_HEADER_SIZE + ENC_SEGMENT_SIZE + ENC_HMAC_SIZE + 100);
+            int tampered = 0;
+            if (ft && fseek(ft, position, SEEK_SET) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, position, SEEK_SET) == 0 && fputc(c ^ 0x01, ft) != EOF) {
+                    tampered = 1;
+                }
+            }
+            if (ft) fclose(ft);
+            
+            char final_path[512];
+            int decrypt_result = decrypt_file(seg_encrypted, seg_decrypted, "TestPass123",
+                                              final_path, sizeof(final_path));
+            FILE* leftover = fopen(seg_decrypted, "rb");
+            if (tampered && !decrypt_result && !leftover) {
+                printf("  [PASS] 변조 감지, 출력 파일 없음\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 변조된 세그먼트가 거부되지 않았습니다\n");
+            }
+            if (leftover) {
+                fclose(leftover);
+                remove(seg_decrypted);
+            }
+        }
+        
+        remove(seg_input);
+        remove(seg_encrypted);
+    }
+    printf("\n");
+    
+    // 임의 위치 읽기 테스트 (enc_open/enc_pread: 필요한 암호문만 읽어 복호화)
+    printf("--- 임의 위치 복호화 읽기 테스트 ---\n");
+    {
+        const char* reader_input = "e2e_reader_input.bin";
+        const char* reader_encrypted = "e2e_reader_encrypted.enc";
+        
+        // 블록 중간, 세그먼트 경계를 가로지르는 범위, 파일 끝을 넘는 범위
+        const int64_t offsets[4] = { 0, 12345, ENC_SEGMENT_SIZE - 7, 2 * 1024 * 1024 - 10 };
+        const size_t lengths[4] = { 16, 100, 4096, 4096 };
+        int created = create_test_file(reader_input, 2);
+        
+        for (int format = 0; format < 2; format++) {
+            total_count++;
+            printf("  [테스트] enc_pread (%s)\n", format ? "v6 세그먼트" : "v4");
+            set_encryption_format(format ? ENC_FORMAT_SEGMENTED : ENC_FORMAT_DEFAULT);
+            int encrypt_result = created && encrypt_file(reader_input, reader_encrypted, 256, "TestPass123");
+            set_encryption_format(ENC_FORMAT_DEFAULT);
+            
+            EncReader* reader = encrypt_result ? enc_open(reader_encrypted, "TestPass123") : NULL;
+            FILE* plain = fopen(reader_input, "rb");
+            int matched = (reader != NULL && plain != NULL && enc_size(reader) == 2 * 1024 * 1024);
+            for (int i = 0; matched && i < 4; i++) {
+                unsigned char expected[4096];
+                unsigned char actual[4096];
+                size_t expected_len = 0;
+                if (fseek(plain, (long)offsets[i], SEEK_SET) == 0) {
+                    expected_len = fread(expected, 1, lengths[i], plain);
+                }
+                int64_t got = enc_pread(reader, actual, lengths[i], offsets[i]);
+                matched = (got == (int64_t)expected_len && memcmp(actual, expected, expected_len) == 0);
+            }
+            if (plain) fclose(plain);
+            enc_close(reader);
+            
+            if (matched) {
+                printf("  [PASS] 부분 복호화 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 부분 복호화 결과가 원본과 다릅니다\n");
+            }
+        }
+        
+        // 잘못된 비밀번호는 열기에서 거부, v6 변조는 해당 세그먼트를 읽을 때만 거부
+        total_count++;
+        printf("  [테스트] 잘못된 비밀번호 / 변조된 세그먼트 읽기 거부\n");
+        {
+            int wrong_rejected = (enc_open(reader_encrypted, "WrongPass") == NULL);
+            
+            FILE* ft = fopen(reader_encrypted, "r+b");
+            long position = (long)(ENC_HEADER_SIZE + ENC_SEGMENT_SIZE + ENC_HMAC_SIZE + 10);
+            int tampered = 0;
+            if (ft && fseek(ft, position, SEEK_SET) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, position, SEEK_SET) == 0 && fputc(c ^ 0x01, ft) != EOF) {
+                    tampered = 1;
+                }
+            }
+            if (ft) fclose(ft);
+            
+            unsigned char buffer[64];
+            EncReader* reader = enc_open(reader_encrypted, "TestPass123");
+            int opened = (reader != NULL);
+            int64_t intact = enc_pread(reader, buffer, sizeof(buffer), 0);
+            int64_t damaged = enc_pread(reader, buffer, sizeof(buffer), ENC_SEGMENT_SIZE);
+            enc_close(reader);
+            
+            if (wrong_rejected && tampered && opened && intact == (int64_t)sizeof(buffer) && damaged == -1) {
+                printf("  [PASS] 거부됨 (변조되지 않은 세그먼트는 계속 읽힘)\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 잘못된 비밀번호 또는 변조가 감지되지 않았습니다\n");
+            }
+        }
+        
+        remove(reader_input);
+        remove(reader_encrypted);
+    }
+    printf("\n");
+    
+    // 검증 전용 API와 명령 모드 출력 경로 규칙
+    printf("--- verify_file / 출력 경로 분리 테스트 ---\n");
+    total_count++;
+    {
+        printf("  [테스트] verify_file (올바른 비밀번호 / 잘못된 비밀번호)\n");
+        if (verify_file("e2e_test_256.enc", "TestPass123") && !verify_file("e2e_test_256.enc", "WrongPass")) {
+            printf("  [PASS] 검증 결과 정상\n");
+            pass_count++;
+        } else {
+            printf("  [FAIL] verify_file 결과가 잘못되었습니다\n");
+        }
+    }
+    total_count++;
+    {
+        printf("  [테스트] split_file_path\n");
+        char dir[MAX_PATH_LENGTH];
+        char stem[MAX_FILENAME_LENGTH];
+        int ok = 1;
+        split_file_path("data/photo.png", dir, sizeof(dir), stem, sizeof(stem));
+        ok &= (strcmp(dir, "data") == 0 && strcmp(stem, "photo") == 0);
+        split_file_path("archive.tar.enc", dir, sizeof(dir), stem, sizeof(stem));
+        ok &= (strcmp(dir, ".") == 0 && strcmp(stem, "archive.tar") == 0);
+        split_file_path("/.profile", dir, sizeof(dir), stem, sizeof(stem));
+        ok &= (strcmp(dir, "/") == 0 && strcmp(stem, ".profile") == 0);
+        if (ok) {
+            printf("  [PASS] 디렉토리/파일명 분리 정상\n");
+            pass_count++;
+        } else {
+            printf("  [FAIL] 디렉토리/파일명 분리 결과가 잘못되었습니다\n");
+        }
+    }
+    printf("\n");
+    
+    // 배치 스케줄러 테스트 (큰 v6 파일은 세그먼트 범위로 나뉘어 작은 파일과 함께 여러 스레드에서 처리)
+    printf("--- 배치 작업 훔치기 스케줄러 테스트 ---\n");
+    {
+        const char* inputs[3] = { "e2e_batch_big.bin", "e2e_batch_small1.txt", "e2e_batch_small2.txt" };
+        const char* encrypted[3] = { "e2e_batch_big.enc", "e2e_batch_small1.enc", "e2e_batch_small2.enc" };
+        const char* outputs[3] = { "e2e_batch_big_out", "e2e_batch_small1_out", "e2e_batch_small2_out" };
+        int created = create_test_file(inputs[0], 20);  // 세그먼트 21개
+        for (int i = 1; i < 3; i++) {
+            FILE* fs = fopen(inputs[i], "wb");
+            if (fs) {
+                for (int j = 0; j < 1000 * i; j++) fputc('a' + (j % 26), fs);
+                fclose(fs);
+            } else {
+                created = 0;
+            }
+        }
+        
+        FileBatchItem items[3];
+        memset(items, 0, sizeof(items));
+        FileBatchJob job;
+        memset(&job, 0, sizeof(job));
+        job.aes_key_bits = 256;
+        job.password = "TestPass123";
+        job.items = items;
+        job.count = 3;
+        job.thread_count = 4;
+        
+        total_count++;
+        printf("  [테스트] process_file_batch(세그먼트 형식 암호화 → 복호화)\n");
+        {
+            for (int i = 0; i < 3; i++) {
+                items[i].input_path = inputs[i];
+                items[i].output_path = encrypted[i];
+            }
+            set_encryption_format(ENC_FORMAT_SEGMENTED);
+            job.op = FILE_BATCH_ENCRYPT;
+            size_t encrypted_count = created ? process_file_batch(&job) : 0;
+            set_encryption_format(ENC_FORMAT_DEFAULT);
+            
+            for (int i = 0; i < 3; i++) {
+                items[i].input_path = encrypted[i];
+                items[i].output_path = outputs[i];
+            }
+            job.op = FILE_BATCH_DECRYPT;
+            size_t decrypted_count = (encrypted_count == 3) ? process_file_batch(&job) : 0;
+            
+            int ok = (decrypted_count == 3);
+            for (int i = 0; ok && i < 3; i++) {
+                ok = items[i].result && compare_files(inputs[i], items[i].final_path);
+            }
+            if (ok) {
+                printf("  [PASS] 3개 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 배치 암복호화 결과가 잘못되었습니다 (암호화 %zu, 복호화 %zu)\n",
+                       encrypted_count, decrypted_count);
+            }
+            for (int i = 0; i < 3; i++) {
+                if (items[i].result) remove(items[i].final_path);
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] process_file_batch(검증, 잘못된 비밀번호)\n");
+        {
+            for (int i = 0; i < 3; i++) {
+                items[i].input_path = encrypted[i];
+                items[i].output_path = NULL;
+            }
+            job.op = FILE_BATCH_VERIFY;
+            size_t verified_count = process_file_batch(&job);
+            job.password = "WrongPass";
+            size_t wrong_count = process_file_batch(&job);
+            if (verified_count == 3 && wrong_count == 0) {
+                printf("  [PASS] 검증 결과 정상\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 배치 검증 결과가 잘못되었습니다 (성공 %zu, 잘못된 비밀번호 %zu)\n",
+                       verified_count, wrong_count);
+            }
+        }
+        
+        for (int i = 0; i < 3; i++) {
+            remove(inputs[i]);
+            remove(encrypted[i]);
+        }
+    }
+    printf("\n");
+    
+    // 비동기 엔진 테스트 (작업 핸들, 완료 콜백, 배압, 취소)
+    printf("--- 비동기 작업 엔진 테스트 ---\n");
+    {
+        const char* inputs[6] = { "e2e_async_0.txt", "e2e_async_1.txt", "e2e_async_2.txt",
+                                  "e2e_async_3.txt", "e2e_async_4.txt", "e2e_async_5.txt" };
+        const char* encrypted[6] = { "e2e_async_0.enc", "e2e_async_1.enc", "e2e_async_2.enc",
+                                     "e2e_async_3.enc", "e2e_async_4.enc", "e2e_async_5.enc" };
+        const char* outputs[6] = { "e2e_async_0_out", "e2e_async_1_out", "e2e_async_2_out",
+                                   "e2e_async_3_out", "e2e_async_4_out", "e2e_async_5_out" };
+        int created = 1;
+        for (int i = 0; i < 6; i++) {
+            FILE* fs = fopen(inputs[i], "wb");
+            if (fs) {
+                for (int j = 0; j < 5000 * (i + 1); j++) fputc('A' + ((i + j) % 26), fs);
+                fclose(fs);
+            } else {
+                created = 0;
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] crypto_submit_encrypt/decrypt (스레드 2개, 동시 작업 한도 2)\n");
+        {
+            volatile long callbacks = 0;
+            crypto_engine_t* engine = crypto_engine_create(2, 2);
+            crypto_job_t* jobs[6] = { NULL };
+            int ok = created && engine;
+            for (int i = 0; ok && i < 6; i++) {
+                jobs[i] = crypto_submit_encrypt(engine, inputs[i], encrypted[i], 256, "TestPass123",
+                                                async_count_callback, (void*)&callbacks);
+                if (!jobs[i]) ok = 0;
+            }
+            crypto_engine_wait_all(engine);
+            for (int i = 0; i < 6; i++) {
+                if (jobs[i] && crypto_job_state(jobs[i]) != CRYPTO_JOB_DONE) ok = 0;
+                crypto_job_release(jobs[i]);
+                jobs[i] = NULL;
+            }
+            int encrypt_callbacks = (int)platform_atomic_load(&callbacks);
+            
+            for (int i = 0; ok && i < 6; i++) {
+                jobs[i] = crypto_submit_decrypt(engine, encrypted[i], outputs[i], "TestPass123", NULL, NULL);
+                if (!jobs[i]) ok = 0;
+            }
+            for (int i = 0; i < 6; i++) {
+                if (!jobs[i]) continue;
+                if (crypto_job_wait(jobs[i]) != CRYPTO_JOB_DONE ||
+                    !compare_files(inputs[i], crypto_job_final_path(jobs[i]))) {
+                    ok = 0;
+                }
+                int64_t processed = 0, total = 0;
+                crypto_job_progress(jobs[i], &processed, &total);
+                if (total <= 0 || processed != total) ok = 0;
+                remove(crypto_job_final_path(jobs[i]));
+                crypto_job_release(jobs[i]);
+            }
+            crypto_engine_destroy(engine);
+            
+            if (ok && encrypt_callbacks == 6) {
+                printf("  [PASS] 6개 파일 내용 일치, 콜백 6회\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 비동기 암복호화 결과가 잘못되었습니다 (콜백 %d회)\n", encrypt_callbacks);
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] crypto_job_cancel (대기 중/처리 중 작업)\n");
+        {
+            const char* big_input = "e2e_async_big.bin";
+            const char* big_encrypted = "e2e_async_big.enc";
+            crypto_engine_t* engine = crypto_engine_create(1, 0);
+            int ok = engine && create_test_file(big_input, 20);
+            crypto_job_t* jobs[4] = { NULL };
+            for (int i = 1; i < 4; i++) {
+                remove(encrypted[i]);  // 앞 테스트의 결과
+            }
+            if (ok) {
+                // 스레드가 하나라 뒤의 작업은 앞 작업이 끝날 때까지 대기열에 남음
+                jobs[0] = crypto_submit_encrypt(engine, big_input, big_encrypted, 256, "TestPass123", NULL, NULL);
+                for (int i = 1; i < 4; i++) {
+                    jobs[i] = crypto_submit_encrypt(engine, inputs[i], encrypted[i], 256, "TestPass123", NULL, NULL);
+                }
+                for (int i = 0; i < 4; i++) {
+                    crypto_job_cancel(jobs[i]);
+                }
+                for (int i = 0; i < 4; i++) {
+                    if (!jobs[i] || crypto_job_wait(jobs[i]) != CRYPTO_JOB_CANCELLED) ok = 0;
+                    crypto_job_release(jobs[i]);
+                }
+                if (access(big_encrypted, F_OK) == 0) ok = 0;
+                for (int i = 1; i < 4; i++) {
+                    if (access(encrypted[i], F_OK) == 0) ok = 0;
+                }
+            }
+            crypto_engine_destroy(engine);
+            remove(big_input);
+            remove(big_encrypted);
+            
+            if (ok) {
+                printf("  [PASS] 4개 작업 모두 취소, 출력 파일 없음\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 취소한 작업이 실행되었거나 출력 파일이 남았습니다\n");
+            }
+        }
+        
+        for (int i = 0; i < 6; i++) {
+            remove(inputs[i]);
+            remove(encrypted[i]);
+        }
+    }
+    
+    // 암호화 아카이브 테스트 (KDF 한 번, 항목별 키/nonce, 암호화된 색인)
+    printf("--- 암호화 아카이브 테스트 ---\n");
+    {
+        const char* archive_path = "e2e_archive.aesa";
+        const char* inputs[3] = { "e2e_archive_0.txt", "e2e_archive_1.bin", "e2e_archive_2.txt" };
+        const char* names[3] = { "e2e_archive_entry_0", "e2e_archive_entry_1", "e2e_archive_entry_2" };
+        const char* outputs[3] = { "e2e_archive_out_0", "e2e_archive_out_1", "e2e_archive_out_2" };
+        int created = create_test_file(inputs[1], 1);
+        for (int i = 0; i < 3; i += 2) {
+            FILE* fs = fopen(inputs[i], "wb");
+            if (fs) {
+                for (int j = 0; j < 3000 * (i + 1); j++) fputc('a' + ((i + j) % 26), fs);
+                fclose(fs);
+            } else {
+                created = 0;
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] enc_archive_create/add/extract, 다시 열어 추가 후 전체 추출\n");
+        {
+            EncArchive* archive = NULL;
+            int ok = created && enc_archive_create(archive_path, "TestPass123", 256, &archive) == FILE_CRYPTO_SUCCESS;
+            for (int i = 0; ok && i < 2; i++) {
+                if (enc_archive_add_file(archive, inputs[i], names[i]) != FILE_CRYPTO_SUCCESS) ok = 0;
+            }
+            // 경로 구분자와 Windows에서 드라이브/대체 데이터 스트림으로 해석되는 이름은 거부
+            const char* bad_names[4] = { "../escape.txt", "C:evil", "name:stream", "what?.txt" };
+            for (int i = 0; ok && i < 4; i++) {
+                if (enc_archive_add_file(archive, inputs[2], bad_names[i]) != FILE_CRYPTO_ERR_INVALID_INPUT) ok = 0;
+            }
+            if (archive && enc_archive_close(archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+            
+            // 다시 열어 새 항목과 같은 이름의 새 내용 추가 (뒤 항목이 우선)
+            archive = NULL;
+            if (ok && enc_archive_open(archive_path, "TestPass123", 1, &archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+            if (ok && (enc_archive_add_file(archive, inputs[2], names[2]) != FILE_CRYPTO_SUCCESS ||
+                       enc_archive_add_file(archive, inputs[2], names[0]) != FILE_CRYPTO_SUCCESS)) {
+                ok = 0;
+            }
+            if (archive && enc_archive_close(archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+            
+            archive = NULL;
+            if (ok && enc_archive_open(archive_path, "TestPass123", 0, &archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+            ArchiveEntryInfo info;
+            if (ok && (enc_archive_entry_count(archive) != 4 ||
+                       enc_archive_entry_info(archive, 1, &info) != FILE_CRYPTO_SUCCESS ||
+                       strcmp(info.name, names[1]) != 0 || enc_archive_find(archive, names[0]) != 3)) {
+                ok = 0;
+            }
+            // 항목 하나만 추출 (첫 번째 항목은 이름 검색에서 가려졌지만 번호로는 추출 가능)
+            if (ok && (enc_archive_extract(archive, 0, outputs[0]) != FILE_CRYPTO_SUCCESS ||
+                       enc_archive_extract(archive, (size_t)enc_archive_find(archive, names[1]), outputs[1]) != FILE_CRYPTO_SUCCESS ||
+                       !compare_files(inputs[0], outputs[0]) || !compare_files(inputs[1], outputs[1]))) {
+                ok = 0;
+            }
+            size_t extracted = 0;
+            if (ok && (enc_archive_extract_all(archive, ".", &extracted) != FILE_CRYPTO_SUCCESS || extracted != 3)) {
+                ok = 0;
+            }
+            if (archive) enc_archive_close(archive);
+            
+            for (int i = 0; ok && i < 3; i++) {
+                // names[0]에는 나중에 추가한 inputs[2] 내용이 들어 있어야 함
+                if (!compare_files((i == 0) ? inputs[2] : inputs[i], names[i])) ok = 0;
+            }
+            for (int i = 0; i < 3; i++) {
+                remove(names[i]);
+                remove(outputs[i]);
+            }
+            
+            if (ok) {
+                printf("  [PASS] 항목 4개, 개별/전체 추출 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 아카이브 추가/추출 결과가 잘못되었습니다\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 잘못된 비밀번호, 항목 변조, 색인 변조\n");
+        {
+            EncArchive* archive = NULL;
+            int ok = (enc_archive_open(archive_path, "WrongPass1", 0, &archive) == FILE_CRYPTO_ERR_KEY_CHECK_FAILED &&
+                      archive == NULL);
+            
+            // 첫 항목 암호문 한 바이트 변조: 그 항목만 실패하고 출력 파일은 남지 않음
+            FILE* fs = fopen(archive_path, "r+b");
+            if (fs && fseek(fs, ARCHIVE_HEADER_SIZE + 100, SEEK_SET) == 0) {
+                int c = fgetc(fs);
+                fseek(fs, ARCHIVE_HEADER_SIZE + 100, SEEK_SET);
+                fputc(c ^ 0x01, fs);
+            } else {
+                ok = 0;
+            }
+            if (fs) fclose(fs);
+            if (ok && enc_archive_open(archive_path, "TestPass123", 0, &archive) == FILE_CRYPTO_SUCCESS) {
+                if (enc_archive_extract(archive, 0, outputs[0]) != FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED ||
+                    access(outputs[0], F_OK) == 0 ||
+                    enc_archive_extract(archive, 1, outputs[1]) != FILE_CRYPTO_SUCCESS ||
+                    !compare_files(inputs[1], outputs[1])) {
+                    ok = 0;
+                }
+                enc_archive_close(archive);
+            } else {
+                ok = 0;
+            }
+            remove(outputs[1]);
+            
+            // 트레일러 바로 앞(색인 태그) 변조: 열기 실패
+            fs = fopen(archive_path, "r+b");
+            if (fs && fseek(fs, -(long)(ARCHIVE_TRAILER_SIZE + 1), SEEK_END) == 0) {
+                int c = fgetc(fs);
+                fseek(fs, -(long)(ARCHIVE_TRAILER_SIZE + 1), SEEK_END);
+                fputc(c ^ 0x01, fs);
+            } else {
+                ok = 0;
+            }
+            if (fs) fclose(fs);
+            archive = NULL;
+            if (enc_archive_open(archive_path, "TestPass123", 0, &archive) != FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) ok = 0;
+            if (archive) enc_archive_close(archive);
+            
+            if (ok) {
+                printf("  [PASS] 비밀번호 거부, 변조된 항목/색인 검출\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 잘못된 비밀번호나 변조를 검출하지 못했습니다\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 추가 도중 중단된 아카이브에서 기존 항목 목록/추출, 다시 추가\n");
+        {
+            const char* cut_path = "e2e_archive_cut.aesa";
+            EncArchive* archive = NULL;
+            int ok = created && enc_archive_create(cut_path, "TestPass123", 128, &archive) == FILE_CRYPTO_SUCCESS;
+            for (int i = 0; ok && i < 2; i++) {
+                if (enc_archive_add_file(archive, inputs[i], names[i]) != FILE_CRYPTO_SUCCESS) ok = 0;
+            }
+            if (archive && enc_archive_close(archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+            uint64_t committed_size = get_file_size(cut_path);
+            
+            // 중단된 추가가 남기는 상태: 트레일러 뒤에 항목 암호문 일부 (트레일러 서명과 같은 바이트 포함)
+            for (int round = 0; ok && round < 2; round++) {
+                FILE* fs = fopen(cut_path, "ab");
+                if (!fs) {
+                    ok = 0;
+                    break;
+                }
+                for (int j = 0; j < 70000; j++) fputc((j % 9000 == 17) ? "AESI"[0] : (j * 131 + round) & 0xFF, fs);
+                fputs(ARCHIVE_TRAILER_SIGNATURE, fs);
+                for (int j = 0; j < ARCHIVE_TRAILER_SIZE; j++) fputc(j, fs);
+                fclose(fs);
+                
+                archive = NULL;
+                if (enc_archive_open(cut_path, "TestPass123", 0, &archive) != FILE_CRYPTO_SUCCESS ||
+                    enc_archive_entry_count(archive) != 2 ||
+                    enc_archive_extract(archive, 0, outputs[0]) != FILE_CRYPTO_SUCCESS ||
+                    enc_archive_extract(archive, 1, outputs[1]) != FILE_CRYPTO_SUCCESS ||
+                    !compare_files(inputs[0], outputs[0]) || !compare_files(inputs[1], outputs[1])) {
+                    ok = 0;
+                }
+                if (archive) enc_archive_close(archive);
+                
+                // 첫 번째: 추가 없이 쓰기로 열고 닫으면 남은 바이트 제거, 두 번째: 그 자리에 새 항목 추가
+                archive = NULL;
+                if (ok && enc_archive_open(cut_path, "TestPass123", 1, &archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+                if (ok && round == 1 && enc_archive_add_file(archive, inputs[2], names[2]) != FILE_CRYPTO_SUCCESS) ok = 0;
+                if (archive && enc_archive_close(archive) != FILE_CRYPTO_SUCCESS) ok = 0;
+                if (ok && round == 0 && get_file_size(cut_path) != committed_size) ok = 0;
+            }
+            
+            archive = NULL;
+            if (ok && (enc_archive_open(cut_path, "TestPass123", 0, &archive) != FILE_CRYPTO_SUCCESS ||
+                       enc_archive_entry_count(archive) != 3 ||
+                       enc_archive_extract(archive, 2, outputs[2]) != FILE_CRYPTO_SUCCESS ||
+                       enc_archive_extract(archive, 0, outputs[0]) != FILE_CRYPTO_SUCCESS ||
+                       !compare_files(inputs[2], outputs[2]) || !compare_files(inputs[0], outputs[0]))) {
+                ok = 0;
+            }
+            if (archive) enc_archive_close(archive);
+            
+            remove(cut_path);
+            for (int i = 0; i < 3; i++) {
+                remove(outputs[i]);
+            }
+            
+            if (ok) {
+                printf("  [PASS] 기존 항목 2개 유지, 남은 바이트 제거 후 항목 추가\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 중단된 추가 뒤 기존 항목을 읽지 못했습니다\n");
+            }
+        }
+        
+        remove(archive_path);
+        for (int i = 0; i < 3; i++) {
+            remove(inputs[i]);
+        }
+    }
+    printf("\n");
+    
+    // 압축 후 암호화 테스트 (v7: 압축되는 데이터는 작아지고, 압축되지 않는 데이터는 그대로 저장)
+    printf("--- 압축 후 암호화 테스트 ---\n");
+    {
+        const char* inputs[2] = { "e2e_compress_text.txt", "e2e_compress_mixed.bin" };
+        const char* encrypted[2] = { "e2e_compress_text.enc", "e2e_compress_mixed.enc" };
+        const char* decrypted[2] = { "e2e_compress_text_out.txt", "e2e_compress_mixed_out.bin" };
+        int created = 1;
+        FILE* fs = fopen(inputs[1], "wb");
+        if (fs) {
+            // 짧은 텍스트 뒤에 무작위 데이터 2MB: 압축 프레임과 저장 프레임이 섞여 프레임 경계가 암호화 청크 경계와 어긋남
+            for (int i = 0; i < 2000; i++) fprintf(fs, "header line %d\n", i);
+            for (int i = 0; i < 2 * 1024 * 1024; i++) fputc(rand() % 256, fs);
+            fclose(fs);
+        } else {
+            created = 0;
+        }
+        fs = fopen(inputs[0], "wb");
+        if (fs) {
+            // 로그처럼 반복이 많은 텍스트 (약 1.5MB, 블록 여러 개)
+            for (int i = 0; i < 30000; i++) {
+                fprintf(fs, "2026-01-01 12:00:%02d INFO request %d handled in %d ms\n", i % 60, i, i % 97);
+            }
+            fclose(fs);
+        } else {
+            created = 0;
+        }
+        
+        set_encryption_format(ENC_FORMAT_COMPRESSED);
+        int encrypt_result[2];
+        for (int i = 0; i < 2; i++) {
+            encrypt_result[i] = created && encrypt_file(inputs[i], encrypted[i], 256, "TestPass123");
+        }
+        set_encryption_format(ENC_FORMAT_DEFAULT);
+        
+        total_count++;
+        printf("  [테스트] encrypt_file(압축) → decrypt_file (텍스트, 텍스트 + 무작위 데이터)\n");
+        {
+            int ok = 1;
+            long sizes[2][2] = { { 0, 0 }, { 0, 0 } };
+            for (int i = 0; ok && i < 2; i++) {
+                unsigned char header_bytes[5] = { 0 };
+                FILE* in = fopen(encrypted[i], "rb");
+                if (!encrypt_result[i] || !in || fread(header_bytes, 1, 5, in) != 5 ||
+                    header_bytes[4] != ENC_VERSION_COMPRESSED) {
+                    ok = 0;
+                }
+                if (in) {
+                    fseek(in, 0, SEEK_END);
+                    sizes[i][1] = ftell(in);
+                    fclose(in);
+                }
+                FILE* plain = fopen(inputs[i], "rb");
+                if (plain) {
+                    fseek(plain, 0, SEEK_END);
+                    sizes[i][0] = ftell(plain);
+                    fclose(plain);
+                }
+                
+                char final_path[512];
+                if (ok && !(decrypt_file(encrypted[i], decrypted[i], "TestPass123", final_path, sizeof(final_path)) &&
+                            compare_files(inputs[i], final_path))) {
+                    ok = 0;
+                }
+                remove(decrypted[i]);
+            }
+            // 텍스트는 절반 이하로 줄고, 무작위 데이터는 프레임 헤더만큼만 늘어남
+            if (ok && sizes[0][1] * 2 < sizes[0][0] && sizes[1][1] < sizes[1][0] + 4096) {
+                printf("  [PASS] v7 헤더, 파일 내용 일치 (텍스트 %ld → %ld 바이트)\n", sizes[0][0], sizes[0][1]);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 압축 형식 암복호화 실패\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] enc_pread(v7) 순차/역방향 읽기, 변조 거부\n");
+        {
+            const int64_t offsets[4] = { 100000, 12345, 200000, 1000 };
+            EncReader* reader = encrypt_result[0] ? enc_open(encrypted[0], "TestPass123") : NULL;
+            FILE* plain = fopen(inputs[0], "rb");
+            int ok = (reader != NULL && plain != NULL);
+            if (ok) {
+                fseek(plain, 0, SEEK_END);
+                ok = (enc_size(reader) == ftell(plain));
+            }
+            for (int i = 0; ok && i < 4; i++) {
+                unsigned char expected[70000];
+                unsigned char actual[70000];  // 64 KiB 블록 경계를 가로지르는 길이
+                size_t expected_len = 0;
+                if (fseek(plain, (long)offsets[i], SEEK_SET) == 0) {
+                    expected_len = fread(expected, 1, sizeof(expected), plain);
+                }
+                int64_t got = enc_pread(reader, actual, sizeof(actual), offsets[i]);
+                if (got != (int64_t)expected_len || memcmp(expected, actual, expected_len) != 0) ok = 0;
+            }
+            if (plain) fclose(plain);
+            if (reader) enc_close(reader);
+            
+            // 암호문 중간 한 바이트 변조: HMAC 불일치로 복호화/검증/열기 모두 실패
+            FILE* ft = ok ? fopen(encrypted[0], "r+b") : NULL;
+            long position = (long)(ENC_HEADER_SIZE + ENC_HMAC_SIZE + ENC_COMPRESSION_INFO_SIZE + 5000);
+            int tampered = 0;
+            if (ft && fseek(ft, position, SEEK_SET) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, position, SEEK_SET) == 0 && fputc(c ^ 0x01, ft) != EOF) {
+                    tampered = 1;
+                }
+            }
+            if (ft) fclose(ft);
+            
+            char final_path[512];
+            if (tampered && !decrypt_file(encrypted[0], decrypted[0], "TestPass123", final_path, sizeof(final_path)) &&
+                access(decrypted[0], F_OK) != 0 && !verify_file(encrypted[0], "TestPass123") &&
+                enc_open(encrypted[0], "TestPass123") == NULL) {
+                printf("  [PASS] 임의 위치 읽기 일치, 변조 감지\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] v7 임의 위치 읽기 또는 변조 감지 실패\n");
+            }
+            remove(decrypted[0]);
+        }
+        
+        for (int i = 0; i < 2; i++) {
+            remove(inputs[i]);
+            remove(encrypted[i]);
+        }
+    }
+    printf("\n");
+    
+    // 증분 암호화 테스트 (v8: 출력이 같은 비밀번호의 v8 파일이면 지문이 바뀐 청크만 다시 암호화)
+    printf("--- 증분 암호화 테스트 ---\n");
+    {
+        const char* input = "e2e_incremental.bin";
+        const char* encrypted = "e2e_incremental.enc";
+        const char* decrypted = "e2e_incremental_out.bin";
+        size_t capacity = 16 * ENC_CHUNK_SIZE + 100 + 70000;
+        unsigned char* data = (unsigned char*)malloc(capacity);
+        if (data) {
+            for (size_t i = 0; i < capacity; i++) data[i] = (unsigned char)(rand() % 256);
+        }
+        remove(encrypted);
+        
+        total_count++;
+        printf("  [테스트] encrypt_file_incremental 새로 만들기 → 한 청크 수정 → 늘이기 → 줄이기\n");
+        {
+            // 단계별 입력 크기, 수정 위치 (-1이면 수정 없음), 다시 암호화해야 하는 청크 수
+            const size_t sizes[4] = { 16 * ENC_CHUNK_SIZE + 100, 16 * ENC_CHUNK_SIZE + 100,
+                                      16 * ENC_CHUNK_SIZE + 100 + 70000, 500000 };
+            const long edits[4] = { -1, 200000, -1, -1 };
+            const uint64_t expected_written[4] = { 17, 1, 2, 1 };
+            int ok = (data != NULL);
+            for (int step = 0; ok && step < 4; step++) {
+                if (edits[step] >= 0) data[edits[step]] ^= 0x5A;
+                FILE* fs = fopen(input, "wb");
+                if (!fs || fwrite(data, 1, sizes[step], fs) != sizes[step]) ok = 0;
+                if (fs) fclose(fs);
+                
+                EncIncrementalStats stats;
+                memset(&stats, 0, sizeof(stats));
+                char final_path[512];
+                if (!ok || !encrypt_file_incremental(input, encrypted, 256, "TestPass123", &stats) ||
+                    stats.chunks_written != expected_written[step] || stats.full_rewrite != (step == 0) ||
+                    !(decrypt_file(encrypted, decrypted, "TestPass123", final_path, sizeof(final_path)) &&
+                      compare_files(input, final_path))) {
+                    ok = 0;
+                }
+                remove(decrypted);
+            }
+            
+            // 줄인 뒤에는 남는 청크 없이 잘려 있어야 함
+            long expected_size = (long)(ENC_HEADER_SIZE + ENC_HMAC_SIZE) + 8 * ENC_CHUNK_META_SIZE + 500000;
+            FILE* fe = ok ? fopen(encrypted, "rb") : NULL;
+            if (!fe || fseek(fe, 0, SEEK_END) != 0 || ftell(fe) != expected_size) ok = 0;
+            if (fe) fclose(fe);
+            
+            if (ok) {
+                printf("  [PASS] 바뀐 청크만 기록 (17 → 1 → 2 → 1), 파일 내용 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 증분 암호화 실패\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] enc_pread(v8) 청크 경계 읽기, 변조된 청크 거부, 다른 비밀번호는 전체 재암호화\n");
+        {
+            const int64_t offsets[3] = { 60000, 300000, 440000 };
+            EncReader* reader = enc_open(encrypted, "TestPass123");
+            int ok = (reader != NULL && data != NULL && enc_size(reader) == 500000);
+            for (int i = 0; ok && i < 3; i++) {
+                unsigned char actual[70000];  // 64 KiB 청크 경계를 가로지르는 길이
+                size_t expected_len = (offsets[i] + (int64_t)sizeof(actual) > 500000) ?
+                                      (size_t)(500000 - offsets[i]) : sizeof(actual);
+                int64_t got = enc_pread(reader, actual, sizeof(actual), offsets[i]);
+                if (got != (int64_t)expected_len || memcmp(data + offsets[i], actual, expected_len) != 0) ok = 0;
+            }
+            if (reader) enc_close(reader);
+            
+            // 청크 2의 암호문 한 바이트 변조: 그 청크를 읽을 때만 실패 (다른 청크는 읽힘)
+            FILE* ft = ok ? fopen(encrypted, "r+b") : NULL;
+            long position = (long)(ENC_HEADER_SIZE + ENC_HMAC_SIZE) + 2 * (ENC_CHUNK_META_SIZE + ENC_CHUNK_SIZE) +
+                            ENC_CHUNK_META_SIZE + 10;
+            int tampered = 0;
+            if (ft && fseek(ft, position, SEEK_SET) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, position, SEEK_SET) == 0 && fputc(c ^ 0x01, ft) != EOF) {
+                    tampered = 1;
+                }
+            }
+            if (ft) fclose(ft);
+            
+            unsigned char probe[16];
+            char final_path[512];
+            reader = tampered ? enc_open(encrypted, "TestPass123") : NULL;
+            if (!reader || enc_pread(reader, probe, sizeof(probe), 0) != (int64_t)sizeof(probe) ||
+                enc_pread(reader, probe, sizeof(probe), 2 * ENC_CHUNK_SIZE + 5) != -1 ||
+                decrypt_file(encrypted, decrypted, "TestPass123", final_path, sizeof(final_path)) ||
+                access(decrypted, F_OK) == 0 || verify_file(encrypted, "TestPass123")) {
+                ok = 0;
+            }
+            if (reader) enc_close(reader);
+            remove(decrypted);
+            
+            // 다른 비밀번호로 갱신하면 기존 청크를 쓸 수 없으므로 새 salt로 모두 다시 암호화
+            EncIncrementalStats stats;
+            memset(&stats, 0, sizeof(stats));
+            if (ok && !(encrypt_file_incremental(input, encrypted, 256, "OtherPass456", &stats) &&
+                        stats.full_rewrite && stats.chunks_written == 8 &&
+                        decrypt_file(encrypted, decrypted, "OtherPass456", final_path, sizeof(final_path)) &&
+                        compare_files(input, final_path))) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] 임의 위치 읽기 일치, 변조된 청크 감지, 비밀번호 변경 시 전체 재암호화\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] v8 임의 위치 읽기, 변조 감지 또는 재암호화 실패\n");
+            }
+        }
+        
+        free(data);
+        remove(input);
+        remove(encrypted);
+    }
+    printf("\n");
+    
+    // 키 슬롯 테스트 (v9: 비밀번호 변경/추가/삭제는 키 슬롯만 다시 기록)
+    printf("--- 키 슬롯 / 비밀번호 변경 테스트 ---\n");
+    {
+        const char* input = "e2e_keyslots.bin";
+        const char* encrypted = "e2e_keyslots.enc";
+        const char* decrypted = "e2e_keyslots_out.bin";
+        const long slot_table_start = (long)(ENC_HEADER_SIZE + ENC_HMAC_SIZE);
+        const long slot_table_end = slot_table_start + KEY_SLOT_TABLE_SIZE;
+        int created = 0;
+        FILE* fs = fopen(input, "wb");
+        if (fs) {
+            for (int i = 0; i < 300000; i++) fputc(rand() % 256, fs);
+            created = (fclose(fs) == 0);
+        }
+        set_encryption_format(ENC_FORMAT_KEYSLOTS);
+        int encrypt_result = created && encrypt_file(input, encrypted, 192, "OldPass1");
+        set_encryption_format(ENC_FORMAT_DEFAULT);
+        
+        total_count++;
+        printf("  [테스트] enc_rekey: 키 슬롯 외 바이트 불변, 이전 비밀번호 거부, 새 비밀번호로 복호화\n");
+        {
+            unsigned char* before = (unsigned char*)malloc(400000);
+            unsigned char* after = (unsigned char*)malloc(400000);
+            size_t before_len = 0, after_len = 0;
+            FILE* fe = encrypt_result ? fopen(encrypted, "rb") : NULL;
+            if (fe && before) before_len = fread(before, 1, 400000, fe);
+            if (fe) fclose(fe);
+            
+            int ok = (before_len > (size_t)slot_table_end && before[4] == ENC_VERSION_KEYSLOTS &&
+                      enc_rekey(encrypted, "OldPass1", "NewPass2") == FILE_CRYPTO_SUCCESS);
+            fe = ok ? fopen(encrypted, "rb") : NULL;
+            if (fe && after) after_len = fread(after, 1, 400000, fe);
+            if (fe) fclose(fe);
+            
+            // 헤더, HMAC, 암호문은 그대로이고 슬롯 표만 바뀜
+            if (!ok || after_len != before_len ||
+                memcmp(before, after, (size_t)slot_table_start) != 0 ||
+                memcmp(before + slot_table_end, after + slot_table_end, before_len - (size_t)slot_table_end) != 0 ||
+                memcmp(before + slot_table_start, after + slot_table_start, KEY_SLOT_TABLE_SIZE) == 0) {
+                ok = 0;
+            }
+            
+            char final_path[512];
+            if (ok && (decrypt_file(encrypted, decrypted, "OldPass1", final_path, sizeof(final_path)) ||
+                       !decrypt_file(encrypted, decrypted, "NewPass2", final_path, sizeof(final_path)) ||
+                       !compare_files(input, final_path))) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            unsigned char probe[1000];
+            EncReader* reader = ok ? enc_open(encrypted, "NewPass2") : NULL;
+            FILE* plain = fopen(input, "rb");
+            unsigned char expected[1000];
+            if (!reader || !plain || fseek(plain, 123456, SEEK_SET) != 0 ||
+                fread(expected, 1, sizeof(expected), plain) != sizeof(expected) ||
+                enc_pread(reader, probe, sizeof(probe), 123456) != (int64_t)sizeof(probe) ||
+                memcmp(expected, probe, sizeof(probe)) != 0) {
+                ok = 0;
+            }
+            if (plain) fclose(plain);
+            if (reader) enc_close(reader);
+            free(before);
+            free(after);
+            
+            if (ok) {
+                printf("  [PASS] 슬롯 표 %d바이트만 변경, 파일 내용 일치\n", KEY_SLOT_TABLE_SIZE);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 비밀번호 변경 실패\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 키 슬롯 추가/삭제, 마지막 슬롯 삭제 거부, 변조된 슬롯 거부, v4 파일 거부\n");
+        {
+            int added = -1;
+            uint8_t states[ENC_KEY_SLOT_COUNT];
+            int ok = encrypt_result &&
+                     enc_add_key_slot(encrypted, "NewPass2", "Second3", &added) == FILE_CRYPTO_SUCCESS &&
+                     verify_file(encrypted, "NewPass2") && verify_file(encrypted, "Second3") &&
+                     enc_key_slot_states(encrypted, states) == FILE_CRYPTO_SUCCESS;
+            int active = 0;
+            for (int i = 0; ok && i < ENC_KEY_SLOT_COUNT; i++) {
+                if (states[i] == ENC_KEY_SLOT_ACTIVE) active++;
+            }
+            if (active != 2 || enc_add_key_slot(encrypted, "Wrong9", "Third4", NULL) != FILE_CRYPTO_ERR_KEY_CHECK_FAILED) {
+                ok = 0;
+            }
+            
+            // 추가한 슬롯을 다른 비밀번호로 삭제하면 그 비밀번호로는 열리지 않고, 마지막 슬롯은 지울 수 없음
+            int remaining = -1;
+            for (int i = 0; i < ENC_KEY_SLOT_COUNT; i++) {
+                if (states[i] == ENC_KEY_SLOT_ACTIVE && i != added) remaining = i;
+            }
+            if (!ok || remaining < 0 ||
+                enc_remove_key_slot(encrypted, "NewPass2", added) != FILE_CRYPTO_SUCCESS ||
+                verify_file(encrypted, "Second3") || !verify_file(encrypted, "NewPass2") ||
+                enc_remove_key_slot(encrypted, "NewPass2", remaining) != FILE_CRYPTO_ERR_INVALID_INPUT) {
+                ok = 0;
+            }
+            
+            // 남은 슬롯의 감싼 키 한 바이트 변조: 슬롯 태그 불일치로 비밀번호가 맞아도 열리지 않음
+            FILE* ft = ok ? fopen(encrypted, "r+b") : NULL;
+            long position = slot_table_start + (long)remaining * ENC_KEY_SLOT_SIZE + 30;
+            int tampered = 0;
+            if (ft && fseek(ft, position, SEEK_SET) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, position, SEEK_SET) == 0 && fputc(c ^ 0x01, ft) != EOF) tampered = 1;
+            }
+            if (ft) fclose(ft);
+            if (!tampered || verify_file(encrypted, "NewPass2") || enc_open(encrypted, "NewPass2") != NULL) ok = 0;
+            
+            // 키 슬롯이 없는 v4 파일은 데이터를 다시 암호화하지 않고는 비밀번호를 바꿀 수 없음
+            if (!encrypt_file(input, decrypted, 256, "OldPass1") ||
+                enc_rekey(decrypted, "OldPass1", "NewPass2") != FILE_CRYPTO_ERR_UNSUPPORTED_VERSION) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] 슬롯 %d 추가 후 삭제, 변조와 v4 파일 거부\n", added);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 키 슬롯 관리 실패\n");
+            }
+        }
+        
+        remove(input);
+        remove(encrypted);
+    }
+    printf("\n");
+    
+    // 추가 암호화 테스트 (v6: 마지막 세그먼트와 새 세그먼트만 기록)
+    printf("--- 추가 암호화 테스트 ---\n");
+    {
+        const char* encrypted = "e2e_append.enc";
+        const char* decrypted = "e2e_append_out.bin";
+        // 네 번째 추가로 2 MiB를 정확히 채우면 빈 마지막 세그먼트가 붙고, 다섯 번째 추가에서 채워짐
+        const size_t pieces[] = { 700000, 1, 700000, (size_t)2 * ENC_SEGMENT_SIZE - 1400001, 5000 };
+        const size_t piece_count = sizeof(pieces) / sizeof(pieces[0]);
+        size_t total = 0;
+        for (size_t i = 0; i < piece_count; i++) total += pieces[i];
+        unsigned char* data = (unsigned char*)malloc(total);
+        unsigned char* before = (unsigned char*)malloc(total + 4096);
+        unsigned char* after = (unsigned char*)malloc(total + 4096);
+        for (size_t i = 0; data && i < total; i++) data[i] = (unsigned char)(rand() % 256);
+        remove(encrypted);
+        
+        total_count++;
+        printf("  [테스트] 세그먼트 경계를 넘는 여러 번의 추가: 기존 바이트 불변, 전체 복호화 일치\n");
+        {
+            int ok = (data && before && after);
+            size_t offset = 0;
+            size_t before_len = 0;
+            for (size_t i = 0; ok && i < piece_count; i++) {
+                if (encrypt_append(encrypted, data + offset, pieces[i], 128, "AppendPw1") != FILE_CRYPTO_SUCCESS) {
+                    ok = 0;
+                    break;
+                }
+                offset += pieces[i];
+                
+                // 이전 파일에서 마지막 태그를 뺀 모든 바이트가 그대로 남아 있어야 함
+                FILE* fe = fopen(encrypted, "rb");
+                size_t after_len = fe ? fread(after, 1, total + 4096, fe) : 0;
+                if (fe) fclose(fe);
+                if (after_len <= before_len ||
+                    (i > 0 && memcmp(before, after, before_len - ENC_HMAC_SIZE) != 0)) {
+                    ok = 0;
+                }
+                memcpy(before, after, after_len);
+                before_len = after_len;
+            }
+            
+            FILE* fin = ok ? fopen(encrypted, "rb") : NULL;
+            FILE* fout = fin ? fopen(decrypted, "wb") : NULL;
+            int stream_ok = fin && fout && decrypt_stream(fin, fout, "AppendPw1");
+            if (fin) fclose(fin);
+            if (fout) fclose(fout);
+            
+            fin = stream_ok ? fopen(decrypted, "rb") : NULL;
+            size_t read_len = fin ? fread(after, 1, total + 4096, fin) : 0;
+            if (fin) fclose(fin);
+            if (!stream_ok || read_len != total || memcmp(after, data, total) != 0 ||
+                before_len != sizeof(EncFileHeader) + total + 3 * ENC_HMAC_SIZE) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] %zu번 추가, %zu바이트 일치\n", piece_count, total);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 추가 암호화 실패\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 잘못된 비밀번호, 변조된 마지막 세그먼트, v4 파일에 추가 거부\n");
+        {
+            int ok = (encrypt_append(encrypted, "x", 1, 128, "WrongPw1") == FILE_CRYPTO_ERR_KEY_CHECK_FAILED);
+            
+            // 거부된 추가는 파일을 바꾸지 않음
+            FILE* fe = fopen(encrypted, "rb");
+            size_t current_len = (fe && after) ? fread(after, 1, total + 4096, fe) : 0;
+            if (fe) fclose(fe);
+            if (!before || current_len != sizeof(EncFileHeader) + total + 3 * ENC_HMAC_SIZE ||
+                memcmp(before, after, current_len) != 0) {
+                ok = 0;
+            }
+            
+            // 마지막 세그먼트 암호문 한 바이트 변조
+            FILE* ft = ok ? fopen(encrypted, "r+b") : NULL;
+            int tampered = 0;
+            if (ft && fseek(ft, -(long)ENC_HMAC_SIZE - 10, SEEK_END) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, -(long)ENC_HMAC_SIZE - 10, SEEK_END) == 0 && fputc(c ^ 0x01, ft) != EOF) {
+                    tampered = 1;
+                }
+            }
+            if (ft) fclose(ft);
+            if (!tampered ||
+                encrypt_append(encrypted, "x", 1, 128, "AppendPw1") != FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED) {
+                ok = 0;
+            }
+            
+            // 전체 HMAC 하나뿐인 v4 파일은 앞부분을 다시 읽지 않고는 이어 붙일 수 없음
+            FILE* fs = fopen(decrypted, "wb");
+            if (fs) {
+                fwrite("plain", 1, 5, fs);
+                fclose(fs);
+            }
+            if (!encrypt_file(decrypted, encrypted, 256, "AppendPw1") ||
+                encrypt_append(encrypted, "x", 1, 256, "AppendPw1") != FILE_CRYPTO_ERR_UNSUPPORTED_VERSION) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] 모두 거부, 거부된 추가는 파일 불변\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 잘못된 추가가 거부되지 않았습니다\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 마지막 세그먼트를 다시 쓰다 중단된 추가: 다음 추가가 저널로 되돌린 뒤 이어 붙임\n");
+        {
+            const char* cut = "e2e_append_cut.enc";
+            const char* expected = "e2e_append_cut.bin";
+            char journal[256];
+            snprintf(journal, sizeof(journal), "%s%s", cut, ENC_APPEND_JOURNAL_SUFFIX);
+            const size_t tail_plain = 300000;
+            const size_t first = ENC_SEGMENT_SIZE + tail_plain;
+            const size_t second = 5000;
+            remove(cut);
+            remove(journal);
+            int ok = (data && after && total >= first + second &&
+                      encrypt_append(cut, data, first, 192, "AppendPw1") == FILE_CRYPTO_SUCCESS &&
+                      access(journal, F_OK) != 0);
+            
+            // encrypt_append가 꼬리를 덮어쓰기 전에 남기는 저널을 같은 형식으로 만들고,
+            // 꼬리 일부를 덮어쓰고 뒤에 바이트를 붙여 기록 도중 중단된 파일을 흉내 냄
+            FILE* fe = ok ? fopen(cut, "rb") : NULL;
+            size_t cut_len = fe ? fread(after, 1, total + 4096, fe) : 0;
+            if (fe) fclose(fe);
+            const size_t tail_offset = sizeof(EncFileHeader) + ENC_SEGMENT_SIZE + ENC_HMAC_SIZE;
+            if (cut_len != tail_offset + tail_plain + ENC_HMAC_SIZE) ok = 0;
+            if (ok) {
+                EncFileHeader header;
+                EncAppendJournal record;
+                uint8_t aes_key[32];
+                uint8_t hmac_key[HMAC_KEY_SIZE];
+                uint8_t full_tag[HMAC_SHA512_DIGEST_SIZE];
+                HMAC_SHA512_CTX hmac_ctx;
+                memcpy(&header, after, sizeof(header));
+                derive_keys("AppendPw1", 192, header.salt, ENC_SALT_SIZE, aes_key, hmac_key);
+                memset(&record, 0, sizeof(record));
+                memcpy(record.signature, ENC_APPEND_JOURNAL_SIGNATURE, 4);
+                for (int i = 0; i < 8; i++) {
+                    record.file_size[i] = (uint8_t)((uint64_t)cut_len >> (56 - 8 * i));
+                    record.tail_offset[i] = (uint8_t)((uint64_t)tail_offset >> (56 - 8 * i));
+                }
+                hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+                hmac_sha512_update(&hmac_ctx, (const uint8_t*)&record, offsetof(EncAppendJournal, tag));
+                hmac_sha512_update(&hmac_ctx, after + tail_offset, cut_len - tail_offset);
+                hmac_sha512_final(&hmac_ctx, full_tag);
+                memcpy(record.tag, full_tag, sizeof(record.tag));
+                
+                FILE* fj = fopen(journal, "wb");
+                FILE* ft = fopen(cut, "r+b");
+                if (!fj || !ft || fwrite(&record, 1, sizeof(record), fj) != sizeof(record) ||
+                    fwrite(after + tail_offset, 1, cut_len - tail_offset, fj) != cut_len - tail_offset ||
+                    fseek(ft, (long)(tail_offset + 1000), SEEK_SET) != 0) {
+                    ok = 0;
+                } else {
+                    for (int i = 0; i < 100; i++) fputc(0xAA, ft);
+                    fseek(ft, 0, SEEK_END);
+                    for (int i = 0; i < 200000; i++) fputc(i & 0xFF, ft);
+                }
+                if (fj) fclose(fj);
+                if (ft) fclose(ft);
+            }
+            
+            FILE* fx = fopen(expected, "wb");
+            if (!fx || !data || fwrite(data, 1, first + second, fx) != first + second) ok = 0;
+            if (fx) fclose(fx);
+            
+            // 되돌리기 전에는 마지막 세그먼트 태그가 맞지 않음
+            FILE* fin = ok ? fopen(cut, "rb") : NULL;
+            FILE* fout = fin ? fopen(decrypted, "wb") : NULL;
+            if (!fin || !fout || decrypt_stream(fin, fout, "AppendPw1")) ok = 0;
+            if (fin) fclose(fin);
+            if (fout) fclose(fout);
+            
+            if (ok && (encrypt_append(cut, data + first, second, 192, "AppendPw1") != FILE_CRYPTO_SUCCESS ||
+                       access(journal, F_OK) == 0)) {
+                ok = 0;
+            }
+            
+            // 기록 도중 끊긴 저널 (태그 불일치): 파일은 그대로이므로 저널만 지움
+            FILE* fj = ok ? fopen(journal, "wb") : NULL;
+            if (fj) {
+                fputs(ENC_APPEND_JOURNAL_SIGNATURE, fj);
+                for (int i = 0; i < 100; i++) fputc(i, fj);
+                fclose(fj);
+            }
+            if (!fj || encrypt_append(cut, "", 0, 192, "AppendPw1") != FILE_CRYPTO_SUCCESS || access(journal, F_OK) == 0) {
+                ok = 0;
+            }
+            
+            fin = ok ? fopen(cut, "rb") : NULL;
+            fout = fin ? fopen(decrypted, "wb") : NULL;
+            int stream_ok = fin && fout && decrypt_stream(fin, fout, "AppendPw1");
+            if (fin) fclose(fin);
+            if (fout) fclose(fout);
+            if (!stream_ok || !compare_files(expected, decrypted)) ok = 0;
+            
+            remove(cut);
+            remove(journal);
+            remove(expected);
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] 기존 꼬리 복원 후 %zu바이트 추가, 끊긴 저널은 무시\n", second);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 중단된 추가를 되돌리지 못했습니다\n");
+            }
+        }
+        
+        free(data);
+        free(before);
+        free(after);
+        remove(encrypted);
+    }
+    printf("\n");
+    
+    // 제자리 암호화 테스트 (v10: 같은 파일을 청크 단위로 변환, 헤더는 끝의 트레일러)
+    printf("--- 제자리 암호화 테스트 ---\n");
+    {
+        const char* path = "e2e_inplace.dat";
+        const char* decrypted = "e2e_inplace_out.bin";
+        // 마지막 청크가 섹터 중간에서 끝나도록 청크 2개 + 일부
+        const size_t size = (size_t)2 * ENC_INPLACE_CHUNK_SIZE + 12345;
+        unsigned char* data = (unsigned char*)malloc(size);
+        unsigned char* check = (unsigned char*)malloc(size + ENC_INPLACE_TRAILER_SIZE);
+        for (size_t i = 0; data && i < size; i++) data[i] = (unsigned char)(rand() % 256);
+        FILE* fw = data ? fopen(path, "wb") : NULL;
+        if (fw) {
+            fwrite(data, 1, size, fw);
+            fclose(fw);
+        }
+        
+        total_count++;
+        printf("  [테스트] 제자리 암호화 → 일반 복호화/검증 → 제자리 복호화 왕복\n");
+        {
+            int ok = (data && check && fw);
+            if (ok && encrypt_file_in_place(path, 192, "InPlacePw1", NULL, NULL) != FILE_CRYPTO_SUCCESS) ok = 0;
+            
+            // 파일 크기는 트레일러만큼만 늘고, 저널은 남지 않음
+            FILE* fe = ok ? fopen(path, "rb") : NULL;
+            size_t encrypted_len = fe ? fread(check, 1, size + ENC_INPLACE_TRAILER_SIZE, fe) : 0;
+            if (fe) fclose(fe);
+            if (encrypted_len != size + ENC_INPLACE_TRAILER_SIZE || memcmp(check, data, 64) == 0 ||
+                enc_in_place_pending(path)) {
+                ok = 0;
+            }
+            
+            // 일반 경로도 v10 파일을 읽음
+            char final_path[512];
+            if (!ok || !verify_file(path, "InPlacePw1") ||
+                !decrypt_file(path, decrypted, "InPlacePw1", final_path, sizeof(final_path))) {
+                ok = 0;
+            }
+            FILE* fd = ok ? fopen(final_path, "rb") : NULL;
+            size_t read_len = fd ? fread(check, 1, size + ENC_INPLACE_TRAILER_SIZE, fd) : 0;
+            if (fd) fclose(fd);
+            if (read_len != size || memcmp(check, data, size) != 0) ok = 0;
+            if (ok) remove(final_path);
+            
+            char extension[8];
+            if (!ok || decrypt_file_in_place(path, "InPlacePw1", extension, sizeof(extension), NULL, NULL) !=
+                       FILE_CRYPTO_SUCCESS) {
+                ok = 0;
+            }
+            fd = ok ? fopen(path, "rb") : NULL;
+            read_len = fd ? fread(check, 1, size + ENC_INPLACE_TRAILER_SIZE, fd) : 0;
+            if (fd) fclose(fd);
+            if (read_len != size || memcmp(check, data, size) != 0 || enc_in_place_pending(path)) ok = 0;
+            
+            if (ok) {
+                printf("  [PASS] %zu바이트 일치, 트레일러 %d바이트만 증가\n", size, ENC_INPLACE_TRAILER_SIZE);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 제자리 암호화 왕복 실패\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 잘못된 비밀번호와 변조 파일은 바꾸기 전에 거부, 일반 파일과 저널 없는 되돌리기 거부\n");
+        {
+            int ok = (data && check && encrypt_file_in_place(path, 128, "InPlacePw1", NULL, NULL) == FILE_CRYPTO_SUCCESS);
+            FILE* fe = ok ? fopen(path, "rb") : NULL;
+            size_t before_len = fe ? fread(check, 1, size + ENC_INPLACE_TRAILER_SIZE, fe) : 0;
+            if (fe) fclose(fe);
+            
+            char extension[8];
+            if (decrypt_file_in_place(path, "WrongPw1", extension, sizeof(extension), NULL, NULL) !=
+                FILE_CRYPTO_ERR_KEY_CHECK_FAILED) {
+                ok = 0;
+            }
+            
+            // 암호문 한 바이트 변조: 전체 HMAC을 먼저 검증하므로 평문을 하나도 쓰지 않음
+            FILE* ft = ok ? fopen(path, "r+b") : NULL;
+            int tampered = 0;
+            if (ft && fseek(ft, (long)ENC_INPLACE_CHUNK_SIZE + 7, SEEK_SET) == 0 &&
+                fputc(check[ENC_INPLACE_CHUNK_SIZE + 7] ^ 0x01, ft) != EOF) {
+                tampered = 1;
+            }
+            if (ft) fclose(ft);
+            if (!tampered ||
+                decrypt_file_in_place(path, "InPlacePw1", extension, sizeof(extension), NULL, NULL) !=
+                FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED || enc_in_place_pending(path)) {
+                ok = 0;
+            }
+            check[ENC_INPLACE_CHUNK_SIZE + 7] ^= 0x01;
+            unsigned char* after = (unsigned char*)malloc(size + ENC_INPLACE_TRAILER_SIZE);
+            fe = after ? fopen(path, "rb") : NULL;
+            size_t after_len = fe ? fread(after, 1, size + ENC_INPLACE_TRAILER_SIZE, fe) : 0;
+            if (fe) fclose(fe);
+            if (after_len != before_len || memcmp(after, check, after_len) != 0) ok = 0;
+            free(after);
+            
+            // 앞에 헤더가 있는 일반 파일, 중단된 작업이 없는 되돌리기
+            if (!encrypt_file(path, decrypted, 256, "InPlacePw1") ||
+                decrypt_file_in_place(decrypted, "InPlacePw1", extension, sizeof(extension), NULL, NULL) !=
+                FILE_CRYPTO_ERR_UNSUPPORTED_VERSION ||
+                enc_in_place_rollback(path, "InPlacePw1") != FILE_CRYPTO_ERR_FILE_OPEN) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] 모두 거부, 거부된 파일은 불변\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 잘못된 제자리 작업이 거부되지 않았습니다\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 이미 암호화된 파일의 제자리 암호화 거부 (이름 변경 전 중단 후 재실행)\n");
+        {
+            FILE* fp = (data && check) ? fopen(path, "wb") : NULL;
+            int ok = fp && fwrite(data, 1, size, fp) == size;
+            if (fp) fclose(fp);
+            if (ok && (enc_in_place_encrypted(path) ||
+                       encrypt_file_in_place(path, 256, "InPlacePw1", NULL, NULL) != FILE_CRYPTO_SUCCESS ||
+                       !enc_in_place_encrypted(path))) {
+                ok = 0;
+            }
+            FILE* fe = ok ? fopen(path, "rb") : NULL;
+            size_t before_len = fe ? fread(check, 1, size + ENC_INPLACE_TRAILER_SIZE, fe) : 0;
+            if (fe) fclose(fe);
+            
+            // 두 번째 암호화는 저널을 만들기 전에 거부되고 파일은 그대로
+            if (ok && (encrypt_file_in_place(path, 256, "InPlacePw1", NULL, NULL) != FILE_CRYPTO_ERR_UNSUPPORTED_VERSION ||
+                       enc_in_place_pending(path))) {
+                ok = 0;
+            }
+            unsigned char* after = ok ? (unsigned char*)malloc(size + ENC_INPLACE_TRAILER_SIZE) : NULL;
+            fe = after ? fopen(path, "rb") : NULL;
+            size_t after_len = fe ? fread(after, 1, size + ENC_INPLACE_TRAILER_SIZE, fe) : 0;
+            if (fe) fclose(fe);
+            if (!after || after_len != before_len || memcmp(after, check, after_len) != 0) ok = 0;
+            free(after);
+            
+            // 앞에 헤더가 있는 일반 암호화 파일도 거부
+            if (ok && (!encrypt_file(path, decrypted, 128, "InPlacePw1") ||
+                       encrypt_file_in_place(decrypted, 128, "InPlacePw1", NULL, NULL) != FILE_CRYPTO_ERR_UNSUPPORTED_VERSION ||
+                       enc_in_place_encrypted(decrypted) || enc_in_place_pending(decrypted))) {
+                ok = 0;
+            }
+            remove(decrypted);
+            
+            if (ok) {
+                printf("  [PASS] 두 번째 암호화 거부, 파일 불변\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 이미 암호화된 파일이 다시 암호화되었습니다\n");
+            }
+        }
+        
+        free(data);
+        free(check);
+        remove(path);
+    }
+    printf("\n");
+    
+    // 체크포인트 테스트 (중단 시점의 파일 상태를 복사해 두었다가 되돌린 뒤 이어서 처리)
+    printf("--- 체크포인트 이어서 하기 테스트 ---\n");
+    {
+        const char* input = "e2e_ckpt.dat";
+        const char* encrypted = "e2e_ckpt.enc";
+        const char* encrypted_ckpt = "e2e_ckpt.enc" ENC_CHECKPOINT_SUFFIX;
+        const char* decrypted = "e2e_ckpt_out";
+        const char* decrypted_final = "e2e_ckpt_out.dat";
+        const char* decrypted_part = "e2e_ckpt_out.dat" ENC_CHECKPOINT_PART_SUFFIX;
+        const char* decrypted_ckpt = "e2e_ckpt_out.dat" ENC_CHECKPOINT_PART_SUFFIX ENC_CHECKPOINT_SUFFIX;
+        const size_t size = (size_t)5 * 1024 * 1024 + 777;
+        unsigned char* data = (unsigned char*)malloc(size);
+        for (size_t i = 0; data && i < size; i++) data[i] = (unsigned char)(rand() % 256);
+        FILE* fw = data ? fopen(input, "wb") : NULL;
+        if (fw) {
+            fwrite(data, 1, size, fw);
+            fclose(fw);
+        }
+        set_checkpoint_interval(1024 * 1024);
+        
+        total_count++;
+        printf("  [테스트] 4 MiB 지점에서 중단된 암호화/복호화를 체크포인트에서 이어서 완료\n");
+        {
+            int ok = (fw != NULL);
+            CheckpointSnapshot snapshot = { { encrypted, encrypted_ckpt }, { "e2e_ckpt_snap0", "e2e_ckpt_snap1" },
+                                            (int64_t)4 * 1024 * 1024, 0 };
+            if (!ok || encrypt_file_resumable(input, encrypted, 128, "CkptPw1", checkpoint_snapshot_progress,
+                                              &snapshot) != FILE_CRYPTO_SUCCESS ||
+                platform_file_exists(encrypted_ckpt) || !checkpoint_snapshot_restore(&snapshot)) {
+                ok = 0;
+            }
+            
+            // 되돌린 출력의 헤더(salt, nonce)가 이어서 한 결과에 그대로 남아야 함 (처음부터 다시 하지 않음)
+            EncFileHeader before_header, after_header;
+            FILE* fh = fopen(encrypted, "rb");
+            if (!fh || fread(&before_header, 1, sizeof(before_header), fh) != sizeof(before_header)) ok = 0;
+            if (fh) fclose(fh);
+            if (!ok || encrypt_file_resumable(input, encrypted, 128, "CkptPw1", NULL, NULL) != FILE_CRYPTO_SUCCESS ||
+                platform_file_exists(encrypted_ckpt)) {
+                ok = 0;
+            }
+            fh = fopen(encrypted, "rb");
+            if (!fh || fread(&after_header, 1, sizeof(after_header), fh) != sizeof(after_header) ||
+                memcmp(&before_header, &after_header, sizeof(before_header)) != 0) {
+                ok = 0;
+            }
+            if (fh) fclose(fh);
+            if (!ok || !verify_file(encrypted, "CkptPw1")) ok = 0;
+            
+            // 복호화도 같은 방법으로 중단 후 이어서 함
+            CheckpointSnapshot dec_snapshot = { { decrypted_part, decrypted_ckpt }, { "e2e_ckpt_snap0", "e2e_ckpt_snap1" },
+                                                (int64_t)4 * 1024 * 1024, 0 };
+            char final_path[512];
+            if (!ok || decrypt_file_resumable(encrypted, decrypted, "CkptPw1", final_path, sizeof(final_path),
+                                              checkpoint_snapshot_progress, &dec_snapshot) != FILE_CRYPTO_SUCCESS ||
+                !checkpoint_snapshot_restore(&dec_snapshot)) {
+                ok = 0;
+            }
+            remove(decrypted_final);
+            if (!ok || decrypt_file_resumable(encrypted, decrypted, "CkptPw1", final_path, sizeof(final_path),
+                                              NULL, NULL) != FILE_CRYPTO_SUCCESS ||
+                strcmp(final_path, decrypted_final) != 0 || !compare_files(decrypted_final, input) ||
+                platform_file_exists(decrypted_part) || platform_file_exists(decrypted_ckpt)) {
+                ok = 0;
+            }
+            remove(decrypted_final);
+            
+            if (ok) {
+                printf("  [PASS] 같은 헤더로 이어서 암호화, 복호화 결과 %zu바이트 일치\n", size);
+                pass_count++;
+            } else {
+                printf("  [FAIL] 체크포인트에서 이어서 하기 실패\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 잘못된 비밀번호 거부, 입력이 바뀌면 처음부터, 변조 파일은 게시하지 않음\n");
+        {
+            int ok = (fw != NULL);
+            CheckpointSnapshot snapshot = { { encrypted, encrypted_ckpt }, { "e2e_ckpt_snap0", "e2e_ckpt_snap1" },
+                                            (int64_t)3 * 1024 * 1024, 0 };
+            if (!ok || encrypt_file_resumable(input, encrypted, 256, "CkptPw1", checkpoint_snapshot_progress,
+                                              &snapshot) != FILE_CRYPTO_SUCCESS ||
+                !checkpoint_snapshot_restore(&snapshot)) {
+                ok = 0;
+            }
+            
+            // 다른 비밀번호: 남은 출력과 체크포인트를 건드리지 않고 거부
+            if (encrypt_file_resumable(input, encrypted, 256, "OtherPw1", NULL, NULL) != FILE_CRYPTO_ERR_KEY_CHECK_FAILED ||
+                !platform_file_exists(encrypted_ckpt)) {
+                ok = 0;
+            }
+            
+            // 체크포인트 직전 구간의 입력이 바뀜: 처음부터 다시 암호화 (새 salt)
+            EncFileHeader before_header, after_header;
+            FILE* fh = fopen(encrypted, "rb");
+            if (!fh || fread(&before_header, 1, sizeof(before_header), fh) != sizeof(before_header)) ok = 0;
+            if (fh) fclose(fh);
+            data[2 * 1024 * 1024 + 5] ^= 0x01;
+            fw = fopen(input, "wb");
+            if (fw) {
+                fwrite(data, 1, size, fw);
+                fclose(fw);
+            }
+            if (!fw || encrypt_file_resumable(input, encrypted, 256, "CkptPw1", NULL, NULL) != FILE_CRYPTO_SUCCESS) ok = 0;
+            fh = fopen(encrypted, "rb");
+            if (!fh || fread(&after_header, 1, sizeof(after_header), fh) != sizeof(after_header) ||
+                memcmp(before_header.salt, after_header.salt, sizeof(before_header.salt)) == 0) {
+                ok = 0;
+            }
+            if (fh) fclose(fh);
+            
+            // 암호문 한 바이트 변조: 끝까지 복호화한 뒤 HMAC이 맞지 않아 스테이징 파일까지 삭제
+            char final_path[512];
+            FILE* ft = fopen(encrypted, "r+b");
+            int tampered = 0;
+            if (ft && fseek(ft, 4 * 1024 * 1024, SEEK_SET) == 0) {
+                int c = fgetc(ft);
+                if (c != EOF && fseek(ft, 4 * 1024 * 1024, SEEK_SET) == 0 && fputc(c ^ 0x01, ft) != EOF) tampered = 1;
+            }
+            if (ft) fclose(ft);
+            remove(decrypted_final);
+            if (!tampered ||
+                decrypt_file_resumable(encrypted, decrypted, "CkptPw1", final_path, sizeof(final_path), NULL, NULL) !=
+                FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED ||
+                platform_file_exists(decrypted_final) || platform_file_exists(decrypted_part) ||
+                platform_file_exists(decrypted_ckpt)) {
+                ok = 0;
+            }
+            
+            if (ok) {
+                printf("  [PASS] 모두 예상대로 처리\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 체크포인트 확인 실패\n");
+            }
+        }
+        
+        set_checkpoint_interval(0);
+        free(data);
+        remove(input);
+        remove(encrypted);
+        remove(encrypted_ckpt);
+    }
+    printf("\n");
+    
+    printf("--- 읽기 전용 검증 테스트 ---\n");
+    {
+        const char* input = "e2e_verify.dat";
+        const char* encrypted[3] = { "e2e_verify_v4.enc", "e2e_verify_v6.enc", "e2e_verify_v9.enc" };
+        const ENC_FORMAT formats[3] = { ENC_FORMAT_DEFAULT, ENC_FORMAT_SEGMENTED, ENC_FORMAT_KEYSLOTS };
+        const char* truncated = "e2e_verify_short.enc";
+        const size_t size = (size_t)3 * 1024 * 1024 + 321;
+        unsigned char* data = (unsigned char*)malloc(size);
+        for (size_t i = 0; data && i < size; i++) data[i] = (unsigned char)(rand() % 256);
+        FILE* fw = data ? fopen(input, "wb") : NULL;
+        if (fw) {
+            fwrite(data, 1, size, fw);
+            fclose(fw);
+        }
+        int created = (fw != NULL);
+        for (int i = 0; i < 3 && created; i++) {
+            set_encryption_format(formats[i]);
+            if (!encrypt_file(input, encrypted[i], 128, "VerifyPw1")) created = 0;
+        }
+        set_encryption_format(ENC_FORMAT_DEFAULT);
+        
+        total_count++;
+        printf("  [테스트] verify_file_with_progress(v4, v6, v9: 성공, 잘못된 비밀번호, 변조 결과 코드)\n");
+        {
+            int ok = created;
+            for (int i = 0; i < 3 && ok; i++) {
+                VerifyProgress progress = { 0, 0 };
+                struct stat st;
+                if (stat(encrypted[i], &st) != 0 ||
+                    verify_file_with_progress(encrypted[i], "VerifyPw1", verify_progress_record, &progress) !=
+                    FILE_CRYPTO_SUCCESS ||
+                    progress.total != (int64_t)st.st_size || progress.last != (int64_t)st.st_size ||
+                    verify_file_with_progress(encrypted[i], "WrongPw1", NULL, NULL) != FILE_CRYPTO_ERR_KEY_CHECK_FAILED) {
+                    ok = 0;
+                }
+            }
+            
+            // 암호문 가운데 한 바이트 변조 (v9는 v4와 같은 전체 HMAC, v6은 세그먼트 태그)
+            for (int i = 0; i < 3 && ok; i++) {
+                FILE* ft = fopen(encrypted[i], "r+b");
+                long position = 2 * 1024 * 1024;
+                int c = (ft && fseek(ft, position, SEEK_SET) == 0) ? fgetc(ft) : EOF;
+                if (c == EOF || fseek(ft, position, SEEK_SET) != 0 || fputc(c ^ 0x01, ft) == EOF) ok = 0;
+                if (ft) fclose(ft);
+                if (ok && (verify_file_with_progress(encrypted[i], "VerifyPw1", NULL, NULL) !=
+                           FILE_CRYPTO_ERR_HMAC_VERIFICATION_FAILED || verify_file(encrypted[i], "VerifyPw1"))) {
+                    ok = 0;
+                }
+            }
+            
+            if (ok) {
+                printf("  [PASS] 결과 코드와 진행률이 예상대로\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 결과 코드 또는 진행률 불일치\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] process_file_batch(검증): 파일별 실패 원인, 디렉토리 탐색, 디스크에 쓰지 않음\n");
+        {
+            // 첫 파일은 다시 만들어 정상, 두 번째(v6)는 위에서 변조된 상태, 세 번째는 잘린 파일, 네 번째는 없는 파일
+            int ok = created && encrypt_file(input, encrypted[0], 256, "VerifyPw1");
+            FILE* fs = fopen(truncated, "wb");
+            if (!fs || fwrite(data, 1, 100, fs) != 100) ok = 0;
+            if (fs) fclose(fs);
+            
+            VerifyWalkCount before = { "e2e_verify_", 0, 0 };
+            if (!platform_walk_directory(".", verify_walk_count, &before) || before.matched != 4) ok = 0;
+            
+            FileBatchItem items[4];
+            const char* paths[4] = { encrypted[0], encrypted[1], truncated, "e2e_verify_missing.enc" };
+            memset(items, 0, sizeof(items));
+            for (int i = 0; i < 4; i++) items[i].input_path = paths[i];
+            FileBatchJob job;
+            memset(&job, 0, sizeof(job));
+            job.op = FILE_BATCH_VERIFY;
+            job.password = "VerifyPw1";
+            job.items = items;
+            job.count = 4;
+            job.thread_count = 4;
+            if (!ok || process_file_batch(&job) != 1 || !items[0].result || items[0].final_path[0] != '\0' ||
+                items[1].result || strstr(items[1].final_path, "ntegrity") == NULL ||
+                items[2].result || items[2].final_path[0] == '\0' ||
+                items[3].result || items[3].final_path[0] == '\0') {
+                ok = 0;
+            }
+            
+            VerifyWalkCount after = { "e2e_verify_", 0, 0 };
+            if (!platform_walk_directory(".", verify_walk_count, &after) || after.files != before.files ||
+                after.matched != before.matched) {
+                ok = 0;
+            }
+            
+            if (ok) {
+                printf("  [PASS] 정상 파일만 통과, 실패 원인 보고, 새 파일 없음\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 배치 검증 결과 불일치\n");
+            }
+        }
+        
+        free(data);
+        remove(input);
+        for (int i = 0; i < 3; i++) remove(encrypted[i]);
+        remove(truncated);
+    }
+    printf("\n");
+    
+    printf("--- 병렬 SHA-512 체크섬 테스트 ---\n");
+    {
+        const char* big = "e2e_hash_big.dat";
+        const char* small = "e2e_hash_abc.txt";
+        const size_t size = (size_t)FILE_HASH_MMAP_THRESHOLD * 2 + 777;
+        unsigned char* data = (unsigned char*)malloc(size);
+        for (size_t i = 0; data && i < size; i++) data[i] = (unsigned char)(rand() % 256);
+        FILE* fw = data ? fopen(big, "wb") : NULL;
+        if (fw) {
+            fwrite(data, 1, size, fw);
+            fclose(fw);
+        }
+        FILE* fa = fopen(small, "wb");
+        if (fa) {
+            fputs("abc", fa);
+            fclose(fa);
+        }
+        int created = (fw != NULL && fa != NULL);
+        
+        total_count++;
+        printf("  [테스트] file_sha512(메모리 매핑, 스트리밍) / file_hash_batch(스레드 풀, 없는 파일)\n");
+        {
+            // FIPS 180-2 "abc" 벡터
+            static const uint8_t abc_digest[SHA512_DIGEST_LENGTH] = {
+                0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+                0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2, 0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+                0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+                0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f
+            };
+            uint8_t expected[SHA512_DIGEST_LENGTH];
+            uint8_t mapped[SHA512_DIGEST_LENGTH];
+            uint8_t streamed[SHA512_DIGEST_LENGTH];
+            SHA512_CTX ctx;
+            int ok = created;
+            if (ok) {
+                sha512_init(&ctx);
+                sha512_update(&ctx, data, size);
+                sha512_final(&ctx, expected);
+            }
+            if (ok && (file_sha512(big, 1, mapped) != FILE_CRYPTO_SUCCESS ||
+                       file_sha512(big, 0, streamed) != FILE_CRYPTO_SUCCESS ||
+                       memcmp(mapped, expected, SHA512_DIGEST_LENGTH) != 0 ||
+                       memcmp(streamed, expected, SHA512_DIGEST_LENGTH) != 0)) {
+                ok = 0;
+            }
+            
+            // 큰 파일과 작은 파일을 섞어 입력 순서와 다른 순서로 끝나도 결과가 제자리에 들어가는지 확인
+            FileHashItem items[6];
+            const char* paths[6] = { big, small, "e2e_hash_missing.dat", small, big, small };
+            memset(items, 0, sizeof(items));
+            for (int i = 0; i < 6; i++) items[i].path = paths[i];
+            platform_thread_pool_t* pool = platform_thread_pool_create(3, 0);
+            if (!pool || file_hash_batch(items, 6, 1, pool) != 5 ||
+                items[2].status != FILE_CRYPTO_ERR_FILE_OPEN) {
+                ok = 0;
+            }
+            for (int i = 0; i < 6 && ok; i++) {
+                const uint8_t* want = (paths[i] == big) ? expected : abc_digest;
+                if (i != 2 && (items[i].status != FILE_CRYPTO_SUCCESS ||
+                               memcmp(items[i].digest, want, SHA512_DIGEST_LENGTH) != 0)) {
+                    ok = 0;
+                }
+            }
+            if (pool) platform_thread_pool_destroy(pool);
+            
+            if (ok) {
+                printf("  [PASS] 메모리 매핑, 스트리밍, 배치 결과가 메모리 해시와 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 파일 해시 불일치\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] file_hash_format_line / file_hash_parse_line (sha512sum 형식, 이스케이프, BSD 태그)\n");
+        {
+            static const char abc_hex[] =
+                "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f";
+            uint8_t digest[SHA512_DIGEST_LENGTH];
+            uint8_t parsed[SHA512_DIGEST_LENGTH];
+            char line[FILE_HASH_LINE_LENGTH];
+            char expected_line[FILE_HASH_LINE_LENGTH];
+            char path[MAX_PATH_LENGTH];
+            int ok = (file_sha512(small, 0, digest) == FILE_CRYPTO_SUCCESS);
+            
+            // 일반 경로: "해시  경로\n"
+            snprintf(expected_line, sizeof(expected_line), "%s  dir/abc.txt\n", abc_hex);
+            if (ok && (!file_hash_format_line(digest, "dir/abc.txt", line, sizeof(line)) ||
+                       strcmp(line, expected_line) != 0 ||
+                       !file_hash_parse_line(line, parsed, path, sizeof(path)) ||
+                       memcmp(parsed, digest, SHA512_DIGEST_LENGTH) != 0 || strcmp(path, "dir/abc.txt") != 0)) {
+                ok = 0;
+            }
+            
+            // '\'와 줄바꿈이 있는 경로는 줄 앞에 '\'를 붙이고 이스케이프
+            snprintf(expected_line, sizeof(expected_line), "\\%s  a\\\\b\\nc\n", abc_hex);
+            if (ok && (!file_hash_format_line(digest, "a\\b\nc", line, sizeof(line)) ||
+                       strcmp(line, expected_line) != 0 ||
+                       !file_hash_parse_line(line, parsed, path, sizeof(path)) || strcmp(path, "a\\b\nc") != 0)) {
+                ok = 0;
+            }
+            
+            // BSD 태그 형식, 대문자 16진수와 바이너리 표시('*'), CRLF
+            snprintf(line, sizeof(line), "SHA512 (x (1).txt) = %s\r\n", abc_hex);
+            if (ok && (!file_hash_parse_line(line, parsed, path, sizeof(path)) ||
+                       memcmp(parsed, digest, SHA512_DIGEST_LENGTH) != 0 || strcmp(path, "x (1).txt") != 0)) {
+                ok = 0;
+            }
+            snprintf(line, sizeof(line), "%s *bin.dat\r\n", abc_hex);
+            for (int i = 0; i < FILE_HASH_HEX_LENGTH; i++) {
+                if (line[i] >= 'a' && line[i] <= 'f') line[i] = (char)(line[i] - 'a' + 'A');
+            }
+            if (ok && (!file_hash_parse_line(line, parsed, path, sizeof(path)) ||
+                       memcmp(parsed, digest, SHA512_DIGEST_LENGTH) != 0 || strcmp(path, "bin.dat") != 0)) {
+                ok = 0;
+            }
+            
+            // 형식 오류: 짧은 해시, 구분자 없음, 16진수가 아닌 문자, 빈 경로, 잘못된 이스케이프
+            const char* malformed[5] = { "abcd  file\n", NULL, NULL, NULL, NULL };
+            char bad[4][FILE_HASH_LINE_LENGTH];
+            snprintf(bad[0], sizeof(bad[0]), "%s-file\n", abc_hex);
+            snprintf(bad[1], sizeof(bad[1]), "%s  file\n", abc_hex);
+            bad[1][5] = 'g';
+            snprintf(bad[2], sizeof(bad[2]), "%s  \n", abc_hex);
+            snprintf(bad[3], sizeof(bad[3]), "\\%s  a\\tb\n", abc_hex);
+            for (int i = 0; i < 4; i++) malformed[i + 1] = bad[i];
+            for (int i = 0; i < 5 && ok; i++) {
+                if (file_hash_parse_line(malformed[i], parsed, path, sizeof(path))) ok = 0;
+            }
+            
+            if (ok) {
+                printf("  [PASS] 줄 생성과 해석이 sha512sum 규칙과 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 체크섬 줄 형식 불일치\n");
+            }
+        }
+        
+        free(data);
+        remove(big);
+        remove(small);
+    }
+    printf("\n");
+    
+    printf("--- 암호화 + 평문 SHA-512 동시 계산 테스트 ---\n");
+    {
+        const char* input = "e2e_digest.dat";
+        const char* encrypted = "e2e_digest.enc";
+        const char* decrypted = "e2e_digest_out";
+        const char* small = "e2e_digest_small.dat";
+        const char* small_encrypted = "e2e_digest_small.enc";
+        // 청크 크기로 나누어떨어지지 않고 I/O 가속 경로를 타는 크기
+        const size_t size = (size_t)5 * 1024 * 1024 + 4321;
+        unsigned char* data = (unsigned char*)malloc(size);
+        for (size_t i = 0; data && i < size; i++) data[i] = (unsigned char)(rand() % 256);
+        FILE* fw = data ? fopen(input, "wb") : NULL;
+        if (fw) {
+            fwrite(data, 1, size, fw);
+            fclose(fw);
+        }
+        FILE* fs = fopen(small, "wb");
+        if (fs) {
+            fwrite("digest", 1, 6, fs);
+            fclose(fs);
+        }
+        uint8_t expected[SHA512_DIGEST_LENGTH];
+        uint8_t expected_small[SHA512_DIGEST_LENGTH];
+        int created = (fw != NULL && fs != NULL);
+        if (created) {
+            SHA512_CTX ctx;
+            sha512_init(&ctx);
+            sha512_update(&ctx, data, size);
+            sha512_final(&ctx, expected);
+            sha512_init(&ctx);
+            sha512_update(&ctx, (const uint8_t*)"digest", 6);
+            sha512_final(&ctx, expected_small);
+        }
+        
+        total_count++;
+        printf("  [테스트] encrypt_file_with_digest(단일 스레드, 파이프라인, 메모리 매핑, io_uring, O_DIRECT)\n");
+        {
+            const FILE_IO_MODE modes[5] = { FILE_IO_MODE_SERIAL, FILE_IO_MODE_PIPELINED, FILE_IO_MODE_MMAP,
+                                            FILE_IO_MODE_IO_URING, FILE_IO_MODE_DIRECT };
+            int ok = created;
+            for (int m = 0; m < 5 && ok; m++) {
+                uint8_t digest[ENC_PLAINTEXT_DIGEST_SIZE];
+                char final_path[512];
+                memset(digest, 0, sizeof(digest));
+                set_file_io_mode(modes[m]);
+                if (!encrypt_file_with_digest(input, encrypted, 256, "DigestPw1", NULL, NULL, digest) ||
+                    memcmp(digest, expected, sizeof(digest)) != 0) {
+                    ok = 0;
+                }
+                // 해시를 함께 계산해도 암호문은 그대로 복호화되어야 함
+                set_file_io_mode(FILE_IO_MODE_AUTO);
+                if (ok && (!decrypt_file(encrypted, decrypted, "DigestPw1", final_path, sizeof(final_path)) ||
+                           !compare_files(input, final_path))) {
+                    ok = 0;
+                }
+                if (ok) remove(final_path);
+                remove(encrypted);
+            }
+            set_file_io_mode(FILE_IO_MODE_AUTO);
+            
+            if (ok) {
+                printf("  [PASS] 모든 I/O 경로에서 평문 해시 일치, 복호화 결과 동일\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 평문 해시 또는 복호화 결과 불일치\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] process_file_batch(plaintext_digest: v6, v7, v8, v9 형식, 없는 파일)\n");
+        {
+            const ENC_FORMAT formats[4] = { ENC_FORMAT_SEGMENTED, ENC_FORMAT_COMPRESSED,
+                                            ENC_FORMAT_INCREMENTAL, ENC_FORMAT_KEYSLOTS };
+            int ok = created;
+            for (int f = 0; f < 4 && ok; f++) {
+                FileBatchItem items[3];
+                const char* inputs[3] = { input, small, "e2e_digest_missing.dat" };
+                const char* outputs[3] = { encrypted, small_encrypted, "e2e_digest_missing.enc" };
+                memset(items, 0, sizeof(items));
+                for (int i = 0; i < 3; i++) {
+                    items[i].input_path = inputs[i];
+                    items[i].output_path = outputs[i];
+                }
+                FileBatchJob job;
+                memset(&job, 0, sizeof(job));
+                job.op = FILE_BATCH_ENCRYPT;
+                job.aes_key_bits = 128;
+                job.password = "DigestPw1";
+                job.items = items;
+                job.count = 3;
+                job.thread_count = 3;
+                job.plaintext_digest = 1;
+                set_encryption_format(formats[f]);
+                if (process_file_batch(&job) != 2 || items[2].result ||
+                    memcmp(items[0].plaintext_digest, expected, SHA512_DIGEST_LENGTH) != 0 ||
+                    memcmp(items[1].plaintext_digest, expected_small, SHA512_DIGEST_LENGTH) != 0 ||
+                    !verify_file(encrypted, "DigestPw1") || !verify_file(small_encrypted, "DigestPw1")) {
+                    ok = 0;
+                }
+                remove(encrypted);
+                remove(small_encrypted);
+            }
+            set_encryption_format(ENC_FORMAT_DEFAULT);
+            
+            if (ok) {
+                printf("  [PASS] 형식과 무관하게 항목별 평문 해시 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 배치 평문 해시 불일치\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] process_file_batch(resumable + plaintext_digest: 새로 시작, 중단 후 이어서)\n");
+        {
+            char checkpoint_path[512];
+            snprintf(checkpoint_path, sizeof(checkpoint_path), "%s%s", encrypted, ENC_CHECKPOINT_SUFFIX);
+            set_checkpoint_interval(1024 * 1024);
+            int ok = created;
+            for (int resumed = 0; resumed < 2 && ok; resumed++) {
+                // 두 번째는 3 MiB 지점에서 중단된 상태를 만든 뒤 배치가 이어서 암호화
+                if (resumed) {
+                    CheckpointSnapshot snapshot = { { encrypted, checkpoint_path }, { "e2e_digest_snap0", "e2e_digest_snap1" },
+                                                    (int64_t)3 * 1024 * 1024, 0 };
+                    if (encrypt_file_resumable(input, encrypted, 128, "DigestPw1", checkpoint_snapshot_progress,
+                                               &snapshot) != FILE_CRYPTO_SUCCESS ||
+                        !checkpoint_snapshot_restore(&snapshot) || !platform_file_exists(checkpoint_path)) {
+                        ok = 0;
+                    }
+                }
+                FileBatchItem item;
+                memset(&item, 0, sizeof(item));
+                item.input_path = input;
+                item.output_path = encrypted;
+                FileBatchJob job;
+                memset(&job, 0, sizeof(job));
+                job.op = FILE_BATCH_ENCRYPT;
+                job.aes_key_bits = 128;
+                job.password = "DigestPw1";
+                job.items = &item;
+                job.count = 1;
+                job.thread_count = 1;
+                job.resumable = 1;
+                job.plaintext_digest = 1;
+                if (!ok || process_file_batch(&job) != 1 ||
+                    memcmp(item.plaintext_digest, expected, SHA512_DIGEST_LENGTH) != 0 ||
+                    platform_file_exists(checkpoint_path) || !verify_file(encrypted, "DigestPw1")) {
+                    ok = 0;
+                }
+                remove(encrypted);
+            }
+            remove(checkpoint_path);
+            set_checkpoint_interval(0);
+            
+            if (ok) {
+                printf("  [PASS] 새로 시작한 실행과 이어서 한 실행 모두 평문 해시 일치\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 체크포인트 암호화의 평문 해시 불일치\n");
+            }
+        }
+        
+        free(data);
+        remove(input);
+        remove(small);
+    }
+    printf("\n");
+    
+    // 키 확인 값 테스트 (v3+: 잘못된 비밀번호는 데이터를 읽기 전에 거부, v2는 KCV 없이 복호화)
+    printf("--- 키 확인 값(KCV)과 v2 호환 테스트 ---\n");
+    {
+        const char* input = "e2e_kcv_input.txt";
+        const char* encrypted = "e2e_kcv.enc";
+        const char* output = "e2e_kcv_out.txt";
+        const char* legacy = "e2e_kcv_legacy.enc";
+        const char* legacy_output = "e2e_kcv_legacy_out.txt";
+        char part_path[512];
+        snprintf(part_path, sizeof(part_path), "%s%s", output, ENC_CHECKPOINT_PART_SUFFIX);
+        
+        static uint8_t plaintext[100000];
+        for (size_t i = 0; i < sizeof(plaintext); i++) plaintext[i] = (uint8_t)('a' + (i * 7) % 26);
+        FILE* fp = fopen(input, "wb");
+        int created = fp && fwrite(plaintext, 1, sizeof(plaintext), fp) == sizeof(plaintext);
+        if (fp) fclose(fp);
+        
+        total_count++;
+        printf("  [테스트] 잘못된 비밀번호 (FILE_CRYPTO_ERR_KEY_CHECK_FAILED, 출력/스테이징 파일 없음)\n");
+        {
+            int ok = created && encrypt_file(input, encrypted, 256, "KcvPass1");
+            VerifyWalkCount before = { ".decrypt_", 0, 0 };
+            if (ok && !platform_walk_directory(".", verify_walk_count, &before)) ok = 0;
+            if (ok) {
+                char final_path[512] = "";
+                VerifyProgress progress = { 0, 0 };
+                if (decrypt_file_with_progress(encrypted, output, "WrongKcv1", final_path, sizeof(final_path),
+                                               verify_progress_record, &progress) ||
+                    strstr(final_path, "Incorrect password") == NULL || progress.last != 0) {
+                    ok = 0;
+                }
+                if (decrypt_file_resumable(encrypted, output, "WrongKcv1", final_path, sizeof(final_path),
+                                           NULL, NULL) != FILE_CRYPTO_ERR_KEY_CHECK_FAILED ||
+                    verify_file_with_progress(encrypted, "WrongKcv1", NULL, NULL) != FILE_CRYPTO_ERR_KEY_CHECK_FAILED) {
+                    ok = 0;
+                }
+            }
+            VerifyWalkCount after = { ".decrypt_", 0, 0 };
+            if (ok && (!platform_walk_directory(".", verify_walk_count, &after) ||
+                       after.files != before.files || after.matched != 0)) {
+                ok = 0;
+            }
+            if (ok && (access(output, F_OK) == 0 || access(part_path, F_OK) == 0)) ok = 0;
+            
+            if (ok) {
+                printf("  [PASS] 키 확인 실패, 출력과 스테이징 파일 없음\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 잘못된 비밀번호 처리 결과가 잘못되었습니다\n");
+            }
+        }
+        
+        // v2 파일을 직접 구성: [헤더 (reserved = 0) | HMAC(헤더 + 평문) | 암호문]
+        total_count++;
+        printf("  [테스트] 직접 만든 v2 파일 (KCV 없음) 복호화\n");
+        {
+            EncFileHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.signature, ENC_SIGNATURE, 4);
+            header.version = ENC_VERSION_LEGACY;
+            header.key_length_code = KEY_LENGTH_CODE_128;
+            header.mode_code = ENC_MODE_CTR;
+            header.hmac_enabled = ENC_HMAC_ENABLED;
+            for (int i = 0; i < ENC_NONCE_SIZE; i++) header.nonce[i] = (uint8_t)(0x30 + i);
+            memcpy(header.format, ".txt", 4);
+            for (int i = 0; i < ENC_SALT_SIZE; i++) header.salt[i] = (uint8_t)(0xA0 + i);
+            
+            uint8_t aes_key[16];
+            uint8_t hmac_key[HMAC_KEY_SIZE];
+            derive_keys("LegacyPass1", 128, header.salt, ENC_SALT_SIZE, aes_key, hmac_key);
+            
+            uint8_t tag[ENC_HMAC_SIZE];
+            HMAC_SHA512_CTX hmac_ctx;
+            hmac_sha512_init(&hmac_ctx, hmac_key, HMAC_KEY_SIZE);
+            hmac_sha512_update(&hmac_ctx, (const uint8_t*)&header, sizeof(header));
+            hmac_sha512_update(&hmac_ctx, plaintext, sizeof(plaintext));
+            hmac_sha512_final(&hmac_ctx, tag);
+            
+            static uint8_t ciphertext[sizeof(plaintext)];
+            uint8_t nonce_counter[AES_BLOCK_SIZE];
+            memset(nonce_counter, 0, sizeof(nonce_counter));
+            memcpy(nonce_counter, header.nonce, ENC_NONCE_SIZE);
+            AES_CTX aes_ctx;
+            int ok = created && AES_set_key(&aes_ctx, aes_key, 128) == CRYPTO_SUCCESS &&
+                     AES_CTR_crypt(&aes_ctx, plaintext, sizeof(plaintext), ciphertext, nonce_counter) == CRYPTO_SUCCESS;
+            
+            FILE* fl = ok ? fopen(legacy, "wb") : NULL;
+            if (!fl || fwrite(&header, 1, sizeof(header), fl) != sizeof(header) ||
+                fwrite(tag, 1, sizeof(tag), fl) != sizeof(tag) ||
+                fwrite(ciphertext, 1, sizeof(ciphertext), fl) != sizeof(ciphertext)) {
+                ok = 0;
+            }
+            if (fl) fclose(fl);
+            
+            char final_path[512] = "";
+            if (ok && (!decrypt_file(legacy, legacy_output, "LegacyPass1", final_path, sizeof(final_path)) ||
+                       !compare_files(input, final_path))) {
+                ok = 0;
+            }
+            if (final_path[0] != '\0') remove(final_path);
+            if (ok && decrypt_file(legacy, legacy_output, "WrongLegacy1", final_path, sizeof(final_path))) ok = 0;
+            
+            if (ok) {
+                printf("  [PASS] v2 파일 복호화 결과 일치, 잘못된 비밀번호는 HMAC으로 거부\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] v2 파일 복호화 실패\n");
+            }
+        }
+        
+        remove(input);
+        remove(encrypted);
+        remove(output);
+        remove(part_path);
+        remove(legacy);
+        remove(legacy_output);
+    }
+    printf("\n");
+    
+    // 출력 스테이징 테스트 (대상 디렉토리의 숨김 파일에 복호화한 뒤 검증이 끝나면 rename으로 게시)
+    printf("--- 복호화 출력 스테이징 테스트 ---\n");
+    {
+        const char* stage_dir = "e2e_stage_dir";
+        const char* input = "e2e_stage_input.txt";
+        const char* encrypted = "e2e_stage.enc";
+        const char* tampered = "e2e_stage_tampered.enc";
+        const char* fresh_output = "e2e_stage_dir/fresh.txt";
+        const char* existing_output = "e2e_stage_dir/existing.txt";
+        const char* rejected_output = "e2e_stage_dir/rejected.txt";
+        
+        int created = make_test_directory(stage_dir) && create_test_file(input, 2);
+        created = created && encrypt_file(input, encrypted, 256, "StagePass1") && copy_test_file(encrypted, tampered);
+        FILE* ft = created ? fopen(tampered, "r+b") : NULL;
+        if (!ft || fseek(ft, -1, SEEK_END) != 0 || fputc(0x5A, ft) == EOF) created = 0;
+        if (ft) fclose(ft);
+        
+        total_count++;
+        printf("  [테스트] 대상 디렉토리에 복호화 (스테이징 파일이 남지 않음)\n");
+        {
+            char final_path[512] = "";
+            int ok = created && decrypt_file(encrypted, fresh_output, "StagePass1", final_path, sizeof(final_path)) &&
+                     strcmp(final_path, fresh_output) == 0 && compare_files(input, fresh_output);
+            VerifyWalkCount count = { ".decrypt_", 0, 0 };
+            if (ok && (!platform_walk_directory(stage_dir, verify_walk_count, &count) ||
+                       count.files != 1 || count.matched != 0)) {
+                ok = 0;
+            }
+            
+            if (ok) {
+                printf("  [PASS] 출력만 남고 .decrypt_* 파일 없음\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 대상 디렉토리 복호화 결과가 잘못되었습니다\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] 기존 출력 파일 위에 복호화 (게시 시 교체)\n");
+        {
+            FILE* fe = fopen(existing_output, "wb");
+            int ok = created && fe && fputs("stale output that must be replaced\n", fe) >= 0;
+            if (fe) fclose(fe);
+            char final_path[512] = "";
+            ok = ok && decrypt_file(encrypted, existing_output, "StagePass1", final_path, sizeof(final_path)) &&
+                 strcmp(final_path, existing_output) == 0 && compare_files(input, existing_output);
+            VerifyWalkCount count = { ".decrypt_", 0, 0 };
+            if (ok && (!platform_walk_directory(stage_dir, verify_walk_count, &count) ||
+                       count.files != 2 || count.matched != 0)) {
+                ok = 0;
+            }
+            
+            if (ok) {
+                printf("  [PASS] 기존 파일이 복호화 결과로 교체됨\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] 기존 출력 파일이 교체되지 않았습니다\n");
+            }
+        }
+        
+        total_count++;
+        printf("  [테스트] HMAC 검증 실패 (출력과 스테이징 파일 없음, 기존 파일 유지)\n");
+        {
+            char final_path[512] = "";
+            int ok = created &&
+                     !decrypt_file(tampered, rejected_output, "StagePass1", final_path, sizeof(final_path)) &&
+                     !decrypt_file(tampered, existing_output, "StagePass1", final_path, sizeof(final_path)) &&
+                     access(rejected_output, F_OK) != 0 && compare_files(input, existing_output);
+            VerifyWalkCount count = { ".decrypt_", 0, 0 };
+            if (ok && (!platform_walk_directory(stage_dir, verify_walk_count, &count) ||
+                       count.files != 2 || count.matched != 0)) {
+                ok = 0;
+            }
+            
+            if (ok) {
+                printf("  [PASS] 변조 감지, 새 출력과 .decrypt_* 파일 없음\n");
+                pass_count++;
+            } else {
+                printf("  [FAIL] HMAC 실패 후 출력 또는 스테이징 파일이 남았습니다\n");
+            }
+        }
+        
+        remove(fresh_output);
+        remove(existing_output);
+        remove(rejected_output);
+        rmdir(stage_dir);
+        remove(input);
+        remove(encrypted);
+        remove(tampered);
+    }
+    printf("\n");
+    
+    // 변조된 암호문 테스트 (v4: 복호화 전에 HMAC 검증, 출력 파일 생성 안 함)
+    printf("--- 변조된 암호문 복호화 거부 테스트 ---\n");
+    total_count++;
+    {
+        const char* tampered_decrypted = "e2e_test_tampered.txt";
+        FILE* ft = fopen("e2e_test_256.enc", "r+b");
+        int tampered = 0;
+        if (ft && fseek(ft, -1, SEEK_END) == 0) {
+            int c = fgetc(ft);
+            if (c != EOF && fseek(ft, -1, SEEK_END) == 0 && fputc(c ^ 0x01, ft) != EOF) {
+                tampered = 1;
+            }
+        }
+        if (ft) fclose(ft);
+        
+        if (!tampered) {
+            printf("  [ERROR] 암호문 변조 실패\n");
+        } else {
+            char final_path[512];
+            int decrypt_result = decrypt_file("e2e_test_256.enc", tampered_decrypted,
+                                              "TestPass123", final_path, sizeof(final_path));
+            if (decrypt_result) {
+                printf("  [FAIL] 변조된 파일의 복호화가 성공했습니다\n");
+            } else if (access(tampered_decrypted, F_OK) == 0) {
+                printf("  [FAIL] 검증 실패 후에도 출력 파일이 남아 있습니다\n");
+            } else {
+                printf("  [PASS] 변조 감지, 출력 파일 없음\n");
+                pass_count++;
+            }
+        }
+        remove(tampered_decrypted);
+    }
+    total_count++;
+    printf("  [테스트] verify_file로 변조 감지\n");
+    if (!verify_file("e2e_test_256.enc", "TestPass123")) {
+        printf("  [PASS] 변조 감지\n");
+        pass_count++;
+    } else {
+        printf("  [FAIL] 변조된 파일의 검증이 성공했습니다\n");
+    }
+    printf("\n");
+    
     // 테스트 파일 정리
     remove(test_input);
     remove(test_encrypted);
@@ -1451,6 +4191,7 @@ int main(void) {
     int hmac_result = test_hmac_sha512();
     int pbkdf2_result = test_pbkdf2_sha512();
     int aes_result = test_aes();
+    int pool_result = test_thread_pool();
     
     printf("=======================================\n");
     printf("  Unit Test Summary\n");
@@ -1459,6 +4200,7 @@ int main(void) {
     printf("HMAC-SHA512:  %s\n", hmac_result == 0 ? "PASS" : "FAIL");
     printf("PBKDF2-SHA512: %s\n", pbkdf2_result == 0 ? "PASS" : "FAIL");
     printf("AES:          %s\n", aes_result == 0 ? "PASS" : "FAIL");
+    printf("Thread Pool:  %s\n", pool_result == 0 ? "PASS" : "FAIL");
     printf("=======================================\n\n");
     
     // 통합 테스트
@@ -1467,7 +4209,7 @@ int main(void) {
     // E2E 테스트
     int e2e_result = test_e2e_cli();
     
-    if (sha512_result == 0 && hmac_result == 0 && pbkdf2_result == 0 && aes_result == 0) {
+    if (sha512_result == 0 && hmac_result == 0 && pbkdf2_result == 0 && aes_result == 0 && pool_result == 0) {
         printf("All unit tests PASSED!\n");
         return 0;
     } else {